@@ -0,0 +1,887 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Array.h"
+#include "Sparse.h"
+#include "dMatrix.h"
+#include "idx-vector.h"
+#include "lo-mappers.h"
+#include "oct-inttypes.h"
+#include "oct-thread-pool.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "ov.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// accumarray gathers the values that share a subscript into bins and
+// reduces each bin to a single value.  The built-in reductions scatter
+// the values straight into an accumulator per bin.  Large inputs with
+// fewer bins than values are split between threads, each of which
+// accumulates into private bins that are merged at the end.  For sparse
+// results, and for reductions given as arbitrary functions, the values
+// are instead grouped by subscript with a stable counting sort.
+
+enum class accum_op { sum, prod, max, min, mean, count, any, all };
+
+static accum_op
+accum_op_value (const std::string& name)
+{
+  if (name == "sum")
+    return accum_op::sum;
+  else if (name == "prod")
+    return accum_op::prod;
+  else if (name == "max")
+    return accum_op::max;
+  else if (name == "min")
+    return accum_op::min;
+  else if (name == "mean")
+    return accum_op::mean;
+  else if (name == "count")
+    return accum_op::count;
+  else if (name == "any")
+    return accum_op::any;
+  else if (name == "all")
+    return accum_op::all;
+  else
+    error ("__accumarray__: unknown reduction '%s'", name.c_str ());
+}
+
+// Types used to accumulate sums and products, and to compare values,
+// for each element type.  Integer and logical values are summed in
+// double precision like the rest of accumarray always has, and logical
+// maxima and minima are double as well.
+
+// Products of integers saturate, so the order in which they are
+// multiplied matters and they are never split between threads.
+
+template <typename T>
+struct accum_traits
+{
+  typedef T sum_type;
+  typedef T prod_type;
+  typedef T minmax_type;
+  static const bool prod_associative = true;
+};
+
+template <typename T>
+struct accum_traits<octave_int<T>>
+{
+  typedef double sum_type;
+  typedef octave_int<T> prod_type;
+  typedef octave_int<T> minmax_type;
+  static const bool prod_associative = false;
+};
+
+template <>
+struct accum_traits<bool>
+{
+  typedef double sum_type;
+  typedef double prod_type;
+  typedef double minmax_type;
+  static const bool prod_associative = true;
+};
+
+// Reductions with an identity element start every bin from it.  max and
+// min take the first value that arrives in a bin and ignore NaN after
+// that, like the max and min functions do.  VALUE converts an element to
+// the type of the bins.
+
+template <typename R>
+struct accum_numeric
+{
+  template <typename T>
+  static R value (const T& x) { return static_cast<R> (x); }
+};
+
+template <typename R>
+struct accum_add : public accum_numeric<R>
+{
+  static const bool has_identity = true;
+  static R identity () { return R (0); }
+  static void apply (R& a, const R& x) { a += x; }
+};
+
+template <typename R>
+struct accum_mul : public accum_numeric<R>
+{
+  static const bool has_identity = true;
+  static R identity () { return R (1); }
+  static void apply (R& a, const R& x) { a = a * x; }
+};
+
+template <typename R>
+struct accum_max : public accum_numeric<R>
+{
+  static const bool has_identity = false;
+  static R identity () { return R (); }
+  static void apply (R& a, const R& x) { a = math::max (a, x); }
+};
+
+template <typename R>
+struct accum_min : public accum_numeric<R>
+{
+  static const bool has_identity = false;
+  static R identity () { return R (); }
+  static void apply (R& a, const R& x) { a = math::min (a, x); }
+};
+
+// any ignores NaN, but all counts it as true, like the any and all
+// functions do.
+
+struct accum_or
+{
+  template <typename T>
+  static bool value (const T& x) { return ! math::isnan (x) && x != T (0); }
+
+  static const bool has_identity = true;
+  static bool identity () { return false; }
+  static void apply (bool& a, bool x) { a = a || x; }
+};
+
+struct accum_and
+{
+  template <typename T>
+  static bool value (const T& x) { return x != T (0); }
+
+  static const bool has_identity = true;
+  static bool identity () { return true; }
+  static void apply (bool& a, bool x) { a = a && x; }
+};
+
+// Accumulate the values V[K*VSTEP] for BEG <= K < END into the bins
+// ACC[IDX[K]] and, if CNT is not null, count them in CNT[IDX[K]].
+// Reductions without an identity element always need the counts.
+
+template <typename OP, typename T, typename R>
+static void
+accum_scatter (const octave_idx_type *idx, const T *v, octave_idx_type vstep,
+               octave_idx_type beg, octave_idx_type end,
+               R *acc, octave_idx_type *cnt)
+{
+  for (octave_idx_type k = beg; k < end; k++)
+    {
+      octave_idx_type j = idx[k];
+      R x = OP::value (v[k * vstep]);
+
+      if (OP::has_identity || cnt[j] != 0)
+        OP::apply (acc[j], x);
+      else
+        acc[j] = x;
+
+      if (cnt)
+        cnt[j]++;
+    }
+}
+
+template <typename OP, typename T, typename R>
+static void
+accum_dense (const octave_idx_type *idx, octave_idx_type len,
+             const T *v, octave_idx_type vstep, octave_idx_type n,
+             bool associative, R *acc, octave_idx_type *cnt)
+{
+  R init = OP::identity ();
+
+  std::fill_n (acc, n, init);
+  if (cnt)
+    std::fill_n (cnt, n, 0);
+
+  octave_idx_type nt = thread_pool::num_threads ();
+
+  if (! associative || nt < 2 || n > len / nt
+      || ! thread_pool::use_threads (len))
+    {
+      accum_scatter<OP> (idx, v, vstep, 0, len, acc, cnt);
+      return;
+    }
+
+  // The first share of the values goes into the result and the others
+  // into private bins.  The shares depend only on the number of threads,
+  // so the result does not depend on how the threads are scheduled.
+
+  Array<R> pacc (dim_vector (n, nt - 1), init);
+  Array<octave_idx_type> pcnt (dim_vector (cnt ? n : 0, nt - 1), 0);
+  R *pa = pacc.rwdata ();
+  octave_idx_type *pc = pcnt.rwdata ();
+
+  thread_pool::parallel_for (nt, len / nt,
+                             [=] (std::size_t b, std::size_t e)
+  {
+    for (octave_idx_type c = b; c < static_cast<octave_idx_type> (e); c++)
+      {
+        octave_idx_type beg = len / nt * c + std::min (c, len % nt);
+        octave_idx_type end = beg + len / nt + (c < len % nt);
+
+        if (c == 0)
+          accum_scatter<OP> (idx, v, vstep, beg, end, acc, cnt);
+        else
+          accum_scatter<OP> (idx, v, vstep, beg, end, pa + (c-1)*n,
+                             cnt ? pc + (c-1)*n : nullptr);
+      }
+  });
+
+  thread_pool::parallel_for (n, nt, [=] (std::size_t b, std::size_t e)
+  {
+    for (std::size_t j = b; j < e; j++)
+      for (octave_idx_type c = 1; c < nt; c++)
+        {
+          const R& x = pa[(c-1)*n + j];
+
+          if (OP::has_identity)
+            OP::apply (acc[j], x);
+          else if (pc[(c-1)*n + j] != 0)
+            {
+              if (cnt[j] != 0)
+                OP::apply (acc[j], x);
+              else
+                acc[j] = x;
+            }
+
+          if (cnt)
+            cnt[j] += pc[(c-1)*n + j];
+        }
+  });
+}
+
+// Reduce the bins with OP and set the empty ones to FILL.  If FILL is
+// zero and OP starts from zero, the empty bins need not be tracked.
+
+template <typename OP, typename R, typename T>
+static octave_value
+accum_reduce (const octave_idx_type *idx, octave_idx_type len,
+              const T *v, octave_idx_type vstep, octave_idx_type n,
+              bool associative, double fill)
+{
+  Array<R> acc (dim_vector (n, 1));
+  R *pa = acc.rwdata ();
+
+  bool track = ! (OP::has_identity && fill == 0
+                  && OP::identity () == R (0));
+
+  Array<octave_idx_type> cnt (dim_vector (track ? n : 0, 1));
+  octave_idx_type *pc = (track ? cnt.rwdata () : nullptr);
+
+  accum_dense<OP> (idx, len, v, vstep, n, associative, pa, pc);
+
+  if (track)
+    {
+      R fval = static_cast<R> (fill);
+      for (octave_idx_type j = 0; j < n; j++)
+        if (pc[j] == 0)
+          pa[j] = fval;
+    }
+
+  return acc;
+}
+
+template <typename R, typename T>
+static octave_value
+accum_mean (const octave_idx_type *idx, octave_idx_type len,
+            const T *v, octave_idx_type vstep, octave_idx_type n,
+            double fill)
+{
+  Array<R> acc (dim_vector (n, 1));
+  Array<octave_idx_type> cnt (dim_vector (n, 1));
+  R *pa = acc.rwdata ();
+  octave_idx_type *pc = cnt.rwdata ();
+
+  accum_dense<accum_add<R>> (idx, len, v, vstep, n, true, pa, pc);
+
+  R fval = static_cast<R> (fill);
+  for (octave_idx_type j = 0; j < n; j++)
+    pa[j] = (pc[j] == 0 ? fval : pa[j] / static_cast<R> (pc[j]));
+
+  return acc;
+}
+
+static octave_value
+accum_count (const octave_idx_type *idx, octave_idx_type len,
+             octave_idx_type n, double fill)
+{
+  NDArray retval (dim_vector (n, 1), 0);
+  double *pr = retval.rwdata ();
+
+  for (octave_idx_type k = 0; k < len; k++)
+    pr[idx[k]]++;
+
+  if (fill != 0)
+    for (octave_idx_type j = 0; j < n; j++)
+      if (pr[j] == 0)
+        pr[j] = fill;
+
+  return retval;
+}
+
+// any and all are logical, unless empty bins are filled with something
+// other than false.
+
+template <typename OP, typename T>
+static octave_value
+accum_logical (const octave_idx_type *idx, octave_idx_type len,
+               const T *v, octave_idx_type vstep, octave_idx_type n,
+               double fill)
+{
+  if (fill == 0 && ! OP::identity ())
+    return accum_reduce<OP, bool> (idx, len, v, vstep, n, true, fill);
+
+  Array<bool> acc (dim_vector (n, 1));
+  Array<octave_idx_type> cnt (dim_vector (n, 1));
+  octave_idx_type *pc = cnt.rwdata ();
+
+  accum_dense<OP> (idx, len, v, vstep, n, true, acc.rwdata (), pc);
+
+  if (fill == 0)
+    {
+      for (octave_idx_type j = 0; j < n; j++)
+        if (pc[j] == 0)
+          acc.xelem (j) = false;
+
+      return acc;
+    }
+
+  NDArray retval (dim_vector (n, 1));
+  for (octave_idx_type j = 0; j < n; j++)
+    retval.xelem (j) = (pc[j] == 0 ? fill : acc.xelem (j));
+
+  return retval;
+}
+
+template <typename NDA>
+static octave_value
+do_accumarray (accum_op op, const octave_idx_type *idx, octave_idx_type len,
+               const NDA& vals, octave_idx_type n, double fill)
+{
+  typedef typename NDA::element_type T;
+  typedef typename accum_traits<T>::sum_type S;
+  typedef typename accum_traits<T>::prod_type P;
+  typedef typename accum_traits<T>::minmax_type M;
+
+  const T *v = vals.data ();
+  octave_idx_type vstep = (vals.numel () == 1 ? 0 : 1);
+
+  switch (op)
+    {
+    case accum_op::sum:
+      return accum_reduce<accum_add<S>, S> (idx, len, v, vstep, n, true,
+                                            fill);
+
+    case accum_op::prod:
+      return accum_reduce<accum_mul<P>, P> (idx, len, v, vstep, n,
+                                            accum_traits<T>::prod_associative,
+                                            fill);
+
+    case accum_op::max:
+      return accum_reduce<accum_max<M>, M> (idx, len, v, vstep, n, true,
+                                            fill);
+
+    case accum_op::min:
+      return accum_reduce<accum_min<M>, M> (idx, len, v, vstep, n, true,
+                                            fill);
+
+    case accum_op::mean:
+      return accum_mean<S> (idx, len, v, vstep, n, fill);
+
+    case accum_op::count:
+      return accum_count (idx, len, n, fill);
+
+    case accum_op::any:
+      return accum_logical<accum_or> (idx, len, v, vstep, n, fill);
+
+    case accum_op::all:
+      return accum_logical<accum_and> (idx, len, v, vstep, n, fill);
+    }
+
+  return octave_value ();
+}
+
+// Sort the positions 0 to LEN-1, or the positions IN[0] to IN[LEN-1] if
+// IN is not null, stably by KEY, whose values lie in [0, NK).
+
+static void
+accum_counting_sort (const octave_idx_type *key, octave_idx_type nk,
+                     const octave_idx_type *in, octave_idx_type len,
+                     octave_idx_type *out)
+{
+  std::vector<octave_idx_type> start (nk + 1, 0);
+
+  for (octave_idx_type k = 0; k < len; k++)
+    start[key[in ? in[k] : k] + 1]++;
+
+  std::partial_sum (start.begin (), start.end (), start.begin ());
+
+  for (octave_idx_type k = 0; k < len; k++)
+    {
+      octave_idx_type p = (in ? in[k] : k);
+      out[start[key[p]]++] = p;
+    }
+}
+
+// Positions of the values grouped by subscript, in the order of the
+// linear index of the subscript and in their original order within each
+// group, and the start of each group followed by the end of the last.
+
+struct accum_groups
+{
+  std::vector<octave_idx_type> perm;
+  std::vector<octave_idx_type> start;
+};
+
+static accum_groups
+accum_group (const octave_idx_type *ii, octave_idx_type m,
+             const octave_idx_type *jj, octave_idx_type n,
+             octave_idx_type len)
+{
+  accum_groups g;
+  g.perm.resize (len);
+  octave_idx_type *perm = g.perm.data ();
+
+  if (jj)
+    {
+      // Sort by row and then by column.
+      std::vector<octave_idx_type> tmp (len);
+      accum_counting_sort (ii, m, nullptr, len, tmp.data ());
+      accum_counting_sort (jj, n, tmp.data (), len, perm);
+    }
+  else
+    accum_counting_sort (ii, m, nullptr, len, perm);
+
+  for (octave_idx_type k = 0; k < len; k++)
+    if (k == 0 || ii[perm[k]] != ii[perm[k-1]]
+        || (jj && jj[perm[k]] != jj[perm[k-1]]))
+      g.start.push_back (k);
+
+  g.start.push_back (len);
+
+  return g;
+}
+
+// Reduce the values of a group.  Groups are never empty.
+
+template <typename OP, typename R, typename T>
+static R
+accum_run (const octave_idx_type *perm, octave_idx_type beg,
+           octave_idx_type end, const T *v, octave_idx_type vstep)
+{
+  R a = OP::value (v[perm[beg] * vstep]);
+
+  for (octave_idx_type k = beg + 1; k < end; k++)
+    OP::apply (a, OP::value (v[perm[k] * vstep]));
+
+  return a;
+}
+
+// Build a sparse matrix from the reduced groups, leaving out the groups
+// that reduce to zero like the sparse function does.
+
+template <typename R, typename F>
+static Sparse<R>
+accum_sparse (const accum_groups& g, const octave_idx_type *ii,
+              const octave_idx_type *jj, octave_idx_type m,
+              octave_idx_type n, F reduce)
+{
+  octave_idx_type ng = g.start.size () - 1;
+
+  Array<R> val (dim_vector (ng, 1));
+  octave_idx_type nz = 0;
+
+  for (octave_idx_type k = 0; k < ng; k++)
+    {
+      val.xelem (k) = reduce (g.start[k], g.start[k+1]);
+      if (val.xelem (k) != R (0))
+        nz++;
+    }
+
+  Sparse<R> retval (m, n, nz);
+  octave_idx_type *cidx = retval.xcidx ();
+  std::fill_n (cidx, n + 1, 0);
+
+  nz = 0;
+  for (octave_idx_type k = 0; k < ng; k++)
+    if (val.xelem (k) != R (0))
+      {
+        octave_idx_type p = g.perm[g.start[k]];
+        retval.xridx (nz) = ii[p];
+        retval.xdata (nz) = val.xelem (k);
+        cidx[jj[p] + 1]++;
+        nz++;
+      }
+
+  std::partial_sum (cidx, cidx + n + 1, cidx);
+
+  return retval;
+}
+
+template <typename NDA>
+static octave_value
+do_accumarray_sparse (accum_op op, const accum_groups& g,
+                      const octave_idx_type *ii, const octave_idx_type *jj,
+                      octave_idx_type m, octave_idx_type n, const NDA& vals)
+{
+  typedef typename NDA::element_type T;
+
+  const octave_idx_type *perm = g.perm.data ();
+  const T *v = vals.data ();
+  octave_idx_type vstep = (vals.numel () == 1 ? 0 : 1);
+
+  switch (op)
+    {
+    case accum_op::sum:
+      return accum_sparse<T> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                    octave_idx_type e)
+      {
+        return accum_run<accum_add<T>, T> (perm, b, e, v, vstep);
+      });
+
+    case accum_op::prod:
+      return accum_sparse<T> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                    octave_idx_type e)
+      {
+        return accum_run<accum_mul<T>, T> (perm, b, e, v, vstep);
+      });
+
+    case accum_op::max:
+      return accum_sparse<T> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                    octave_idx_type e)
+      {
+        return accum_run<accum_max<T>, T> (perm, b, e, v, vstep);
+      });
+
+    case accum_op::min:
+      return accum_sparse<T> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                    octave_idx_type e)
+      {
+        return accum_run<accum_min<T>, T> (perm, b, e, v, vstep);
+      });
+
+    case accum_op::mean:
+      return accum_sparse<T> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                    octave_idx_type e)
+      {
+        return (accum_run<accum_add<T>, T> (perm, b, e, v, vstep)
+                / static_cast<T> (e - b));
+      });
+
+    case accum_op::count:
+      return accum_sparse<double> (g, ii, jj, m, n, [] (octave_idx_type b,
+                                                        octave_idx_type e)
+      {
+        return static_cast<double> (e - b);
+      });
+
+    case accum_op::any:
+      return accum_sparse<bool> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                       octave_idx_type e)
+      {
+        return accum_run<accum_or, bool> (perm, b, e, v, vstep);
+      });
+
+    case accum_op::all:
+      return accum_sparse<bool> (g, ii, jj, m, n, [=] (octave_idx_type b,
+                                                       octave_idx_type e)
+      {
+        return accum_run<accum_and, bool> (perm, b, e, v, vstep);
+      });
+    }
+
+  return octave_value ();
+}
+
+// Call FCN with the values as an array of the appropriate type.
+
+template <typename F>
+static octave_value
+accum_dispatch (const octave_value& vals, F fcn)
+{
+  switch (vals.builtin_type ())
+    {
+    case btyp_double:
+      return fcn (vals.array_value ());
+
+    case btyp_float:
+      return fcn (vals.float_array_value ());
+
+    case btyp_complex:
+      return fcn (vals.complex_array_value ());
+
+    case btyp_float_complex:
+      return fcn (vals.float_complex_array_value ());
+
+#define MAKE_INT_BRANCH(X)                      \
+    case btyp_ ## X:                            \
+      return fcn (vals.X ## _array_value ());
+
+      MAKE_INT_BRANCH (int8);
+      MAKE_INT_BRANCH (int16);
+      MAKE_INT_BRANCH (int32);
+      MAKE_INT_BRANCH (int64);
+      MAKE_INT_BRANCH (uint8);
+      MAKE_INT_BRANCH (uint16);
+      MAKE_INT_BRANCH (uint32);
+      MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+    case btyp_bool:
+      return fcn (vals.bool_array_value ());
+
+    default:
+      err_wrong_type_arg ("accumarray", vals);
+    }
+}
+
+// Extract the zero-based subscripts and the size of the result.  Dense
+// results take linear indices and sparse results take a column of row
+// subscripts and a column of column subscripts.  If SZ is empty, the
+// result is just large enough to hold the largest subscript.
+
+static void
+accum_subscripts (const octave_value& subs, const octave_value& sz,
+                  bool issparse, idx_vector& ii, idx_vector& jj,
+                  octave_idx_type& m, octave_idx_type& n)
+{
+  if (! subs.isnumeric ())
+    error ("accumarray: subscripts must be numeric");
+
+  Array<octave_idx_type> dims;
+  if (! sz.isempty ())
+    dims = sz.octave_idx_type_vector_value (true);
+
+  if (issparse)
+    {
+      Matrix s = subs.matrix_value ();
+
+      if (s.columns () != 2 || ! (dims.isempty () || dims.numel () == 2))
+        error ("accumarray: in the sparse case, needs 1 or 2 subscripts");
+
+      ii = idx_vector (s.column (0));
+      jj = idx_vector (s.column (1));
+
+      m = (dims.isempty () ? ii.extent (0) : dims(0));
+      n = (dims.isempty () ? jj.extent (0) : dims(1));
+
+      if (ii.extent (m) > m || jj.extent (n) > n)
+        error ("accumarray: index out of range");
+    }
+  else
+    {
+      ii = subs.index_vector ();
+
+      m = (dims.isempty () ? ii.extent (0) : dims(0));
+      n = 1;
+
+      if (ii.extent (m) > m)
+        error ("accumarray: index out of range");
+    }
+}
+
+DEFUN (__accumarray__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{A} =} __accumarray__ (@var{op}, @var{subs}, @var{vals}, @var{sz}, @var{fillval}, @var{issparse})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 6)
+    print_usage ();
+
+  accum_op op
+    = accum_op_value (args(0).xstring_value ("__accumarray__: OP must be a string"));
+  octave_value vals = args(2);
+  double fill = args(4).xdouble_value ("__accumarray__: FILLVAL must be a real scalar");
+  bool issparse = args(5).xbool_value ("__accumarray__: ISSPARSE must be logical");
+
+  if (issparse && fill != 0)
+    error ("accumarray: FILLVAL must be zero in the sparse case");
+
+  octave_value retval;
+
+  try
+    {
+      idx_vector ii, jj;
+      octave_idx_type m, n;
+
+      accum_subscripts (args(1), args(3), issparse, ii, jj, m, n);
+
+      octave_idx_type len = ii.length (m);
+
+      if (vals.numel () != 1 && vals.numel () != len)
+        error ("accumarray: dimensions mismatch");
+
+      if (issparse)
+        {
+          const octave_idx_type *pi = ii.raw ();
+          const octave_idx_type *pj = jj.raw ();
+
+          accum_groups g = accum_group (pi, m, pj, n, len);
+
+          if (vals.iscomplex ())
+            retval = do_accumarray_sparse (op, g, pi, pj, m, n,
+                                           vals.complex_array_value ());
+          else
+            retval = do_accumarray_sparse (op, g, pi, pj, m, n,
+                                           vals.array_value ());
+        }
+      else
+        {
+          const octave_idx_type *pi = ii.raw ();
+
+          retval = accum_dispatch (vals, [=] (const auto& va)
+          {
+            return do_accumarray (op, pi, len, va, m, fill);
+          });
+        }
+    }
+  catch (const index_exception& ie)
+    {
+      error ("__accumarray__: invalid index %s", ie.what ());
+    }
+
+  return retval;
+}
+
+DEFUN (__accumarray_groups__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{u}, @var{p}, @var{n}] =} __accumarray_groups__ (@var{subs}, @var{sz}, @var{issparse})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  bool issparse = args(2).xbool_value ("__accumarray_groups__: ISSPARSE must be logical");
+
+  octave_value_list retval;
+
+  try
+    {
+      idx_vector ii, jj;
+      octave_idx_type m, n;
+
+      accum_subscripts (args(0), args(1), issparse, ii, jj, m, n);
+
+      octave_idx_type len = ii.length (m);
+      const octave_idx_type *pi = ii.raw ();
+      const octave_idx_type *pj = (issparse ? jj.raw () : nullptr);
+
+      accum_groups g = accum_group (pi, m, pj, n, len);
+
+      octave_idx_type ng = g.start.size () - 1;
+
+      Matrix u (ng, issparse ? 2 : 1);
+      NDArray p (dim_vector (len, 1));
+      NDArray cnt (dim_vector (ng, 1));
+
+      for (octave_idx_type k = 0; k < ng; k++)
+        {
+          octave_idx_type q = g.perm[g.start[k]];
+          u(k, 0) = pi[q] + 1;
+          if (issparse)
+            u(k, 1) = pj[q] + 1;
+          cnt.xelem (k) = g.start[k+1] - g.start[k];
+        }
+
+      for (octave_idx_type k = 0; k < len; k++)
+        p.xelem (k) = g.perm[k] + 1;
+
+      retval = ovl (u, p, cnt);
+    }
+  catch (const index_exception& ie)
+    {
+      error ("__accumarray_groups__: invalid index %s", ie.what ());
+    }
+
+  return retval;
+}
+
+/*
+%!assert (__accumarray__ ("sum", [1; 2; 4; 2; 4], 101:105, [], 0, false),
+%!        [101; 206; 0; 208])
+%!assert (__accumarray__ ("prod", [1; 2; 4; 2; 4], 1:5, 5, 7, false),
+%!        [1; 8; 7; 15; 7])
+%!assert (__accumarray__ ("max", [1; 2; 2; 3], [1, NaN, 3, NaN], [], 0, false),
+%!        [1; 3; NaN])
+%!assert (__accumarray__ ("min", [2; 2; 3], int8 ([5, -3, 7]), 4, -1, false),
+%!        int8 ([-1; -3; 7; -1]))
+%!assert (__accumarray__ ("mean", [1; 3; 3], single ([2, 1, 4]), [], NaN, false),
+%!        single ([2; NaN; 2.5]))
+%!assert (__accumarray__ ("count", [1; 3; 3], [], [], 0, false), [1; 0; 2])
+%!assert (__accumarray__ ("any", [1; 3; 3], [0, 0, 2], [], 0, false),
+%!        [false; false; true])
+%!assert (__accumarray__ ("all", [1; 3; 3], [0, 1, 2], [], 0, false),
+%!        [false; false; true])
+%!assert (__accumarray__ ("all", [1; 3; 3], [0, 1, 2], [], -1, false),
+%!        [0; -1; 1])
+%!assert (__accumarray__ ("any", [1; 1; 2], [NaN, 0, NaN], [], 0, false),
+%!        [false; false])
+%!assert (__accumarray__ ("all", [1; 1; 2], [NaN, 0, NaN], [], 0, false),
+%!        [false; true])
+%!assert (__accumarray__ ("sum", [1; 2; 2], int8 ([100, 100, 100]), [], 0, false),
+%!        [100; 200])
+%!assert (__accumarray__ ("prod", [1; 1; 1], int8 ([100, 2, -1]), [], 0, false),
+%!        int8 (-127))
+
+%!test
+%! subs = randi (50, 1e5, 1);
+%! vals = rand (1e5, 1);
+%! A = __accumarray__ ("sum", subs, vals, [], 0, false);
+%! assert (A, accumarray (subs, vals, [], @(x) sum (x)), -1e-12);
+%! A = __accumarray__ ("max", subs, vals, 60, -1, false);
+%! assert (A, accumarray (subs, vals, [60, 1], @(x) max (x), -1));
+
+%!test
+%! A = __accumarray__ ("min", [1, 1; 2, 3; 1, 1; 3, 2], [4; 0; 2; 5],
+%!                     [3, 4], 0, true);
+%! assert (A, sparse ([1, 3], [1, 2], [2, 5], 3, 4));
+%! A = __accumarray__ ("any", [1, 1; 2, 3; 1, 1], [0; 0; 2], [], 0, true);
+%! assert (A, sparse (1, 1, true, 2, 3));
+
+%!test
+%! [u, p, n] = __accumarray_groups__ ([3; 1; 3; 2; 1], [], false);
+%! assert (u, [1; 2; 3]);
+%! assert (p, [2; 5; 4; 1; 3]);
+%! assert (n, [2; 1; 2]);
+%! [u, p, n] = __accumarray_groups__ ([1, 2; 2, 1; 1, 2; 1, 1], [], true);
+%! assert (u, [1, 1; 2, 1; 1, 2]);
+%! assert (p, [4; 2; 1; 3]);
+%! assert (n, [1; 1; 2]);
+
+%!error <index out of range> __accumarray__ ("sum", [1; 5], 1, 4, 0, false)
+%!error <dimensions mismatch> __accumarray__ ("sum", [1; 2], 1:3, [], 0, false)
+%!error <unknown reduction> __accumarray__ ("foo", 1, 1, [], 0, false)
+%!error <FILLVAL must be zero> __accumarray__ ("max", [1, 1], 1, [], 1, true)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,583 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "lo-mappers.h"
+#include "oct-thread-pool.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ov.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Sliding-window statistics for movfun.  Each column is extended by the
+// elements that the "Endpoints" option puts in place of the data outside
+// the array, so that every window has the same length W.  Every element
+// of the extended column is one of
+//
+//   * a value used by the statistic,
+//
+//   * absent: outside the array with "shrink", or a NaN that is omitted
+//     with "omitnan",
+//
+//   * a NaN that is passed to the statistic, which is what movfun does
+//     with NaN fill values and with the NaNs that "periodic" copies from
+//     the other end of the array when NaNs are included,
+//
+//   * a NaN of the array with "includenan", which makes the result NaN.
+//
+// The numbers of each kind in a window are updated as the window moves.
+// Sums, variances, maxima, and minima of the values are found by the van
+// Herk/Gil-Werman method: the column is split into blocks of W elements,
+// each window is the end of one block followed by the start of the next,
+// and the statistic of both parts is taken from prefix and suffix scans
+// of the blocks.  This needs O(1) work per element whatever W is, and
+// unlike a running sum never subtracts elements that leave the window.
+// Medians are kept by two balanced multisets holding the lower and upper
+// halves of the window.
+
+enum mov_kind : unsigned char
+{
+  mov_absent,
+  mov_value,
+  mov_nan_value,
+  mov_nan
+};
+
+enum mov_op
+{
+  mov_sum,
+  mov_mean,
+  mov_var,
+  mov_std,
+  mov_max,
+  mov_min,
+  mov_median
+};
+
+enum mov_bc
+{
+  mov_shrink,
+  mov_discard,
+  mov_fill,
+  mov_same,
+  mov_periodic
+};
+
+struct mov_options
+{
+  mov_op op;
+  mov_bc bc;
+  double fill_value;
+  bool omitnan;
+  double nanval;
+};
+
+// Count, mean, and sum of squared deviations of a set of values, which
+// can be merged exactly for the union of two sets (Chan et al.).
+
+template <typename T>
+struct mov_moments
+{
+  octave_idx_type n;
+  T mean;
+  T m2;
+};
+
+template <typename T>
+static inline mov_moments<T>
+mov_merge (const mov_moments<T>& a, const mov_moments<T>& b)
+{
+  if (a.n == 0)
+    return b;
+  if (b.n == 0)
+    return a;
+
+  octave_idx_type n = a.n + b.n;
+  T delta = b.mean - a.mean;
+  T fb = static_cast<T> (b.n) / n;
+
+  return { n, a.mean + delta * fb, a.m2 + b.m2 + delta * delta * a.n * fb };
+}
+
+// Fill PRE and SUF with the scans of blocks of W elements of the L values
+// produced by INIT, combined by COMB.  The statistic of the window that
+// starts at A is then window_stat (PRE, SUF, A, W, COMB).
+
+template <typename S, typename Init, typename Comb>
+static void
+mov_block_scan (octave_idx_type l, octave_idx_type w, S *pre, S *suf,
+                Init init, Comb comb)
+{
+  for (octave_idx_type b = 0; b < l; b += w)
+    {
+      octave_idx_type e = std::min (b + w, l);
+
+      pre[b] = init (b);
+      for (octave_idx_type i = b + 1; i < e; i++)
+        pre[i] = comb (pre[i-1], init (i));
+
+      suf[e-1] = init (e-1);
+      for (octave_idx_type i = e - 2; i >= b; i--)
+        suf[i] = comb (init (i), suf[i+1]);
+    }
+}
+
+template <typename S, typename Comb>
+static inline S
+window_stat (const S *pre, const S *suf, octave_idx_type a,
+             octave_idx_type w, Comb comb)
+{
+  return (a % w == 0) ? suf[a] : comb (suf[a], pre[a+w-1]);
+}
+
+// The values of a window, split into a lower and an upper half.
+
+template <typename T>
+class mov_median_set
+{
+public:
+
+  void insert (T v)
+  {
+    if (m_lo.empty () || v <= *m_lo.rbegin ())
+      m_lo.insert (v);
+    else
+      m_hi.insert (v);
+
+    balance ();
+  }
+
+  void erase (T v)
+  {
+    if (v <= *m_lo.rbegin ())
+      m_lo.erase (m_lo.find (v));
+    else
+      m_hi.erase (m_hi.find (v));
+
+    balance ();
+  }
+
+  T median () const
+  {
+    T m = *m_lo.rbegin ();
+
+    if (m_lo.size () > m_hi.size ())
+      return m;
+    else
+      return (m + *m_hi.begin ()) / 2;
+  }
+
+private:
+
+  void balance ()
+  {
+    if (m_lo.size () > m_hi.size () + 1)
+      {
+        auto p = std::prev (m_lo.end ());
+        m_hi.insert (*p);
+        m_lo.erase (p);
+      }
+    else if (m_hi.size () > m_lo.size ())
+      {
+        auto p = m_hi.begin ();
+        m_lo.insert (*p);
+        m_hi.erase (p);
+      }
+  }
+
+  std::multiset<T> m_lo;
+  std::multiset<T> m_hi;
+};
+
+// Compute the statistic for each window of the column X of length N and
+// store the M results in Y.
+
+template <typename T>
+static void
+mov_column (const mov_options& opts, const T *x, octave_idx_type n,
+            octave_idx_type nb, octave_idx_type na, T *y, octave_idx_type m)
+{
+  const T nan = numeric_limits<T>::NaN ();
+
+  octave_idx_type w = nb + na + 1;
+
+  bool all_nan = true;
+  for (octave_idx_type i = 0; i < n && all_nan; i++)
+    all_nan = math::isnan (x[i]);
+
+  if (all_nan)
+    {
+      T val = ((opts.omitnan && ! math::isnan (opts.nanval))
+               ? static_cast<T> (opts.nanval) : nan);
+      std::fill (y, y + m, val);
+      return;
+    }
+
+  // Build the extended column.  With "discard", only the windows that
+  // lie inside the array are computed and nothing is added.
+
+  octave_idx_type pad = (opts.bc == mov_discard ? 0 : nb);
+  octave_idx_type l = (opts.bc == mov_discard ? n : nb + n + na);
+
+  std::vector<T> ev (l);
+  std::vector<unsigned char> kind (l);
+
+  for (octave_idx_type e = 0; e < l; e++)
+    {
+      octave_idx_type j = e - pad;
+      T v;
+      bool inside = (j >= 0 && j < n);
+
+      if (inside)
+        v = x[j];
+      else if (opts.bc == mov_fill)
+        v = static_cast<T> (opts.fill_value);
+      else if (opts.bc == mov_same)
+        v = x[j < 0 ? 0 : n-1];
+      else if (opts.bc == mov_periodic)
+        v = x[((j % n) + n) % n];
+      else
+        {
+          ev[e] = 0;
+          kind[e] = mov_absent;
+          continue;
+        }
+
+      ev[e] = v;
+
+      if (! math::isnan (v))
+        kind[e] = mov_value;
+      else if (opts.bc == mov_fill && ! inside)
+        kind[e] = mov_nan_value;
+      else if (opts.omitnan)
+        kind[e] = mov_absent;
+      else
+        kind[e] = (inside ? mov_nan : mov_nan_value);
+    }
+
+  // The statistic of the values of the window starting at A, given that
+  // it has NV of them.
+
+  std::vector<T> pre, suf;
+  std::vector<mov_moments<T>> mpre, msuf;
+  mov_median_set<T> mset;
+
+  auto value = [&] (octave_idx_type e, T identity)
+  {
+    return kind[e] == mov_value ? ev[e] : identity;
+  };
+
+  auto sum_comb = [] (T a, T b) { return a + b; };
+  auto max_comb = [] (T a, T b) { return a < b ? b : a; };
+  auto min_comb = [] (T a, T b) { return b < a ? b : a; };
+
+  switch (opts.op)
+    {
+    case mov_sum:
+    case mov_mean:
+      pre.resize (l);
+      suf.resize (l);
+      mov_block_scan (l, w, pre.data (), suf.data (),
+                      [&] (octave_idx_type e) { return value (e, 0); },
+                      sum_comb);
+      break;
+
+    case mov_max:
+    case mov_min:
+      {
+        T identity = (opts.op == mov_max ? -numeric_limits<T>::Inf ()
+                                         : numeric_limits<T>::Inf ());
+        pre.resize (l);
+        suf.resize (l);
+        if (opts.op == mov_max)
+          mov_block_scan (l, w, pre.data (), suf.data (),
+                          [&] (octave_idx_type e) { return value (e, identity); },
+                          max_comb);
+        else
+          mov_block_scan (l, w, pre.data (), suf.data (),
+                          [&] (octave_idx_type e) { return value (e, identity); },
+                          min_comb);
+      }
+      break;
+
+    case mov_var:
+    case mov_std:
+      mpre.resize (l);
+      msuf.resize (l);
+      mov_block_scan (l, w, mpre.data (), msuf.data (),
+                      [&] (octave_idx_type e)
+                      {
+                        return (kind[e] == mov_value
+                                ? mov_moments<T> { 1, ev[e], 0 }
+                                : mov_moments<T> { 0, 0, 0 });
+                      },
+                      mov_merge<T>);
+      break;
+
+    case mov_median:
+      break;
+    }
+
+  // Slide the window over the extended column, keeping the number of
+  // elements of each kind.
+
+  octave_idx_type count[4] = { 0, 0, 0, 0 };
+
+  for (octave_idx_type e = 0; e < std::min (w - 1, l); e++)
+    {
+      count[kind[e]]++;
+      if (opts.op == mov_median && kind[e] == mov_value)
+        mset.insert (ev[e]);
+    }
+
+  for (octave_idx_type a = 0; a < m; a++)
+    {
+      octave_idx_type e = a + w - 1;
+
+      count[kind[e]]++;
+      if (opts.op == mov_median && kind[e] == mov_value)
+        mset.insert (ev[e]);
+
+      octave_idx_type nv = count[mov_value];
+      octave_idx_type nn = count[mov_nan_value];
+
+      T r;
+
+      if (count[mov_nan] > 0)
+        r = nan;
+      else if (nv + nn == 0)
+        r = static_cast<T> (opts.nanval);
+      else if (opts.op == mov_max || opts.op == mov_min)
+        r = (nv == 0 ? nan
+                     : (opts.op == mov_max
+                        ? window_stat (pre.data (), suf.data (), a, w, max_comb)
+                        : window_stat (pre.data (), suf.data (), a, w,
+                                       min_comb)));
+      else if (nn > 0)
+        r = nan;
+      else
+        {
+          switch (opts.op)
+            {
+            case mov_sum:
+              r = window_stat (pre.data (), suf.data (), a, w, sum_comb);
+              break;
+
+            case mov_mean:
+              r = window_stat (pre.data (), suf.data (), a, w, sum_comb) / nv;
+              break;
+
+            case mov_var:
+            case mov_std:
+              {
+                mov_moments<T> s = window_stat (mpre.data (), msuf.data (),
+                                                a, w, mov_merge<T>);
+                r = (nv == 1 ? 0 : s.m2 / (nv - 1));
+                if (opts.op == mov_std)
+                  r = std::sqrt (r);
+              }
+              break;
+
+            default:
+              r = mset.median ();
+              break;
+            }
+        }
+
+      y[a] = r;
+
+      count[kind[a]]--;
+      if (opts.op == mov_median && kind[a] == mov_value)
+        mset.erase (ev[a]);
+    }
+}
+
+template <typename NDA>
+static NDA
+do_movfun (const mov_options& opts, const NDA& x, octave_idx_type nb,
+           octave_idx_type na)
+{
+  typedef typename NDA::element_type T;
+
+  octave_idx_type n = x.rows ();
+  octave_idx_type nc = x.columns ();
+
+  octave_idx_type m = n;
+  if (opts.bc == mov_discard)
+    m = std::max (n - nb - na, static_cast<octave_idx_type> (0));
+
+  NDA y (dim_vector (m, nc));
+
+  const T *px = x.data ();
+  T *py = y.rwdata ();
+
+  if (n == 0 || m == 0)
+    return y;
+
+  auto fcn = [=, &opts] (octave_idx_type jbeg, octave_idx_type jend)
+  {
+    for (octave_idx_type j = jbeg; j < jend; j++)
+      mov_column (opts, px + j*n, n, nb, na, py + j*m, m);
+  };
+
+  if (nc > 1 && thread_pool::use_threads (nc, n + nb + na))
+    thread_pool::parallel_for (nc, n + nb + na, fcn);
+  else
+    fcn (0, nc);
+
+  return y;
+}
+
+DEFUN (__movfun__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{y} =} __movfun__ (@var{op}, @var{x}, @var{nb}, @var{na}, @var{endpoints}, @var{omitnan}, @var{nanval})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 7)
+    print_usage ();
+
+  std::string op = args(0).xstring_value ("__movfun__: OP must be a string");
+
+  mov_options opts;
+
+  if (op == "sum")
+    opts.op = mov_sum;
+  else if (op == "mean")
+    opts.op = mov_mean;
+  else if (op == "var")
+    opts.op = mov_var;
+  else if (op == "std")
+    opts.op = mov_std;
+  else if (op == "max")
+    opts.op = mov_max;
+  else if (op == "min")
+    opts.op = mov_min;
+  else if (op == "median")
+    opts.op = mov_median;
+  else
+    error ("__movfun__: unknown OP '%s'", op.c_str ());
+
+  octave_value x = args(1);
+
+  if (! x.isfloat () || x.iscomplex () || x.issparse () || x.ndims () > 2)
+    error ("__movfun__: X must be a real floating point matrix");
+
+  double nbval = args(2).xdouble_value ("__movfun__: NB must be a number");
+  double naval = args(3).xdouble_value ("__movfun__: NA must be a number");
+
+  if (nbval < 0 || naval < 0 || nbval != math::fix (nbval)
+      || naval != math::fix (naval))
+    error ("__movfun__: NB and NA must be non-negative integers");
+
+  octave_idx_type nb = static_cast<octave_idx_type> (nbval);
+  octave_idx_type na = static_cast<octave_idx_type> (naval);
+
+  opts.fill_value = 0;
+
+  if (args(4).is_string ())
+    {
+      std::string bc = args(4).string_value ();
+
+      if (bc == "shrink")
+        opts.bc = mov_shrink;
+      else if (bc == "discard")
+        opts.bc = mov_discard;
+      else if (bc == "same")
+        opts.bc = mov_same;
+      else if (bc == "periodic")
+        opts.bc = mov_periodic;
+      else
+        error ("__movfun__: unknown ENDPOINTS '%s'", bc.c_str ());
+    }
+  else
+    {
+      opts.bc = mov_fill;
+      opts.fill_value
+        = args(4).xdouble_value ("__movfun__: ENDPOINTS must be a string or a real scalar");
+    }
+
+  opts.omitnan
+    = args(5).xbool_value ("__movfun__: OMITNAN must be a logical value");
+  opts.nanval
+    = args(6).xdouble_value ("__movfun__: NANVAL must be a real scalar");
+
+  if (x.is_single_type ())
+    return ovl (do_movfun (opts, x.float_array_value (), nb, na));
+  else
+    return ovl (do_movfun (opts, x.array_value (), nb, na));
+}
+
+/*
+%!test
+%! x = [4; 8; 6; -1; -2; -3; -1; 3; 4; 5];
+%! assert (__movfun__ ("sum", x, 1, 1, "shrink", false, NaN),
+%!         [12; 18; 13; 3; -6; -6; -1; 6; 12; 9]);
+%! assert (__movfun__ ("max", x, 1, 1, "discard", false, NaN),
+%!         [8; 8; 6; -1; -1; 3; 4; 5]);
+%! assert (__movfun__ ("median", x, 2, 1, 0, false, NaN),
+%!         [2; 5; 5; 2.5; -1.5; -1.5; -1.5; 1; 3.5; 3.5]);
+%! assert (__movfun__ ("mean", single (x), 0, 2, "same", false, NaN),
+%!         single ([6; 13/3; 1; -2; -2; -1/3; 2; 4; 14/3; 5]));
+
+%!test
+%! x = [1; NaN; 3; 4; NaN; NaN; NaN; 8];
+%! assert (__movfun__ ("sum", x, 1, 1, "shrink", false, NaN),
+%!         [NaN; NaN; NaN; NaN; NaN; NaN; NaN; NaN]);
+%! assert (__movfun__ ("sum", x, 1, 1, "shrink", true, 0),
+%!         [1; 4; 7; 7; 4; 0; 8; 8]);
+%! assert (__movfun__ ("max", x, 1, 1, NaN, true, NaN),
+%!         [1; 3; 4; 4; 4; NaN; 8; 8]);
+%! assert (__movfun__ ("var", x, 1, 1, "periodic", true, NaN),
+%!         [24.5; 2; 0.5; 0.5; 0; NaN; 0; 24.5]);
+
+%!test
+%! x = NaN (5, 2);
+%! assert (__movfun__ ("sum", x, 1, 1, 0, true, 0), zeros (5, 2));
+%! assert (__movfun__ ("max", x, 1, 1, 0, true, NaN), NaN (5, 2));
+%! assert (size (__movfun__ ("sum", rand (3, 2), 2, 2, "discard", false, 0)),
+%!         [0, 2]);
+
+%!error <unknown OP> __movfun__ ("prod", 1, 1, 1, "shrink", false, NaN)
+%!error <real floating point> __movfun__ ("sum", int8 (1), 1, 1, "shrink", false, NaN)
+%!error <unknown ENDPOINTS> __movfun__ ("sum", 1, 1, 1, "wrap", false, NaN)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,911 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Array.h"
+#include "idx-vector.h"
+#include "lo-mappers.h"
+#include "oct-inttypes.h"
+
+#include "Cell.h"
+#include "defun.h"
+#include "error.h"
+#include "ov.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Set operations group equal elements, or equal rows, of an array.  Two
+// elements are equal if operator == says so, so NaN is never equal to
+// anything and -0 is equal to 0.  There are three ways to find the
+// groups:
+//
+//   * Values that are integers in a range not much larger than the
+//     number of elements index a table directly.
+//
+//   * Otherwise, if the groups are wanted in the order of their first
+//     occurrence, or to look up elements of one set in another, a hash
+//     table of group numbers is used.
+//
+//   * If the groups are wanted in sorted order, the elements are sorted
+//     and runs of equal elements become groups.
+
+// Mix the bits of a 64-bit value so that nearby values hash to
+// unrelated table slots.
+
+static inline uint64_t
+set_mix (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Bits of a value such that equal values have equal bits.
+
+static inline uint64_t
+set_bits (double x)
+{
+  if (x == 0)
+    x = 0;
+
+  uint64_t u;
+  std::memcpy (&u, &x, sizeof (u));
+  return u;
+}
+
+static inline uint64_t
+set_bits (float x)
+{
+  if (x == 0)
+    x = 0;
+
+  uint32_t u;
+  std::memcpy (&u, &x, sizeof (u));
+  return u;
+}
+
+static inline uint64_t
+set_bits (bool x)
+{
+  return x;
+}
+
+static inline uint64_t
+set_bits (char x)
+{
+  return static_cast<unsigned char> (x);
+}
+
+static inline uint64_t
+set_bits (const std::string& x)
+{
+  return std::hash<std::string> () (x);
+}
+
+template <typename T>
+static inline uint64_t
+set_bits (const octave_int<T>& x)
+{
+  return static_cast<uint64_t> (x.value ());
+}
+
+template <typename T>
+static inline uint64_t
+set_bits (const std::complex<T>& x)
+{
+  return set_mix (set_bits (x.real ())) ^ set_bits (x.imag ());
+}
+
+template <typename T>
+static inline bool
+set_isnan (const T&)
+{
+  return false;
+}
+
+static inline bool
+set_isnan (double x)
+{
+  return math::isnan (x);
+}
+
+static inline bool
+set_isnan (float x)
+{
+  return math::isnan (x);
+}
+
+template <typename T>
+static inline bool
+set_isnan (const std::complex<T>& x)
+{
+  return math::isnan (x);
+}
+
+// If X is an integer that fits in 64 bits, store it in VAL and return
+// true.  The order of the integers is the order of the values.
+
+template <typename T>
+static inline bool
+set_int_value (const T&, int64_t&)
+{
+  return false;
+}
+
+static inline bool
+set_int_value (double x, int64_t& val)
+{
+  // Also false for NaN.
+  if (! (std::abs (x) <= 9007199254740992.0) || x != std::trunc (x))
+    return false;
+
+  val = static_cast<int64_t> (x);
+  return true;
+}
+
+static inline bool
+set_int_value (float x, int64_t& val)
+{
+  return set_int_value (static_cast<double> (x), val);
+}
+
+static inline bool
+set_int_value (bool x, int64_t& val)
+{
+  val = x;
+  return true;
+}
+
+static inline bool
+set_int_value (char x, int64_t& val)
+{
+  val = x;
+  return true;
+}
+
+template <typename T>
+static inline bool
+set_int_value (const octave_int<T>& x, int64_t& val)
+{
+  T v = x.value ();
+  if (v > std::numeric_limits<int64_t>::max ())
+    return false;
+
+  val = static_cast<int64_t> (v);
+  return true;
+}
+
+// Access to the elements of an array as members of a set.
+
+template <typename T>
+class set_elements
+{
+public:
+
+  set_elements (const T *data, octave_idx_type n)
+    : m_data (data), m_n (n)
+  { }
+
+  octave_idx_type numel () const { return m_n; }
+
+  uint64_t hash (octave_idx_type k) const
+  {
+    return set_mix (set_bits (m_data[k]));
+  }
+
+  bool isnan (octave_idx_type k) const { return set_isnan (m_data[k]); }
+
+  bool equal (octave_idx_type k, const set_elements& b,
+              octave_idx_type kb) const
+  {
+    return m_data[k] == b.m_data[kb];
+  }
+
+  bool int_value (octave_idx_type k, int64_t& val) const
+  {
+    return set_int_value (m_data[k], val);
+  }
+
+private:
+
+  const T *m_data;
+  octave_idx_type m_n;
+};
+
+// Access to the rows of an NR by NC matrix as members of a set.  A row
+// with a NaN is not equal to any row.
+
+template <typename T>
+class set_rows
+{
+public:
+
+  set_rows (const T *data, octave_idx_type nr, octave_idx_type nc)
+    : m_data (data), m_nr (nr), m_nc (nc)
+  { }
+
+  octave_idx_type numel () const { return m_nr; }
+
+  uint64_t hash (octave_idx_type k) const
+  {
+    uint64_t h = 0;
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      h = set_mix (h ^ set_bits (m_data[k + j*m_nr]));
+    return h;
+  }
+
+  bool isnan (octave_idx_type k) const
+  {
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      if (set_isnan (m_data[k + j*m_nr]))
+        return true;
+    return false;
+  }
+
+  bool equal (octave_idx_type k, const set_rows& b, octave_idx_type kb) const
+  {
+    for (octave_idx_type j = 0; j < m_nc; j++)
+      if (! (m_data[k + j*m_nr] == b.m_data[kb + j*b.m_nr]))
+        return false;
+    return true;
+  }
+
+  bool int_value (octave_idx_type, int64_t&) const { return false; }
+
+private:
+
+  const T *m_data;
+  octave_idx_type m_nr;
+  octave_idx_type m_nc;
+};
+
+// Open addressing hash table of group numbers.  The table does not
+// store keys.  Slots are compared through the element that represents
+// each group.
+
+class set_hash_table
+{
+public:
+
+  set_hash_table (octave_idx_type n)
+  {
+    std::size_t cap = 16;
+    while (cap < 2 * static_cast<std::size_t> (n))
+      cap *= 2;
+
+    m_slots.assign (cap, -1);
+    m_mask = cap - 1;
+  }
+
+  // Return the group of the element with hash H that is equal to the
+  // representative of a group according to EQ, or insert and return
+  // NEW_GROUP if there is none.
+  template <typename EQ>
+  octave_idx_type find_or_insert (uint64_t h, EQ eq, octave_idx_type new_group)
+  {
+    for (std::size_t k = h & m_mask; ; k = (k + 1) & m_mask)
+      {
+        octave_idx_type g = m_slots[k];
+        if (g < 0)
+          {
+            m_slots[k] = new_group;
+            return new_group;
+          }
+        if (eq (g))
+          return g;
+      }
+  }
+
+  // Likewise, but return -1 if there is no such group.
+  template <typename EQ>
+  octave_idx_type find (uint64_t h, EQ eq) const
+  {
+    for (std::size_t k = h & m_mask; ; k = (k + 1) & m_mask)
+      {
+        octave_idx_type g = m_slots[k];
+        if (g < 0 || eq (g))
+          return g;
+      }
+  }
+
+private:
+
+  std::vector<octave_idx_type> m_slots;
+  std::size_t m_mask;
+};
+
+// Groups of equal members of a set, numbered in output order.
+
+struct set_groups
+{
+public:
+
+  // Index of the first and last member of each group.
+  std::vector<octave_idx_type> first;
+  std::vector<octave_idx_type> last;
+
+  // Group of each member.
+  std::vector<octave_idx_type> group;
+
+  octave_idx_type add (octave_idx_type k)
+  {
+    first.push_back (k);
+    last.push_back (k);
+    return first.size () - 1;
+  }
+};
+
+// If all members of X are integers in a small range, store the smallest
+// in VMIN and the size of the range in RANGE and return true.
+
+template <typename ACC>
+static bool
+set_int_range (const ACC& x, octave_idx_type max_range, int64_t& vmin,
+               octave_idx_type& range)
+{
+  octave_idx_type n = x.numel ();
+
+  if (n == 0)
+    return false;
+
+  int64_t lo, hi;
+  if (! x.int_value (0, lo))
+    return false;
+  hi = lo;
+
+  for (octave_idx_type k = 1; k < n; k++)
+    {
+      int64_t v;
+      if (! x.int_value (k, v))
+        return false;
+      lo = std::min (lo, v);
+      hi = std::max (hi, v);
+    }
+
+  // Compare without overflow for ranges that span most of int64.
+  if (static_cast<uint64_t> (hi) - static_cast<uint64_t> (lo)
+      >= static_cast<uint64_t> (max_range))
+    return false;
+
+  vmin = lo;
+  range = hi - lo + 1;
+  return true;
+}
+
+static octave_idx_type
+set_max_table_size (octave_idx_type n)
+{
+  return std::max (2 * n, static_cast<octave_idx_type> (4096));
+}
+
+// Find the groups of X directly by value.  If SORTED, number them in
+// ascending order of value, otherwise in order of first occurrence.
+
+template <typename ACC>
+static void
+set_group_by_table (const ACC& x, int64_t vmin, octave_idx_type range,
+                    bool sorted, set_groups& grp)
+{
+  octave_idx_type n = x.numel ();
+
+  std::vector<octave_idx_type> table (range, -1);
+
+  grp.group.resize (n);
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      int64_t v;
+      x.int_value (k, v);
+
+      octave_idx_type& g = table[v - vmin];
+      if (g < 0)
+        g = grp.add (k);
+      else
+        grp.last[g] = k;
+
+      grp.group[k] = g;
+    }
+
+  if (sorted)
+    {
+      octave_idx_type ng = grp.first.size ();
+
+      std::vector<octave_idx_type> first (ng), last (ng);
+      octave_idx_type m = 0;
+      for (octave_idx_type v = 0; v < range; v++)
+        {
+          octave_idx_type g = table[v];
+          if (g >= 0)
+            {
+              first[m] = grp.first[g];
+              last[m] = grp.last[g];
+              table[v] = m++;
+            }
+        }
+
+      for (octave_idx_type k = 0; k < n; k++)
+        {
+          int64_t v;
+          x.int_value (k, v);
+          grp.group[k] = table[v - vmin];
+        }
+
+      grp.first.swap (first);
+      grp.last.swap (last);
+    }
+}
+
+// Find the groups of X with a hash table, in order of first occurrence.
+
+template <typename ACC>
+static void
+set_group_by_hash (const ACC& x, set_groups& grp)
+{
+  octave_idx_type n = x.numel ();
+
+  set_hash_table table (n);
+
+  grp.group.resize (n);
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      octave_idx_type g;
+
+      if (x.isnan (k))
+        g = grp.add (k);
+      else
+        {
+          octave_idx_type new_g = grp.first.size ();
+
+          g = table.find_or_insert
+                (x.hash (k),
+                 [&] (octave_idx_type h) { return x.equal (k, x, grp.first[h]); },
+                 new_g);
+
+          if (g == new_g)
+            grp.add (k);
+          else
+            grp.last[g] = k;
+        }
+
+      grp.group[k] = g;
+    }
+}
+
+// Find the groups of X from the permutation PERM that sorts it.
+
+template <typename ACC>
+static void
+set_group_by_sort (const ACC& x, const octave_idx_type *perm,
+                   set_groups& grp)
+{
+  octave_idx_type n = x.numel ();
+
+  grp.group.resize (n);
+
+  octave_idx_type g = -1;
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      octave_idx_type p = perm[k];
+
+      // Sorting is stable, so the first member of a run has the lowest
+      // index and the last member has the highest.
+      if (k == 0 || ! x.equal (perm[k-1], x, p))
+        g = grp.add (p);
+      else
+        grp.last[g] = p;
+
+      grp.group[p] = g;
+    }
+}
+
+// Find the index in S of the last member equal to each member of A, or
+// -1 if there is none.
+
+template <typename ACC>
+static void
+set_lookup (const ACC& a, const ACC& s, octave_idx_type *loc)
+{
+  octave_idx_type na = a.numel ();
+  octave_idx_type ns = s.numel ();
+
+  int64_t vmin;
+  octave_idx_type range;
+
+  if (ns <= 8)
+    {
+      for (octave_idx_type k = 0; k < na; k++)
+        {
+          loc[k] = -1;
+          for (octave_idx_type l = ns - 1; l >= 0; l--)
+            if (a.equal (k, s, l))
+              {
+                loc[k] = l;
+                break;
+              }
+        }
+    }
+  else if (set_int_range (s, set_max_table_size (ns), vmin, range))
+    {
+      std::vector<octave_idx_type> table (range, -1);
+
+      for (octave_idx_type l = 0; l < ns; l++)
+        {
+          int64_t v;
+          s.int_value (l, v);
+          table[v - vmin] = l;
+        }
+
+      for (octave_idx_type k = 0; k < na; k++)
+        {
+          int64_t v;
+          if (a.int_value (k, v) && v >= vmin && v - vmin < range)
+            loc[k] = table[v - vmin];
+          else
+            loc[k] = -1;
+        }
+    }
+  else
+    {
+      set_hash_table table (ns);
+
+      // Groups are represented by their last member.
+      std::vector<octave_idx_type> last;
+
+      for (octave_idx_type l = 0; l < ns; l++)
+        {
+          if (s.isnan (l))
+            continue;
+
+          octave_idx_type new_g = last.size ();
+
+          octave_idx_type g
+            = table.find_or_insert
+                (s.hash (l),
+                 [&] (octave_idx_type h) { return s.equal (l, s, last[h]); },
+                 new_g);
+
+          if (g == new_g)
+            last.push_back (l);
+          else
+            last[g] = l;
+        }
+
+      for (octave_idx_type k = 0; k < na; k++)
+        {
+          octave_idx_type g = -1;
+
+          if (! a.isnan (k))
+            g = table.find (a.hash (k),
+                            [&] (octave_idx_type h)
+                            { return a.equal (k, s, last[h]); });
+
+          loc[k] = (g < 0 ? -1 : last[g]);
+        }
+    }
+}
+
+// Call FCN with the contents of X as an array of the appropriate type.
+// If CPLX is true, real floating point values are converted to complex.
+
+template <typename F>
+static octave_value_list
+set_dispatch (const char *who, const octave_value& x, bool cplx, F fcn)
+{
+  if (x.iscellstr ())
+    return fcn (x.cellstr_value ());
+  else if (x.issparse ())
+    error ("%s: sparse arrays are not supported", who);
+  else if (x.is_double_type ())
+    {
+      if (cplx)
+        return fcn (x.complex_array_value ());
+      else
+        return fcn (x.array_value ());
+    }
+  else if (x.is_single_type ())
+    {
+      if (cplx)
+        return fcn (x.float_complex_array_value ());
+      else
+        return fcn (x.float_array_value ());
+    }
+  else if (x.is_int8_type ())
+    return fcn (x.int8_array_value ());
+  else if (x.is_int16_type ())
+    return fcn (x.int16_array_value ());
+  else if (x.is_int32_type ())
+    return fcn (x.int32_array_value ());
+  else if (x.is_int64_type ())
+    return fcn (x.int64_array_value ());
+  else if (x.is_uint8_type ())
+    return fcn (x.uint8_array_value ());
+  else if (x.is_uint16_type ())
+    return fcn (x.uint16_array_value ());
+  else if (x.is_uint32_type ())
+    return fcn (x.uint32_array_value ());
+  else if (x.is_uint64_type ())
+    return fcn (x.uint64_array_value ());
+  else if (x.islogical ())
+    return fcn (x.bool_array_value ());
+  else if (x.is_string ())
+    return fcn (x.char_array_value ());
+  else
+    error ("%s: X must be an array or cell array of strings", who);
+}
+
+// Extract a value of the same type as LIKE from X.
+
+template <typename NDA>
+static NDA
+set_extract (const octave_value& x, const NDA&)
+{
+  if constexpr (std::is_same<NDA, Array<std::string>>::value)
+    return x.cellstr_value ();
+  else
+    return octave_value_extract<NDA> (x);
+}
+
+template <typename NDA>
+static octave_value
+set_value (const Array<typename NDA::element_type>& y, const octave_value& x)
+{
+  if constexpr (std::is_same<NDA, Array<std::string>>::value)
+    return Cell (y);
+  else if constexpr (std::is_same<NDA, charNDArray>::value)
+    return octave_value (charNDArray (y), x.is_sq_string () ? '\'' : '"');
+  else
+    return NDA (y);
+}
+
+static Array<octave_idx_type>
+set_index_array (const std::vector<octave_idx_type>& idx)
+{
+  Array<octave_idx_type> retval (dim_vector (idx.size (), 1));
+
+  std::copy (idx.begin (), idx.end (), retval.rwdata ());
+
+  return retval;
+}
+
+static NDArray
+set_index_value (const std::vector<octave_idx_type>& idx)
+{
+  NDArray retval (dim_vector (idx.size (), 1));
+
+  double *p = retval.rwdata ();
+  for (std::size_t k = 0; k < idx.size (); k++)
+    p[k] = idx[k] + 1;
+
+  return retval;
+}
+
+template <typename NDA>
+static octave_value_list
+do_unique (const NDA& x, const octave_value& xval, bool by_rows, bool stable,
+           bool last, int nargout)
+{
+  typedef typename NDA::element_type T;
+
+  set_groups grp;
+
+  Array<T> xc;
+
+  if (by_rows)
+    {
+      xc = x;
+
+      set_rows<T> acc (xc.data (), xc.rows (), xc.columns ());
+
+      if (stable)
+        set_group_by_hash (acc, grp);
+      else
+        {
+          Array<octave_idx_type> perm = xc.sort_rows_idx (ASCENDING);
+          set_group_by_sort (acc, perm.data (), grp);
+        }
+    }
+  else
+    {
+      octave_idx_type n = x.numel ();
+
+      xc = x.reshape (dim_vector (n, 1));
+
+      set_elements<T> acc (xc.data (), n);
+
+      int64_t vmin;
+      octave_idx_type range;
+
+      if (set_int_range (acc, set_max_table_size (n), vmin, range))
+        set_group_by_table (acc, vmin, range, ! stable, grp);
+      else if (stable)
+        set_group_by_hash (acc, grp);
+      else
+        {
+          Array<octave_idx_type> perm;
+          xc.sort (perm, 0, ASCENDING);
+          set_group_by_sort (acc, perm.data (), grp);
+        }
+    }
+
+  // The values are taken from the first member of each group if the
+  // order is stable and from the last one otherwise, as the former
+  // m-file implementation of unique did.  Only the sign of zero
+  // depends on this.
+
+  idx_vector rep (set_index_array (stable ? grp.first : grp.last));
+
+  Array<T> y;
+  if (by_rows)
+    y = xc.index (rep, idx_vector::colon);
+  else
+    y = xc.index (rep);
+
+  octave_value_list retval (nargout > 1 ? nargout : 1);
+
+  retval(0) = set_value<NDA> (y, xval);
+
+  if (nargout > 1)
+    retval(1) = set_index_value (last && ! stable ? grp.last : grp.first);
+
+  if (nargout > 2)
+    retval(2) = set_index_value (grp.group);
+
+  return retval;
+}
+
+DEFUN (__unique__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{y}, @var{i}, @var{j}] =} __unique__ (@var{x}, @var{by_rows}, @var{stable}, @var{last})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 4)
+    print_usage ();
+
+  octave_value x = args(0);
+  bool by_rows = args(1).xbool_value ("__unique__: BY_ROWS must be logical");
+  bool stable = args(2).xbool_value ("__unique__: STABLE must be logical");
+  bool last = args(3).xbool_value ("__unique__: LAST must be logical");
+
+  if (by_rows && (x.ndims () > 2 || x.iscell ()))
+    error ("__unique__: X must be a 2-D matrix to use \"rows\"");
+
+  return set_dispatch ("__unique__", x, x.iscomplex (),
+                       [&] (const auto& xa)
+  {
+    return do_unique (xa, x, by_rows, stable, last, nargout);
+  });
+}
+
+template <typename NDA>
+static octave_value_list
+do_ismember (const NDA& a, const NDA& s, bool by_rows)
+{
+  typedef typename NDA::element_type T;
+
+  dim_vector dv = (by_rows ? dim_vector (a.rows (), 1) : a.dims ());
+
+  std::vector<octave_idx_type> loc (dv.numel ());
+
+  if (by_rows)
+    set_lookup (set_rows<T> (a.data (), a.rows (), a.columns ()),
+                set_rows<T> (s.data (), s.rows (), s.columns ()),
+                loc.data ());
+  else
+    set_lookup (set_elements<T> (a.data (), a.numel ()),
+                set_elements<T> (s.data (), s.numel ()),
+                loc.data ());
+
+  boolNDArray tf (dv);
+  NDArray s_idx (dv);
+
+  for (octave_idx_type k = 0; k < dv.numel (); k++)
+    {
+      tf.xelem (k) = loc[k] >= 0;
+      s_idx.xelem (k) = loc[k] + 1;
+    }
+
+  return ovl (tf, s_idx);
+}
+
+DEFUN (__ismember__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{tf}, @var{s_idx}] =} __ismember__ (@var{a}, @var{s}, @var{by_rows})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value a = args(0);
+  octave_value s = args(1);
+  bool by_rows = args(2).xbool_value ("__ismember__: BY_ROWS must be logical");
+
+  if (a.class_name () != s.class_name () || a.iscellstr () != s.iscellstr ())
+    error ("__ismember__: A and S must have the same class");
+
+  if (by_rows && (a.ndims () > 2 || s.ndims () > 2 || a.iscell ()
+                  || a.columns () != s.columns ()))
+    error ("__ismember__: A and S must be 2-D matrices with the same number of columns to use \"rows\"");
+
+  return set_dispatch ("__ismember__", a, a.iscomplex () || s.iscomplex (),
+                       [&] (const auto& aa)
+  {
+    return do_ismember (aa, set_extract (s, aa), by_rows);
+  });
+}
+
+/*
+%!test
+%! [y, i, j] = __unique__ ([3; 1; NaN; 1; 2; NaN; 3], false, false, false);
+%! assert (y, [1; 2; 3; NaN; NaN]);
+%! assert (i, [2; 5; 1; 3; 6]);
+%! assert (j, [3; 1; 4; 1; 2; 5; 3]);
+%! [y, i, j] = __unique__ ([3; 1; NaN; 1; 2; NaN; 3], false, true, false);
+%! assert (y, [3; 1; NaN; 2; NaN]);
+%! assert (i, [1; 2; 3; 5; 6]);
+%! assert (j, [1; 2; 3; 2; 4; 5; 1]);
+
+%!test
+%! x = [2, 1; 1, 2; 2, 1; NaN, 1; NaN, 1];
+%! [y, i, j] = __unique__ (x, true, false, true);
+%! assert (y, [1, 2; 2, 1; NaN, 1; NaN, 1]);
+%! assert (i, [2; 3; 4; 5]);
+%! assert (j, [2; 1; 2; 3; 4]);
+%! [y, i, j] = __unique__ (x, true, true, false);
+%! assert (y, [2, 1; 1, 2; NaN, 1; NaN, 1]);
+%! assert (i, [1; 2; 4; 5]);
+%! assert (j, [1; 2; 1; 3; 4]);
+
+%!test
+%! [tf, s_idx] = __ismember__ ([1, 5; NaN, 2], [2, 1, NaN, 1], false);
+%! assert (tf, [true, false; false, true]);
+%! assert (s_idx, [4, 0; 0, 1]);
+%! [tf, s_idx] = __ismember__ ({"b", "x"}, {"a", "b", "b"}, false);
+%! assert (tf, [true, false]);
+%! assert (s_idx, [3, 0]);
+
+%!error <same class> __ismember__ (1, single (1), false)
+%!error <sparse arrays> __unique__ (sparse (1), false, false, false)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -91,6 +91,14 @@ public:
     return m_cs[m_curr_frame];
   }
 
+  // Like get_current_stack_frame, but without the reference counting
+  // of a shared pointer.  The pointer is only valid until the frame is
+  // popped from the stack.
+  stack_frame * current_stack_frame_ptr () const
+  {
+    return m_cs[m_curr_frame].get ();
+  }
+
   symbol_scope top_scope () const
   {
     return m_cs[0]->get_scope ();
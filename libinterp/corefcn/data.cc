@@ -40,6 +40,7 @@
 #include "mx-base.h"
 #include "oct-base64.h"
 #include "oct-binmap.h"
+#include "oct-thread-pool.h"
 #include "oct-time.h"
 #include "quit.h"
 
@@ -121,6 +122,18 @@ If the optional argument @var{dim} is supplied, work along dimension @var{dim}.
 %! assert (all (x, 1) == [0, 1, 1]);
 %! assert (all (x, 2) == [0; 1; 1]);
 
+%!test
+%! for n = [1, 7, 16, 33, 100]
+%!   x = ones (n, 1);
+%!   assert (all (x));
+%!   assert (all (single (x)));
+%!   x(end) = 0;
+%!   assert (! all (x));
+%!   assert (! all (single (x)));
+%!   x(1:end-1) = NaN;
+%!   assert (! all (x));
+%! endfor
+
 %!error all ()
 %!error all (1, 2, 3)
 */
@@ -186,6 +199,18 @@ any (eye (2, 4), 2)
 %! assert (any (x, 1) == [0, 0, 1]);
 %! assert (any (x, 2) == [0; 0; 1]);
 
+%!test
+%! for n = [1, 7, 16, 33, 100]
+%!   x = NaN (n, 1);
+%!   assert (! any (x));
+%!   assert (! any (single (x)));
+%!   x(end) = -0.5;
+%!   assert (any (x));
+%!   assert (any (single (x)));
+%!   x(:) = 0;
+%!   assert (! any (x));
+%! endfor
+
 %!error any ()
 %!error any (1, 2, 3)
 */
@@ -1066,6 +1091,7 @@ cumprod ([1, 2; 3, 4; 5, 6])
 
 %!assert (cumprod (single ([2, 3; 4, 5]), 1), single ([2, 3; 8, 15]))
 %!assert (cumprod (single ([2, 3; 4, 5]), 2), single ([2, 6; 4, 20]))
+%!assert (cumprod ([1e200, 1e200, 1e-200 * ones(1, 40000)])(end), Inf)
 
 %!error cumprod ()
 */
@@ -1202,6 +1228,18 @@ For an explanation of the optional parameters @qcode{"native"} and
 
 /*
 %!assert (cumsum ([1, 2, 3]), [1, 3, 6])
+%!assert (cumsum (ones (1e5, 1))(end-2:end), [99998; 99999; 100000])
+%!test
+%! x = rand (2e5, 1) - 0.5;
+%! n_old = maxNumCompThreads (1);
+%! unwind_protect
+%!   c1 = cumsum (x);
+%!   maxNumCompThreads (4);
+%!   assert (cumsum (x), c1);
+%!   assert (c1(end), sum (x), 1e-10);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
 %!assert (cumsum ([-1; -2; -3]), [-1; -3; -6])
 %!assert (cumsum ([i, 2+i, -3+2i, 4]), [i, 2+2i, -1+4i, 3+4i])
 %!assert (cumsum ([1, 2, 3; i, 2i, 3i; 1+i, 2+2i, 3+3i]),
@@ -1546,6 +1584,9 @@ in double precision even for single precision inputs.
 %!assert (prod (zeros (0, 2), 1), [1, 1])
 %!assert (prod (zeros (0, 2), 2), zeros (0, 1))
 
+## Products are evaluated in order, so an overflow is not undone later
+%!assert (prod ([1e200, 1e200, 1e-200 * ones(1, 300)]), Inf)
+
 %!assert (prod (single ([1, 2; 3, 4]), 1), single ([3, 8]))
 %!assert (prod (single ([1, 2; 3, 4]), 2), single ([2; 12]))
 %!assert (prod (zeros (1, 0, "single")), single (1))
@@ -2613,6 +2654,51 @@ returns the original array @var{A}.
   return do_permute (args, true);
 }
 
+/*
+%!test
+%! a = reshape (1:24, [2, 3, 4]);
+%! assert (size (permute (a, [2, 1, 3])), [3, 2, 4]);
+%! assert (permute (a, [2, 1, 3])(:,:,2), a(:,:,2).');
+%! assert (permute (a, [3, 1, 2]), reshape (reshape (a, [], 4).', [4, 2, 3]));
+%! assert (ipermute (permute (a, [3, 1, 2]), [3, 1, 2]), a);
+
+%!function b = __permute_ref__ (a, perm)
+%!  sz = size (a);
+%!  sz(end+1:numel (perm)) = 1;
+%!  c = cell (1, numel (perm));
+%!  [c{:}] = ndgrid (arrayfun (@(n) 1:n, sz(perm), "uniformoutput", false){:});
+%!  sub(perm) = c;
+%!  b = a(sub2ind (sz, sub{:}));
+%!endfunction
+
+## Large arrays of several element sizes, which use blocked kernels
+%!test
+%! n_old = maxNumCompThreads (1);
+%! unwind_protect
+%!   for nt = [1, 4]
+%!     maxNumCompThreads (nt);
+%!     for cls = {"double", "single", "int16", "uint32", "logical"}
+%!       a = cast (reshape (mod (0:(67*45*31-1), 251), [67, 45, 31]), cls{1});
+%!       for perm = perms (1:3).'
+%!         b = permute (a, perm);
+%!         assert (b, __permute_ref__ (a, perm));
+%!         assert (ipermute (b, perm), a);
+%!       endfor
+%!       x = reshape (a, [67, 15, 3, 31]);
+%!       assert (permute (x, [3, 1, 4, 2]), __permute_ref__ (x, [3, 1, 4, 2]));
+%!       y = a(1:3,:,1);
+%!       assert (y.', [y(1,:).', y(2,:).', y(3,:).']);
+%!       assert (a(:,:,2).', __permute_ref__ (a(:,:,2), [2, 1]));
+%!     endfor
+%!     z = complex (rand (40, 50), rand (40, 50));
+%!     assert (z.', __permute_ref__ (z, [2, 1]));
+%!     assert (single (z).', __permute_ref__ (single (z), [2, 1]));
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+*/
+
 DEFUN (length, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{n} =} length (@var{A})
@@ -3334,6 +3420,22 @@ type @qcode{"extra"} has no effect.
 ;-)
 %!assert (sum ("Octave") + "8", sumsq (primes (17)))
 
+## Long sums are accurate and do not depend on the number of threads
+%!assert (sum (0.1 * ones (1e6, 1)), 1e5, 1e-9)
+%!assert (sum (single (0.1) * ones (1e6, 1, "single")), single (1e5), 0.1)
+%!test
+%! x = rand (3e5, 4) - 0.5;
+%! n_old = maxNumCompThreads (1);
+%! unwind_protect
+%!   s1 = sum (x);
+%!   s2 = sum (x(:));
+%!   maxNumCompThreads (4);
+%!   assert (sum (x), s1);
+%!   assert (sum (x(:)), s2);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
 %!error sum ()
 %!error sum (1,2,3)
 %!error <unrecognized type argument 'foobar'> sum (1, "foobar")
@@ -6589,6 +6691,14 @@ cumulatively from left to right:
 ## Test input validation for all functions which use binary_assoc_op_defun_body
 %!error plus ()
 %!error plus (1)
+
+%!demo
+%! ## Saturating addition of int16 arrays, compared with forming the sums
+%! ## in double and converting back.  Compare the times with those of an
+%! ## older build to see the effect of the vectorized integer kernels.
+%! init = ["a = int16 (randi ([-32768, 32767], n, 1)); ", ...
+%!         "b = int16 (randi ([-32768, 32767], n, 1));"];
+%! speed ("a + b", init, [1e4, 1e7], "int16 (double (a) + double (b))");
 */
 
 DEFUN (minus, args, ,
@@ -6601,6 +6711,14 @@ This function and @w{@tcode{@var{A} - @var{B}}}@ are equivalent.
   return binary_op_defun_body (octave_value::op_sub, args);
 }
 
+/*
+%!demo
+%! ## Saturating subtraction of uint8 arrays, compared with forming the
+%! ## differences in double and converting back.
+%! init = "a = uint8 (randi ([0, 255], n, 1)); b = uint8 (randi ([0, 255], n, 1));";
+%! speed ("a - b", init, [1e4, 1e7], "uint8 (double (a) - double (b))");
+*/
+
 DEFUN (mtimes, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{C} =} mtimes (@var{A}, @var{B})
@@ -7400,6 +7518,48 @@ ordered lists.
 %! assert (B, A);
 %! assert (idx, ones (2))
 
+## Long vectors and many columns, which are sorted by radix and by several
+## threads
+%!test
+%! n_old = maxNumCompThreads (1);
+%! unwind_protect
+%!   x = [randi([-50, 50], 1, 30000), -0, 0, NaN(1, 5), Inf, -Inf];
+%!   x = x(randperm (numel (x)));
+%!   a = randi (1000, 3000, 50);
+%!   [sa1, ia1] = sort (a);
+%!   [sa2, ia2] = sort (a, 2, "descend");
+%!   for nt = [1, 4]
+%!     maxNumCompThreads (nt);
+%!     for cls = {"double", "single", "int8", "int64", "uint16"}
+%!       y = cast (x, cls{1});
+%!       for mode = {"ascend", "descend"}
+%!         [s, i] = sort (y, mode{1});
+%!         assert (s, y(i));
+%!         assert (sort (y, mode{1}), s);
+%!         nn = ! isnan (s);
+%!         if (strcmp (mode{1}, "ascend"))
+%!           assert (all (nn(1:end-5)));
+%!           d = diff (double (s(nn)));
+%!           assert (all (d >= 0));
+%!         else
+%!           assert (all (nn(6:end)));
+%!           d = diff (double (s(nn)));
+%!           assert (all (d <= 0));
+%!         endif
+%!         ## Equal elements, including 0 and -0, keep their order.
+%!         di = diff (i(nn));
+%!         assert (all (di(d == 0) > 0));
+%!       endfor
+%!     endfor
+%!     [s, i] = sort (a);
+%!     assert ({s, i}, {sa1, ia1});
+%!     [s, i] = sort (a, 2, "descend");
+%!     assert ({s, i}, {sa2, ia2});
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
 %!error <Invalid call> sort ()
 %!error <Invalid call> sort (1, 2, 3, 4)
 %!error <MODE must be either "ascend" or "descend"> sort (1, "foobar")
@@ -7730,218 +7890,180 @@ the ratio K/M is small; otherwise, it may be better to use @code{sort}.
 %!error nth_element ("abcd", 3)
 */
 
-template <typename NDT>
-static NDT
-do_accumarray_sum (const idx_vector& idx, const NDT& vals,
-                   octave_idx_type n = -1)
-{
-  typedef typename NDT::element_type T;
-  if (n < 0)
-    n = idx.extent (0);
-  else if (idx.extent (n) > n)
-    error ("accumarray: index out of range");
-
-  NDT retval (dim_vector (n, 1), T ());
-
-  if (vals.numel () == 1)
-    retval.idx_add (idx, vals (0));
-  else if (vals.numel () == idx.length (n))
-    retval.idx_add (idx, vals);
-  else
-    error ("accumarray: dimensions mismatch");
+// Select, for each column J of X, the elements at the zero-based indices
+// K(:,J) of the sorted column, with any NaNs sorted last as by sort.  If K
+// has a single column, it applies to every column of X.  All indices of a
+// column are placed by a single partitioning pass, and the columns are
+// split between threads.
 
-  return retval;
-}
-
-DEFUN (__accumarray_sum__, args, ,
-       doc: /* -*- texinfo -*-
-@deftypefn {} {} __accumarray_sum__ (@var{idx}, @var{vals}, @var{n})
-Undocumented internal function.
-@end deftypefn */)
+template <typename T>
+static Array<T>
+do_nth_element_columns (const Array<T>& x, const Array<octave_idx_type>& k)
 {
-  int nargin = args.length ();
+  octave_idx_type nr = x.rows ();
+  octave_idx_type nc = x.columns ();
+  octave_idx_type nk = k.rows ();
+  bool shared = (k.columns () == 1);
 
-  if (nargin < 2 || nargin > 3)
-    print_usage ();
+  Array<T> retval (dim_vector (nk, nc));
 
-  if (! args(0).isnumeric ())
-    error ("__accumarray_sum__: first argument must be numeric");
+  const T *px = x.data ();
+  const octave_idx_type *pk = k.data ();
+  T *py = retval.rwdata ();
 
-  octave_value retval;
+  auto fcn = [=] (octave_idx_type jbeg, octave_idx_type jend)
+  {
+    octave_sort<T> lsort;
+    lsort.set_compare (ASCENDING);
 
-  try
-    {
-      idx_vector idx = args(0).index_vector ();
-      octave_idx_type n = -1;
-      if (nargin == 3)
-        n = args(2).idx_type_value (true);
-
-      octave_value vals = args(1);
-
-      if (vals.is_range ())
-        {
-          range<double> r = vals.range_value ();
-          if (r.increment () == 0)
-            vals = r.base ();
-        }
+    OCTAVE_LOCAL_BUFFER (T, buf, nr);
+    OCTAVE_LOCAL_BUFFER (octave_idx_type, ranks, nk);
 
-      if (vals.is_single_type ())
-        {
-          if (vals.iscomplex ())
-            retval = do_accumarray_sum (idx,
-                                        vals.float_complex_array_value (),
-                                        n);
-          else
-            retval = do_accumarray_sum (idx, vals.float_array_value (), n);
-        }
-      else if (vals.isnumeric () || vals.islogical ())
-        {
-          if (vals.iscomplex ())
-            retval = do_accumarray_sum (idx,
-                                        vals.complex_array_value (),
-                                        n);
-          else
-            retval = do_accumarray_sum (idx, vals.array_value (), n);
-        }
-      else
-        err_wrong_type_arg ("accumarray", vals);
-    }
-  catch (const index_exception& ie)
-    {
-      error ("__accumarray_sum__: invalid index %s", ie.what ());
-    }
+    for (octave_idx_type j = jbeg; j < jend; j++)
+      {
+        const T *xj = px + j*nr;
+        const octave_idx_type *kj = pk + (shared ? 0 : j*nk);
+        T *yj = py + j*nk;
+
+        // Copy the column, moving NaNs to the end.
+        octave_idx_type kl = 0;
+        octave_idx_type ku = nr;
+        for (octave_idx_type i = 0; i < nr; i++)
+          {
+            T tmp = xj[i];
+            if (octave::math::isnan (tmp))
+              buf[--ku] = tmp;
+            else
+              buf[kl++] = tmp;
+          }
 
-  return retval;
-}
+        // Only the distinct indices of non-NaN elements need to be placed.
+        octave_idx_type nsel = 0;
+        for (octave_idx_type i = 0; i < nk; i++)
+          if (kj[i] < kl)
+            ranks[nsel++] = kj[i];
 
-template <typename NDT>
-static NDT
-do_accumarray_minmax (const idx_vector& idx, const NDT& vals,
-                      octave_idx_type n, bool ismin,
-                      const typename NDT::element_type& zero_val)
-{
-  typedef typename NDT::element_type T;
-  if (n < 0)
-    n = idx.extent (0);
-  else if (idx.extent (n) > n)
-    error ("accumarray: index out of range");
+        std::sort (ranks, ranks + nsel);
+        nsel = std::unique (ranks, ranks + nsel) - ranks;
 
-  NDT retval (dim_vector (n, 1), zero_val);
+        lsort.nth_element (buf, kl, ranks, nsel);
 
-  // Pick minimizer or maximizer.
-  void (MArray<T>::*op) (const idx_vector&, const MArray<T>&)
-    = ismin ? (&MArray<T>::idx_min) : (&MArray<T>::idx_max);
+        for (octave_idx_type i = 0; i < nk; i++)
+          yj[i] = buf[kj[i]];
+      }
+  };
 
-  octave_idx_type l = idx.length (n);
-  if (vals.numel () == 1)
-    (retval.*op) (idx, NDT (dim_vector (l, 1), vals(0)));
-  else if (vals.numel () == l)
-    (retval.*op) (idx, vals);
+  if (nc > 1 && octave::thread_pool::use_threads (nc, nr))
+    octave::thread_pool::parallel_for (nc, nr, fcn);
   else
-    error ("accumarray: dimensions mismatch");
+    fcn (0, nc);
 
   return retval;
 }
 
-static octave_value_list
-do_accumarray_minmax_fcn (const octave_value_list& args,
-                          bool ismin)
+DEFUN (__nth_element__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{y} =} __nth_element__ (@var{x}, @var{k})
+Undocumented internal function.
+@end deftypefn */)
 {
-  int nargin = args.length ();
-
-  if (nargin < 3 || nargin > 4)
+  if (args.length () != 2)
     print_usage ();
 
-  if (! args(0).isnumeric ())
-    error ("accumarray: first argument must be numeric");
+  octave_value argx = args(0);
 
-  octave_value retval;
+  if (argx.ndims () > 2)
+    error ("__nth_element__: X must be a 2-D array");
 
-  try
-    {
-      idx_vector idx = args(0).index_vector ();
-      octave_idx_type n = -1;
-      if (nargin == 4)
-        n = args(3).idx_type_value (true);
+  octave_idx_type nr = argx.rows ();
+  octave_idx_type nc = argx.columns ();
 
-      octave_value vals = args(1);
-      octave_value zero = args(2);
+  NDArray kval = args(1).xarray_value ("__nth_element__: K must be numeric");
 
-      switch (vals.builtin_type ())
-        {
-        case btyp_double:
-          retval = do_accumarray_minmax (idx, vals.array_value (), n, ismin,
-                                         zero.double_value ());
-          break;
+  if (kval.ndims () > 2 || (kval.columns () != 1 && kval.columns () != nc))
+    error ("__nth_element__: K must have one column or as many columns as X");
 
-        case btyp_float:
-          retval = do_accumarray_minmax (idx, vals.float_array_value (), n,
-                                         ismin, zero.float_value ());
-          break;
+  Array<octave_idx_type> k (kval.dims ());
 
-        case btyp_complex:
-          retval = do_accumarray_minmax (idx, vals.complex_array_value (),
-                                         n, ismin, zero.complex_value ());
-          break;
+  for (octave_idx_type i = 0; i < kval.numel (); i++)
+    {
+      double ki = kval.xelem (i);
+      if (ki != octave::math::fix (ki) || ki < 1 || ki > nr)
+        error ("__nth_element__: K must contain valid indices into the columns of X");
+      k.xelem (i) = static_cast<octave_idx_type> (ki) - 1;
+    }
 
-        case btyp_float_complex:
-          retval = do_accumarray_minmax (idx,
-                                         vals.float_complex_array_value (),
-                                         n, ismin,
-                                         zero.float_complex_value ());
-          break;
+  octave_value retval;
+
+  switch (argx.builtin_type ())
+    {
+    case btyp_double:
+      retval = NDArray (do_nth_element_columns (argx.array_value (), k));
+      break;
+    case btyp_float:
+      retval = FloatNDArray (do_nth_element_columns (argx.float_array_value (),
+                                                     k));
+      break;
+    case btyp_complex:
+      retval = ComplexNDArray (do_nth_element_columns
+                               (argx.complex_array_value (), k));
+      break;
+    case btyp_float_complex:
+      retval = FloatComplexNDArray (do_nth_element_columns
+                                    (argx.float_complex_array_value (), k));
+      break;
 
 #define MAKE_INT_BRANCH(X)                                              \
-          case btyp_ ## X:                                              \
-            retval = do_accumarray_minmax (idx, vals.X ## _array_value (), \
-                                           n, ismin, zero.X ## _scalar_value ()); \
-            break;
+      case btyp_ ## X:                                                  \
+        retval = X ## NDArray (do_nth_element_columns                   \
+                               (argx.X ## _array_value (), k));         \
+        break;
 
-          MAKE_INT_BRANCH (int8);
-          MAKE_INT_BRANCH (int16);
-          MAKE_INT_BRANCH (int32);
-          MAKE_INT_BRANCH (int64);
-          MAKE_INT_BRANCH (uint8);
-          MAKE_INT_BRANCH (uint16);
-          MAKE_INT_BRANCH (uint32);
-          MAKE_INT_BRANCH (uint64);
+      MAKE_INT_BRANCH (int8);
+      MAKE_INT_BRANCH (int16);
+      MAKE_INT_BRANCH (int32);
+      MAKE_INT_BRANCH (int64);
+      MAKE_INT_BRANCH (uint8);
+      MAKE_INT_BRANCH (uint16);
+      MAKE_INT_BRANCH (uint32);
+      MAKE_INT_BRANCH (uint64);
 
 #undef MAKE_INT_BRANCH
 
-        case btyp_bool:
-          retval = do_accumarray_minmax (idx, vals.array_value (), n, ismin,
-                                         zero.bool_value ());
-          break;
+    case btyp_bool:
+      retval = boolNDArray (do_nth_element_columns (argx.bool_array_value (),
+                                                    k));
+      break;
 
-        default:
-          err_wrong_type_arg ("accumarray", vals);
-        }
-    }
-  catch (const index_exception& ie)
-    {
-      error ("do_accumarray_minmax_fcn: invalid index %s", ie.what ());
+    default:
+      err_wrong_type_arg ("__nth_element__", argx);
     }
 
   return retval;
 }
 
-DEFUN (__accumarray_min__, args, ,
-       doc: /* -*- texinfo -*-
-@deftypefn {} {} __accumarray_min__ (@var{idx}, @var{vals}, @var{zero}, @var{n})
-Undocumented internal function.
-@end deftypefn */)
-{
-  return do_accumarray_minmax_fcn (args, true);
-}
+/*
+%!test
+%! x = [3, NaN, 2; 1, 5, NaN; 2, 4, 1; NaN, 6, 3];
+%! assert (__nth_element__ (x, [1; 2; 4]), [1, 4, 1; 2, 5, 2; NaN, NaN, NaN]);
+%! assert (__nth_element__ (x, [1, 3, 2; 3, 1, 3]), [1, 6, 2; 3, 4, 3]);
+%! assert (__nth_element__ (single (x), [4; 1]),
+%!         single ([NaN, NaN, NaN; 1, 4, 1]));
+%! assert (__nth_element__ (int8 ([5, -2; 1, 7; 3, 0]), [2; 3]),
+%!         int8 ([3, 0; 5, 7]));
 
-DEFUN (__accumarray_max__, args, ,
-       doc: /* -*- texinfo -*-
-@deftypefn {} {} __accumarray_max__ (@var{idx}, @var{vals}, @var{zero}, @var{n})
-Undocumented internal function.
-@end deftypefn */)
-{
-  return do_accumarray_minmax_fcn (args, false);
-}
+%!test
+%! x = rand (1000, 7);
+%! x(rand (size (x)) < 0.1) = NaN;
+%! k = [1; 17; 500; 501; 999; 17];
+%! s = sort (x);
+%! assert (__nth_element__ (x, k), s(k,:));
+
+%!error <K must have one column> __nth_element__ (ones (3, 2), ones (2, 3))
+%!error <K must contain valid indices> __nth_element__ (ones (3, 2), 4)
+%!error <K must contain valid indices> __nth_element__ (ones (3, 2), 1.5)
+%!error <X must be a 2-D array> __nth_element__ (ones (2, 2, 2), 1)
+*/
 
 template <typename NDT>
 static NDT
@@ -638,13 +638,18 @@ out_of_date_check (octave_value& function,
                     }
 
                   // If the function has been replaced then clear any
-                  // breakpoints associated with it
+                  // breakpoints associated with it and any cached
+                  // lookups that may refer to the old definition.
                   if (clear_breakpoints)
                     {
                       bp_table& bptab = __get_bp_table__ ();
 
                       bptab.remove_all_breakpoints_from_function (canonical_nm,
                                                                   true);
+
+                      symbol_table& symtab = __get_symbol_table__ ();
+
+                      symtab.invalidate_function_caches ();
                     }
                 }
             }
@@ -658,6 +658,9 @@ input_system::interactive_input (const std::string& s, bool& eof)
 {
   Vlast_prompt_time.stamp ();
 
+  // Files may have changed since the last prompt.
+  m_interpreter.get_symbol_table ().invalidate_function_caches ();
+
   if (Vdrawnow_requested && m_interpreter.interactive ())
     {
       bool eval_error = false;
@@ -1411,6 +1411,8 @@ interpreter::chdir (const std::string& dir)
   // further back in the load path order.
   Vlast_prompt_time.stamp ();
 
+  m_symbol_table.invalidate_function_caches ();
+
   m_event_manager.directory_changed (sys::env::get_current_directory ());
 
   return cd_ok;
@@ -0,0 +1,851 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <sstream>
+
+// include headers for 'fd_set' type
+#if defined (OCTAVE_USE_WINDOWS_API)
+#  include <winsock2.h>
+#else
+#  include <sys/select.h>
+#endif
+
+#include "dNDArray.h"
+#include "lo-mappers.h"
+#include "oct-syscalls.h"
+#include "quit.h"
+#include "select-wrappers.h"
+#include "unistd-wrappers.h"
+
+#include "defun.h"
+#include "error.h"
+#include "lab-comm.h"
+#include "ls-oct-binary.h"
+#include "ov.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Request and reply codes.  Every message starts with a header of four
+// integers: the code, a lab index, a tag, and the length of the data
+// that follows.
+
+enum lab_message
+{
+  lab_send = 1,
+  lab_receive,
+  lab_probe,
+  lab_barrier,
+  lab_reply_data,
+  lab_reply_probe,
+  lab_reply_barrier,
+  lab_reply_error
+};
+
+// State of the current process.
+
+static int s_labindex = 1;
+static int s_numlabs = 1;
+static int s_request_fd = -1;
+static int s_reply_fd = -1;
+
+static bool
+write_all (int fd, const char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t k = octave_write_wrapper (fd, buf, n);
+
+      if (k < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          return false;
+        }
+
+      buf += k;
+      n -= k;
+    }
+
+  return true;
+}
+
+static bool
+read_all (int fd, char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t k = octave_read_wrapper (fd, buf, n);
+
+      if (k < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          return false;
+        }
+
+      if (k == 0)
+        return false;
+
+      buf += k;
+      n -= k;
+    }
+
+  return true;
+}
+
+static bool
+write_message (int fd, int code, int lab, int tag,
+               const std::string& data = "")
+{
+  int64_t hdr[4] = { code, lab, tag, static_cast<int64_t> (data.size ()) };
+
+  return (write_all (fd, reinterpret_cast<const char *> (hdr), sizeof (hdr))
+          && write_all (fd, data.data (), data.size ()));
+}
+
+static bool
+read_message (int fd, int64_t hdr[4], std::string& data)
+{
+  if (! read_all (fd, reinterpret_cast<char *> (hdr), 4 * sizeof (int64_t)))
+    return false;
+
+  data.resize (hdr[3]);
+
+  return hdr[3] == 0 || read_all (fd, &data[0], hdr[3]);
+}
+
+// Send a request from a lab to the client and, unless it is a send,
+// wait for the reply.
+
+static void
+lab_request (const char *who, int code, int lab, int tag,
+             const std::string& data, int64_t reply[4], std::string& result)
+{
+  if (! write_message (s_request_fd, code, lab, tag, data))
+    error ("%s: lost connection to the client", who);
+
+  if (code == lab_send)
+    return;
+
+  // Interrupts are noticed by the client as well, which stops
+  // relaying messages once every lab has quit.
+
+  if (! read_message (s_reply_fd, reply, result))
+    {
+      octave_quit ();
+
+      error ("%s: lost connection to the client", who);
+    }
+
+  if (reply[0] == lab_reply_error)
+    error ("%s: %s", who, result.c_str ());
+}
+
+lab_channels::~lab_channels ()
+{
+  close_all ();
+}
+
+void
+lab_channels::open (int nlabs)
+{
+  m_nlabs = nlabs;
+
+  m_requests.assign (nlabs, -1);
+  m_replies.assign (nlabs, -1);
+  m_lab_requests.assign (nlabs, -1);
+  m_lab_replies.assign (nlabs, -1);
+
+  for (int k = 0; k < nlabs; k++)
+    {
+      int fd[2];
+      std::string msg;
+
+      if (sys::pipe (fd, msg) < 0)
+        {
+          close_all ();
+          error ("spmd: unable to create pipe: %s", msg.c_str ());
+        }
+
+      m_requests[k] = fd[0];
+      m_lab_requests[k] = fd[1];
+
+      if (sys::pipe (fd, msg) < 0)
+        {
+          close_all ();
+          error ("spmd: unable to create pipe: %s", msg.c_str ());
+        }
+
+      m_lab_replies[k] = fd[0];
+      m_replies[k] = fd[1];
+    }
+}
+
+void
+lab_channels::attach (int k)
+{
+  // Keep only this lab's ends of its own pipes.
+
+  for (int i = 0; i < m_nlabs; i++)
+    {
+      octave_close_wrapper (m_requests[i]);
+      octave_close_wrapper (m_replies[i]);
+
+      if (i != k)
+        {
+          octave_close_wrapper (m_lab_requests[i]);
+          octave_close_wrapper (m_lab_replies[i]);
+        }
+    }
+
+  s_labindex = k + 1;
+  s_numlabs = m_nlabs;
+  s_request_fd = m_lab_requests[k];
+  s_reply_fd = m_lab_replies[k];
+
+  m_requests.clear ();
+  m_replies.clear ();
+  m_lab_requests.clear ();
+  m_lab_replies.clear ();
+}
+
+void
+lab_channels::serve (int nstarted)
+{
+  struct message
+  {
+    int source;
+    int tag;
+    std::string data;
+  };
+
+  enum lab_status
+  {
+    lab_running,
+    lab_receiving,
+    lab_at_barrier,
+    lab_finished
+  };
+
+  for (int k = 0; k < m_nlabs; k++)
+    {
+      octave_close_wrapper (m_lab_requests[k]);
+      octave_close_wrapper (m_lab_replies[k]);
+
+      m_lab_requests[k] = -1;
+      m_lab_replies[k] = -1;
+    }
+
+  std::vector<lab_status> status (m_nlabs, lab_running);
+  std::vector<int> want_source (m_nlabs, any);
+  std::vector<int> want_tag (m_nlabs, any);
+  std::vector<std::deque<message>> mailbox (m_nlabs);
+
+  auto finish = [&] (int k)
+  {
+    status[k] = lab_finished;
+
+    octave_close_wrapper (m_requests[k]);
+    octave_close_wrapper (m_replies[k]);
+
+    m_requests[k] = -1;
+    m_replies[k] = -1;
+  };
+
+  auto reply = [&] (int k, int code, int lab, int tag,
+                    const std::string& data)
+  {
+    if (! write_message (m_replies[k], code, lab, tag, data))
+      finish (k);
+  };
+
+  auto find_message = [&] (int k, int source, int tag)
+  {
+    std::deque<message>& box = mailbox[k];
+
+    auto p = box.begin ();
+
+    for (; p != box.end (); p++)
+      {
+        if ((source == any || p->source == source)
+            && (tag == any || p->tag == tag))
+          break;
+      }
+
+    return p;
+  };
+
+  auto deliver = [&] (int k)
+  {
+    if (status[k] != lab_receiving)
+      return;
+
+    auto p = find_message (k, want_source[k], want_tag[k]);
+
+    if (p != mailbox[k].end ())
+      {
+        status[k] = lab_running;
+
+        message msg = *p;
+        mailbox[k].erase (p);
+
+        reply (k, lab_reply_data, msg.source, msg.tag, msg.data);
+      }
+  };
+
+  for (int k = nstarted; k < m_nlabs; k++)
+    finish (k);
+
+  while (true)
+    {
+      fd_set readfds;
+      octave_fd_zero (&readfds);
+
+      int maxfd = -1;
+
+      for (int k = 0; k < m_nlabs; k++)
+        {
+          if (status[k] != lab_finished)
+            {
+              octave_fd_set (m_requests[k], &readfds);
+
+              if (m_requests[k] > maxfd)
+                maxfd = m_requests[k];
+            }
+        }
+
+      if (maxfd < 0)
+        break;
+
+      int nready = octave_select (maxfd + 1, &readfds, nullptr, nullptr,
+                                  nullptr);
+
+      if (nready < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          // Closing the pipes makes every lab fail.
+          break;
+        }
+
+      for (int k = 0; k < m_nlabs; k++)
+        {
+          if (status[k] == lab_finished
+              || ! octave_fd_isset (m_requests[k], &readfds))
+            continue;
+
+          int64_t hdr[4];
+          std::string data;
+
+          if (! read_message (m_requests[k], hdr, data))
+            {
+              finish (k);
+              continue;
+            }
+
+          int lab = hdr[1];
+          int tag = hdr[2];
+
+          switch (hdr[0])
+            {
+            case lab_send:
+              if (lab >= 1 && lab <= m_nlabs)
+                {
+                  mailbox[lab-1].push_back ({k + 1, tag, data});
+
+                  deliver (lab-1);
+                }
+              break;
+
+            case lab_receive:
+              status[k] = lab_receiving;
+              want_source[k] = lab;
+              want_tag[k] = tag;
+
+              deliver (k);
+              break;
+
+            case lab_probe:
+              {
+                auto p = find_message (k, lab, tag);
+
+                if (p != mailbox[k].end ())
+                  reply (k, lab_reply_probe, p->source, p->tag, "1");
+                else
+                  reply (k, lab_reply_probe, lab, tag, "");
+              }
+              break;
+
+            case lab_barrier:
+              {
+                status[k] = lab_at_barrier;
+
+                int nwaiting = 0;
+
+                for (int i = 0; i < m_nlabs; i++)
+                  {
+                    if (status[i] == lab_at_barrier)
+                      nwaiting++;
+                  }
+
+                if (nwaiting == m_nlabs)
+                  {
+                    for (int i = 0; i < m_nlabs; i++)
+                      {
+                        status[i] = lab_running;
+
+                        reply (i, lab_reply_barrier, 0, 0, "");
+                      }
+                  }
+              }
+              break;
+
+            default:
+              finish (k);
+              break;
+            }
+        }
+
+      // If no lab is running, nothing can change any more.
+
+      bool blocked = false;
+
+      for (int k = 0; k < m_nlabs; k++)
+        {
+          if (status[k] == lab_running)
+            {
+              blocked = false;
+              break;
+            }
+
+          if (status[k] != lab_finished)
+            blocked = true;
+        }
+
+      if (blocked)
+        {
+          for (int k = 0; k < m_nlabs; k++)
+            {
+              if (status[k] == lab_receiving)
+                {
+                  status[k] = lab_running;
+
+                  reply (k, lab_reply_error, 0, 0,
+                         "deadlock: no lab can send the requested message");
+                }
+              else if (status[k] == lab_at_barrier)
+                {
+                  status[k] = lab_running;
+
+                  reply (k, lab_reply_error, 0, 0,
+                         "deadlock: not every lab can reach the barrier");
+                }
+            }
+        }
+    }
+
+  close_all ();
+}
+
+int
+lab_channels::labindex ()
+{
+  return s_labindex;
+}
+
+int
+lab_channels::numlabs ()
+{
+  return s_numlabs;
+}
+
+bool
+lab_channels::in_lab ()
+{
+  return s_request_fd >= 0;
+}
+
+void
+lab_channels::send (const std::string& data, int dest, int tag)
+{
+  int64_t reply[4];
+  std::string result;
+
+  lab_request ("labSend", lab_send, dest, tag, data, reply, result);
+}
+
+std::string
+lab_channels::receive (int& source, int& tag)
+{
+  int64_t reply[4];
+  std::string result;
+
+  lab_request ("labReceive", lab_receive, source, tag, "", reply, result);
+
+  source = reply[1];
+  tag = reply[2];
+
+  return result;
+}
+
+bool
+lab_channels::probe (int& source, int& tag)
+{
+  int64_t reply[4];
+  std::string result;
+
+  lab_request ("labProbe", lab_probe, source, tag, "", reply, result);
+
+  if (result.empty ())
+    return false;
+
+  source = reply[1];
+  tag = reply[2];
+
+  return true;
+}
+
+void
+lab_channels::barrier ()
+{
+  int64_t reply[4];
+  std::string result;
+
+  lab_request ("labBarrier", lab_barrier, 0, 0, "", reply, result);
+}
+
+void
+lab_channels::close_all ()
+{
+  for (auto *fds : { &m_requests, &m_replies, &m_lab_requests,
+                     &m_lab_replies })
+    {
+      for (int fd : *fds)
+        {
+          if (fd >= 0)
+            octave_close_wrapper (fd);
+        }
+
+      fds->clear ();
+    }
+}
+
+static std::string
+encode_lab_data (const char *who, const octave_value& val)
+{
+  std::ostringstream buf;
+
+  if (! save_binary_data (buf, val, "data", "", false, false))
+    error ("%s: unable to send value of class %s", who,
+           val.class_name ().c_str ());
+
+  return buf.str ();
+}
+
+static octave_value
+decode_lab_data (const std::string& data)
+{
+  std::istringstream is (data);
+
+  bool global = false;
+  octave_value val;
+  std::string doc;
+
+  read_binary_data (is, false, mach_info::native_float_format (),
+                    "labReceive", global, val, doc);
+
+  return val;
+}
+
+static int
+lab_source_arg (const char *who, const octave_value& arg)
+{
+  if (arg.is_string ())
+    {
+      if (arg.string_value () != "any")
+        error (R"(%s: SOURCE must be a lab index or "any")", who);
+
+      return lab_channels::any;
+    }
+
+  int source = arg.xint_value ("%s: SOURCE must be a lab index or \"any\"",
+                               who);
+
+  if (source < 1 || source > lab_channels::numlabs ())
+    error ("%s: SOURCE must be between 1 and %d", who,
+           lab_channels::numlabs ());
+
+  return source;
+}
+
+static int
+lab_tag_arg (const char *who, const octave_value& arg)
+{
+  int tag = arg.xint_value ("%s: TAG must be an integer", who);
+
+  if (tag < 0)
+    error ("%s: TAG must be nonnegative", who);
+
+  return tag;
+}
+
+DEFUN (labindex, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{idx} =} labindex ()
+Return the index of the current lab in an @code{spmd} block.
+
+Labs are numbered from 1 to @code{numlabs ()}.  Outside of an @code{spmd}
+block, @code{labindex} returns 1.
+@seealso{numlabs, spmd, labSend, labReceive}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  return ovl (lab_channels::labindex ());
+}
+
+DEFUN (numlabs, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} numlabs ()
+Return the number of labs running the current @code{spmd} block.
+
+Outside of an @code{spmd} block, @code{numlabs} returns 1.
+@seealso{labindex, spmd}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  return ovl (lab_channels::numlabs ());
+}
+
+DEFUN (labSend, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {} labSend (@var{data}, @var{dest})
+@deftypefnx {} {} labSend (@var{data}, @var{dest}, @var{tag})
+Send @var{data} from the current lab to the lab or labs @var{dest}.
+
+The message is identified by the nonnegative integer @var{tag}, which is 0
+if not given.  @code{labSend} returns without waiting for the message to
+be received.  Any value that can be saved with
+@code{save -binary} can be sent.
+@seealso{labReceive, labProbe, labBarrier, labindex, numlabs}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  NDArray dest
+    = args(1).xarray_value ("labSend: DEST must be a vector of lab indices");
+
+  int tag = (nargin == 3 ? lab_tag_arg ("labSend", args(2)) : 0);
+
+  for (octave_idx_type i = 0; i < dest.numel (); i++)
+    {
+      double d = dest(i);
+
+      if (math::x_nint (d) != d || d < 1 || d > lab_channels::numlabs ())
+        error ("labSend: DEST must be between 1 and %d",
+               lab_channels::numlabs ());
+
+      if (d == lab_channels::labindex ())
+        error ("labSend: a lab can not send a message to itself");
+    }
+
+  std::string data = encode_lab_data ("labSend", args(0));
+
+  for (octave_idx_type i = 0; i < dest.numel (); i++)
+    lab_channels::send (data, dest(i), tag);
+
+  return ovl ();
+}
+
+DEFUN (labReceive, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{data} =} labReceive ()
+@deftypefnx {} {@var{data} =} labReceive (@var{source})
+@deftypefnx {} {@var{data} =} labReceive ("any", @var{tag})
+@deftypefnx {} {@var{data} =} labReceive (@var{source}, @var{tag})
+@deftypefnx {} {[@var{data}, @var{source}, @var{tag}] =} labReceive (@dots{})
+Wait for a message sent to the current lab with @code{labSend} and return
+its data.
+
+If @var{source} is given, only accept a message from that lab.  If
+@var{tag} is given, only accept a message with that tag.  Messages from the
+same lab are received in the order they were sent.  The optional outputs
+@var{source} and @var{tag} identify the message that was received.
+
+If no lab can send a matching message any more, @code{labReceive} fails
+with an error instead of waiting forever.
+@seealso{labSend, labProbe, labBarrier}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 2)
+    print_usage ();
+
+  int source = (nargin > 0 ? lab_source_arg ("labReceive", args(0))
+                           : lab_channels::any);
+
+  int tag = (nargin > 1 ? lab_tag_arg ("labReceive", args(1))
+                        : lab_channels::any);
+
+  if (! lab_channels::in_lab ())
+    error ("labReceive: no other labs are running");
+
+  std::string data = lab_channels::receive (source, tag);
+
+  return ovl (decode_lab_data (data), source, tag);
+}
+
+DEFUN (labProbe, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{tf} =} labProbe ()
+@deftypefnx {} {@var{tf} =} labProbe (@var{source})
+@deftypefnx {} {@var{tf} =} labProbe ("any", @var{tag})
+@deftypefnx {} {@var{tf} =} labProbe (@var{source}, @var{tag})
+@deftypefnx {} {[@var{tf}, @var{source}, @var{tag}] =} labProbe (@dots{})
+Return true if a message for the current lab is ready to be received.
+
+The arguments select messages in the same way as for @code{labReceive}.
+If a message is available, the optional outputs @var{source} and @var{tag}
+identify it.
+@seealso{labReceive, labSend}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 2)
+    print_usage ();
+
+  int source = (nargin > 0 ? lab_source_arg ("labProbe", args(0))
+                           : lab_channels::any);
+
+  int tag = (nargin > 1 ? lab_tag_arg ("labProbe", args(1))
+                        : lab_channels::any);
+
+  bool found = (lab_channels::in_lab ()
+                && lab_channels::probe (source, tag));
+
+  if (! found)
+    return ovl (false, Matrix (), Matrix ());
+
+  return ovl (true, source, tag);
+}
+
+DEFUN (labBarrier, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} labBarrier ()
+Wait until every lab running the current @code{spmd} block has called
+@code{labBarrier}.
+
+Outside of an @code{spmd} block, @code{labBarrier} returns immediately.
+@seealso{labSend, labReceive, spmd}
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  if (lab_channels::in_lab ())
+    lab_channels::barrier ();
+
+  return ovl ();
+}
+
+/*
+%!assert (labindex (), 1)
+%!assert (numlabs (), 1)
+%!assert (labProbe (), false)
+
+%!test
+%! labBarrier ();
+
+%!error <no other labs are running> labReceive ()
+%!error <can not send a message to itself> labSend (1, 1)
+%!error <DEST must be between 1 and 1> labSend (1, 2)
+%!error <SOURCE must be between 1 and 1> labReceive (3)
+%!error <TAG must be nonnegative> labReceive ("any", -1)
+%!error labindex (1)
+%!error labSend (1)
+
+%!test
+%! spmd (3)
+%!   idx = labindex ();
+%!   n = numlabs ();
+%! end
+%! assert (idx, {1, 2, 3});
+%! assert (n, {3, 3, 3});
+
+## Pass a value around a ring of labs
+%!test
+%! spmd (4)
+%!   next = mod (labindex (), numlabs ()) + 1;
+%!   prev = mod (labindex () - 2, numlabs ()) + 1;
+%!   labSend (labindex () * 10, next);
+%!   [val, src] = labReceive (prev);
+%! end
+%! assert (val, {40, 10, 20, 30});
+%! assert (src, {4, 1, 2, 3});
+
+## Tags select messages regardless of order
+%!test
+%! spmd (2)
+%!   if (labindex () == 1)
+%!     labSend ("first", 2, 1);
+%!     labSend ([1, 2; 3, 4], 2, 2);
+%!     labBarrier ();
+%!   else
+%!     labBarrier ();
+%!     ready = labProbe (1, 2);
+%!     a = labReceive (1, 2);
+%!     b = labReceive ("any", 1);
+%!   end
+%! end
+%! assert (ready{2}, true);
+%! assert (a{2}, [1, 2; 3, 4]);
+%! assert (b{2}, "first");
+
+%!error <deadlock>
+%! spmd (2)
+%!   labReceive ();
+%! end
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_lab_comm_h)
+#define octave_lab_comm_h 1
+
+#include "octave-config.h"
+
+#include <string>
+#include <vector>
+
+#include "local-workers.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Message passing between the labs of an spmd block.
+//
+// Every lab is connected to the client by a pair of pipes.  The client
+// relays messages: labSend hands a message to the client, which queues
+// it for the destination lab until that lab asks for it with
+// labReceive.  The client only writes to a lab that is waiting for a
+// reply, so neither side can block the other indefinitely.  If every
+// running lab is waiting for a message that can never arrive, or for a
+// barrier that can't be completed, the client makes their requests
+// fail with an error instead of hanging.
+//
+// Outside of an spmd block, the current process is lab 1 of 1.
+
+class OCTINTERP_API lab_channels : public local_workers::link
+{
+public:
+
+  // Matches any source lab or any tag.
+  static const int any = -1;
+
+  lab_channels () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (lab_channels)
+
+  ~lab_channels ();
+
+  void open (int nlabs);
+
+  void attach (int k);
+
+  void serve (int nstarted);
+
+  // Index of the current lab, counting from 1.
+  static int labindex ();
+
+  static int numlabs ();
+
+  // TRUE in a lab process, FALSE in the client.
+  static bool in_lab ();
+
+  static void send (const std::string& data, int dest, int tag);
+
+  // Wait for a message from lab SOURCE with tag TAG (either may be
+  // ANY).  On return, SOURCE and TAG are set to those of the message.
+  static std::string receive (int& source, int& tag);
+
+  // TRUE if a message from lab SOURCE with tag TAG is available.  If
+  // so, SOURCE and TAG are set to those of the message.
+  static bool probe (int& source, int& tag);
+
+  static void barrier ();
+
+private:
+
+  void close_all ();
+
+  int m_nlabs = 0;
+
+  // Client ends of the pipes: the client reads requests from
+  // m_requests[k] and writes replies to m_replies[k].
+  std::vector<int> m_requests;
+  std::vector<int> m_replies;
+
+  // Lab ends of the same pipes.
+  std::vector<int> m_lab_requests;
+  std::vector<int> m_lab_replies;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -297,6 +297,8 @@ load_path::initialize (bool set_initial_path)
 void
 load_path::clear ()
 {
+  m_interpreter.get_symbol_table ().invalidate_function_caches ();
+
   m_dir_info_list.clear ();
 
   m_top_level_package.clear ();
@@ -385,6 +387,8 @@ load_path::remove (const std::string& dir_arg)
 {
   bool retval = false;
 
+  m_interpreter.get_symbol_table ().invalidate_function_caches ();
+
   if (! dir_arg.empty ())
     {
       if (sys::same_file (dir_arg, "."))
@@ -428,6 +432,8 @@ load_path::update ()
   // preserve the correct directory ordering for new files that
   // have appeared.
 
+  m_interpreter.get_symbol_table ().invalidate_function_caches ();
+
   m_top_level_package.clear ();
 
   m_package_map.clear ();
@@ -1097,6 +1103,8 @@ load_path::move (const dir_info& di, bool at_end, const std::string& pname)
 void
 load_path::add (const std::string& dir_arg, bool at_end, bool warn)
 {
+  m_interpreter.get_symbol_table ().invalidate_function_caches ();
+
   std::size_t len = dir_arg.length ();
 
   if (len > 1 && dir_arg.substr (len-2) == "//")
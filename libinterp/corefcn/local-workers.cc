@@ -0,0 +1,360 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "file-ops.h"
+#include "lo-sysdep.h"
+#include "mkostemp-wrapper.h"
+#include "oct-env.h"
+#include "oct-rand.h"
+#include "oct-syscalls.h"
+#include "oct-thread-pool.h"
+#include "quit.h"
+#include "unistd-wrappers.h"
+#include "wait-wrappers.h"
+
+#include "error.h"
+#include "local-workers.h"
+#include "octave.h"
+#include "pager.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Status codes written as the first byte of a worker's output file.
+static const char worker_success = 'R';
+static const char worker_error = 'E';
+
+// Exit codes of worker processes.
+static const int worker_exit_ok = 0;
+static const int worker_exit_error = 1;
+static const int worker_exit_interrupt = 2;
+static const int worker_exit_abort = 3;
+
+// Derive new random number streams from the current state of the
+// generators, so that every worker draws different numbers and results
+// are still repeatable.  The parent advances its own streams the same
+// way once the workers are done.
+
+static void
+split_random_streams (uint32_t k)
+{
+  static const char *dists[]
+    = { "uniform", "normal", "exponential", "poisson", "gamma" };
+
+  for (const char *d : dists)
+    {
+      uint32NDArray s = rand::state (d);
+
+      octave_idx_type n = s.numel ();
+
+      uint32NDArray t (dim_vector (n + 1, 1));
+
+      std::copy_n (s.data (), n, t.fortran_vec ());
+
+      t(n) = k;
+
+      rand::state (t, d);
+    }
+}
+
+// Write all of DATA to the file descriptor FD.
+
+static bool
+write_all (int fd, const std::string& data)
+{
+  const char *p = data.data ();
+  std::size_t n = data.size ();
+
+  while (n > 0)
+    {
+      ssize_t k = octave_write_wrapper (fd, p, n);
+
+      if (k < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          return false;
+        }
+
+      p += k;
+      n -= k;
+    }
+
+  return true;
+}
+
+// Create a temporary file for the output of a worker.  Return a
+// descriptor for writing and open IS for reading.  The file is removed
+// at once, so it can only be reached through these two handles.
+
+static int
+create_output_file (std::ifstream& is)
+{
+  std::string tmpl = sys::file_ops::concat (sys::env::get_temp_directory (),
+                                            "oct-XXXXXX");
+
+  int fd = octave_mkostemp_wrapper (&tmpl[0]);
+
+  if (fd < 0)
+    return -1;
+
+  is = sys::ifstream (tmpl.c_str (), std::ios::in | std::ios::binary);
+
+  sys::unlink (tmpl);
+
+  if (! is)
+    {
+      octave_close_wrapper (fd);
+      return -1;
+    }
+
+  return fd;
+}
+
+static int
+run_worker (int k, const local_workers::task& fcn,
+            local_workers::link *channels, int fd)
+{
+  int status = worker_exit_ok;
+
+  std::ostringstream buf;
+
+  std::string id;
+  std::string msg;
+
+  try
+    {
+      split_random_streams (k + 1);
+
+      if (channels)
+        channels->attach (k);
+
+      fcn (k, buf);
+    }
+  catch (const execution_exception& ee)
+    {
+      status = worker_exit_error;
+      id = ee.identifier ();
+      msg = ee.message ();
+    }
+  catch (const interrupt_exception&)
+    {
+      status = worker_exit_interrupt;
+    }
+  catch (...)
+    {
+      status = worker_exit_abort;
+    }
+
+  flush_stdout ();
+  std::cout.flush ();
+  std::cerr.flush ();
+
+  std::string output;
+
+  if (status == worker_exit_ok)
+    output = worker_success + buf.str ();
+  else if (status == worker_exit_error)
+    {
+      output = worker_error + id;
+      output += '\0';
+      output += msg;
+    }
+
+  if (! write_all (fd, output))
+    return worker_exit_abort;
+
+  return status;
+}
+
+bool
+local_workers::available ()
+{
+  return octave_have_fork () && ! application::is_multi_threaded ();
+}
+
+std::vector<std::string>
+local_workers::run (int nworkers, const task& fcn, link *channels)
+{
+  std::vector<std::ifstream> outputs (nworkers);
+  std::vector<int> fds (nworkers, -1);
+  std::vector<pid_t> pids (nworkers, -1);
+
+  for (int k = 0; k < nworkers; k++)
+    {
+      fds[k] = create_output_file (outputs[k]);
+
+      if (fds[k] < 0)
+        {
+          std::string msg = std::strerror (errno);
+
+          for (int j = 0; j < k; j++)
+            octave_close_wrapper (fds[j]);
+
+          error ("unable to create temporary file for worker output: %s",
+                 msg.c_str ());
+        }
+    }
+
+  // Anything still buffered would otherwise be written once by the
+  // parent and once more by every worker.
+  flush_stdout ();
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::fflush (nullptr);
+
+  if (channels)
+    channels->open (nworkers);
+
+  std::string fork_msg;
+
+  int nstarted = 0;
+
+  for (int k = 0; k < nworkers; k++)
+    {
+      pid_t pid = sys::fork (fork_msg);
+
+      if (pid == 0)
+        {
+          // The threads of the parent's thread pool do not exist here.
+          thread_pool::reset_in_child ();
+
+          // Skip exit handlers and destructors; they belong to the
+          // parent.
+          std::_Exit (run_worker (k, fcn, channels, fds[k]));
+        }
+
+      if (pid < 0)
+        break;
+
+      pids[k] = pid;
+      nstarted++;
+    }
+
+  for (int k = 0; k < nworkers; k++)
+    octave_close_wrapper (fds[k]);
+
+  if (channels)
+    channels->serve (nstarted);
+
+  split_random_streams (0);
+
+  std::vector<int> exit_codes (nworkers, -1);
+
+  for (int k = 0; k < nworkers; k++)
+    {
+      if (pids[k] < 0)
+        continue;
+
+      int status = 0;
+      std::string msg;
+
+      pid_t pid;
+
+      do
+        pid = sys::waitpid (pids[k], &status, 0, msg);
+      while (pid < 0 && errno == EINTR);
+
+      if (pid == pids[k] && octave_wifexited_wrapper (status))
+        exit_codes[k] = octave_wexitstatus_wrapper (status);
+    }
+
+  std::vector<std::string> retval (nworkers);
+
+  int failed = -1;
+  std::string err_id;
+  std::string err_msg;
+
+  for (int k = 0; k < nworkers; k++)
+    {
+      std::string contents;
+
+      if (pids[k] >= 0)
+        {
+          std::ostringstream buf;
+          buf << outputs[k].rdbuf ();
+          contents = buf.str ();
+        }
+
+      outputs[k].close ();
+
+      if (failed >= 0)
+        continue;
+
+      if (exit_codes[k] == worker_exit_ok && ! contents.empty ()
+          && contents[0] == worker_success)
+        retval[k] = contents.substr (1);
+      else
+        {
+          failed = k;
+
+          if (exit_codes[k] == worker_exit_error && ! contents.empty ()
+              && contents[0] == worker_error)
+            {
+              std::size_t pos = contents.find ('\0', 1);
+
+              if (pos != std::string::npos)
+                {
+                  err_id = contents.substr (1, pos-1);
+                  err_msg = contents.substr (pos+1);
+                }
+            }
+        }
+    }
+
+  // Workers receive interrupts too, so give the parent a chance to
+  // notice one before reporting the workers' failure.
+  octave_quit ();
+
+  if (pids[0] < 0)
+    error ("unable to start worker process: %s", fork_msg.c_str ());
+
+  if (failed >= 0)
+    {
+      if (! err_msg.empty ())
+        error_with_id (err_id.c_str (), "%s", err_msg.c_str ());
+      else if (pids[failed] < 0)
+        error ("unable to start worker process: %s", fork_msg.c_str ());
+      else
+        error ("worker process %d terminated abnormally", failed + 1);
+    }
+
+  return retval;
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_local_workers_h)
+#define octave_local_workers_h 1
+
+#include "octave-config.h"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Run a task in several forked copies of the interpreter on the local
+// machine.
+//
+// Each worker is a child process that starts with a copy of the
+// parent's entire state, runs the task for its own worker index, and
+// sends whatever the task writes to its output stream back to the
+// parent.  The parent collects the outputs in worker order.  If any
+// worker fails, the error of the worker with the lowest index is
+// raised in the parent after all workers have finished.
+//
+// Every worker draws from its own random number streams, derived from
+// the state of the generators when the workers are started.
+
+class OCTINTERP_API local_workers
+{
+public:
+
+  typedef std::function<void (int, std::ostream&)> task;
+
+  // Communication channels between running workers.
+
+  class link
+  {
+  public:
+
+    link () = default;
+
+    OCTAVE_DISABLE_COPY_MOVE (link)
+
+    virtual ~link () = default;
+
+    // Called in the parent before any worker is started.
+    virtual void open (int nworkers) = 0;
+
+    // Called in worker K before it runs its task.
+    virtual void attach (int k) = 0;
+
+    // Called in the parent once the first NSTARTED workers have been
+    // started.  Must return once all of them have stopped
+    // communicating.
+    virtual void serve (int nstarted) = 0;
+  };
+
+  // TRUE if worker processes can be started.  Forking is unsafe once
+  // other threads (the GUI, for example) are running.  The threads of
+  // octave::thread_pool are the exception: they only run during a
+  // parallel loop, which never contains a fork, and each worker process
+  // starts with an empty pool.
+  static bool available ();
+
+  static std::vector<std::string>
+  run (int nworkers, const task& fcn, link *channels = nullptr);
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -549,6 +549,21 @@ the first index of the minimum value(s).  Thus,
 %!test <51307>
 %! assert (min (sparse ([4, 2i 4.999; -2, 2, 3+4i])), sparse ([-2, 2, 4.999]));
 
+## NaN values are ignored in vectors of any length
+%!test
+%! for n = [1, 3, 8, 17, 64, 101]
+%!   x = -(1:n);
+%!   x(1:2:end) = NaN;
+%!   if (n > 1)
+%!     assert (min (x), -2*floor (n/2));
+%!     assert (min (single (x)), single (-2*floor (n/2)));
+%!   endif
+%!   assert (isnan (min (NaN (n, 1))));
+%!   assert (isnan (min (NaN (n, 1, "single"))));
+%!   x(end) = -Inf;
+%!   assert (min (x), -Inf);
+%! endfor
+
 ## Test dimension argument
 %!test
 %! x = reshape (1:8, [2,2,2]);
@@ -658,6 +673,13 @@ the first index of the minimum value(s).  Thus,
 %!warning <second argument is ignored> min ([1 2 3 4], 2, 2);
 %!error <wrong type argument 'cell'> min ({1 2 3 4})
 %!error <cannot compute min \(cell, scalar\)> min ({1, 2, 3}, 2)
+
+%!demo
+%! ## Minimum of a vector with a few NaNs, compared with removing the NaNs
+%! ## first.  Compare the times with those of an older build to see the
+%! ## effect of the vectorized NaN-skipping kernels.
+%! init = "x = rand (n, 1); x(1:100:n) = NaN;";
+%! speed ("min (x)", init, [1e4, 1e7], "min (x(! isnan (x)))");
 */
 
 DEFUN (max, args, nargout,
@@ -769,6 +791,21 @@ the first index of the maximum value(s).  Thus,
 %!assert (max (sparse ([1; -10; 5; -2])), sparse(5))
 %!assert (max (sparse ([4, 2i 4.999; -2, 2, 3+4i])), sparse ([4, 2i, 3+4i]))
 
+## NaN values are ignored in vectors of any length
+%!test
+%! for n = [1, 3, 8, 17, 64, 101]
+%!   x = 1:n;
+%!   x(1:2:end) = NaN;
+%!   if (n > 1)
+%!     assert (max (x), 2*floor (n/2));
+%!     assert (max (single (x)), single (2*floor (n/2)));
+%!   endif
+%!   assert (isnan (max (NaN (n, 1))));
+%!   assert (isnan (max (NaN (n, 1, "single"))));
+%!   x(end) = Inf;
+%!   assert (max (x), Inf);
+%! endfor
+
 ## Test dimension argument
 %!test
 %! x = reshape (1:8, [2,2,2]);
@@ -884,6 +921,11 @@ the first index of the maximum value(s).  Thus,
 %!error <wrong type argument 'cell'> max ({1 2 3 4})
 %!error <cannot compute max \(cell, scalar\)> max ({1, 2, 3}, 2)
 
+%!demo
+%! ## Maximum of a single precision vector with a few NaNs, compared with
+%! ## removing the NaNs first.
+%! init = "x = single (rand (n, 1)); x(1:100:n) = NaN;";
+%! speed ("max (x)", init, [1e4, 1e7], "max (x(! isnan (x)))");
 */
 
 template <typename ArrayType>
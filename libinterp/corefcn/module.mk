@@ -48,9 +48,11 @@ COREFCN_INC = \
   %reldir%/hook-fcn.h \
   %reldir%/input.h \
   %reldir%/interpreter.h \
+  %reldir%/lab-comm.h \
   %reldir%/latex-text-renderer.h \
   %reldir%/load-path.h \
   %reldir%/load-save.h \
+  %reldir%/local-workers.h \
   %reldir%/ls-ascii-helper.h \
   %reldir%/ls-hdf5.h \
   %reldir%/ls-mat-ascii.h \
@@ -113,6 +115,7 @@ NOINSTALL_COREFCN_INC = \
 
 COREFCN_SRC = \
   %reldir%/Cell.cc \
+  %reldir%/__accumarray__.cc \
   %reldir%/__betainc__.cc \
   %reldir%/__contourc__.cc \
   %reldir%/__dsearchn__.cc \
@@ -125,8 +128,10 @@ COREFCN_SRC = \
   %reldir%/__isprimelarge__.cc \
   %reldir%/__lin_interpn__.cc \
   %reldir%/__magick_read__.cc \
+  %reldir%/__movfun__.cc \
   %reldir%/__pchip_deriv__.cc \
   %reldir%/__qp__.cc \
+  %reldir%/__unique__.cc \
   %reldir%/amd.cc \
   %reldir%/auto-shlib.cc \
   %reldir%/balance.cc \
@@ -198,9 +203,11 @@ COREFCN_SRC = \
   %reldir%/jsondecode.cc \
   %reldir%/jsonencode.cc \
   %reldir%/kron.cc \
+  %reldir%/lab-comm.cc \
   %reldir%/latex-text-renderer.cc \
   %reldir%/load-path.cc \
   %reldir%/load-save.cc \
+  %reldir%/local-workers.cc \
   %reldir%/lookup.cc \
   %reldir%/ls-ascii-helper.cc \
   %reldir%/ls-hdf5.cc \
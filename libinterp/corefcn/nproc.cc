@@ -27,10 +27,15 @@
 #  include "config.h"
 #endif
 
+#include <limits>
+
+#include "lo-mappers.h"
 #include "nproc-wrapper.h"
+#include "oct-thread-pool.h"
 
 #include "defun.h"
 #include "error.h"
+#include "ovl.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -112,4 +117,88 @@ same as @code{current}, but overridable through the
 %!error nproc ("no_valid_option")
 */
 
+DEFUN (maxNumCompThreads, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} maxNumCompThreads ()
+@deftypefnx {} {@var{n_old} =} maxNumCompThreads (@var{n})
+@deftypefnx {} {@var{n_old} =} maxNumCompThreads ("automatic")
+Query or set the maximum number of computational threads.
+
+Element-wise operations and mapper functions on large arrays are split
+between at most @var{n} threads.  By default, @var{n} is the number of
+available processors as determined by the @code{nproc} function.
+
+If called with a positive integer @var{n}, use at most @var{n} threads and
+return the previous value.  If called with the argument
+@qcode{"automatic"}, restore the default.  Calling with @var{n} equal to 1
+disables multithreading.
+@seealso{nproc}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  octave_value retval = thread_pool::num_threads ();
+
+  if (nargin == 1)
+    {
+      octave_value arg = args(0);
+
+      if (arg.is_string () && arg.string_value () == "automatic")
+        thread_pool::set_num_threads (0);
+      else if (arg.isnumeric () && arg.is_scalar_type () && ! arg.iscomplex ())
+        {
+          double dval = arg.double_value ();
+
+          if (! math::isinteger (dval) || dval < 1
+              || dval > std::numeric_limits<int>::max ())
+            error ("maxNumCompThreads: invalid input argument");
+
+          thread_pool::set_num_threads (static_cast<int> (dval));
+        }
+      else
+        error ("maxNumCompThreads: invalid input argument");
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! maxNumCompThreads ("automatic");
+%! assert (maxNumCompThreads (), nproc ());
+
+%!test
+%! n_old = maxNumCompThreads (4);
+%! unwind_protect
+%!   assert (maxNumCompThreads (), 4);
+%!   x = 1:1e6;
+%!   assert (sum (sqrt (x) .* 2 + x), sum (2 * sqrt (x) + x), -1e-12);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
+%!test
+%! n_old = maxNumCompThreads (3);
+%! unwind_protect
+%!   x = linspace (-2, 2, 200001);
+%!   y = sqrt (x);
+%!   assert (iscomplex (y));
+%!   assert (real (y(end)), sqrt (2));
+%!   assert (y(1), sqrt (-2));
+%!   y = sqrt (abs (x));
+%!   assert (isreal (y));
+%!   assert (y, abs (x) .^ 0.5, eps);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
+%!error <invalid input argument> maxNumCompThreads ([1, 2])
+%!error <invalid input argument> maxNumCompThreads ("foobar")
+%!error <invalid input argument> maxNumCompThreads (0)
+%!error <invalid input argument> maxNumCompThreads (1.5)
+*/
+
 OCTAVE_END_NAMESPACE(octave)
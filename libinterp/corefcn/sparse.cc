@@ -30,6 +30,9 @@
 #include <cstdlib>
 #include <string>
 
+#include "sparse-assembly.h"
+
+#include "Cell.h"
 #include "variables.h"
 #include "utils.h"
 #include "pager.h"
@@ -282,6 +285,135 @@ sprandsym, spconvert, spfun}
 %!assert (1)
 */
 
+DEFUN (__sparse_assemble__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{C} =} __sparse_assemble__ (@var{i}, @var{j}, @var{SV}, @var{m}, @var{n})
+@deftypefnx {} {@var{C} =} __sparse_assemble__ (@dots{}, "unique")
+Return a cell array holding @code{sparse (@var{i}, @var{j}, @var{SV}(:,k),
+@var{m}, @var{n})} for each column @var{k} of @var{SV}.
+
+The pattern of the triplets is computed once and used for all columns.
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  bool summation = true;
+  if (nargin == 6)
+    {
+      std::string opt = args(5).xstring_value ("__sparse_assemble__: option must be a string");
+      if (opt == "unique")
+        summation = false;
+      else if (opt != "sum" && opt != "summation")
+        error ("__sparse_assemble__: invalid option: %s", opt.c_str ());
+
+      nargin--;
+    }
+
+  if (nargin != 5)
+    print_usage ();
+
+  octave_idx_type m = args(3).strict_idx_type_value ("__sparse_assemble__: M must be a non-negative integer");
+  octave_idx_type n = args(4).strict_idx_type_value ("__sparse_assemble__: N must be a non-negative integer");
+
+  if (m < 0 || n < 0)
+    error ("__sparse_assemble__: dimensions M and N must be non-negative");
+
+  octave_value arg = args(2);
+
+  if (! arg.isfloat () || arg.ndims () > 2)
+    err_wrong_type_arg ("__sparse_assemble__", arg);
+
+  octave_idx_type nt = arg.rows ();
+  octave_idx_type nv = arg.columns ();
+
+  int argidx = 0;    // index being checked when index_vector throws
+  try
+    {
+      idx_vector i = args(0).index_vector ();
+      argidx = 1;
+      idx_vector j = args(1).index_vector ();
+
+      if (i.extent (m) > m || j.extent (n) > n)
+        error ("__sparse_assemble__: index out of bound");
+
+      octave_idx_type il = i.length (m);
+      octave_idx_type jl = j.length (n);
+
+      if ((il != 1 && il != nt) || (jl != 1 && jl != nt))
+        error ("__sparse_assemble__: dimension mismatch");
+
+      sparse_assembly p (i, j, m, n, nt);
+
+      Cell retval (1, nv);
+
+      if (arg.iscomplex ())
+        {
+          ComplexMatrix sv = arg.complex_matrix_value ();
+
+          for (octave_idx_type k = 0; k < nv; k++)
+            retval(k) = SparseComplexMatrix (Sparse<Complex> (sv.column (k), p,
+                                                              summation));
+        }
+      else
+        {
+          Matrix sv = arg.matrix_value ();
+
+          for (octave_idx_type k = 0; k < nv; k++)
+            retval(k) = SparseMatrix (Sparse<double> (sv.column (k), p,
+                                                      summation));
+        }
+
+      return ovl (retval);
+    }
+  catch (index_exception& ie)
+    {
+      // Rethrow to allow more info to be reported later.
+      ie.set_pos_if_unset (2, argidx+1);
+      throw;
+    }
+}
+
+/*
+%!test
+%! i = [3, 1, 2, 1, 3, 2, 3];
+%! j = [2, 1, 3, 1, 2, 1, 3];
+%! SV = [1:7; 7:-1:1; 1, 1, 1, -1, 0, 0, 2]';
+%! C = __sparse_assemble__ (i, j, SV, 3, 4);
+%! assert (size (C), [1, 3]);
+%! for k = 1:3
+%!   S = sparse (i, j, SV(:,k), 3, 4);
+%!   assert (C{k}, S);
+%!   assert (nnz (C{k}), nnz (S));
+%! endfor
+%! ## Sums that cancel and zero values are not stored.
+%! assert (nnz (C{3}), 3);
+%! C = __sparse_assemble__ (i, j, SV, 3, 4, "unique");
+%! for k = 1:3
+%!   assert (C{k}, sparse (i, j, SV(:,k), 3, 4, "unique"));
+%! endfor
+
+%!test
+%! C = __sparse_assemble__ (2, [1, 3, 1], [1, 2i; 3, 4; 5, 0], 2, 3);
+%! assert (C{1}, sparse ([0, 0, 0; 6, 0, 3]));
+%! assert (C{2}, sparse ([0, 0, 0; 2i, 0, 4]));
+
+%!test
+%! n = 200000;
+%! i = mod ((1:n)' * 7919, 1000) + 1;
+%! j = mod ((1:n)' * 104729, 997) + 1;
+%! SV = [sin(1:n)', cos(1:n)', ones(n, 1)];
+%! C = __sparse_assemble__ (i, j, SV, 1000, 997);
+%! for k = 1:3
+%!   assert (C{k}, sparse (i, j, SV(:,k), 1000, 997), -1e-12);
+%! endfor
+
+%!error __sparse_assemble__ ()
+%!error <index out of bound> __sparse_assemble__ (3, 1, 1, 2, 2)
+%!error <dimension mismatch> __sparse_assemble__ ([1, 2], [1, 2], [1; 2; 3], 2, 2)
+%!error <invalid option> __sparse_assemble__ (1, 1, 1, 2, 2, "foo")
+*/
+
 DEFUN (spalloc, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{s} =} spalloc (@var{m}, @var{n}, @var{nz})
@@ -373,9 +373,18 @@ public:
       m_values (num_symbols, octave_value ()),
       m_flags (num_symbols, LOCAL),
       m_auto_vars (NUM_AUTO_VARS, octave_value ())
-  { }
+  {
+    m_slot_values = &m_values;
+    m_slot_flags = &m_flags;
+  }
 
-  base_value_stack_frame (const base_value_stack_frame& elt) = default;
+  base_value_stack_frame (const base_value_stack_frame& elt)
+    : stack_frame (elt), m_values (elt.m_values), m_flags (elt.m_flags),
+      m_auto_vars (elt.m_auto_vars)
+  {
+    m_slot_values = &m_values;
+    m_slot_flags = &m_flags;
+  }
 
   base_value_stack_frame&
   operator = (const base_value_stack_frame& elt) = delete;
@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 class octave_value;
 class octave_value_list;
@@ -146,7 +147,8 @@ public:
     : m_evaluator (tw), m_is_closure_context (false),
       m_line (-1), m_column (-1), m_index (index),
       m_parent_link (parent_link), m_static_link (static_link),
-      m_access_link (access_link), m_dispatch_class ()
+      m_access_link (access_link), m_dispatch_class (),
+      m_slot_values (nullptr), m_slot_flags (nullptr)
   { }
 
   // Compiled function.
@@ -351,6 +353,11 @@ public:
 
   bool is_defined (const symbol_record& sym) const
   {
+    const octave_value *slot = local_slot (sym);
+
+    if (slot)
+      return slot->is_defined ();
+
     octave_value val = varval (sym);
 
     return val.is_defined ();
@@ -358,9 +365,7 @@ public:
 
   bool is_variable (const symbol_record& sym) const
   {
-    octave_value val = varval (sym);
-
-    return val.is_defined ();
+    return is_defined (sym);
   }
 
   bool is_variable (const std::string& name) const
@@ -443,6 +448,50 @@ public:
 
   virtual octave_value varval (std::size_t data_offset) const;
 
+  // Return a pointer to the value of SYM if it is a local variable
+  // stored in this frame and nullptr otherwise.  The value is found
+  // directly from the slot that was assigned to SYM when the function
+  // was parsed or the variable was created, without following access
+  // links or calling any virtual functions.  Frames that do not store
+  // their own values (scripts and compiled functions) have no slots.
+
+  const octave_value * local_slot (const symbol_record& sym) const
+  {
+    if (m_slot_values && sym.frame_offset () == 0)
+      {
+        std::size_t data_offset = sym.data_offset ();
+
+        if (data_offset < m_slot_values->size ()
+            && (*m_slot_flags)[data_offset] == LOCAL)
+          return &(*m_slot_values)[data_offset];
+      }
+
+    return nullptr;
+  }
+
+  octave_value * local_slot (const symbol_record& sym)
+  {
+    const stack_frame *frame = this;
+
+    return const_cast<octave_value *> (frame->local_slot (sym));
+  }
+
+  // Like varval and varref, but use the slot of SYM if possible.
+
+  octave_value slot_varval (const symbol_record& sym) const
+  {
+    const octave_value *slot = local_slot (sym);
+
+    return slot ? *slot : varval (sym);
+  }
+
+  octave_value& slot_varref (const symbol_record& sym)
+  {
+    octave_value *slot = local_slot (sym);
+
+    return slot ? *slot : varref (sym);
+  }
+
   octave_value varval (const std::string& name) const
   {
     symbol_record sym = lookup_symbol (name);
@@ -459,7 +508,7 @@ public:
 
   void assign (const symbol_record& sym, const octave_value& val)
   {
-    octave_value& lhs = varref (sym);
+    octave_value& lhs = slot_varref (sym);
 
     if (lhs.get_count () == 1)
       lhs.call_object_destructor ();
@@ -485,10 +534,10 @@ public:
         if (op == octave_value::op_asn_eq)
           assign (sym, rhs);
         else
-          varref (sym).assign (op, rhs);
+          slot_varref (sym).assign (op, rhs);
       }
     else
-      varref (sym).assign (op, type, idx, rhs);
+      slot_varref (sym).assign (op, type, idx, rhs);
   }
 
   void non_const_unary_op (octave_value::unary_op op,
@@ -497,15 +546,15 @@ public:
                            const std::list<octave_value_list>& idx)
   {
     if (idx.empty ())
-      varref (sym).non_const_unary_op (op);
+      slot_varref (sym).non_const_unary_op (op);
     else
-      varref (sym).non_const_unary_op (op, type, idx);
+      slot_varref (sym).non_const_unary_op (op, type, idx);
   }
 
   octave_value value (const symbol_record& sym, const std::string& type,
                       const std::list<octave_value_list>& idx) const
   {
-    octave_value retval = varval (sym);
+    octave_value retval = slot_varval (sym);
 
     if (! idx.empty ())
       {
@@ -631,6 +680,12 @@ protected:
   // Allow function handles to temporarily store their dispatch class
   // in the call stack.
   std::string m_dispatch_class;
+
+  // For frames that store the values of their variables, the values
+  // and scope flags indexed by data offset.  These point to members of
+  // the derived class and are set by its constructor.
+  std::vector<octave_value> *m_slot_values;
+  std::vector<scope_flags> *m_slot_flags;
 };
 
 OCTAVE_END_NAMESPACE(octave)
@@ -51,8 +51,8 @@
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 symbol_table::symbol_table (interpreter& interp)
-  : m_interpreter (interp), m_fcn_table (), m_class_precedence_table (),
-    m_parent_map ()
+  : m_interpreter (interp), m_generation (1), m_fcn_table (),
+    m_class_precedence_table (), m_parent_map ()
 {
   install_builtins ();
 }
@@ -339,6 +339,8 @@ void
 symbol_table::install_cmdline_function (const std::string& name,
                                         const octave_value& fcn)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -365,6 +367,8 @@ symbol_table::install_local_function (const std::string& name,
                                       const octave_value& fcn,
                                       const std::string& file_name)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -387,6 +391,8 @@ void
 symbol_table::install_user_function (const std::string& name,
                                      const octave_value& fcn)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -411,6 +417,8 @@ void
 symbol_table::install_built_in_function (const std::string& name,
     const octave_value& fcn)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -436,6 +444,8 @@ symbol_table::install_built_in_function (const std::string& name,
 void
 symbol_table::clear_functions (bool force)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -451,6 +461,8 @@ symbol_table::clear_function (const std::string& name)
 void
 symbol_table::clear_function_pattern (const std::string& pat)
 {
+  invalidate_function_caches ();
+
   symbol_match pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -467,6 +479,8 @@ symbol_table::clear_function_pattern (const std::string& pat)
 void
 symbol_table::clear_function_regexp (const std::string& pat)
 {
+  invalidate_function_caches ();
+
   regexp pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -483,6 +497,8 @@ symbol_table::clear_function_regexp (const std::string& pat)
 void
 symbol_table::clear_user_function (const std::string& name)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -500,6 +516,8 @@ symbol_table::clear_user_function (const std::string& name)
 void
 symbol_table::clear_dld_function (const std::string& name)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -514,6 +532,8 @@ symbol_table::clear_dld_function (const std::string& name)
 void
 symbol_table::clear_mex_functions ()
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -528,6 +548,8 @@ bool
 symbol_table::set_class_relationship (const std::string& sup_class,
                                       const std::string& inf_class)
 {
+  invalidate_function_caches ();
+
   if (is_superiorto (inf_class, sup_class))
     return false;
 
@@ -569,6 +591,8 @@ void
 symbol_table::alias_built_in_function (const std::string& alias,
                                        const std::string& name)
 {
+  invalidate_function_caches ();
+
   octave_value fcn = find_built_in_function (name);
 
   if (fcn.is_defined ())
@@ -587,6 +611,8 @@ void
 symbol_table::install_built_in_dispatch (const std::string& name,
     const std::string& klass)
 {
+  invalidate_function_caches ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -690,6 +716,8 @@ void
 symbol_table::add_to_parent_map (const std::string& classname,
                                  const std::list<std::string>& parent_list)
 {
+  invalidate_function_caches ();
+
   m_parent_map[classname] = parent_list;
 }
 
@@ -735,6 +763,64 @@ symbol_table::get_fcn_info (const std::string& name)
   return p != m_fcn_table.end () ? &p->second : nullptr;
 }
 
+octave_value
+fcn_lookup_cache::find_function (symbol_table& symtab,
+                                 const std::string& name,
+                                 const octave_value_list& args)
+{
+  builtin_type_t dispatch_type = btyp_unknown;
+
+  if (! args.empty ())
+    {
+      get_dispatch_type (args, dispatch_type);
+
+      if (dispatch_type == btyp_unknown)
+        return symtab.find_function (name, args);
+    }
+
+  symbol_scope scope = symtab.current_scope ();
+
+  std::shared_ptr<void> scope_rep = scope.get_rep ();
+
+  // Compare owners rather than pointers so that a new scope allocated
+  // at the address of a deleted one does not match.
+
+  if (m_generation == symtab.generation ()
+      && m_dispatch_type == dispatch_type
+      && ! m_scope.owner_before (scope_rep)
+      && ! scope_rep.owner_before (m_scope))
+    return octave_value (m_fcn, true);
+
+  octave_value fcn = symtab.find_function (name, args, scope);
+
+  // The lookup itself may update the load path, so the generation
+  // count is read again after it.
+
+  // Only cache functions that are also held elsewhere, by the symbol
+  // table or by the scope that defines them.
+
+  if (fcn.is_defined () && fcn.get_count () > 1)
+    {
+      m_generation = symtab.generation ();
+      m_scope = scope_rep;
+      m_dispatch_type = dispatch_type;
+      m_fcn = fcn.internal_rep ();
+    }
+  else
+    clear ();
+
+  return fcn;
+}
+
+void
+fcn_lookup_cache::clear ()
+{
+  m_generation = 0;
+  m_scope.reset ();
+  m_dispatch_type = btyp_unknown;
+  m_fcn = nullptr;
+}
+
 octave_value
 symbol_table::dump_fcn_table_map () const
 {
@@ -877,6 +963,90 @@ updated to use some other function.
 %! assert (strcmp (which ("bar"), "command-line function"));
 %! clear bar;
 %! assert (! strcmp (which ("bar"), ""));
+
+## Call sites that cache the result of a function lookup must notice
+## changes to function definitions and to the load path.
+%!test
+%! r = zeros (1, 2);
+%! unwind_protect
+%!   for i = 1:2
+%!     eval (sprintf ("function r = __fcn_cache_test1__ (), r = %d; endfunction", i));
+%!     r(i) = __fcn_cache_test1__;
+%!   endfor
+%!   assert (r, [1, 2]);
+%! unwind_protect_cleanup
+%!   clear -f __fcn_cache_test1__;
+%! end_unwind_protect
+
+%!test
+%! dir1 = tempname ();
+%! dir2 = tempname ();
+%! warning ("off", "Octave:shadowed-function", "local");
+%! unwind_protect
+%!   mkdir (dir1);
+%!   mkdir (dir2);
+%!   fid = fopen (fullfile (dir1, "__fcn_cache_test2__.m"), "w");
+%!   fprintf (fid, "function r = __fcn_cache_test2__ (x)\n  r = x + 1;\nendfunction\n");
+%!   fclose (fid);
+%!   fid = fopen (fullfile (dir2, "__fcn_cache_test2__.m"), "w");
+%!   fprintf (fid, "function r = __fcn_cache_test2__ (x)\n  r = x + 2;\nendfunction\n");
+%!   fclose (fid);
+%!   addpath (dir1);
+%!   r = zeros (1, 3);
+%!   for i = 1:3
+%!     if (i == 2)
+%!       addpath (dir2);
+%!     elseif (i == 3)
+%!       rmpath (dir2);
+%!     endif
+%!     r(i) = __fcn_cache_test2__ (10);
+%!   endfor
+%!   assert (r, [11, 12, 11]);
+%! unwind_protect_cleanup
+%!   rmpath (dir1);
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (dir1, "s");
+%!   sts = rmdir (dir2, "s");
+%! end_unwind_protect
+
+## A function that calls itself is freed when it is cleared
+%!test
+%! global __fcn_cache_test3_freed__
+%! __fcn_cache_test3_freed__ = false;
+%! dir1 = tempname ();
+%! unwind_protect
+%!   mkdir (dir1);
+%!   fid = fopen (fullfile (dir1, "__fcn_cache_test3__.m"), "w");
+%!   fprintf (fid, "function r = __fcn_cache_test3__ (n)\n");
+%!   fprintf (fid, "  persistent c\n");
+%!   fprintf (fid, "  if (isempty (c))\n");
+%!   fprintf (fid, "    c = onCleanup (@__fcn_cache_test3_mark__);\n");
+%!   fprintf (fid, "  endif\n");
+%!   fprintf (fid, "  if (n > 0)\n");
+%!   fprintf (fid, "    r = __fcn_cache_test3__ (n-1) + 1;\n");
+%!   fprintf (fid, "  else\n");
+%!   fprintf (fid, "    r = 0;\n");
+%!   fprintf (fid, "  endif\n");
+%!   fprintf (fid, "endfunction\n");
+%!   fclose (fid);
+%!   fid = fopen (fullfile (dir1, "__fcn_cache_test3_mark__.m"), "w");
+%!   fprintf (fid, "function __fcn_cache_test3_mark__ ()\n");
+%!   fprintf (fid, "  global __fcn_cache_test3_freed__\n");
+%!   fprintf (fid, "  __fcn_cache_test3_freed__ = true;\n");
+%!   fprintf (fid, "endfunction\n");
+%!   fclose (fid);
+%!   addpath (dir1);
+%!   assert (__fcn_cache_test3__ (3), 3);
+%!   assert (__fcn_cache_test3__ (3), 3);
+%!   assert (! __fcn_cache_test3_freed__);
+%!   clear __fcn_cache_test3__;
+%!   assert (__fcn_cache_test3_freed__);
+%! unwind_protect_cleanup
+%!   rmpath (dir1);
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (dir1, "s");
+%!   clear -global __fcn_cache_test3_freed__;
+%! end_unwind_protect
 */
 
 OCTAVE_END_NAMESPACE(octave)
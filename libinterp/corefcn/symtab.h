@@ -28,9 +28,11 @@
 
 #include "octave-config.h"
 
+#include <cstddef>
 #include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -181,10 +183,21 @@ public:
 
   fcn_info * get_fcn_info (const std::string& name);
 
+  // The generation count is incremented whenever a change to the load
+  // path, a function definition, or a function file might change the
+  // result of looking up a function name.  Call sites that cache the
+  // result of a lookup must discard it when the count changes.
+
+  std::size_t generation () const { return m_generation; }
+
+  void invalidate_function_caches () { m_generation++; }
+
 private:
 
   interpreter& m_interpreter;
 
+  std::size_t m_generation;
+
   typedef std::map<std::string, octave_value>::const_iterator
     global_symbols_const_iterator;
   typedef std::map<std::string, octave_value>::iterator
@@ -224,6 +237,48 @@ private:
   void install_builtins ();
 };
 
+// Cache for the function found by looking up a name at a single call
+// site.  The cached function is reused until the generation count of
+// the symbol table changes or the call is made from a different scope
+// or with arguments of a different built-in type.  Calls with objects
+// as arguments are dispatched on their class and are never cached.
+//
+// The cache does not own the function.  A function that calls itself,
+// directly or through others, would otherwise keep its own parse tree
+// alive after it is cleared.  The symbol table or the scope that owns
+// the function only drops it when the generation count changes or the
+// scope is deleted, so the cached pointer is valid whenever it is used.
+
+class OCTINTERP_API fcn_lookup_cache
+{
+public:
+
+  fcn_lookup_cache () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (fcn_lookup_cache)
+
+  ~fcn_lookup_cache () = default;
+
+  octave_value find_function (symbol_table& symtab, const std::string& name,
+                              const octave_value_list& args = ovl ());
+
+  void clear ();
+
+private:
+
+  // Zero means empty, since the generation count of the symbol table
+  // starts at one.
+  std::size_t m_generation = 0;
+
+  // The search scope.  Only its identity is needed, so the reference
+  // does not keep the scope alive.
+  std::weak_ptr<void> m_scope;
+
+  builtin_type_t m_dispatch_type = btyp_unknown;
+
+  octave_base_value *m_fcn = nullptr;
+};
+
 OCTAVE_END_NAMESPACE(octave)
 
 #endif
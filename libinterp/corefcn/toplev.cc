@@ -362,6 +362,12 @@ specified option.
         { "ENABLE_64", false },
 #endif
 
+#if defined (OCTAVE_ENABLE_ATOMIC_REFCOUNT)
+        { "ENABLE_ATOMIC_REFCOUNT", true },
+#else
+        { "ENABLE_ATOMIC_REFCOUNT", false },
+#endif
+
 #if defined (OCTAVE_ENABLE_COMMAND_LINE_PUSH_PARSER)
         { "ENABLE_COMMAND_LINE_PUSH_PARSER", true },
 #else
@@ -632,6 +638,26 @@ specified option.
 %! assert (x.version, OCTAVE_VERSION ());
 
 %!error __octave_config_info__ (1, 2)
+
+%!demo
+%! ## Time a loop dominated by reference count updates: every iteration
+%! ## copies an array, creates an index, and extracts an element.  Run
+%! ## this in builds configured with and without --disable-atomic-refcount
+%! ## to compare the cost of atomic counts.
+%! if (__octave_config_info__ ("ENABLE_ATOMIC_REFCOUNT"))
+%!   disp ("Reference counts are atomic.");
+%! else
+%!   disp ("Reference counts are not atomic.");
+%! endif
+%! A = rand (1, 1000);
+%! n = 1e6;
+%! s = 0;
+%! t0 = tic ();
+%! for k = 1:n
+%!   B = A;
+%!   s += B(mod (k, 1000) + 1);
+%! endfor
+%! printf ("%d iterations of B = A; s += B(i): %.2f s\n", n, toc (t0));
 */
 
 OCTAVE_END_NAMESPACE(octave)
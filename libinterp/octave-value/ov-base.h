@@ -38,6 +38,7 @@
 #include "Range.h"
 #include "data-conv.h"
 #include "mx-base.h"
+#include "oct-alloc.h"
 #include "str-vec.h"
 
 #include "auto-shlib.h"
@@ -246,6 +247,33 @@ DEF_BTYP_TRAITS (btyp_char, char);
 #define DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA(t, n, c)                  \
   DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA_INTERNAL ( , t, n, c)
 
+// Class-specific operator new and delete for value types that are
+// created and destroyed very often, such as scalars and the results of
+// arithmetic.  Objects are taken from a pool of fixed-size blocks that
+// is shared by all values of the type.  See octave::slab_allocator.
+
+#define DECLARE_OV_SLAB_ALLOCATOR_API(API)                            \
+  public:                                                             \
+    API static void * operator new (std::size_t size);                \
+    API static void operator delete (void *p, std::size_t size);      \
+    API static octave::slab_allocator& value_allocator ();
+
+#define DEFINE_OV_SLAB_ALLOCATOR(t)                                   \
+  void * t::operator new (std::size_t size)                           \
+  {                                                                   \
+    return value_allocator ().allocate (size);                        \
+  }                                                                   \
+  void t::operator delete (void *p, std::size_t size)                 \
+  {                                                                   \
+    value_allocator ().deallocate (p, size);                          \
+  }                                                                   \
+  octave::slab_allocator& t::value_allocator ()                       \
+  {                                                                   \
+    static octave::slab_allocator *alloc                              \
+      = new octave::slab_allocator (#t, sizeof (t));                  \
+    return *alloc;                                                    \
+  }
+
 // A base value type, so that derived types only have to redefine what
 // they need (if they are derived from octave_base_value instead of
 // octave_value).
@@ -65,6 +65,8 @@
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_bool_matrix,
                                      "bool matrix", "logical");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_bool_matrix);
+
 static octave_base_value *
 default_numeric_conversion_function (const octave_base_value& a)
 {
@@ -242,6 +242,8 @@ public:
 
 protected:
 
+  DECLARE_OV_SLAB_ALLOCATOR_API (OCTINTERP_API)
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA_API (OCTINTERP_API)
 };
 
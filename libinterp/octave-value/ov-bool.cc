@@ -51,6 +51,8 @@
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_bool, "bool", "logical");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_bool);
+
 static octave_base_value *
 default_numeric_conversion_function (const octave_base_value& a)
 {
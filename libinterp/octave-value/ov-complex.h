@@ -205,6 +205,8 @@ public:
 
 private:
 
+  DECLARE_OV_SLAB_ALLOCATOR_API (OCTINTERP_API)
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA_API (OCTINTERP_API)
 };
 
@@ -38,6 +38,8 @@
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_cs_list, "cs-list", "cs-list");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_cs_list);
+
 octave_cs_list::octave_cs_list (const Cell& c)
   : octave_base_value (), m_list (c)
 { }
@@ -90,6 +90,8 @@ private:
   // The list of Octave values.
   octave_value_list m_list;
 
+  DECLARE_OV_SLAB_ALLOCATOR_API (OCTINTERP_API)
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA_API (OCTINTERP_API)
 };
 
@@ -66,6 +66,8 @@
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_complex_matrix,
                                      "complex matrix", "double");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_complex_matrix);
+
 static octave_base_value *
 default_numeric_demotion_function (const octave_base_value& a)
 {
@@ -60,6 +60,8 @@
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_float_scalar, "float scalar",
                                      "single");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_float_scalar);
+
 octave_value
 octave_float_scalar::do_index_op (const octave_value_list& idx, bool resize_ok)
 {
@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <atomic>
 #include <clocale>
 #include <istream>
 #include <limits>
@@ -51,6 +52,8 @@
 #include "lo-mappers.h"
 #include "mach-info.h"
 #include "mx-base.h"
+#include "mx-inlines.cc"
+#include "oct-thread-pool.h"
 #include "quit.h"
 #include "oct-locbuf.h"
 
@@ -749,6 +752,40 @@ do_rc_map (const FloatNDArray& a, FloatComplex (&fcn) (float))
   octave_idx_type n = a.numel ();
   FloatNDArray rr (a.dims ());
 
+  // Large arrays are split between threads.  Each thread stops as soon
+  // as it finds a complex result, in which case the complex result is
+  // computed again from the start.
+  if (octave::thread_pool::use_threads (n))
+    {
+      const float *pa = a.data ();
+      float *pr = rr.rwdata ();
+      std::atomic<bool> is_complex (false);
+
+      octave::thread_pool::parallel_for
+        (n, [=, &fcn, &is_complex] (std::size_t beg, std::size_t end)
+         {
+           for (std::size_t i = beg; i < end; i++)
+             {
+               if (is_complex.load (std::memory_order_relaxed))
+                 return;
+
+               FloatComplex tmp = fcn (pa[i]);
+               if (tmp.imag () != 0)
+                 {
+                   is_complex = true;
+                   return;
+                 }
+
+               pr[i] = tmp.real ();
+             }
+         });
+
+      if (! is_complex)
+        return rr;
+
+      return new octave_float_complex_matrix (FloatComplexNDArray (do_mx_parallel_map<FloatComplex> (a, fcn)));
+    }
+
   for (octave_idx_type i = 0; i < n; i++)
     {
       octave_quit ();
@@ -803,7 +840,7 @@ octave_float_matrix::map (unary_mapper_t umap) const
 
 #define ARRAY_MAPPER(UMAP, TYPE, FCN)                 \
     case umap_ ## UMAP:                               \
-      return octave_value (m_matrix.map<TYPE> (FCN))
+      return octave_value (do_mx_parallel_map<TYPE> (m_matrix, FCN))
 
 #define RC_ARRAY_MAPPER(UMAP, TYPE, FCN)      \
     case umap_ ## UMAP:                       \
@@ -59,6 +59,8 @@
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_scalar, "scalar", "double");
 
+DEFINE_OV_SLAB_ALLOCATOR (octave_scalar);
+
 static octave_base_value *
 default_numeric_demotion_function (const octave_base_value& a)
 {
@@ -117,11 +117,80 @@ static bool Voptimize_range = true;
 
 // Octave's value type.
 
+// Representations shared by all undefined values and by the most
+// common scalars.  See octave_value::is_static_rep.
+
+class static_value_reps
+{
+public:
+
+  // Doubles with integer values in this range are cached.
+  static const int min_int = -1024;
+  static const int max_int = 1023;
+
+  static_value_reps ()
+    : m_nil (), m_false (false), m_true (true), m_scalars ()
+  {
+    for (int i = min_int; i <= max_int; i++)
+      m_scalars[i - min_int].scalar_ref () = i;
+
+    octave_value::s_static_reps_begin
+      = reinterpret_cast<std::uintptr_t> (this);
+    octave_value::s_static_reps_end
+      = reinterpret_cast<std::uintptr_t> (this + 1);
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (static_value_reps)
+
+  ~static_value_reps () = default;
+
+  octave_base_value m_nil;
+  octave_bool m_false;
+  octave_bool m_true;
+  octave_scalar m_scalars[max_int - min_int + 1];
+};
+
+std::uintptr_t octave_value::s_static_reps_begin = 0;
+std::uintptr_t octave_value::s_static_reps_end = 0;
+
+static static_value_reps&
+static_reps ()
+{
+  // Allocated on first use and never deleted, so that values
+  // destroyed during program exit may still refer to it.
+  static static_value_reps *reps = new static_value_reps ();
+
+  return *reps;
+}
+
 octave_base_value *
 octave_value::nil_rep ()
 {
-  static octave_base_value nr;
-  return &nr;
+  return &static_reps ().m_nil;
+}
+
+octave_base_value *
+octave_value::scalar_rep (double d)
+{
+  // Exclude -0, which is not the same value as the cached 0.
+
+  if (d >= static_value_reps::min_int && d <= static_value_reps::max_int
+      && d == std::trunc (d) && ! (d == 0 && std::signbit (d)))
+    {
+      int i = static_cast<int> (d);
+
+      return &static_reps ().m_scalars[i - static_value_reps::min_int];
+    }
+
+  return new octave_scalar (d);
+}
+
+octave_base_value *
+octave_value::bool_rep (bool b)
+{
+  static_value_reps& reps = static_reps ();
+
+  return b ? &reps.m_true : &reps.m_false;
 }
 
 std::string
@@ -481,38 +550,38 @@ octave_value::binary_op_to_assign_op (binary_op op)
 }
 
 octave_value::octave_value (short int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 octave_value::octave_value (unsigned short int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 octave_value::octave_value (int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 octave_value::octave_value (unsigned int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 octave_value::octave_value (long int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 octave_value::octave_value (unsigned long int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 
 #if defined (OCTAVE_HAVE_LONG_LONG_INT)
 octave_value::octave_value (long long int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 #endif
 
 #if defined (OCTAVE_HAVE_UNSIGNED_LONG_LONG_INT)
 octave_value::octave_value (unsigned long long int i)
-  : m_rep (new octave_scalar (i))
+  : m_rep (scalar_rep (i))
 { }
 #endif
 
@@ -521,7 +590,7 @@ octave_value::octave_value (octave::sys::time t)
 { }
 
 octave_value::octave_value (double d)
-  : m_rep (new octave_scalar (d))
+  : m_rep (scalar_rep (d))
 { }
 
 octave_value::octave_value (float d)
@@ -745,7 +814,7 @@ octave_value::octave_value (const PermMatrix& p)
 }
 
 octave_value::octave_value (bool b)
-  : m_rep (new octave_bool (b))
+  : m_rep (bool_rep (b))
 { }
 
 octave_value::octave_value (const boolMatrix& bm, const MatrixType& t)
@@ -1162,8 +1231,7 @@ octave_value::maybe_mutate ()
 
   if (tmp && tmp != m_rep)
     {
-      if (--m_rep->m_count == 0)
-        delete m_rep;
+      release_rep (m_rep);
 
       m_rep = tmp;
     }
@@ -1588,7 +1656,7 @@ octave_value::assign (assign_op op, const octave_value& rhs)
       octave::type_info::assign_op_fcn f = nullptr;
 
       // Only attempt to operate in-place if this variable is unshared.
-      if (m_rep->m_count == 1)
+      if (get_count () == 1)
         {
           int tthis = this->type_id ();
           int trhs = rhs.type_id ();
@@ -2227,15 +2295,13 @@ octave_value::make_storable_value ()
   if (isnull ())
     {
       octave_base_value *rc = m_rep->empty_clone ();
-      if (--m_rep->m_count == 0)
-        delete m_rep;
+      release_rep (m_rep);
       m_rep = rc;
     }
   else if (is_magic_int ())
     {
-      octave_base_value *rc = new octave_scalar (m_rep->double_value ());
-      if (--m_rep->m_count == 0)
-        delete m_rep;
+      octave_base_value *rc = scalar_rep (m_rep->double_value ());
+      release_rep (m_rep);
       m_rep = rc;
     }
   else if (is_range () && ! m_rep->is_storable ())
@@ -2441,15 +2507,14 @@ octave_value::non_const_unary_op (unary_op op)
             {
               f (*m_rep);
 
-              if (old_rep && --old_rep->m_count == 0)
-                delete old_rep;
+              if (old_rep)
+                release_rep (old_rep);
             }
           else
             {
               if (old_rep)
                 {
-                  if (--m_rep->m_count == 0)
-                    delete m_rep;
+                  release_rep (m_rep);
 
                   m_rep = old_rep;
                 }
@@ -2467,7 +2532,7 @@ octave_value::non_const_unary_op (unary_op op)
       octave::type_info::non_const_unary_op_fcn f = nullptr;
 
       // Only attempt to operate in-place if this variable is unshared.
-      if (m_rep->m_count == 1)
+      if (get_count () == 1)
         {
           octave::type_info& ti = octave::__get_type_info__ ();
 
@@ -4048,4 +4113,119 @@ setting is restored when exiting the function.
 %!assert (typeinfo (__test_dr__ (false)), "matrix")
 */
 
+DEFUN (__allocator_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{s} =} __allocator_stats__ ()
+Return usage statistics for the pooled allocators of frequently created
+value types.
+
+The result is a struct array with one element per allocator and the fields
+
+@table @code
+@item name
+The C++ class that uses the allocator.
+
+@item block_size
+The size of each memory block in bytes.
+
+@item allocated
+@itemx freed
+The total number of objects created and destroyed.
+
+@item in_use
+The number of objects currently alive.
+
+@item reserved
+The number of blocks obtained from the system, whether in use or not.
+@end table
+
+Counts for threads other than the interpreter thread may lag behind by a
+few objects.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  std::list<slab_allocator::statistics> stats = slab_allocator::all_stats ();
+
+  octave_idx_type n = stats.size ();
+
+  Cell name (n, 1);
+  Cell block_size (n, 1);
+  Cell allocated (n, 1);
+  Cell freed (n, 1);
+  Cell in_use (n, 1);
+  Cell reserved (n, 1);
+
+  octave_idx_type i = 0;
+
+  for (const auto& s : stats)
+    {
+      name(i) = s.name;
+      block_size(i) = static_cast<double> (s.block_size);
+      allocated(i) = static_cast<double> (s.allocated);
+      freed(i) = static_cast<double> (s.freed);
+      in_use(i) = static_cast<double> (s.allocated - s.freed);
+      reserved(i) = static_cast<double> (s.reserved);
+      i++;
+    }
+
+  octave_map retval (dim_vector (n, 1));
+
+  retval.assign ("name", name);
+  retval.assign ("block_size", block_size);
+  retval.assign ("allocated", allocated);
+  retval.assign ("freed", freed);
+  retval.assign ("in_use", in_use);
+  retval.assign ("reserved", reserved);
+
+  return ovl (retval);
+}
+
+/*
+%!test
+%! s = __allocator_stats__ ();
+%! assert (isstruct (s));
+%! assert (fieldnames (s),
+%!         {"name"; "block_size"; "allocated"; "freed"; "in_use"; "reserved"});
+%! idx = find (strcmp ({s.name}, "octave_matrix"));
+%! assert (numel (idx), 1);
+%! before = s(idx).allocated;
+%! for k = 1:10
+%!   x = rand (2, 2) + k;
+%! endfor
+%! s = __allocator_stats__ ();
+%! assert (s(idx).allocated > before);
+%! assert (s(idx).in_use, s(idx).allocated - s(idx).freed);
+%! assert (s(idx).reserved >= s(idx).in_use);
+
+%!error __allocator_stats__ (1)
+*/
+
+/*
+## Small integers and logical scalars share static representations.
+## Updating one copy in place must not change any other.
+%!test
+%! a = 1;
+%! b = 1;
+%! a += 1;
+%! a++;
+%! assert (a, 3);
+%! assert (b, 1);
+%! assert (1, 1);
+
+%!test
+%! t = true;
+%! u = true;
+%! t(2) = false;
+%! assert (t, [true, false]);
+%! assert (u, true);
+%! assert (class (u), "logical");
+
+%!assert (1 / -0, -Inf)
+%!assert (1 / (0 * -1), -Inf)
+%!assert (-1025 + 1, -1024)
+%!assert (1023.5 - 0.5, 1023)
+*/
+
 OCTAVE_END_NAMESPACE(octave)
@@ -28,9 +28,11 @@
 
 #include "octave-config.h"
 
+#include <cstdint>
 #include <cstdlib>
 
 #include <iosfwd>
+#include <limits>
 #include <string>
 #include <list>
 #include <memory>
@@ -171,9 +173,7 @@ public:
 
   octave_value ()
     : m_rep (nil_rep ())
-  {
-    m_rep->m_count++;
-  }
+  { }
 
   OCTINTERP_API octave_value (short int i);
   OCTINTERP_API octave_value (unsigned short int i);
@@ -313,7 +313,7 @@ public:
     : m_rep (new_rep)
   {
     if (borrow)
-      m_rep->m_count++;
+      grab_rep (m_rep);
   }
 
   // Copy constructor.
@@ -321,7 +321,7 @@ public:
   octave_value (const octave_value& a)
     : m_rep (a.m_rep)
   {
-    m_rep->m_count++;
+    grab_rep (m_rep);
   }
 
   octave_value (octave_value&& a)
@@ -345,18 +345,17 @@ public:
     // operator, rep may be a nullptr here.  We should only need to
     // protect the move assignment operator in a similar way.
 
-    if (m_rep && --m_rep->m_count == 0 && m_rep != nil_rep ())
-      delete m_rep;
+    if (m_rep)
+      release_rep (m_rep);
   }
 
   void make_unique ()
   {
-    if (m_rep->m_count > 1)
+    if (get_count () > 1)
       {
         octave_base_value *r = m_rep->unique_clone ();
 
-        if (--m_rep->m_count == 0 && m_rep != nil_rep ())
-          delete m_rep;
+        release_rep (m_rep);
 
         m_rep = r;
       }
@@ -367,12 +366,11 @@ public:
   // know a certain copy, typically within a cell array, to be obsolete.
   void make_unique (int obsolete_copies)
   {
-    if (m_rep->m_count > obsolete_copies + 1)
+    if (get_count () > obsolete_copies + 1)
       {
         octave_base_value *r = m_rep->unique_clone ();
 
-        if (--m_rep->m_count == 0 && m_rep != nil_rep ())
-          delete m_rep;
+        release_rep (m_rep);
 
         m_rep = r;
       }
@@ -390,11 +388,10 @@ public:
   {
     if (m_rep != a.m_rep)
       {
-        if (--m_rep->m_count == 0 && m_rep != nil_rep ())
-          delete m_rep;
+        release_rep (m_rep);
 
         m_rep = a.m_rep;
-        m_rep->m_count++;
+        grab_rep (m_rep);
       }
 
     return *this;
@@ -408,8 +405,8 @@ public:
 
     if (this != &a)
       {
-        if (m_rep && --m_rep->m_count == 0 && m_rep != nil_rep ())
-          delete m_rep;
+        if (m_rep)
+          release_rep (m_rep);
 
         m_rep = a.m_rep;
         a.m_rep = nullptr;
@@ -418,7 +415,13 @@ public:
     return *this;
   }
 
-  octave_idx_type get_count () const { return m_rep->m_count; }
+  // Static representations are always treated as shared.
+  octave_idx_type get_count () const
+  {
+    return (is_static_rep (m_rep)
+            ? std::numeric_limits<octave_idx_type>::max ()
+            : m_rep->m_count.value ());
+  }
 
   octave_base_value::type_conv_info numeric_conversion_function () const
   { return m_rep->numeric_conversion_function (); }
@@ -1561,8 +1564,44 @@ protected:
 
   static OCTINTERP_API octave_base_value * nil_rep ();
 
+  // Return a static representation of D if there is one, otherwise a
+  // new octave_scalar object.
+  static OCTINTERP_API octave_base_value * scalar_rep (double d);
+
+  static OCTINTERP_API octave_base_value * bool_rep (bool b);
+
+  // The representations of undefined values, true and false, and
+  // doubles with small integer values are allocated once in a single
+  // block and never deleted.  Values that refer to them do not update
+  // their reference counts, which saves both the allocation and the
+  // atomic increment and decrement for the most common scalars.
+
+  static bool is_static_rep (const octave_base_value *rep)
+  {
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t> (rep);
+
+    return addr >= s_static_reps_begin && addr < s_static_reps_end;
+  }
+
+  static void grab_rep (octave_base_value *rep)
+  {
+    if (! is_static_rep (rep))
+      rep->m_count++;
+  }
+
+  static void release_rep (octave_base_value *rep)
+  {
+    if (! is_static_rep (rep) && --rep->m_count == 0)
+      delete rep;
+  }
+
 private:
 
+  friend class static_value_reps;
+
+  static OCTINTERP_API std::uintptr_t s_static_reps_begin;
+  static OCTINTERP_API std::uintptr_t s_static_reps_end;
+
   OCTINTERP_API assign_op unary_op_to_assign_op (unary_op op);
 
   OCTINTERP_API binary_op op_eq_to_binary_op (assign_op op);
@@ -15,6 +15,7 @@ PARSE_TREE_INC = \
   %reldir%/pt-assign.h \
   %reldir%/pt-binop.h \
   %reldir%/pt-bp.h \
+  %reldir%/pt-bytecode.h \
   %reldir%/pt-cbinop.h \
   %reldir%/pt-cell.h \
   %reldir%/pt-check.h \
@@ -34,6 +35,7 @@ PARSE_TREE_INC = \
   %reldir%/pt-loop.h \
   %reldir%/pt-mat.h \
   %reldir%/pt-misc.h \
+  %reldir%/pt-parfor.h \
   %reldir%/pt-pr-code.h \
   %reldir%/pt-select.h \
   %reldir%/pt-spmd.h \
@@ -66,6 +68,7 @@ PARSE_TREE_SRC = \
   %reldir%/pt-assign.cc \
   %reldir%/pt-binop.cc \
   %reldir%/pt-bp.cc \
+  %reldir%/pt-bytecode.cc \
   %reldir%/pt-cbinop.cc \
   %reldir%/pt-cell.cc \
   %reldir%/pt-check.cc \
@@ -82,6 +85,7 @@ PARSE_TREE_SRC = \
   %reldir%/pt-loop.cc \
   %reldir%/pt-mat.cc \
   %reldir%/pt-misc.cc \
+  %reldir%/pt-parfor.cc \
   %reldir%/pt-pr-code.cc \
   %reldir%/pt-select.cc \
   %reldir%/pt-spmd.cc \
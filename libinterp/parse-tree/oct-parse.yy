@@ -244,7 +244,7 @@ static void yyerror (octave::base_parser& parser, const char *s);
 // %token VARARGIN VARARGOUT
 
 // Nonterminals we construct.
-%type <dummy_type> push_fcn_symtab push_script_symtab begin_file
+%type <dummy_type> spmd_begin push_fcn_symtab push_script_symtab begin_file
 %type <dummy_type> stmt_begin anon_fcn_begin
 %type <dummy_type> parsing_local_fcns parse_error
 %type <tok> param_list_beg param_list_end
@@ -1191,14 +1191,45 @@ jump_command    : BREAK
 // Parallel execution pool
 // =======================
 
-spmd_command    : SPMD statement_list END
+spmd_command    : SPMD spmd_begin statement_list END
                   {
-                    if (! ($$ = parser.make_spmd_command ($1, $2, $3)))
+                    if (! ($$ = parser.make_spmd_command ($1, nullptr, nullptr, $3, $4)))
                       {
-                        // make_spmd_command deleted $2.
+                        // make_spmd_command deleted $3.
                         YYABORT;
                       }
                   }
+                | SPMD '(' expression ')' statement_list END
+                  {
+                    // FIXME: Need to capture token info here.
+                    OCTAVE_YYUSE ($2, $4);
+
+                    if (! ($$ = parser.make_spmd_command ($1, $3, nullptr, $5, $6)))
+                      {
+                        // make_spmd_command deleted $3 and $5.
+                        YYABORT;
+                      }
+                  }
+                | SPMD '(' expression ',' expression ')' statement_list END
+                  {
+                    // FIXME: Need to capture token info here.
+                    OCTAVE_YYUSE ($2, $4, $6);
+
+                    if (! ($$ = parser.make_spmd_command ($1, $3, $5, $7, $8)))
+                      {
+                        // make_spmd_command deleted $3, $5, and $7.
+                        YYABORT;
+                      }
+                  }
+                ;
+
+// An spmd block whose body starts with a parenthesized expression on
+// the same line can't be told apart from one with arguments.  Like
+// Matlab, always treat the parentheses as the argument list.
+
+spmd_begin      : // empty
+                  %prec UNARY
+                  { $$ = 0; }
                 ;
 
 // ==========
@@ -3288,14 +3319,17 @@ base_parser::make_return_command (token *return_tok)
 // Build an spmd command.
 
 tree_spmd_command *
-base_parser::make_spmd_command (token *spmd_tok, tree_statement_list *body, token *end_tok)
+base_parser::make_spmd_command (token *spmd_tok, tree_expression *nworkers, tree_expression *max_workers,
+                                tree_statement_list *body, token *end_tok)
 {
   tree_spmd_command *retval = nullptr;
 
   if (end_token_ok (end_tok, token::spmd_end))
-    retval = new tree_spmd_command (*spmd_tok, body, *end_tok);
+    retval = new tree_spmd_command (*spmd_tok, nworkers, max_workers, body, *end_tok);
   else
     {
+      delete nworkers;
+      delete max_workers;
       delete body;
 
       end_token_error (end_tok, token::spmd_end);
@@ -315,7 +315,7 @@ public:
   // Build an spmd command.
 
   OCTINTERP_API tree_spmd_command *
-  make_spmd_command (token *spmd_tok, tree_statement_list *body, token *end_tok);
+  make_spmd_command (token *spmd_tok, tree_expression *nworkers, tree_expression *max_workers, tree_statement_list *body, token *end_tok);
 
   // Start an if command.
   OCTINTERP_API tree_if_command_list *
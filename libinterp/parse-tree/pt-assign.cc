@@ -33,16 +33,27 @@
 #include "interpreter.h"
 #include "oct-lvalue.h"
 #include "ov.h"
+#include "profiler.h"
 #include "pt-arg-list.h"
 #include "pt-assign.h"
+#include "pt-binop.h"
+#include "pt-cbinop.h"
+#include "pt-eval.h"
+#include "pt-id.h"
+#include "pt-unop.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 // Simple assignment expressions.
 
 tree_simple_assignment::tree_simple_assignment (tree_expression *le, tree_expression *re, bool plhs, octave_value::assign_op t)
-  : m_lhs (le), m_rhs (re), m_preserve (plhs), m_ans_assign (), m_etype (t)
-{ }
+  : m_lhs (le), m_rhs (re), m_preserve (plhs), m_ans_assign (), m_etype (t),
+    m_in_place_op (octave_value::unknown_binary_op),
+    m_in_place_operand (nullptr), m_in_place_ids (),
+    m_in_place_negate (false)
+{
+  find_in_place_update ();
+}
 
 tree_simple_assignment::~tree_simple_assignment ()
 {
@@ -71,6 +82,195 @@ tree_simple_assignment::dup (symbol_scope& scope) const
   return new_sa;
 }
 
+// Return true if EXPR is made up only of constants, identifiers, and
+// operators other than ++ and --, and append the identifiers to IDS.
+// If all the identifiers are variables, evaluating EXPR cannot change
+// the value of any variable.
+
+static bool
+collect_operand_identifiers (tree_expression *expr,
+                             std::vector<tree_identifier *>& ids)
+{
+  if (! expr)
+    return false;
+
+  if (expr->is_constant ())
+    return true;
+
+  if (expr->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (expr);
+
+      if (id->is_black_hole ())
+        return false;
+
+      ids.push_back (id);
+
+      return true;
+    }
+
+  if (expr->is_binary_expression ())
+    {
+      tree_binary_expression *be
+        = dynamic_cast<tree_binary_expression *> (expr);
+
+      return (collect_operand_identifiers (be->lhs (), ids)
+              && collect_operand_identifiers (be->rhs (), ids));
+    }
+
+  if (expr->is_unary_expression ())
+    {
+      tree_unary_expression *ue = dynamic_cast<tree_unary_expression *> (expr);
+
+      octave_value::unary_op op = ue->op_type ();
+
+      if (op == octave_value::op_incr || op == octave_value::op_decr)
+        return false;
+
+      return collect_operand_identifiers (ue->operand (), ids);
+    }
+
+  return false;
+}
+
+// Recognize assignments of the form A = A OP B and A = -A.  If A is an
+// unshared array when the assignment is evaluated, these can be done
+// in place like A OP= B instead of creating a new array for the result.
+
+void
+tree_simple_assignment::find_in_place_update ()
+{
+  if (m_etype != octave_value::op_asn_eq || ! m_lhs || ! m_rhs
+      || ! m_lhs->is_identifier ())
+    return;
+
+  tree_identifier *lhs_id = dynamic_cast<tree_identifier *> (m_lhs);
+
+  if (lhs_id->is_black_hole ())
+    return;
+
+  std::string name = lhs_id->name ();
+
+  if (m_rhs->is_binary_expression () && ! m_rhs->is_boolean_expression ()
+      && ! dynamic_cast<tree_compound_binary_expression *> (m_rhs))
+    {
+      tree_binary_expression *be
+        = dynamic_cast<tree_binary_expression *> (m_rhs);
+
+      tree_expression *a = be->lhs ();
+
+      if (be->is_braindead () || ! a || ! a->is_identifier ()
+          || a->name () != name)
+        return;
+
+      switch (be->op_type ())
+        {
+        case octave_value::op_add:
+        case octave_value::op_sub:
+        case octave_value::op_mul:
+        case octave_value::op_div:
+        case octave_value::op_el_mul:
+        case octave_value::op_el_div:
+          break;
+
+        default:
+          return;
+        }
+
+      std::vector<tree_identifier *> ids;
+
+      if (! collect_operand_identifiers (be->rhs (), ids))
+        return;
+
+      m_in_place_op = be->op_type ();
+      m_in_place_operand = be->rhs ();
+      m_in_place_ids = ids;
+    }
+  else if (m_rhs->is_prefix_expression ())
+    {
+      tree_prefix_expression *pe
+        = dynamic_cast<tree_prefix_expression *> (m_rhs);
+
+      tree_expression *a = pe->operand ();
+
+      if (pe->op_type () == octave_value::op_uminus
+          && a && a->is_identifier () && a->name () == name)
+        m_in_place_negate = true;
+    }
+}
+
+// Perform an assignment recognized by find_in_place_update.  Return
+// false without evaluating anything if the left hand side is not an
+// array or evaluating B might have side effects, in which case the
+// assignment must be evaluated as written.
+
+bool
+tree_simple_assignment::assign_in_place (tree_evaluator& tw,
+                                         octave_lvalue& ult)
+{
+  if (tw.get_profiler ().enabled ())
+    return false;
+
+  for (const tree_identifier *id : m_in_place_ids)
+    {
+      if (! tw.is_variable (id))
+        return false;
+    }
+
+  {
+    // Scalars are handled at least as well by the normal evaluation.
+    // The reference to A must not outlive this block so that the
+    // variable is unshared when it is modified below.
+
+    octave_value a = ult.value ();
+
+    if (! a.is_matrix_type () || a.iscell () || a.numel () <= 1)
+      return false;
+  }
+
+  if (m_in_place_negate)
+    {
+      ult.unary_op (octave_value::op_uminus);
+
+      return true;
+    }
+
+  octave_value b = m_in_place_operand->evaluate (tw);
+
+  if (b.is_undefined ())
+    error ("value on right hand side of assignment is undefined");
+
+  octave_value::binary_op op = m_in_place_op;
+
+  if (b.is_scalar_type ())
+    {
+      // Only the matrix by scalar forms are defined for in-place
+      // multiplication and division.
+
+      if (op == octave_value::op_el_mul)
+        op = octave_value::op_mul;
+      else if (op == octave_value::op_el_div)
+        op = octave_value::op_div;
+    }
+
+  // A OP= B is done in place only if the result has the same size as
+  // A.  Otherwise, evaluate A OP B as usual, with broadcasting.
+
+  if (b.numel () == 1 || ult.value ().dims () == b.dims ())
+    ult.assign (octave_value::binary_op_to_assign_op (op), b);
+  else
+    {
+      interpreter& interp = tw.get_interpreter ();
+
+      type_info& ti = interp.get_type_info ();
+
+      ult.assign (octave_value::op_asn_eq,
+                  binary_op (ti, m_in_place_op, ult.value (), b));
+    }
+
+  return true;
+}
+
 octave_value
 tree_simple_assignment::evaluate (tree_evaluator& tw, int)
 {
@@ -94,6 +294,24 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
           if (ult.numel () != 1)
             err_invalid_structure_assignment ();
 
+          if ((m_in_place_operand || m_in_place_negate)
+              && assign_in_place (tw, ult))
+            {
+              val = ult.value ();
+
+              if (print_result () && tw.statement_printing_enabled ())
+                {
+                  octave_value_list args = ovl (val);
+                  args.stash_name_tags (string_vector (m_lhs->name ()));
+
+                  interpreter& interp = tw.get_interpreter ();
+
+                  interp.feval ("display", args);
+                }
+
+              return val;
+            }
+
           octave_value rhs_val = m_rhs->evaluate (tw);
 
           if (rhs_val.is_undefined ())
@@ -382,4 +600,57 @@ OCTAVE_END_NAMESPACE(octave)
 %!test
 %! [~, y, ~, b] = f3 ();
 %! assert ([y, b], [1, 3]);
+
+## In-place updates of the form A = A OP B and A = -A
+%!test
+%! A = magic (4);
+%! B = A;
+%! A = A + 1;
+%! assert (A, magic (4) + 1);
+%! assert (B, magic (4));
+%! A = A - B;
+%! assert (A, ones (4));
+%! A = A .* B;
+%! assert (A, magic (4));
+%! A = A ./ 2;
+%! assert (A, magic (4) / 2);
+%! A = A * 2;
+%! assert (A, magic (4));
+%! A = -A;
+%! assert (A, -magic (4));
+%! assert (B, magic (4));
+%!test
+%! A = [1, 2; 3, 4];
+%! A = A * [0, 1; 1, 0];
+%! assert (A, [2, 1; 4, 3]);
+%! A = A / [2, 0; 0, 1];
+%! assert (A, [1, 1; 2, 3]);
+%!test
+%! A = [1; 2; 3];
+%! A = A + [10, 20];
+%! assert (A, [11, 21; 12, 22; 13, 23]);
+%! A = A .* [1; 0; 1];
+%! assert (A, [11, 21; 0, 0; 13, 23]);
+%!test
+%! A = int8 ([100, -100, 5]);
+%! A = A + 50;
+%! assert (A, int8 ([127, -50, 55]));
+%! A = -A;
+%! assert (A, int8 ([-127, 50, -55]));
+%!test
+%! A = [1, 2, 3];
+%! A = A + 1i;
+%! assert (A, [1+1i, 2+1i, 3+1i]);
+%! A = A - 1i;
+%! assert (A, [1, 2, 3]);
+%! assert (isreal (A));
+%!test
+%! A = single ([1, 2, 3]);
+%! A = A .* 2;
+%! assert (A, single ([2, 4, 6]));
+%! A = "abc";
+%! A = A + 1;
+%! assert (A, [98, 99, 100]);
+%!error <undefined> A = [1, 2]; A = A + undefined_variable_for_in_place_test;
+%!error <nonconformant> A = [1, 2]; A = A + [1, 2, 3];
 */
@@ -30,6 +30,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 class octave_value;
 class octave_value_list;
@@ -46,6 +47,7 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 class symbol_scope;
 class octave_lvalue;
 class tree_argument_list;
+class tree_identifier;
 
 // Simple assignment expressions.
 
@@ -97,6 +99,10 @@ private:
 
   void do_assign (octave_lvalue& ult, const octave_value& rhs_val);
 
+  void find_in_place_update ();
+
+  bool assign_in_place (tree_evaluator& tw, octave_lvalue& ult);
+
   // The left hand side of the assignment.
   tree_expression *m_lhs;
 
@@ -111,6 +117,16 @@ private:
 
   // The type of the expression.
   octave_value::assign_op m_etype;
+
+  // For assignments of the form A = A OP B, the operator and B.  The
+  // operand B is part of m_rhs and the identifiers are those that
+  // appear in B.
+  octave_value::binary_op m_in_place_op;
+  tree_expression *m_in_place_operand;
+  std::vector<tree_identifier *> m_in_place_ids;
+
+  // True for assignments of the form A = -A.
+  bool m_in_place_negate;
 };
 
 // Multi-valued assignment expressions.
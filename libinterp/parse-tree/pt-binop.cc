@@ -67,9 +67,50 @@ tree_binary_expression::dup (symbol_scope& scope) const
   return new_be;
 }
 
+// Give up on a compiled expression after this many consecutive
+// evaluations with operands the bytecode interpreter can't handle.
+static const int max_bytecode_misses = 16;
+
+bool
+tree_binary_expression::evaluate_bytecode (tree_evaluator& tw,
+                                           octave_value& result)
+{
+  if (m_bytecode_state == bytecode_untried)
+    {
+      m_bytecode = bytecode_program::compile (*this);
+
+      m_bytecode_state = m_bytecode ? bytecode_compiled : bytecode_disabled;
+    }
+
+  if (m_bytecode_state != bytecode_compiled)
+    return false;
+
+  if (m_bytecode->execute (tw, result))
+    {
+      m_bytecode_misses = 0;
+      return true;
+    }
+
+  if (++m_bytecode_misses >= max_bytecode_misses)
+    disable_bytecode ();
+
+  return false;
+}
+
 octave_value
 tree_binary_expression::evaluate (tree_evaluator& tw, int)
 {
+  // The bytecode interpreter evaluates the whole expression tree at
+  // once, so it is bypassed while profiling individual operators.
+  if (m_bytecode_state != bytecode_disabled && tw.bytecode_enabled ()
+      && ! tw.get_profiler ().enabled ())
+    {
+      octave_value result;
+
+      if (evaluate_bytecode (tw, result))
+        return result;
+    }
+
   if (m_lhs)
     {
       // Evaluate with unknown number of output arguments
@@ -34,6 +34,7 @@ class octave_value;
 class octave_value_list;
 
 #include "ov.h"
+#include "pt-bytecode.h"
 #include "pt-exp.h"
 #include "pt-walk.h"
 
@@ -48,11 +49,14 @@ class tree_binary_expression : public tree_expression
 public:
 
   tree_binary_expression (octave_value::binary_op t = octave_value::unknown_binary_op)
-    : m_lhs (nullptr), m_rhs (nullptr), m_etype (t), m_preserve_operands (false)
+    : m_lhs (nullptr), m_rhs (nullptr), m_etype (t), m_preserve_operands (false),
+      m_bytecode_state (bytecode_untried), m_bytecode_misses (0), m_bytecode ()
   { }
 
   tree_binary_expression (tree_expression *a, const token& op_tok, tree_expression *b, octave_value::binary_op t = octave_value::unknown_binary_op)
-    : m_lhs (a), m_op_tok (op_tok), m_rhs (b), m_etype (t), m_preserve_operands (false)
+    : m_lhs (a), m_op_tok (op_tok), m_rhs (b), m_etype (t),
+      m_preserve_operands (false), m_bytecode_state (bytecode_untried),
+      m_bytecode_misses (0), m_bytecode ()
   { }
 
   OCTAVE_DISABLE_COPY_MOVE (tree_binary_expression)
@@ -107,6 +111,14 @@ public:
 
   virtual bool is_braindead () const { return false; }
 
+  // Don't try to compile this expression to bytecode.  Used for
+  // subexpressions that are already part of an enclosing program.
+  void disable_bytecode ()
+  {
+    m_bytecode_state = bytecode_disabled;
+    m_bytecode.reset ();
+  }
+
 protected:
 
   // The operands and operator for the expression.
@@ -123,6 +135,23 @@ private:
 
   // If TRUE, don't delete m_lhs and m_rhs in destructor;
   bool m_preserve_operands;
+
+  enum bytecode_state
+  {
+    bytecode_untried,
+    bytecode_compiled,
+    bytecode_disabled
+  };
+
+  bool evaluate_bytecode (tree_evaluator& tw, octave_value& result);
+
+  bytecode_state m_bytecode_state;
+
+  // Number of consecutive evaluations that had to fall back to the
+  // tree evaluator.
+  int m_bytecode_misses;
+
+  std::unique_ptr<bytecode_program> m_bytecode;
 };
 
 class tree_braindead_shortcircuit_binary_expression
@@ -0,0 +1,879 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include <limits>
+#include <vector>
+
+#include "boolNDArray.h"
+#include "dNDArray.h"
+#include "lo-mappers.h"
+
+#include "interpreter.h"
+#include "ov-re-mat.h"
+#include "ov.h"
+#include "pt-arg-list.h"
+#include "pt-binop.h"
+#include "pt-bytecode.h"
+#include "pt-cbinop.h"
+#include "pt-const.h"
+#include "pt-eval.h"
+#include "pt-id.h"
+#include "pt-idx.h"
+#include "pt-unop.h"
+#include "symtab.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Same test as xpow uses to decide whether a negative base raised to
+// the power B has a real result.
+
+static inline bool
+xisint (double x)
+{
+  return (math::x_nint (x) == x
+          && x <= std::numeric_limits<int>::max ()
+          && x >= std::numeric_limits<int>::min ());
+}
+
+static bool
+map_binary_op (octave_value::binary_op op, bytecode_program::opcode& code,
+               bool& matrix_op)
+{
+  matrix_op = false;
+
+  switch (op)
+    {
+    case octave_value::op_add:
+      code = bytecode_program::op_add;
+      break;
+
+    case octave_value::op_sub:
+      code = bytecode_program::op_sub;
+      break;
+
+    // For scalars, matrix and element-wise operators are the same.
+    case octave_value::op_mul:
+      matrix_op = true;
+      OCTAVE_FALLTHROUGH;
+
+    case octave_value::op_el_mul:
+      code = bytecode_program::op_mul;
+      break;
+
+    case octave_value::op_div:
+      matrix_op = true;
+      OCTAVE_FALLTHROUGH;
+
+    case octave_value::op_el_div:
+      code = bytecode_program::op_div;
+      break;
+
+    case octave_value::op_ldiv:
+      matrix_op = true;
+      OCTAVE_FALLTHROUGH;
+
+    case octave_value::op_el_ldiv:
+      code = bytecode_program::op_ldiv;
+      break;
+
+    case octave_value::op_pow:
+      matrix_op = true;
+      OCTAVE_FALLTHROUGH;
+
+    case octave_value::op_el_pow:
+      code = bytecode_program::op_pow;
+      break;
+
+    case octave_value::op_lt:
+      code = bytecode_program::op_lt;
+      break;
+
+    case octave_value::op_le:
+      code = bytecode_program::op_le;
+      break;
+
+    case octave_value::op_eq:
+      code = bytecode_program::op_eq;
+      break;
+
+    case octave_value::op_ge:
+      code = bytecode_program::op_ge;
+      break;
+
+    case octave_value::op_gt:
+      code = bytecode_program::op_gt;
+      break;
+
+    case octave_value::op_ne:
+      code = bytecode_program::op_ne;
+      break;
+
+    default:
+      return false;
+    }
+
+  return true;
+}
+
+// Built-in functions that are compiled to instructions.  All of them
+// map real arguments to real results, except sqrt and log for negative
+// arguments.
+
+static bool
+map_function (const std::string& name, bytecode_program::opcode& code)
+{
+  static const struct
+  {
+    const char *name;
+    bytecode_program::opcode code;
+  } functions[] =
+  {
+    { "abs", bytecode_program::op_abs },
+    { "exp", bytecode_program::op_exp },
+    { "log", bytecode_program::op_log },
+    { "sqrt", bytecode_program::op_sqrt },
+    { "sin", bytecode_program::op_sin },
+    { "cos", bytecode_program::op_cos }
+  };
+
+  for (const auto& fcn : functions)
+    {
+      if (name == fcn.name)
+        {
+          code = fcn.code;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+static inline bool
+is_comparison (bytecode_program::opcode code)
+{
+  return code >= bytecode_program::op_lt && code <= bytecode_program::op_ne;
+}
+
+// Only plain binary expressions are compiled.  Boolean, compound, and
+// Matlab-style short-circuit expressions are derived classes with their
+// own evaluation rules.
+
+static inline bool
+is_plain_binary_expression (tree_expression *expr)
+{
+  if (! expr->is_binary_expression () || expr->is_boolean_expression ())
+    return false;
+
+  tree_binary_expression *be = dynamic_cast<tree_binary_expression *> (expr);
+
+  return (be && ! be->is_braindead ()
+          && ! dynamic_cast<tree_compound_binary_expression *> (be));
+}
+
+std::unique_ptr<bytecode_program>
+bytecode_program::compile (tree_binary_expression& expr)
+{
+  std::unique_ptr<bytecode_program> prog (new bytecode_program ());
+
+  std::vector<tree_binary_expression *> subexprs;
+
+  if (prog->compile_operand (&expr, subexprs) < 0 || prog->m_code.empty ())
+    return nullptr;
+
+  // The subexpressions are now evaluated as part of this program, so
+  // they should not compile themselves if the enclosing expression
+  // has to fall back to the tree evaluator.
+  for (auto *be : subexprs)
+    {
+      if (be != &expr)
+        be->disable_bytecode ();
+    }
+
+  prog->m_bool_result = is_comparison (prog->m_code.back ().op);
+
+  return prog;
+}
+
+// Emit code for EXPR and return the register that holds its value, or
+// -1 if EXPR can't be compiled.
+
+int
+bytecode_program::compile_operand (tree_expression *expr,
+                                   std::vector<tree_binary_expression *>& subexprs)
+{
+  if (! expr)
+    return -1;
+
+  if (expr->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (expr);
+
+      if (! id || id->is_black_hole ())
+        return -1;
+
+      return variable_register (id->symbol ());
+    }
+  else if (expr->is_constant ())
+    {
+      tree_constant *c = dynamic_cast<tree_constant *> (expr);
+
+      if (! c)
+        return -1;
+
+      octave_value val = c->value ();
+
+      if (! (val.is_real_scalar () && val.is_double_type ()))
+        return -1;
+
+      return constant_register (val.double_value ());
+    }
+  else if (expr->is_unary_expression ())
+    {
+      tree_unary_expression *ue = dynamic_cast<tree_unary_expression *> (expr);
+
+      if (! ue)
+        return -1;
+
+      switch (ue->op_type ())
+        {
+        case octave_value::op_uplus:
+          return compile_operand (ue->operand (), subexprs);
+
+        // No-ops for real scalars.
+        case octave_value::op_transpose:
+        case octave_value::op_hermitian:
+          m_has_transpose = true;
+          return compile_operand (ue->operand (), subexprs);
+
+        case octave_value::op_uminus:
+          {
+            int src = compile_operand (ue->operand (), subexprs);
+
+            if (src < 0)
+              return -1;
+
+            int dst = new_register ();
+
+            if (dst < 0)
+              return -1;
+
+            m_code.push_back ({op_uminus, dst, src, src, false});
+
+            return dst;
+          }
+
+        default:
+          return -1;
+        }
+    }
+  else if (expr->is_index_expression ())
+    {
+      // A call like exp (x).  Whether the name refers to a variable or
+      // to the built-in function is checked when the program is run.
+
+      tree_index_expression *ie = dynamic_cast<tree_index_expression *> (expr);
+
+      if (! ie || ie->type_tags () != "(" || ie->is_word_list_cmd ())
+        return -1;
+
+      tree_expression *fexpr = ie->expression ();
+
+      if (! fexpr || ! fexpr->is_identifier ())
+        return -1;
+
+      tree_identifier *id = dynamic_cast<tree_identifier *> (fexpr);
+
+      opcode code;
+
+      if (! id || ! map_function (id->name (), code))
+        return -1;
+
+      std::list<tree_argument_list *> args = ie->arg_lists ();
+
+      tree_argument_list *arg = args.front ();
+
+      if (! arg || arg->size () != 1)
+        return -1;
+
+      int src = compile_operand (arg->front (), subexprs);
+
+      if (src < 0)
+        return -1;
+
+      int dst = new_register ();
+
+      if (dst < 0)
+        return -1;
+
+      m_code.push_back ({code, dst, src, src, false});
+
+      m_functions.push_back (id->symbol ());
+      m_function_caches.push_back (std::make_unique<fcn_lookup_cache> ());
+
+      return dst;
+    }
+  else if (is_plain_binary_expression (expr))
+    {
+      tree_binary_expression *be = dynamic_cast<tree_binary_expression *> (expr);
+
+      opcode code;
+      bool matrix_op;
+
+      if (! map_binary_op (be->op_type (), code, matrix_op))
+        return -1;
+
+      int lhs = compile_operand (be->lhs (), subexprs);
+
+      if (lhs < 0)
+        return -1;
+
+      int rhs = compile_operand (be->rhs (), subexprs);
+
+      if (rhs < 0)
+        return -1;
+
+      int dst = new_register ();
+
+      if (dst < 0)
+        return -1;
+
+      m_code.push_back ({code, dst, lhs, rhs, matrix_op});
+
+      subexprs.push_back (be);
+
+      return dst;
+    }
+
+  return -1;
+}
+
+int
+bytecode_program::new_register ()
+{
+  if (m_num_registers >= max_registers)
+    return -1;
+
+  return m_num_registers++;
+}
+
+int
+bytecode_program::variable_register (const symbol_record& sym)
+{
+  std::string name = sym.name ();
+
+  for (std::size_t i = 0; i < m_variables.size (); i++)
+    {
+      if (m_variables[i].name () == name)
+        return m_variable_registers[i];
+    }
+
+  int reg = new_register ();
+
+  if (reg >= 0)
+    {
+      m_variables.push_back (sym);
+      m_variable_registers.push_back (reg);
+    }
+
+  return reg;
+}
+
+int
+bytecode_program::constant_register (double val)
+{
+  int reg = new_register ();
+
+  if (reg >= 0)
+    {
+      m_constants.push_back (val);
+      m_constant_registers.push_back (reg);
+    }
+
+  return reg;
+}
+
+// Function names must not have been redefined as variables or shadowed
+// by user functions since the program was compiled.  The function each
+// name refers to is cached, so it is only looked up again after the
+// symbol table changes or from a different scope.
+
+bool
+bytecode_program::functions_are_builtin (tree_evaluator& tw) const
+{
+  if (m_functions.empty ())
+    return true;
+
+  symbol_table& symtab = tw.get_interpreter ().get_symbol_table ();
+
+  for (std::size_t i = 0; i < m_functions.size (); i++)
+    {
+      const symbol_record& sym = m_functions[i];
+
+      if (tw.varval (sym).is_defined ())
+        return false;
+
+      octave_value fcn
+        = m_function_caches[i]->find_function (symtab, sym.name ());
+
+      if (! fcn.is_builtin_function ())
+        return false;
+    }
+
+  return true;
+}
+
+bool
+bytecode_program::execute (tree_evaluator& tw, octave_value& result) const
+{
+  if (! functions_are_builtin (tw))
+    return false;
+
+  double reg[max_registers];
+
+  for (std::size_t i = 0; i < m_variables.size (); i++)
+    {
+      octave_value val = tw.varval (m_variables[i]);
+
+      // Undefined symbols may be function calls and anything else may
+      // need type dispatch, so leave them to the tree evaluator.
+      if (val.is_double_type ())
+        {
+          if (! val.is_real_scalar ())
+            return execute_elementwise (tw, result);
+        }
+      else if (! val.is_bool_scalar ())
+        return false;
+
+      reg[m_variable_registers[i]] = val.double_value ();
+    }
+
+  for (std::size_t i = 0; i < m_constants.size (); i++)
+    reg[m_constant_registers[i]] = m_constants[i];
+
+  for (const auto& insn : m_code)
+    {
+      double a = reg[insn.lhs];
+      double b = reg[insn.rhs];
+
+      double& r = reg[insn.dst];
+
+      switch (insn.op)
+        {
+        case op_add:
+          r = a + b;
+          break;
+
+        case op_sub:
+          r = a - b;
+          break;
+
+        case op_mul:
+          r = a * b;
+          break;
+
+        case op_div:
+          r = a / b;
+          break;
+
+        case op_ldiv:
+          r = b / a;
+          break;
+
+        case op_pow:
+          // Negative base and non-integer exponent gives a complex
+          // result.
+          if (a < 0.0 && ! xisint (b))
+            return false;
+          r = std::pow (a, b);
+          break;
+
+        case op_lt:
+          r = a < b;
+          break;
+
+        case op_le:
+          r = a <= b;
+          break;
+
+        case op_eq:
+          r = a == b;
+          break;
+
+        case op_ge:
+          r = a >= b;
+          break;
+
+        case op_gt:
+          r = a > b;
+          break;
+
+        case op_ne:
+          r = a != b;
+          break;
+
+        case op_uminus:
+          r = -a;
+          break;
+
+        case op_abs:
+          r = std::abs (a);
+          break;
+
+        case op_exp:
+          r = std::exp (a);
+          break;
+
+        case op_log:
+          if (a < 0.0)
+            return false;
+          r = std::log (a);
+          break;
+
+        case op_sqrt:
+          if (a < 0.0)
+            return false;
+          r = std::sqrt (a);
+          break;
+
+        case op_sin:
+          r = std::sin (a);
+          break;
+
+        case op_cos:
+          r = std::cos (a);
+          break;
+        }
+    }
+
+  double val = reg[m_code.back ().dst];
+
+  if (m_bool_result)
+    result = octave_value (val != 0.0);
+  else
+    result = octave_value (val);
+
+  return true;
+}
+
+// Run the program over real double arrays that all have the same size,
+// with the remaining operands scalars.  Registers hold blocks of
+// elements and the final instruction writes directly into the result.
+
+bool
+bytecode_program::execute_elementwise (tree_evaluator& tw,
+                                       octave_value& result) const
+{
+  // Transposes were compiled as no-ops.
+  if (m_has_transpose)
+    return false;
+
+  std::vector<NDArray> arrays;
+  arrays.reserve (m_variables.size ());
+
+  // Data of the array operands, values of the scalar operands, and
+  // whether each register holds array elements.
+  std::vector<const double *> data (m_num_registers, nullptr);
+  std::vector<double> scalars (m_num_registers, 0.0);
+  std::vector<bool> is_array (m_num_registers, false);
+
+  dim_vector dims;
+  bool have_array = false;
+
+  for (std::size_t i = 0; i < m_variables.size (); i++)
+    {
+      octave_value val = tw.varval (m_variables[i]);
+
+      int r = m_variable_registers[i];
+
+      if (val.is_real_scalar ()
+          && (val.is_double_type () || val.is_bool_scalar ()))
+        scalars[r] = val.double_value ();
+      else if (val.type_id () == octave_matrix::static_type_id ())
+        {
+          NDArray a = val.array_value ();
+
+          // Broadcasting between arrays of different sizes is left to
+          // the tree evaluator.
+          if (! have_array)
+            {
+              dims = a.dims ();
+              have_array = true;
+            }
+          else if (a.dims () != dims)
+            return false;
+
+          data[r] = a.data ();
+          is_array[r] = true;
+
+          arrays.push_back (a);
+        }
+      else
+        return false;
+    }
+
+  if (! have_array)
+    return false;
+
+  for (std::size_t i = 0; i < m_constants.size (); i++)
+    scalars[m_constant_registers[i]] = m_constants[i];
+
+  // The matrix forms of the operators are only element-wise if one or
+  // both operands are scalars.
+
+  for (const auto& insn : m_code)
+    {
+      bool a = is_array[insn.lhs];
+      bool b = is_array[insn.rhs];
+
+      if (insn.matrix_op)
+        {
+          switch (insn.op)
+            {
+            case op_mul:
+              if (a && b)
+                return false;
+              break;
+
+            case op_div:
+              if (b)
+                return false;
+              break;
+
+            case op_ldiv:
+              if (a)
+                return false;
+              break;
+
+            case op_pow:
+              if (a || b)
+                return false;
+              break;
+
+            default:
+              break;
+            }
+        }
+
+      is_array[insn.dst] = a || b;
+    }
+
+  int last = m_code.back ().dst;
+
+  NDArray res;
+  boolNDArray bool_res;
+
+  double *res_data = nullptr;
+  bool *bool_res_data = nullptr;
+
+  if (m_bool_result)
+    {
+      bool_res = boolNDArray (dims);
+      bool_res_data = bool_res.fortran_vec ();
+    }
+  else
+    {
+      res = NDArray (dims);
+      res_data = res.fortran_vec ();
+    }
+
+  // Every register gets a block of scratch space.  Scalars are
+  // broadcast into their blocks once, array operands are read in place,
+  // and the last instruction of a double result writes to RES.
+
+  std::vector<double> scratch (m_num_registers * block_size);
+  std::vector<const double *> src (m_num_registers);
+  std::vector<double *> dst (m_num_registers);
+
+  for (int r = 0; r < m_num_registers; r++)
+    {
+      double *blk = scratch.data () + r * block_size;
+
+      if (! is_array[r])
+        std::fill (blk, blk + block_size, scalars[r]);
+
+      src[r] = dst[r] = blk;
+    }
+
+  octave_idx_type n = dims.numel ();
+
+  for (octave_idx_type off = 0; off < n; off += block_size)
+    {
+      int len = std::min (static_cast<octave_idx_type> (block_size), n - off);
+
+      for (int r : m_variable_registers)
+        {
+          if (data[r])
+            src[r] = data[r] + off;
+        }
+
+      if (res_data)
+        {
+          dst[last] = res_data + off;
+          src[last] = dst[last];
+        }
+
+      for (const auto& insn : m_code)
+        {
+          const double *a = src[insn.lhs];
+          const double *b = src[insn.rhs];
+
+          double *r = dst[insn.dst];
+
+          switch (insn.op)
+            {
+            case op_add:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] + b[k];
+              break;
+
+            case op_sub:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] - b[k];
+              break;
+
+            case op_mul:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] * b[k];
+              break;
+
+            case op_div:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] / b[k];
+              break;
+
+            case op_ldiv:
+              for (int k = 0; k < len; k++)
+                r[k] = b[k] / a[k];
+              break;
+
+            case op_pow:
+              for (int k = 0; k < len; k++)
+                {
+                  if (a[k] < 0.0 && ! xisint (b[k]))
+                    return false;
+                  r[k] = std::pow (a[k], b[k]);
+                }
+              break;
+
+            case op_lt:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] < b[k];
+              break;
+
+            case op_le:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] <= b[k];
+              break;
+
+            case op_eq:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] == b[k];
+              break;
+
+            case op_ge:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] >= b[k];
+              break;
+
+            case op_gt:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] > b[k];
+              break;
+
+            case op_ne:
+              for (int k = 0; k < len; k++)
+                r[k] = a[k] != b[k];
+              break;
+
+            case op_uminus:
+              for (int k = 0; k < len; k++)
+                r[k] = -a[k];
+              break;
+
+            case op_abs:
+              for (int k = 0; k < len; k++)
+                r[k] = std::abs (a[k]);
+              break;
+
+            case op_exp:
+              for (int k = 0; k < len; k++)
+                r[k] = std::exp (a[k]);
+              break;
+
+            case op_log:
+              for (int k = 0; k < len; k++)
+                {
+                  if (a[k] < 0.0)
+                    return false;
+                  r[k] = std::log (a[k]);
+                }
+              break;
+
+            case op_sqrt:
+              for (int k = 0; k < len; k++)
+                {
+                  if (a[k] < 0.0)
+                    return false;
+                  r[k] = std::sqrt (a[k]);
+                }
+              break;
+
+            case op_sin:
+              for (int k = 0; k < len; k++)
+                r[k] = std::sin (a[k]);
+              break;
+
+            case op_cos:
+              for (int k = 0; k < len; k++)
+                r[k] = std::cos (a[k]);
+              break;
+            }
+        }
+
+      if (bool_res_data)
+        {
+          const double *r = src[last];
+
+          for (int k = 0; k < len; k++)
+            bool_res_data[off + k] = (r[k] != 0.0);
+        }
+    }
+
+  if (m_bool_result)
+    result = octave_value (bool_res);
+  else
+    result = octave_value (res);
+
+  return true;
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_bytecode_h)
+#define octave_pt_bytecode_h 1
+
+#include "octave-config.h"
+
+#include <memory>
+#include <vector>
+
+#include "symrec.h"
+#include "symtab.h"
+
+class octave_value;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class tree_binary_expression;
+class tree_evaluator;
+class tree_expression;
+
+// Register-based code for arithmetic and comparison expressions whose
+// operands are variables, constants, and calls to a few elementary
+// built-in functions such as exp and sqrt.
+//
+// A program is compiled once from a binary expression tree.  Every
+// distinct variable and every constant in the tree is given a fixed
+// register and each operator writes its result to a register of its
+// own, so executing the program is a single pass over the instruction
+// list with no octave_value temporaries, no type dispatch, and no
+// memory allocation until the final result is boxed.
+//
+// If all variables are real double or logical scalars, each register
+// holds one value.  If some are real double arrays of the same size and
+// the rest are scalars, the program is instead run over the arrays in
+// blocks of elements, with each register holding one block.  The whole
+// expression is then computed in a single fused loop that writes only
+// the final result, instead of creating a full temporary array for
+// every operator.
+//
+// If a variable has any other type or size when the program is run, a
+// function name no longer refers to the built-in function, or an
+// operation would produce a complex result, execute returns false
+// without side effects and the caller evaluates the expression with the
+// tree evaluator instead.
+
+class bytecode_program
+{
+public:
+
+  enum opcode
+  {
+    op_add,
+    op_sub,
+    op_mul,
+    op_div,
+    op_ldiv,
+    op_pow,
+    op_lt,
+    op_le,
+    op_eq,
+    op_ge,
+    op_gt,
+    op_ne,
+    op_uminus,
+    op_abs,
+    op_exp,
+    op_log,
+    op_sqrt,
+    op_sin,
+    op_cos
+  };
+
+  struct instruction
+  {
+    opcode op;
+    int dst;
+    int lhs;
+    int rhs;
+
+    // TRUE for the matrix forms of *, /, \, and ^, which are only
+    // element-wise operations if the operands are scalars.
+    bool matrix_op;
+  };
+
+  // Number of elements of each register for array operands.
+  static const int block_size = 256;
+
+  // Limit on the number of registers a single program may use.  Larger
+  // expressions are left to the tree evaluator.
+  static const int max_registers = 64;
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode_program)
+
+  ~bytecode_program () = default;
+
+  // Return a compiled program for EXPR, or nullptr if EXPR contains
+  // anything the virtual machine does not support.
+  static std::unique_ptr<bytecode_program>
+  compile (tree_binary_expression& expr);
+
+  bool execute (tree_evaluator& tw, octave_value& result) const;
+
+  std::size_t length () const { return m_code.size (); }
+
+private:
+
+  bytecode_program () = default;
+
+  int compile_operand (tree_expression *expr,
+                       std::vector<tree_binary_expression *>& subexprs);
+
+  bool functions_are_builtin (tree_evaluator& tw) const;
+
+  bool execute_elementwise (tree_evaluator& tw, octave_value& result) const;
+
+  int new_register ();
+
+  int variable_register (const symbol_record& sym);
+
+  int constant_register (double val);
+
+  // Instructions, in execution order.
+  std::vector<instruction> m_code;
+
+  // Variables referenced by the expression and the registers they are
+  // loaded into when the program starts.
+  std::vector<symbol_record> m_variables;
+  std::vector<int> m_variable_registers;
+
+  // Constants and the registers that hold them.
+  std::vector<double> m_constants;
+  std::vector<int> m_constant_registers;
+
+  // Names of the functions called by the expression, and the results
+  // of looking them up, which are kept until the symbol table changes.
+  std::vector<symbol_record> m_functions;
+  mutable std::vector<std::unique_ptr<fcn_lookup_cache>> m_function_caches;
+
+  int m_num_registers = 0;
+
+  // TRUE if the result is logical rather than double.
+  bool m_bool_result = false;
+
+  // TRUE if the expression contains a transpose, which is only a no-op
+  // for scalars.
+  bool m_has_transpose = false;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
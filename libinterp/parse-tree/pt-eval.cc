@@ -29,10 +29,13 @@
 
 #include <cctype>
 
+#include <algorithm>
 #include <condition_variable>
 #include <iostream>
 #include <list>
 #include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
 #include <thread>
 
@@ -41,6 +44,8 @@
 #include "file-stat.h"
 #include "lo-array-errwarn.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
+#include "nproc-wrapper.h"
 #include "oct-env.h"
 
 #include "bp-table.h"
@@ -53,6 +58,9 @@
 #include "input.h"
 #include "interpreter-private.h"
 #include "interpreter.h"
+#include "lab-comm.h"
+#include "local-workers.h"
+#include "ls-oct-binary.h"
 #include "mex-private.h"
 #include "octave.h"
 #include "ov-classdef.h"
@@ -66,6 +74,7 @@
 #include "pt-all.h"
 #include "pt-anon-scopes.h"
 #include "pt-eval.h"
+#include "pt-parfor.h"
 #include "pt-tm-const.h"
 #include "stack-frame.h"
 #include "symtab.h"
@@ -607,6 +616,10 @@ tree_evaluator::parse_and_execute (const std::string& input,
 
   Vlast_prompt_time.stamp ();
 
+  symbol_table& symtab = m_interpreter.get_symbol_table ();
+
+  symtab.invalidate_function_caches ();
+
   bool eof = false;
 
   event_manager& evmgr = m_interpreter.get_event_manager ();
@@ -1929,8 +1942,7 @@ tree_evaluator::is_defined (const tree_expression *expr) const
 bool
 tree_evaluator::is_variable (const symbol_record& sym) const
 {
-  std::shared_ptr<stack_frame> frame
-    = m_call_stack.get_current_stack_frame ();
+  const stack_frame *frame = m_call_stack.current_stack_frame_ptr ();
 
   return frame->is_variable (sym);
 }
@@ -1938,8 +1950,7 @@ tree_evaluator::is_variable (const symbol_record& sym) const
 bool
 tree_evaluator::is_defined (const symbol_record& sym) const
 {
-  std::shared_ptr<stack_frame> frame
-    = m_call_stack.get_current_stack_frame ();
+  const stack_frame *frame = m_call_stack.current_stack_frame_ptr ();
 
   return frame->is_defined (sym);
 }
@@ -1956,10 +1967,9 @@ tree_evaluator::is_global (const std::string& name) const
 octave_value
 tree_evaluator::varval (const symbol_record& sym) const
 {
-  std::shared_ptr<stack_frame> frame
-    = m_call_stack.get_current_stack_frame ();
+  const stack_frame *frame = m_call_stack.current_stack_frame_ptr ();
 
-  return frame->varval (sym);
+  return frame->slot_varval (sym);
 }
 
 octave_value
@@ -3217,6 +3227,302 @@ tree_evaluator::execute_range_loop (const range<T>& rng, int line,
     }
 }
 
+static octave_value
+parfor_reduction_identity (parfor_analysis::reduction_op op)
+{
+  switch (op)
+    {
+    case parfor_analysis::red_add:
+      return octave_value (0.0);
+
+    case parfor_analysis::red_mul:
+    case parfor_analysis::red_el_mul:
+      return octave_value (1.0);
+
+    case parfor_analysis::red_el_and:
+      return octave_value (true);
+
+    case parfor_analysis::red_el_or:
+      return octave_value (false);
+
+    case parfor_analysis::red_min:
+      return octave_value (octave::numeric_limits<double>::Inf ());
+
+    case parfor_analysis::red_max:
+      return octave_value (-octave::numeric_limits<double>::Inf ());
+
+    default:
+      return octave_value (Matrix ());
+    }
+}
+
+static octave_value
+parfor_reduce (interpreter& interp, parfor_analysis::reduction_op op,
+               const octave_value& a, const octave_value& b)
+{
+  switch (op)
+    {
+    case parfor_analysis::red_add:
+      return binary_op (octave_value::op_add, a, b);
+
+    case parfor_analysis::red_mul:
+      return binary_op (octave_value::op_mul, a, b);
+
+    case parfor_analysis::red_el_mul:
+      return binary_op (octave_value::op_el_mul, a, b);
+
+    case parfor_analysis::red_el_and:
+      return binary_op (octave_value::op_el_and, a, b);
+
+    case parfor_analysis::red_el_or:
+      return binary_op (octave_value::op_el_or, a, b);
+
+    case parfor_analysis::red_horzcat:
+      return interp.feval ("horzcat", ovl (a, b), 1)(0);
+
+    case parfor_analysis::red_vertcat:
+      return interp.feval ("vertcat", ovl (a, b), 1)(0);
+
+    case parfor_analysis::red_min:
+      return interp.feval ("min", ovl (a, b), 1)(0);
+
+    case parfor_analysis::red_max:
+      return interp.feval ("max", ovl (a, b), 1)(0);
+
+    default:
+      error ("parfor: invalid reduction operator");
+    }
+}
+
+// Index list that selects elements FIRST through LAST along dimension
+// POSITION of a sliced variable.
+
+static octave_value_list
+parfor_slice_index (const parfor_analysis::sliced_variable& var,
+                    double first, double last)
+{
+  octave_value_list idx (var.nargs, octave_value (octave_value::magic_colon_t));
+
+  idx(var.position) = octave_value (range<double> (first, 1.0, last));
+
+  return idx;
+}
+
+static octave_idx_type
+parfor_slice_extent (const parfor_analysis::sliced_variable& var,
+                     const octave_value& val)
+{
+  if (var.nargs == 1)
+    return val.numel ();
+
+  return val.dims ().redim (var.nargs)(var.position);
+}
+
+// Run the iterations of a parfor loop in worker processes.  Return
+// FALSE without evaluating anything if the loop has to be run serially.
+//
+// Each worker runs a contiguous block of iterations in a copy of the
+// interpreter, then sends its part of every sliced variable and its
+// partial result for every reduction variable back to the parent.
+// Broadcast and temporary variables are left unchanged in the parent.
+
+bool
+tree_evaluator::execute_parfor_loop (tree_simple_for_command& cmd,
+                                     const octave_value& rhs,
+                                     octave_lvalue& ult)
+{
+  // Only ranges of consecutive integers are split between workers.
+
+  if (m_in_worker_process || m_debug_mode || m_echo_state
+      || m_bp_table.have_breakpoints () || ! local_workers::available ()
+      || ! (rhs.is_range () && rhs.is_double_type ()))
+    return false;
+
+  int nworkers = m_parfor_workers;
+
+  tree_expression *maxproc = cmd.maxproc_expr ();
+
+  if (maxproc)
+    {
+      octave_value val = maxproc->evaluate (*this);
+
+      nworkers = val.xint_value ("parfor: MAXPROC must be an integer");
+    }
+
+  range<double> rng = rhs.range_value ();
+
+  octave_idx_type steps = rng.numel ();
+
+  double base = rng.base ();
+
+  if (nworkers < 2 || steps < 2 || rng.increment () != 1
+      || math::x_nint (base) != base)
+    return false;
+
+  if (nworkers > steps)
+    nworkers = steps;
+
+  parfor_analysis info (cmd);
+
+  if (! info.ok ())
+    return false;
+
+  const std::vector<parfor_analysis::sliced_variable>& sliced
+    = info.sliced_variables ();
+
+  const std::vector<parfor_analysis::reduction_variable>& reductions
+    = info.reduction_variables ();
+
+  // Scripts could use or modify any variable, and min and max must be
+  // the functions if they are used for reductions.
+
+  symbol_table& symtab = m_interpreter.get_symbol_table ();
+
+  for (const auto& name : info.broadcast_variables ())
+    {
+      if (is_variable (name))
+        {
+          if (name == "min" || name == "max")
+            return false;
+        }
+      else
+        {
+          octave_value fcn = symtab.find_function (name);
+
+          if (fcn.is_defined () && fcn.is_user_script ())
+            return false;
+        }
+    }
+
+  tree_statement_list *loop_body = cmd.body ();
+
+  // First iteration of the block assigned to worker K.
+  auto block_begin = [steps, nworkers] (int k) -> octave_idx_type
+  {
+    octave_idx_type extra = std::min<octave_idx_type> (k, steps % nworkers);
+
+    return (steps / nworkers) * k + extra;
+  };
+
+  local_workers::task worker = [&] (int k, std::ostream& os)
+  {
+    m_in_worker_process = true;
+
+    if (k > 0)
+      {
+        for (const auto& var : reductions)
+          assign (var.name, parfor_reduction_identity (var.op));
+      }
+
+    octave_idx_type lo = block_begin (k);
+    octave_idx_type hi = block_begin (k + 1);
+
+    for (octave_idx_type i = lo; i < hi; i++)
+      {
+        ult.assign (octave_value::op_asn_eq, octave_value (rng.elem (i)));
+
+        if (loop_body)
+          loop_body->accept (*this);
+
+        if (quit_loop_now ())
+          break;
+      }
+
+    for (const auto& var : sliced)
+      {
+        octave_value val = varval (var.name);
+
+        if (val.is_undefined ())
+          continue;
+
+        double first = std::max (base + lo, 1.0);
+        double last = std::min (base + hi - 1,
+                                double (parfor_slice_extent (var, val)));
+
+        if (last < first)
+          continue;
+
+        octave_value_list idx = parfor_slice_index (var, first, last);
+
+        octave_value slice = val.index_op (idx);
+
+        if (! save_binary_data (os, slice, var.name, std::to_string (first),
+                                false, false))
+          error ("parfor: unable to send value of '%s' from worker",
+                 var.name.c_str ());
+      }
+
+    for (const auto& var : reductions)
+      {
+        if (! save_binary_data (os, varval (var.name), var.name, "",
+                                false, false))
+          error ("parfor: unable to send value of '%s' from worker",
+                 var.name.c_str ());
+      }
+  };
+
+  std::vector<std::string> results = local_workers::run (nworkers, worker);
+
+  std::map<std::string, const parfor_analysis::sliced_variable *> sliced_map;
+
+  for (const auto& var : sliced)
+    sliced_map[var.name] = &var;
+
+  std::map<std::string, parfor_analysis::reduction_op> reduction_map;
+
+  for (const auto& var : reductions)
+    reduction_map[var.name] = var.op;
+
+  std::shared_ptr<stack_frame> frame = get_current_stack_frame ();
+
+  for (int k = 0; k < nworkers; k++)
+    {
+      std::istringstream is (results[k]);
+
+      while (is)
+        {
+          bool global = false;
+          octave_value val;
+          std::string doc;
+
+          std::string name
+            = read_binary_data (is, false, mach_info::native_float_format (),
+                                "parfor", global, val, doc);
+
+          if (name.empty ())
+            break;
+
+          auto p = sliced_map.find (name);
+
+          if (p != sliced_map.end ())
+            {
+              const parfor_analysis::sliced_variable& var = *(p->second);
+
+              double first = std::stod (doc);
+              double last = first + parfor_slice_extent (var, val) - 1;
+
+              std::list<octave_value_list> idx;
+              idx.push_back (parfor_slice_index (var, first, last));
+
+              octave_lvalue ref (frame->insert_symbol (name), frame);
+
+              ref.set_index ("(", idx);
+
+              ref.assign (octave_value::op_asn_eq, val);
+            }
+          else if (k == 0)
+            assign (name, val);
+          else
+            assign (name, parfor_reduce (m_interpreter, reduction_map[name],
+                                         varval (name), val));
+        }
+    }
+
+  ult.assign (octave_value::op_asn_eq, octave_value (rng.final_value ()));
+
+  return true;
+}
+
 void
 tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 {
@@ -3233,9 +3539,6 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (m_debug_mode)
     do_breakpoint (cmd.is_active_breakpoint (*this));
 
-  // FIXME: need to handle PARFOR loops here using cmd.in_parallel ()
-  // and cmd.maxproc_expr ();
-
   unwind_protect_var<bool> upv (m_in_loop_command, true);
 
   tree_expression *expr = cmd.control_expr ();
@@ -3249,6 +3552,9 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 
   octave_lvalue ult = lhs->lvalue (*this);
 
+  if (cmd.in_parallel () && execute_parfor_loop (cmd, rhs, ult))
+    return;
+
   tree_statement_list *loop_body = cmd.body ();
 
   if (rhs.is_range ())
@@ -3426,12 +3732,334 @@ tree_evaluator::visit_complex_for_command (tree_complex_for_command& cmd)
 void
 tree_evaluator::visit_spmd_command (tree_spmd_command& cmd)
 {
-  // For now, we just execute the commands serially.
-
   tree_statement_list *body = cmd.body ();
 
+  int nlabs = m_spmd_workers;
+
+  tree_expression *nworkers = cmd.nworkers_expr ();
+
+  if (nworkers)
+    {
+      octave_value val = nworkers->evaluate (*this);
+
+      nlabs = val.xint_value ("spmd: number of workers must be an integer");
+
+      if (nlabs < 0)
+        error ("spmd: number of workers must be nonnegative");
+
+      tree_expression *max_workers = cmd.max_workers_expr ();
+
+      if (max_workers)
+        {
+          val = max_workers->evaluate (*this);
+
+          int max_labs
+            = val.xint_value ("spmd: number of workers must be an integer");
+
+          if (max_labs < nlabs)
+            error ("spmd: maximum number of workers must not be less than the minimum");
+
+          // Use one lab per processor, within the given limits.
+
+          int nproc = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT);
+
+          nlabs = std::max (nlabs, std::min (max_labs, nproc));
+        }
+    }
+
+  if (nlabs < 1 || m_in_worker_process || m_debug_mode || m_echo_state
+      || m_bp_table.have_breakpoints () || ! local_workers::available ())
+    {
+      // Run the block in the client, which is lab 1 of 1.
+
+      if (body)
+        body->accept (*this);
+
+      return;
+    }
+
+  execute_spmd_block (body, nlabs);
+}
+
+// Find the variables that are assigned in a block of statements.
+
+class assigned_variables : public tree_walker
+{
+public:
+
+  assigned_variables () : m_names () { }
+
+  OCTAVE_DISABLE_COPY_MOVE (assigned_variables)
+
+  ~assigned_variables () = default;
+
+  const std::set<std::string>& names () const { return m_names; }
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&)
+  {
+    // Nothing is assigned in the body of an anonymous function.
+  }
+
+  void visit_function_def (tree_function_def&)
+  {
+    // Assignments in a function are local to it.
+  }
+
+  void visit_simple_for_command (tree_simple_for_command& cmd)
+  {
+    note (cmd.left_hand_side ());
+
+    tree_walker::visit_simple_for_command (cmd);
+  }
+
+  void visit_complex_for_command (tree_complex_for_command& cmd)
+  {
+    note (cmd.left_hand_side ());
+
+    tree_walker::visit_complex_for_command (cmd);
+  }
+
+  void visit_simple_assignment (tree_simple_assignment& expr)
+  {
+    note (expr.left_hand_side ());
+
+    tree_walker::visit_simple_assignment (expr);
+  }
+
+  void visit_multi_assignment (tree_multi_assignment& expr)
+  {
+    note (expr.left_hand_side ());
+
+    tree_walker::visit_multi_assignment (expr);
+  }
+
+  void visit_prefix_expression (tree_prefix_expression& expr)
+  {
+    if (expr.op_type () == octave_value::op_incr
+        || expr.op_type () == octave_value::op_decr)
+      note (expr.operand ());
+
+    tree_walker::visit_prefix_expression (expr);
+  }
+
+  void visit_postfix_expression (tree_postfix_expression& expr)
+  {
+    if (expr.op_type () == octave_value::op_incr
+        || expr.op_type () == octave_value::op_decr)
+      note (expr.operand ());
+
+    tree_walker::visit_postfix_expression (expr);
+  }
+
+private:
+
+  // Note the variable assigned by the target EXPR, which is a variable
+  // or an indexed variable.
+
+  void note (tree_expression *expr)
+  {
+    if (expr && expr->is_index_expression ())
+      expr = dynamic_cast<tree_index_expression *> (expr)->expression ();
+
+    if (expr && expr->is_identifier ())
+      {
+        tree_identifier *id = dynamic_cast<tree_identifier *> (expr);
+
+        if (! id->is_black_hole ())
+          m_names.insert (id->name ());
+      }
+  }
+
+  void note (tree_argument_list *lhs)
+  {
+    if (lhs)
+      {
+        for (tree_expression *elt : *lhs)
+          note (elt);
+      }
+  }
+
+  std::set<std::string> m_names;
+};
+
+// Run BODY on NLABS labs.  Each lab starts with a copy of the caller's
+// workspace, except that composites are replaced by their element for
+// that lab.  Every variable that a lab assigns or otherwise changes is
+// returned to the caller as a composite: a 1 by NLABS cell array
+// holding the value from each lab.
+
+void
+tree_evaluator::execute_spmd_block (tree_statement_list *body, int nlabs)
+{
+  std::shared_ptr<stack_frame> frame = get_current_stack_frame ();
+
+  std::list<std::string> names = frame->variable_names ();
+
+  std::map<std::string, Cell> composites;
+
+  for (const auto& name : names)
+    {
+      octave_value val = varval (name);
+
+      if (is_spmd_composite (val))
+        {
+          Cell c = val.cell_value ();
+
+          if (c.numel () != nlabs)
+            error ("spmd: composite '%s' has %" OCTAVE_IDX_TYPE_FORMAT
+                   " elements but the block runs on %d labs",
+                   name.c_str (), c.numel (), nlabs);
+
+          composites[name] = c;
+        }
+    }
+
+  assigned_variables assigned;
+
   if (body)
-    body->accept (*this);
+    body->accept (assigned);
+
+  local_workers::task lab = [&] (int k, std::ostream& os)
+  {
+    m_in_worker_process = true;
+
+    for (const auto& nm_val : composites)
+      assign (nm_val.first, nm_val.second(k));
+
+    std::map<std::string, octave_value> initial;
+
+    for (const auto& name : names)
+      initial[name] = varval (name);
+
+    if (body)
+      body->accept (*this);
+
+    // Variables assigned in the block are returned even if their value
+    // did not change.  Others may have been changed by functions like
+    // eval or load; since INITIAL still refers to their old values,
+    // changing one gives it a new representation unless it is set to
+    // an equal scalar that shares a static one.
+
+    for (const auto& name : frame->variable_names ())
+      {
+        octave_value val = varval (name);
+
+        if (val.is_undefined ())
+          continue;
+
+        auto p = initial.find (name);
+
+        if (p != initial.end ()
+            && assigned.names ().find (name) == assigned.names ().end ()
+            && p->second.internal_rep () == val.internal_rep ())
+          continue;
+
+        std::ostringstream buf;
+
+        if (save_binary_data (buf, val, name, "", false, false))
+          os << buf.str ();
+        else
+          warning_with_id ("Octave:spmd-composite",
+                           "spmd: unable to return value of '%s' from lab %d",
+                           name.c_str (), k + 1);
+      }
+  };
+
+  lab_channels channels;
+
+  std::vector<std::string> results = local_workers::run (nlabs, lab, &channels);
+
+  std::map<std::string, Cell> values;
+  std::vector<std::string> changed;
+
+  for (int k = 0; k < nlabs; k++)
+    {
+      std::istringstream is (results[k]);
+
+      while (is)
+        {
+          bool global = false;
+          octave_value val;
+          std::string doc;
+
+          std::string name
+            = read_binary_data (is, false, mach_info::native_float_format (),
+                                "spmd", global, val, doc);
+
+          if (name.empty ())
+            break;
+
+          auto p = values.find (name);
+
+          if (p == values.end ())
+            {
+              // Labs that did not change the variable keep the value
+              // they started with.
+
+              Cell c (1, nlabs);
+
+              auto q = composites.find (name);
+
+              if (q != composites.end ())
+                c = q->second.reshape (dim_vector (1, nlabs));
+              else
+                {
+                  octave_value orig = varval (name);
+
+                  if (orig.is_defined ())
+                    c = Cell (1, nlabs, orig);
+                }
+
+              p = values.emplace (name, c).first;
+
+              changed.push_back (name);
+            }
+
+          p->second(k) = val;
+        }
+    }
+
+  // Keep track of the new composites and of older ones that are still
+  // in use here.
+
+  std::list<octave_value> in_use;
+
+  for (const auto& name : frame->variable_names ())
+    {
+      if (values.find (name) != values.end ())
+        continue;
+
+      octave_value val = varval (name);
+
+      if (is_spmd_composite (val))
+        in_use.push_back (val);
+    }
+
+  for (const auto& name : changed)
+    {
+      octave_value val (values[name]);
+
+      assign (name, val);
+
+      in_use.push_back (val);
+    }
+
+  m_spmd_composites = in_use;
+}
+
+bool
+tree_evaluator::is_spmd_composite (const octave_value& val)
+{
+  if (! val.iscell ())
+    return false;
+
+  for (const auto& c : m_spmd_composites)
+    {
+      if (c.internal_rep () == val.internal_rep ())
+        return true;
+    }
+
+  return false;
 }
 
 octave_value
@@ -4779,6 +5407,10 @@ tree_evaluator::add_autoload (const std::string& fcn,
                               const std::string& nm)
 {
   m_autoload_map[fcn] = check_autoload_file (nm);
+
+  symbol_table& symtab = m_interpreter.get_symbol_table ();
+
+  symtab.invalidate_function_caches ();
 }
 
 void
@@ -4809,6 +5441,27 @@ tree_evaluator::silent_functions (const octave_value_list& args, int nargout)
                                 "silent_functions");
 }
 
+octave_value
+tree_evaluator::bytecode_enabled (const octave_value_list& args, int nargout)
+{
+  return set_internal_variable (m_bytecode_enabled, args, nargout,
+                                "__vm_enable__");
+}
+
+octave_value
+tree_evaluator::parfor_workers (const octave_value_list& args, int nargout)
+{
+  return set_internal_variable (m_parfor_workers, args, nargout,
+                                "__parfor_workers__", 0);
+}
+
+octave_value
+tree_evaluator::spmd_workers (const octave_value_list& args, int nargout)
+{
+  return set_internal_variable (m_spmd_workers, args, nargout,
+                                "__spmd_workers__", 0);
+}
+
 octave_value
 tree_evaluator::string_fill_char (const octave_value_list& args, int nargout)
 {
@@ -5543,6 +6196,458 @@ The original variable value is restored when exiting the function.
 %!error silent_functions (1, 2)
 */
 
+DEFMETHOD (__vm_enable__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __vm_enable__ ()
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val}, "local")
+Query or set the internal variable that controls whether arithmetic and
+comparison expressions are compiled to bytecode.
+
+When enabled (the default), expressions built only from variables,
+constants, and the operators @code{+}, @code{-}, @code{*}, @code{/},
+@code{\}, @code{^}, their element-wise forms, and the comparison
+operators are compiled the first time they are evaluated.  As long as all
+of the variables hold real double or logical scalars, the compiled form is
+executed directly without creating intermediate values.  Otherwise, the
+expression is evaluated normally.  Disabling the bytecode interpreter does
+not change any results; it is only useful for debugging and benchmarking.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.bytecode_enabled (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = __vm_enable__ ();
+%! old_val = __vm_enable__ (! orig_val);
+%! assert (orig_val, old_val);
+%! assert (__vm_enable__ (), ! orig_val);
+%! __vm_enable__ (orig_val);
+%! assert (__vm_enable__ (), orig_val);
+
+%!function r = __vm_scalar_exprs__ (a, b, c)
+%!  r = zeros (1, 14);
+%!  r(1) = a*b + c;
+%!  r(2) = a - b/c;
+%!  r(3) = -a .* (b - c) ./ 2;
+%!  r(4) = (a + b)^2 - c.^3;
+%!  r(5) = b \ a + c .\ b;
+%!  r(6) = a' + b.';
+%!  r(7) = (a < b) + (b <= c) + (a == c) + (a ~= b);
+%!  r(8) = (a > b) * 3 - (c >= a);
+%!  r(9) = a*a*a - b*b + c;
+%!  r(10) = 1 - a/0;
+%!  r(11) = (a + 1) * (b + 2) * (c + 3) - 4;
+%!  r(12) = +a - -b;
+%!  r(13) = a ^ 2;
+%!  r(14) = 2 ^ -c;
+%!endfunction
+
+%!test
+%! orig_val = __vm_enable__ (false);
+%! unwind_protect
+%!   args = {{1.5, -2, 3}, {0, 0, 0}, {NaN, 1, Inf}, {-Inf, 2, 0.25}, ...
+%!           {true, false, 2}};
+%!   for k = 1:numel (args)
+%!     __vm_enable__ (false);
+%!     expected = __vm_scalar_exprs__ (args{k}{:});
+%!     __vm_enable__ (true);
+%!     for n = 1:3
+%!       assert (__vm_scalar_exprs__ (args{k}{:}), expected);
+%!     endfor
+%!   endfor
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## Results must keep the class produced by the tree evaluator
+%!test
+%! orig_val = __vm_enable__ (true);
+%! unwind_protect
+%!   a = 2;  b = 3;
+%!   assert (class (a + b), "double");
+%!   assert (class (a < b), "logical");
+%!   assert (a < b, true);
+%!   t = true;
+%!   assert (class (t + t), "double");
+%!   assert (t + t, 2);
+%!   assert (class (t == t), "logical");
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## Operands the bytecode interpreter does not handle fall back to the
+## tree evaluator
+%!test
+%! orig_val = __vm_enable__ (true);
+%! unwind_protect
+%!   a = -8;  b = 1/3;
+%!   assert (a ^ b, (-8) ^ (1/3));
+%!   assert (iscomplex (a ^ b));
+%!   x = [1, 2, 3];
+%!   y = 2;
+%!   assert (x * y + 1, [3, 5, 7]);
+%!   x = int8 (100);
+%!   assert (x + y * 20, int8 (127));
+%!   x = single (1);
+%!   assert (class (x + y), "single");
+%!   x = 1i;
+%!   assert (x * y + 1, 1 + 2i);
+%!   assert (pi * y, 2*pi);
+%!   clear x;
+%!   fail ("x + y", "'x' undefined");
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## The compiled program must not be tied to the type an expression first
+## saw
+%!test
+%! orig_val = __vm_enable__ (true);
+%! unwind_protect
+%!   vals = {2, [1 2], 3, int16(4), 5, single(6), 7};
+%!   for k = 1:numel (vals)
+%!     v = vals{k};
+%!     assert (v * 2 + 1, vals{k} .* 2 + 1);
+%!   endfor
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## Element-wise expressions on arrays run as one fused loop
+%!function r = __vm_array_exprs__ (a, x, b, c)
+%!  r = cell (1, 9);
+%!  r{1} = a.*x + b.*x.^2 - c;
+%!  r{2} = 2*x - x/4 + 3\x;
+%!  r{3} = exp (-x.^2 / 2) ./ sqrt (2*c);
+%!  r{4} = (x > b) + (x <= a);
+%!  r{5} = abs (x - b) .* cos (x) + sin (c);
+%!  r{6} = -x .* a;
+%!  r{7} = x .^ 2 + log (abs (x) + 1);
+%!  r{8} = x > c;
+%!  r{9} = 2 .^ x - a ./ (x + b);
+%!endfunction
+
+%!test
+%! orig_val = __vm_enable__ (false);
+%! unwind_protect
+%!   x = [-2, -0.5, 0, 0.25, 1, 3; 7, NaN, Inf, -Inf, 2, -1];
+%!   args = {{2, x, 0.5, 3}, {x, x, -x, 1}, {1, reshape (1:600, 20, 30), 2, 4}, ...
+%!           {true, x, 2, 0}, {1, zeros (0, 3), 1, 1}};
+%!   for k = 1:numel (args)
+%!     __vm_enable__ (false);
+%!     expected = __vm_array_exprs__ (args{k}{:});
+%!     __vm_enable__ (true);
+%!     for n = 1:3
+%!       assert (__vm_array_exprs__ (args{k}{:}), expected);
+%!     endfor
+%!   endfor
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## Matrix operators, broadcasting, complex results, and redefined
+## function names fall back to the tree evaluator
+%!test
+%! orig_val = __vm_enable__ (true);
+%! unwind_protect
+%!   A = [1, 2; 3, 4];
+%!   B = [0, 1; 1, 0];
+%!   assert (A * B + 1, [3, 2; 5, 4]);
+%!   assert (A ^ 2 - 1, [6, 9; 14, 21]);
+%!   b = [5; 11];
+%!   assert (A \ b + 0, [1; 2], 1e-12);
+%!   r = [1, 2, 3];
+%!   c = [1; 2];
+%!   assert (r + c .* 2, [3, 4, 5; 5, 6, 7]);
+%!   assert (r' + 1, [2; 3; 4]);
+%!   assert (sqrt (r - 2) + 1, [1+i, 1, 2]);
+%!   assert (iscomplex ((-r) .^ 0.5 + 1));
+%!   exp = [10, 20, 30];
+%!   assert (exp (2) + 1, 21);
+%! unwind_protect_cleanup
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+
+## Function names are looked up again when a function shadows them
+%!test
+%! orig_val = __vm_enable__ (true);
+%! warning ("off", "Octave:shadowed-function", "local");
+%! unwind_protect
+%!   x = 4;
+%!   r = zeros (1, 3);
+%!   for i = 1:3
+%!     if (i == 2)
+%!       eval ("function r = sqrt (x), r = 100; endfunction");
+%!     elseif (i == 3)
+%!       clear -f sqrt;
+%!     endif
+%!     r(i) = sqrt (x) + 1;
+%!   endfor
+%!   assert (r, [3, 101, 3]);
+%! unwind_protect_cleanup
+%!   clear -f sqrt;
+%!   __vm_enable__ (orig_val);
+%! end_unwind_protect
+*/
+
+DEFMETHOD (__parfor_workers__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __parfor_workers__ ()
+@deftypefnx {} {@var{old_val} =} __parfor_workers__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __parfor_workers__ (@var{new_val}, "local")
+Query or set the internal variable that specifies the number of worker
+processes used by @code{parfor} loops that do not give a maximum number of
+workers themselves.
+
+The default value of 0 runs such loops serially.  A loop written as
+@code{parfor (@var{i} = @var{range}, @var{maxproc})} uses at most
+@var{maxproc} workers regardless of this setting.
+
+Loops only run in parallel when the range is a sequence of consecutive
+integers and every variable used in the loop body can be classified as a
+broadcast, sliced, reduction, or temporary variable.  Other loops, and
+loops executed while debugging or echoing commands, run serially.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{parfor, nproc}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.parfor_workers (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = __parfor_workers__ ();
+%! old_val = __parfor_workers__ (4);
+%! assert (orig_val, old_val);
+%! assert (__parfor_workers__ (), 4);
+%! __parfor_workers__ (orig_val);
+%! assert (__parfor_workers__ (), orig_val);
+
+%!error <arg must be greater than 0> __parfor_workers__ (-1)
+
+## Sliced output variables
+%!test
+%! n = 20;
+%! y = zeros (1, n);
+%! parfor (i = 1:n, 4)
+%!   t = i^2;
+%!   y(i) = t + 1;
+%! endparfor
+%! assert (y, (1:n).^2 + 1);
+
+%!test
+%! A = zeros (3, 10);
+%! c = {};
+%! parfor (k = 1:10, 3)
+%!   A(:,k) = [k; 2*k; 3*k];
+%!   c{k} = sprintf ("%d", k);
+%! endparfor
+%! assert (A, [1:10; 2*(1:10); 3*(1:10)]);
+%! assert (c, arrayfun (@(k) sprintf ("%d", k), 1:10, "uniformoutput", false));
+
+## Sliced variable created by the loop, with a range not starting at 1
+%!test
+%! clear z;
+%! parfor (i = 3:9, 2)
+%!   z(i) = -i;
+%! endparfor
+%! assert (z, [0, 0, -(3:9)]);
+
+## Reduction variables
+%!test
+%! s = 10;
+%! p = 1;
+%! cnt = 0;
+%! v = [];
+%! lo = Inf;
+%! hi = -Inf;
+%! parfor (i = 1:12, 4)
+%!   s = s + i;
+%!   p *= i;
+%!   cnt++;
+%!   v = [v, i];
+%!   lo = min (lo, mod (i, 5));
+%!   hi = max (i - 3, hi);
+%! endparfor
+%! assert (s, 10 + sum (1:12));
+%! assert (p, prod (1:12));
+%! assert (cnt, 12);
+%! assert (v, 1:12);
+%! assert (lo, 0);
+%! assert (hi, 9);
+
+## Broadcast variables, temporaries, and anonymous functions
+%!test
+%! a = 3;
+%! f = @(x) a*x;
+%! r = zeros (8, 1);
+%! parfor (i = 1:8, 4)
+%!   t = f (i);
+%!   if (t > 10)
+%!     t = t - 10;
+%!   endif
+%!   r(i) = t;
+%! endparfor
+%! assert (r, [3; 6; 9; 2; 5; 8; 11; 14]);
+
+## Loops that can't run in parallel still give serial results
+%!test
+%! x = 0;
+%! y = zeros (1, 5);
+%! parfor (i = 1:5, 4)
+%!   x = x * 2 + i;
+%!   y(i) = x;
+%! endparfor
+%! assert (y, [1, 4, 11, 26, 57]);
+%! assert (x, 57);
+
+%!test
+%! y = zeros (1, 5);
+%! parfor (i = 1:5, 4)
+%!   if (i > 3)
+%!     break;
+%!   endif
+%!   y(i) = i;
+%! endparfor
+%! assert (y, [1, 2, 3, 0, 0]);
+
+## Errors in workers are reported in the parent
+%!error <worker error 3>
+%! parfor (i = 1:6, 3)
+%!   if (i == 3)
+%!     error ("worker error %d", i);
+%!   endif
+%! endparfor
+
+## Workers get different random numbers
+%!test
+%! r = zeros (1, 4);
+%! parfor (i = 1:4, 4)
+%!   r(i) = rand ();
+%! endparfor
+%! assert (numel (unique (r)), 4);
+*/
+
+DEFMETHOD (__spmd_workers__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __spmd_workers__ ()
+@deftypefnx {} {@var{old_val} =} __spmd_workers__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __spmd_workers__ (@var{new_val}, "local")
+Query or set the internal variable that specifies the number of labs used
+by @code{spmd} blocks that do not give a number of workers themselves.
+
+The default value of 0 runs such blocks once in the client, which is then
+lab 1 of 1.  Blocks executed while debugging or echoing commands, and
+blocks nested in another @code{spmd} block or @code{parfor} loop, also run
+in the client.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{spmd, labindex, numlabs, __parfor_workers__}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.spmd_workers (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = __spmd_workers__ ();
+%! old_val = __spmd_workers__ (3);
+%! assert (orig_val, old_val);
+%! assert (__spmd_workers__ (), 3);
+%! __spmd_workers__ (orig_val);
+%! assert (__spmd_workers__ (), orig_val);
+
+%!error <arg must be greater than 0> __spmd_workers__ (-1)
+
+## Variables set in the block become composites
+%!test
+%! a = 10;
+%! spmd (3)
+%!   b = a * labindex ();
+%! end
+%! assert (b, {10, 20, 30});
+%! assert (a, 10);
+
+## Composites are split across the labs of the next block
+%!test
+%! spmd (2)
+%!   x = labindex ();
+%!   y = 0;
+%! end
+%! spmd (2)
+%!   if (labindex () == 2)
+%!     x = x + 100;
+%!   end
+%! end
+%! assert (x, {1, 102});
+%! assert (y, {0, 0});
+
+## Assigning a variable makes it a composite even if its value is the same
+%!test
+%! a = 0;
+%! b = [1, 2];
+%! c = b;
+%! spmd (2)
+%!   a = 0;
+%!   c = b;
+%!   [~, d] = deal (1, true);
+%! end
+%! assert (a, {0, 0});
+%! assert (b, [1, 2]);
+%! assert (c, {[1, 2], [1, 2]});
+%! assert (d, {true, true});
+
+## Composite size must match the number of labs
+%!error <composite 'x' has 2 elements>
+%! spmd (2)
+%!   x = 1;
+%! end
+%! spmd (3)
+%!   y = x;
+%! end
+
+## Serial execution in the client
+%!test
+%! spmd (0)
+%!   z = numlabs ();
+%! end
+%! assert (z, 1);
+
+%!test
+%! spmd
+%!   w = labindex ();
+%! end
+%! assert (w, 1);
+
+%!error <must not be less than the minimum>
+%! spmd (3, 2)
+%! end
+
+%!error <lab 2>
+%! spmd (2)
+%!   if (labindex () == 2)
+%!     error ("lab %d", labindex ());
+%!   end
+%! end
+*/
+
 DEFMETHOD (string_fill_char, interp, args, nargout,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{val} =} string_fill_char ()
@@ -132,7 +132,10 @@ public:
       m_debug_mode (false), m_quiet_breakpoint_flag (false),
       m_debugger_stack (), m_exit_status (0), m_max_recursion_depth (256),
       m_whos_line_format ("  %la:5; %ln:6; %cs:16:6:1;  %rb:12;  %lc:-1;\n"),
-      m_silent_functions (false), m_string_fill_char (' '), m_PS4 ("+ "),
+      m_silent_functions (false), m_bytecode_enabled (true),
+      m_parfor_workers (0), m_spmd_workers (0),
+      m_in_worker_process (false), m_spmd_composites (),
+      m_string_fill_char (' '), m_PS4 ("+ "),
       m_dbstep_flag (0), m_break_on_next_stmt (false), m_echo (ECHO_OFF),
       m_echo_state (false), m_echo_file_name (),
       m_echo_file_pos (1),
@@ -628,6 +631,44 @@ public:
   octave_value
   silent_functions (const octave_value_list& args, int nargout);
 
+  bool bytecode_enabled () const { return m_bytecode_enabled; }
+
+  bool bytecode_enabled (bool b)
+  {
+    bool val = m_bytecode_enabled;
+    m_bytecode_enabled = b;
+    return val;
+  }
+
+  octave_value
+  bytecode_enabled (const octave_value_list& args, int nargout);
+
+  int parfor_workers () const { return m_parfor_workers; }
+
+  int parfor_workers (int n)
+  {
+    int val = m_parfor_workers;
+    m_parfor_workers = n;
+    return val;
+  }
+
+  octave_value
+  parfor_workers (const octave_value_list& args, int nargout);
+
+  int spmd_workers () const { return m_spmd_workers; }
+
+  int spmd_workers (int n)
+  {
+    int val = m_spmd_workers;
+    m_spmd_workers = n;
+    return val;
+  }
+
+  octave_value
+  spmd_workers (const octave_value_list& args, int nargout);
+
+  bool in_worker_process () const { return m_in_worker_process; }
+
   std::size_t debug_frame () const { return m_debug_frame; }
 
   std::size_t debug_frame (std::size_t n)
@@ -867,6 +908,13 @@ private:
                            octave_lvalue& ult,
                            tree_statement_list *loop_body);
 
+  bool execute_parfor_loop (tree_simple_for_command& cmd,
+                            const octave_value& rhs, octave_lvalue& ult);
+
+  void execute_spmd_block (tree_statement_list *body, int nlabs);
+
+  bool is_spmd_composite (const octave_value& val);
+
   void set_echo_state (int type, const std::string& file_name, int pos);
 
   void maybe_set_echo_state ();
@@ -945,6 +993,26 @@ private:
   // semicolon has been appended to each statement).
   bool m_silent_functions;
 
+  // If TRUE, compile arithmetic expressions on scalar variables to
+  // bytecode (see pt-bytecode.h) instead of walking the parse tree.
+  bool m_bytecode_enabled;
+
+  // Default number of worker processes for parfor loops that do not
+  // specify one.  Loops run serially if this is less than 2.
+  int m_parfor_workers;
+
+  // Default number of labs for spmd blocks that do not specify one.
+  // Blocks run serially in the client if this is 0.
+  int m_spmd_workers;
+
+  // TRUE in a worker process that is running part of a parfor loop or
+  // an spmd block.  Nested parfor loops and spmd blocks run serially.
+  bool m_in_worker_process;
+
+  // Values returned from spmd blocks as composites.  A composite passed
+  // to a later spmd block is replaced by its element for each lab.
+  std::list<octave_value> m_spmd_composites;
+
   // The character to fill with when creating string arrays.
   char m_string_fill_char;
 
@@ -101,7 +101,7 @@ tree_identifier::evaluate_n (tree_evaluator& tw, int nargout)
 
       symbol_table& symtab = interp.get_symbol_table ();
 
-      val = symtab.find_function (m_sym.name ());
+      val = m_fcn_cache.find_function (symtab, m_sym.name ());
     }
 
   if (val.is_defined ())
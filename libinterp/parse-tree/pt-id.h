@@ -41,6 +41,7 @@ class octave_function;
 #include "pt-exp.h"
 #include "pt-walk.h"
 #include "symscope.h"
+#include "symtab.h"
 #include "token.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -135,6 +136,9 @@ protected:
 
   // The IDENT token from the lexer.
   token m_token;
+
+  // The function this identifier referred to when last evaluated.
+  fcn_lookup_cache m_fcn_cache;
 };
 
 class tree_black_hole : public tree_identifier
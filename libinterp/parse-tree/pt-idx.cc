@@ -456,7 +456,8 @@ tree_index_expression::evaluate_n (tree_evaluator& tw, int nargout)
 
           symbol_table& symtab = interp.get_symbol_table ();
 
-          octave_value val = symtab.find_function (nm, first_args);
+          octave_value val = m_fcn_cache.find_function (symtab, nm,
+                                                        first_args);
 
           octave_function *fcn = nullptr;
 
@@ -38,6 +38,7 @@ class octave_value_list;
 
 #include "pt-exp.h"
 #include "pt-walk.h"
+#include "symtab.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -146,6 +147,10 @@ private:
   // TRUE if this expression was parsed as a word list command.
   bool m_word_list_cmd {false};
 
+  // The function called by the first index when the indexed
+  // expression is a function name.
+  fcn_lookup_cache m_fcn_cache;
+
   tree_index_expression () = default;
 
   octave_map make_arg_struct () const;
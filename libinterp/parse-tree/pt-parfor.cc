@@ -0,0 +1,858 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include "ov.h"
+#include "pt-arg-list.h"
+#include "pt-assign.h"
+#include "pt-binop.h"
+#include "pt-cbinop.h"
+#include "pt-const.h"
+#include "pt-except.h"
+#include "pt-fcn-handle.h"
+#include "pt-id.h"
+#include "pt-idx.h"
+#include "pt-loop.h"
+#include "pt-mat.h"
+#include "pt-misc.h"
+#include "pt-parfor.h"
+#include "pt-select.h"
+#include "pt-stmt.h"
+#include "pt-unop.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Functions that read or modify variables of their caller by name.
+
+static bool
+is_workspace_function (const std::string& name)
+{
+  static const std::set<std::string> names
+    = { "assignin", "clear", "clearvars", "eval", "evalc", "evalin",
+        "input", "inputname", "keyboard", "load" };
+
+  return names.find (name) != names.end ();
+}
+
+// Find out whether an expression refers to a given variable.
+
+class variable_finder : public tree_walker
+{
+public:
+
+  variable_finder (const std::string& name) : m_name (name), m_found (false)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (variable_finder)
+
+  ~variable_finder () = default;
+
+  bool found () const { return m_found; }
+
+  void visit_identifier (tree_identifier& id)
+  {
+    if (id.name () == m_name)
+      m_found = true;
+  }
+
+private:
+
+  std::string m_name;
+
+  bool m_found;
+};
+
+parfor_analysis::parfor_analysis (tree_simple_for_command& cmd)
+  : m_ok (true), m_loop_var (), m_depth (0), m_loop_depth (0),
+    m_anon_params (), m_usage (), m_names (), m_broadcast (), m_sliced (),
+    m_reduction (), m_temporary ()
+{
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (! lhs || ! lhs->is_identifier ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  m_loop_var = dynamic_cast<tree_identifier *> (lhs)->name ();
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  if (m_ok)
+    classify ();
+}
+
+void
+parfor_analysis::visit_anon_fcn_handle (tree_anon_fcn_handle& afh)
+{
+  // Parameters are local to the anonymous function, every other
+  // variable in its body is captured from the loop body.
+
+  tree_parameter_list *params = afh.parameter_list ();
+
+  std::vector<std::string> names;
+
+  if (params)
+    {
+      for (tree_decl_elt *elt : *params)
+        names.push_back (elt->name ());
+    }
+
+  for (const auto& name : names)
+    m_anon_params.insert (name);
+
+  tree_expression *expr = afh.expression ();
+
+  if (expr)
+    expr->accept (*this);
+
+  for (const auto& name : names)
+    m_anon_params.erase (m_anon_params.find (name));
+}
+
+void
+parfor_analysis::visit_break_command (tree_break_command&)
+{
+  if (m_loop_depth == 0)
+    m_ok = false;
+}
+
+void
+parfor_analysis::visit_decl_command (tree_decl_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analysis::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (lhs && lhs->is_identifier ())
+    note_write (lhs->name ());
+  else
+    m_ok = false;
+
+  m_depth++;
+  m_loop_depth++;
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_loop_depth--;
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  tree_argument_list *lhs = cmd.left_hand_side ();
+
+  if (lhs)
+    {
+      for (tree_expression *elt : *lhs)
+        {
+          if (elt && elt->is_identifier ())
+            note_write (elt->name ());
+          else
+            m_ok = false;
+        }
+    }
+
+  m_depth++;
+  m_loop_depth++;
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_loop_depth--;
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_spmd_command (tree_spmd_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analysis::visit_function_def (tree_function_def&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analysis::visit_identifier (tree_identifier& id)
+{
+  note_read (id.name ());
+}
+
+void
+parfor_analysis::visit_if_command_list (tree_if_command_list& lst)
+{
+  m_depth++;
+
+  tree_walker::visit_if_command_list (lst);
+
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_switch_case_list (tree_switch_case_list& lst)
+{
+  m_depth++;
+
+  tree_walker::visit_switch_case_list (lst);
+
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_index_expression (tree_index_expression& expr)
+{
+  tree_expression *base = expr.expression ();
+
+  if (base && base->is_identifier ())
+    note_indexed (base->name (), expr, false);
+  else if (base)
+    base->accept (*this);
+
+  visit_index_arguments (expr);
+}
+
+void
+parfor_analysis::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (rhs)
+    rhs->accept (*this);
+
+  tree_argument_list *lhs = expr.left_hand_side ();
+
+  if (! lhs)
+    return;
+
+  for (tree_expression *elt : *lhs)
+    {
+      if (! elt)
+        continue;
+
+      if (elt->is_identifier ())
+        {
+          tree_identifier *id = dynamic_cast<tree_identifier *> (elt);
+
+          if (! id->is_black_hole ())
+            note_write (id->name ());
+        }
+      else if (elt->is_index_expression ())
+        {
+          tree_index_expression *idx
+            = dynamic_cast<tree_index_expression *> (elt);
+
+          tree_expression *base = idx->expression ();
+
+          if (base && base->is_identifier ())
+            note_indexed (base->name (), *idx, true);
+          else
+            m_ok = false;
+
+          visit_index_arguments (*idx);
+        }
+      else
+        m_ok = false;
+    }
+}
+
+void
+parfor_analysis::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  tree_expression *op = expr.operand ();
+
+  if (op && op->is_identifier ()
+      && (expr.op_type () == octave_value::op_incr
+          || expr.op_type () == octave_value::op_decr))
+    note_reduction (op->name (), red_add);
+  else
+    tree_walker::visit_postfix_expression (expr);
+}
+
+void
+parfor_analysis::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  tree_expression *op = expr.operand ();
+
+  if (op && op->is_identifier ()
+      && (expr.op_type () == octave_value::op_incr
+          || expr.op_type () == octave_value::op_decr))
+    note_reduction (op->name (), red_add);
+  else
+    tree_walker::visit_prefix_expression (expr);
+}
+
+void
+parfor_analysis::visit_return_command (tree_return_command&)
+{
+  m_ok = false;
+}
+
+void
+parfor_analysis::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  tree_expression *lhs = expr.left_hand_side ();
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (! (lhs && rhs))
+    {
+      m_ok = false;
+      return;
+    }
+
+  octave_value::assign_op op = expr.op_type ();
+
+  if (lhs->is_identifier ())
+    {
+      std::string name = lhs->name ();
+
+      reduction_op red = red_none;
+      tree_expression *operand = nullptr;
+
+      if (op == octave_value::op_asn_eq)
+        operand = reduction_operand (rhs, name, red);
+      else
+        {
+          switch (op)
+            {
+            case octave_value::op_add_eq:
+            case octave_value::op_sub_eq:
+              red = red_add;
+              break;
+
+            case octave_value::op_mul_eq:
+              red = red_mul;
+              break;
+
+            case octave_value::op_el_mul_eq:
+              red = red_el_mul;
+              break;
+
+            case octave_value::op_el_and_eq:
+              red = red_el_and;
+              break;
+
+            case octave_value::op_el_or_eq:
+              red = red_el_or;
+              break;
+
+            default:
+              break;
+            }
+
+          if (red != red_none && ! mentions_variable (rhs, name))
+            operand = rhs;
+        }
+
+      if (operand)
+        {
+          operand->accept (*this);
+
+          note_reduction (name, red);
+        }
+      else
+        {
+          rhs->accept (*this);
+
+          if (op == octave_value::op_asn_eq)
+            note_write (name);
+          else
+            note_other (name);
+        }
+    }
+  else if (lhs->is_index_expression ())
+    {
+      rhs->accept (*this);
+
+      tree_index_expression *idx = dynamic_cast<tree_index_expression *> (lhs);
+
+      tree_expression *base = idx->expression ();
+
+      if (base && base->is_identifier ())
+        note_indexed (base->name (), *idx, true);
+      else
+        m_ok = false;
+
+      visit_index_arguments (*idx);
+    }
+  else
+    m_ok = false;
+}
+
+void
+parfor_analysis::visit_try_catch_command (tree_try_catch_command& cmd)
+{
+  m_depth++;
+
+  tree_statement_list *try_code = cmd.body ();
+
+  if (try_code)
+    try_code->accept (*this);
+
+  tree_identifier *expr_id = cmd.identifier ();
+
+  if (expr_id)
+    note_write (expr_id->name ());
+
+  tree_statement_list *catch_code = cmd.cleanup ();
+
+  if (catch_code)
+    catch_code->accept (*this);
+
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_unwind_protect_command
+  (tree_unwind_protect_command& cmd)
+{
+  m_depth++;
+
+  tree_walker::visit_unwind_protect_command (cmd);
+
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_while_command (tree_while_command& cmd)
+{
+  m_depth++;
+  m_loop_depth++;
+
+  tree_walker::visit_while_command (cmd);
+
+  m_loop_depth--;
+  m_depth--;
+}
+
+void
+parfor_analysis::visit_do_until_command (tree_do_until_command& cmd)
+{
+  m_depth++;
+  m_loop_depth++;
+
+  tree_walker::visit_do_until_command (cmd);
+
+  m_loop_depth--;
+  m_depth--;
+}
+
+parfor_analysis::usage&
+parfor_analysis::use (const std::string& name)
+{
+  auto p = m_usage.find (name);
+
+  if (p == m_usage.end ())
+    {
+      m_names.push_back (name);
+
+      p = m_usage.emplace (name, usage ()).first;
+    }
+
+  return p->second;
+}
+
+void
+parfor_analysis::note_read (const std::string& name)
+{
+  if (name == "end" || m_anon_params.count (name))
+    return;
+
+  if (is_workspace_function (name))
+    m_ok = false;
+
+  use (name).read = true;
+}
+
+void
+parfor_analysis::note_write (const std::string& name)
+{
+  bool first = (m_usage.find (name) == m_usage.end ());
+
+  usage& u = use (name);
+
+  if (first && m_depth == 0)
+    u.assigned_first = true;
+
+  u.write = true;
+}
+
+void
+parfor_analysis::note_indexed (const std::string& name,
+                               tree_index_expression& expr, bool is_write)
+{
+  if (m_anon_params.count (name))
+    return;
+
+  if (is_workspace_function (name))
+    m_ok = false;
+
+  int nargs = 0;
+  int position = 0;
+
+  if (! slice_position (expr, nargs, position))
+    {
+      if (is_write)
+        note_other (name);
+      else
+        note_read (name);
+
+      return;
+    }
+
+  usage& u = use (name);
+
+  if (u.indexed && (u.nargs != nargs || u.position != position))
+    u.indexed_mismatch = true;
+
+  u.indexed = true;
+  u.nargs = nargs;
+  u.position = position;
+
+  if (is_write)
+    u.indexed_write = true;
+}
+
+void
+parfor_analysis::note_reduction (const std::string& name, reduction_op op)
+{
+  usage& u = use (name);
+
+  if (u.op != red_none && u.op != op)
+    u.reduction_mismatch = true;
+
+  u.op = op;
+}
+
+void
+parfor_analysis::note_other (const std::string& name)
+{
+  use (name).other = true;
+}
+
+// Return TRUE if EXPR is a single "()" or "{}" index that has the loop
+// variable by itself as one index and only colons, constants, or other
+// variables as the remaining indices.
+
+bool
+parfor_analysis::slice_position (tree_index_expression& expr, int& nargs,
+                                 int& position)
+{
+  std::string type = expr.type_tags ();
+
+  if (type != "(" && type != "{")
+    return false;
+
+  std::list<tree_argument_list *> arg_lists = expr.arg_lists ();
+
+  tree_argument_list *args = arg_lists.front ();
+
+  if (! args || args->empty ())
+    return false;
+
+  nargs = 0;
+  position = -1;
+
+  for (tree_expression *arg : *args)
+    {
+      if (! arg)
+        return false;
+
+      if (arg->is_identifier ())
+        {
+          if (arg->name () == m_loop_var)
+            {
+              if (position >= 0)
+                return false;
+
+              position = nargs;
+            }
+        }
+      else if (! arg->is_constant ())
+        return false;
+
+      nargs++;
+    }
+
+  return position >= 0;
+}
+
+bool
+parfor_analysis::mentions_variable (tree_expression *expr,
+                                    const std::string& name)
+{
+  variable_finder finder (name);
+
+  expr->accept (finder);
+
+  return finder.found ();
+}
+
+// If RHS has one of the forms of a reduction of the variable NAME,
+// return the other operand and set OP.  Otherwise, return nullptr.
+
+tree_expression *
+parfor_analysis::reduction_operand (tree_expression *rhs,
+                                    const std::string& name,
+                                    reduction_op& op)
+{
+  tree_expression *v = nullptr;
+  tree_expression *e = nullptr;
+
+  op = red_none;
+
+  if (rhs->is_binary_expression () && ! rhs->is_boolean_expression ()
+      && ! dynamic_cast<tree_compound_binary_expression *> (rhs))
+    {
+      tree_binary_expression *be = dynamic_cast<tree_binary_expression *> (rhs);
+
+      if (be->is_braindead ())
+        return nullptr;
+
+      tree_expression *lhs = be->lhs ();
+      tree_expression *rhs_op = be->rhs ();
+
+      bool commutative = true;
+
+      switch (be->op_type ())
+        {
+        case octave_value::op_add:
+          op = red_add;
+          break;
+
+        // V - E is accumulated as V + (-E), so partial results from
+        // several workers are added together.
+        case octave_value::op_sub:
+          op = red_add;
+          commutative = false;
+          break;
+
+        case octave_value::op_mul:
+          op = red_mul;
+          commutative = false;
+          break;
+
+        case octave_value::op_el_mul:
+          op = red_el_mul;
+          break;
+
+        case octave_value::op_el_and:
+          op = red_el_and;
+          break;
+
+        case octave_value::op_el_or:
+          op = red_el_or;
+          break;
+
+        default:
+          return nullptr;
+        }
+
+      if (lhs && lhs->is_identifier () && lhs->name () == name)
+        {
+          v = lhs;
+          e = rhs_op;
+        }
+      else if (commutative && rhs_op && rhs_op->is_identifier ()
+               && rhs_op->name () == name)
+        {
+          v = rhs_op;
+          e = lhs;
+        }
+    }
+  else if (rhs->is_matrix ())
+    {
+      tree_matrix *m = dynamic_cast<tree_matrix *> (rhs);
+
+      if (m->size () == 1)
+        {
+          tree_argument_list *row = m->front ();
+
+          if (row && row->size () == 2)
+            {
+              op = red_horzcat;
+              v = row->front ();
+              e = row->back ();
+            }
+        }
+      else if (m->size () == 2)
+        {
+          tree_argument_list *row1 = m->front ();
+          tree_argument_list *row2 = m->back ();
+
+          if (row1 && row2 && row1->size () == 1 && row2->size () == 1)
+            {
+              op = red_vertcat;
+              v = row1->front ();
+              e = row2->front ();
+            }
+        }
+
+      if (! (v && v->is_identifier () && v->name () == name))
+        v = nullptr;
+    }
+  else if (rhs->is_index_expression ())
+    {
+      tree_index_expression *idx = dynamic_cast<tree_index_expression *> (rhs);
+
+      tree_expression *base = idx->expression ();
+
+      if (base && base->is_identifier () && idx->type_tags () == "(")
+        {
+          std::string fcn = base->name ();
+
+          if (fcn == "min")
+            op = red_min;
+          else if (fcn == "max")
+            op = red_max;
+          else
+            return nullptr;
+
+          tree_argument_list *args = idx->arg_lists ().front ();
+
+          if (args && args->size () == 2)
+            {
+              tree_expression *a = args->front ();
+              tree_expression *b = args->back ();
+
+              if (a && a->is_identifier () && a->name () == name)
+                {
+                  v = a;
+                  e = b;
+                }
+              else if (b && b->is_identifier () && b->name () == name)
+                {
+                  v = b;
+                  e = a;
+                }
+            }
+
+          // The function names are checked again when the loop runs.
+          if (v)
+            use (fcn).read = true;
+        }
+    }
+
+  if (! v || ! e || mentions_variable (e, name))
+    {
+      op = red_none;
+      return nullptr;
+    }
+
+  return e;
+}
+
+void
+parfor_analysis::visit_index_arguments (tree_index_expression& expr)
+{
+  std::list<tree_argument_list *> arg_lists = expr.arg_lists ();
+  std::list<tree_expression *> dyn_fields = expr.dyn_fields ();
+
+  for (tree_argument_list *args : arg_lists)
+    {
+      if (args)
+        args->accept (*this);
+    }
+
+  for (tree_expression *df : dyn_fields)
+    {
+      if (df)
+        df->accept (*this);
+    }
+}
+
+void
+parfor_analysis::classify ()
+{
+  for (const auto& name : m_names)
+    {
+      const usage& u = m_usage[name];
+
+      if (name == m_loop_var)
+        {
+          if (u.write || u.indexed_write || u.op != red_none || u.other)
+            m_ok = false;
+        }
+      else if (u.other)
+        m_ok = false;
+      else if (u.op != red_none)
+        {
+          if (u.read || u.write || u.indexed || u.reduction_mismatch)
+            m_ok = false;
+          else
+            m_reduction.push_back ({name, u.op});
+        }
+      else if (u.write)
+        {
+          if (u.assigned_first)
+            m_temporary.push_back (name);
+          else
+            m_ok = false;
+        }
+      else if (u.indexed_write)
+        {
+          if (u.read || u.indexed_mismatch)
+            m_ok = false;
+          else
+            m_sliced.push_back ({name, u.nargs, u.position});
+        }
+      else
+        m_broadcast.push_back (name);
+
+      if (! m_ok)
+        return;
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
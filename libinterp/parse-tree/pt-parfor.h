@@ -0,0 +1,251 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_parfor_h)
+#define octave_pt_parfor_h 1
+
+#include "octave-config.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "pt-walk.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class tree_expression;
+class tree_index_expression;
+
+// Classify the variables used in the body of a parfor loop.
+//
+// A loop can run in parallel if every variable it uses falls in one of
+// the following classes (after the rules Matlab uses):
+//
+//   broadcast:  only read in the loop body.
+//
+//   sliced:     only indexed, always with the loop variable by itself
+//               in the same position of a single "()" or "{}" index.
+//               Each iteration then only touches its own slice.
+//
+//   reduction:  only updated as V = V op EXPR (or EXPR op V for
+//               commutative operators), V op= EXPR, V++, V--,
+//               V = [V, EXPR], V = [V; EXPR], V = min (V, EXPR), or
+//               V = max (V, EXPR), with the same kind of operator
+//               everywhere.
+//
+//   temporary:  unconditionally assigned before any other use in each
+//               iteration.
+//
+// The loop variable itself must not be assigned in the body.  Loops
+// with break or return statements, global or persistent declarations,
+// or calls to functions that work on the caller's workspace are
+// rejected and run serially.
+
+class parfor_analysis : public tree_walker
+{
+public:
+
+  enum reduction_op
+  {
+    red_none,
+    red_add,
+    red_mul,
+    red_el_mul,
+    red_el_and,
+    red_el_or,
+    red_horzcat,
+    red_vertcat,
+    red_min,
+    red_max
+  };
+
+  struct sliced_variable
+  {
+    std::string name;
+
+    // Number of indices and the position of the loop variable.
+    int nargs;
+    int position;
+  };
+
+  struct reduction_variable
+  {
+    std::string name;
+
+    reduction_op op;
+  };
+
+  parfor_analysis (tree_simple_for_command& cmd);
+
+  OCTAVE_DISABLE_COPY_MOVE (parfor_analysis)
+
+  ~parfor_analysis () = default;
+
+  bool ok () const { return m_ok; }
+
+  std::string loop_variable () const { return m_loop_var; }
+
+  const std::vector<std::string>& broadcast_variables () const
+  {
+    return m_broadcast;
+  }
+
+  const std::vector<sliced_variable>& sliced_variables () const
+  {
+    return m_sliced;
+  }
+
+  const std::vector<reduction_variable>& reduction_variables () const
+  {
+    return m_reduction;
+  }
+
+  const std::vector<std::string>& temporary_variables () const
+  {
+    return m_temporary;
+  }
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_decl_command (tree_decl_command&);
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_spmd_command (tree_spmd_command&);
+
+  void visit_function_def (tree_function_def&);
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_if_command_list (tree_if_command_list&);
+
+  void visit_switch_case_list (tree_switch_case_list&);
+
+  void visit_index_expression (tree_index_expression&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_return_command (tree_return_command&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_unwind_protect_command (tree_unwind_protect_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+private:
+
+  struct usage
+  {
+    // Read without an index, or with an index that does not select a
+    // slice.
+    bool read = false;
+
+    // Assigned without an index.
+    bool write = false;
+
+    // TRUE if the first use is an unconditional assignment.
+    bool assigned_first = false;
+
+    // Indexed uses that select a slice, and whether any of them is an
+    // assignment.
+    bool indexed = false;
+    bool indexed_write = false;
+    bool indexed_mismatch = false;
+    int nargs = 0;
+    int position = 0;
+
+    reduction_op op = red_none;
+    bool reduction_mismatch = false;
+
+    // Used in a way that fits none of the classes.
+    bool other = false;
+  };
+
+  usage& use (const std::string& name);
+
+  void note_read (const std::string& name);
+
+  void note_write (const std::string& name);
+
+  void note_indexed (const std::string& name, tree_index_expression& expr,
+                     bool is_write);
+
+  void note_reduction (const std::string& name, reduction_op op);
+
+  void note_other (const std::string& name);
+
+  bool slice_position (tree_index_expression& expr, int& nargs,
+                       int& position);
+
+  bool mentions_variable (tree_expression *expr, const std::string& name);
+
+  tree_expression * reduction_operand (tree_expression *rhs,
+                                       const std::string& name,
+                                       reduction_op& op);
+
+  void visit_index_arguments (tree_index_expression& expr);
+
+  void classify ();
+
+  bool m_ok;
+
+  std::string m_loop_var;
+
+  // Nesting depth of conditional code and of loops within the body.
+  int m_depth;
+  int m_loop_depth;
+
+  // Names of parameters of anonymous functions being visited.
+  std::multiset<std::string> m_anon_params;
+
+  std::map<std::string, usage> m_usage;
+
+  // Names in order of first use.
+  std::vector<std::string> m_names;
+
+  std::vector<std::string> m_broadcast;
+  std::vector<sliced_variable> m_sliced;
+  std::vector<reduction_variable> m_reduction;
+  std::vector<std::string> m_temporary;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
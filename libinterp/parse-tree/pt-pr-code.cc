@@ -342,6 +342,25 @@ tree_print_code::visit_spmd_command (tree_spmd_command& cmd)
 
   m_os << "spmd";
 
+  tree_expression *nworkers = cmd.nworkers_expr ();
+
+  if (nworkers)
+    {
+      m_os << " (";
+
+      nworkers->accept (*this);
+
+      tree_expression *max_workers = cmd.max_workers_expr ();
+
+      if (max_workers)
+        {
+          m_os << ", ";
+          max_workers->accept (*this);
+        }
+
+      m_os << ')';
+    }
+
   newline ();
 
   tree_statement_list *list = cmd.body ();
@@ -28,6 +28,7 @@
 #endif
 
 #include "comment-list.h"
+#include "pt-exp.h"
 #include "pt-spmd.h"
 #include "pt-stmt.h"
 
@@ -35,6 +36,8 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 tree_spmd_command::~tree_spmd_command ()
 {
+  delete m_nworkers;
+  delete m_max_workers;
   delete m_body;
 }
 
@@ -34,6 +34,7 @@
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 class comment_list;
+class tree_expression;
 class tree_statement_list;
 
 // Spmd.
@@ -42,8 +43,9 @@ class tree_spmd_command : public tree_command
 {
 public:
 
-  tree_spmd_command (const token& spmd_tok, tree_statement_list *body, const token& end_tok)
-    : m_spmd_tok (spmd_tok), m_body (body), m_end_tok (end_tok)
+  tree_spmd_command (const token& spmd_tok, tree_expression *nworkers, tree_expression *max_workers,
+                     tree_statement_list *body, const token& end_tok)
+    : m_spmd_tok (spmd_tok), m_nworkers (nworkers), m_max_workers (max_workers), m_body (body), m_end_tok (end_tok)
   { }
 
   OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (tree_spmd_command)
@@ -53,6 +55,13 @@ public:
   filepos beg_pos () const { return m_spmd_tok.beg_pos (); }
   filepos end_pos () const { return m_end_tok.end_pos (); }
 
+  // For spmd (N), the number of workers.  For spmd (M, N), the
+  // minimum number.
+  tree_expression * nworkers_expr () { return m_nworkers; }
+
+  // For spmd (M, N), the maximum number of workers.
+  tree_expression * max_workers_expr () { return m_max_workers; }
+
   tree_statement_list * body () { return m_body; }
 
   void accept (tree_walker& tw)
@@ -64,6 +73,10 @@ private:
 
   token m_spmd_tok;
 
+  // Expressions that give the number of workers (may be nullptr).
+  tree_expression *m_nworkers;
+  tree_expression *m_max_workers;
+
   // List of commands.
   tree_statement_list *m_body;
 
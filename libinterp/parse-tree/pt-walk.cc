@@ -277,6 +277,16 @@ tree_walker::visit_complex_for_command (tree_complex_for_command& cmd)
 void
 tree_walker::visit_spmd_command (tree_spmd_command& cmd)
 {
+  tree_expression *nworkers = cmd.nworkers_expr ();
+
+  if (nworkers)
+    nworkers->accept (*this);
+
+  tree_expression *max_workers = cmd.max_workers_expr ();
+
+  if (max_workers)
+    max_workers->accept (*this);
+
   tree_statement_list *body = cmd.body ();
 
   if (body)
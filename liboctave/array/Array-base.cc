@@ -32,12 +32,15 @@
 // this file.
 
 #include <ostream>
+#include <type_traits>
 
 #include "Array-util.h"
 #include "Array.h"
 #include "lo-error.h"
 #include "lo-mappers.h"
+#include "mx-simd.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // One dimensional array class.  Handles the reference counting for
 // all the derived classes.
@@ -354,8 +357,10 @@ public:
           }
       }
 
-    // Determine whether we can use block transposes.
-    m_use_blk = m_top >= 1 && m_stride[1] == 1 && m_stride[0] == m_dim[1];
+    // Determine whether we can use block transposes.  The innermost
+    // reduced dimension of the source must be contiguous, but the
+    // source rows need not be adjacent, as in permute (x, [3 1 4 2]).
+    m_use_blk = m_top >= 1 && m_stride[1] == 1;
 
   }
 
@@ -364,49 +369,113 @@ public:
   ~rec_permute_helper () { delete [] m_dim; }
 
   template <typename T>
-  void permute (const T *src, T *dest) const { do_permute (src, dest, m_top); }
+  void permute (const T *src, T *dest) const
+  {
+    // Large arrays of plain data are split between threads.  Other
+    // element types may share reference-counted data, so copying them
+    // is not thread safe.
+    if constexpr (std::is_trivially_copyable<T>::value)
+      {
+        octave_idx_type n = 1;
+        for (int k = 0; k <= m_top; k++)
+          n *= m_dim[k];
+
+        if (octave::thread_pool::use_threads (n))
+          {
+            do_permute_parallel (src, dest, m_top);
+            return;
+          }
+      }
+
+    do_permute (src, dest, m_top);
+  }
 
   // Helper method for fast blocked transpose.
   template <typename T>
   static T *
   blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc)
   {
-    static const octave_idx_type m = 8;
-    OCTAVE_LOCAL_BUFFER (T, blk, m*m);
-    for (octave_idx_type kr = 0; kr < nr; kr += m)
-      for (octave_idx_type kc = 0; kc < nc; kc += m)
-        {
-          octave_idx_type lr = std::min (m, nr - kr);
-          octave_idx_type lc = std::min (m, nc - kc);
-          if (lr == m && lc == m)
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < m; j++)
-                for (octave_idx_type i = 0; i < m; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-          else
-            {
-              const T *ss = src + kc * nr + kr;
-              for (octave_idx_type j = 0; j < lc; j++)
-                for (octave_idx_type i = 0; i < lr; i++)
-                  blk[j*m+i] = ss[j*nr + i];
-              T *dd = dest + kr * nc + kc;
-              for (octave_idx_type j = 0; j < lr; j++)
-                for (octave_idx_type i = 0; i < lc; i++)
-                  dd[j*nc+i] = blk[i*m+j];
-            }
-        }
+    return blk_trans (src, dest, nr, nc, nr);
+  }
+
+  // Likewise, for a source matrix with leading dimension LDS.
+  template <typename T>
+  static T *
+  blk_trans (const T *src, T *dest, octave_idx_type nr, octave_idx_type nc,
+             octave_idx_type lds)
+  {
+    if constexpr (std::is_trivially_copyable<T>::value)
+      {
+        if (octave::thread_pool::use_threads (nr * nc))
+          {
+            // Each thread transposes a range of rows of SRC, which is
+            // a range of columns of DEST.
+            octave::thread_pool::parallel_for
+              (nr, nc, [=] (std::size_t beg, std::size_t end)
+               {
+                 blk_trans_serial (src + beg, dest + beg * nc, end - beg, nc,
+                                   lds, nc);
+               });
+
+            return dest + nr*nc;
+          }
+      }
+
+    blk_trans_serial (src, dest, nr, nc, lds, nc);
 
     return dest + nr*nc;
   }
 
 private:
 
+  template <typename T>
+  static void
+  blk_trans_serial (const T *src, T *dest,
+                    octave_idx_type nr, octave_idx_type nc,
+                    octave_idx_type lds, octave_idx_type ldd)
+  {
+    // Only the size of trivially copyable elements matters, so
+    // integers, single and double values, and single complex values
+    // use the same vectorized kernels.
+    if constexpr (std::is_trivially_copyable<T>::value && sizeof (T) == 4)
+      mx_simd_transpose_4 (src, dest, nr, nc, lds, ldd);
+    else if constexpr (std::is_trivially_copyable<T>::value && sizeof (T) == 8)
+      mx_simd_transpose_8 (src, dest, nr, nc, lds, ldd);
+    else
+      {
+        static const octave_idx_type m = 8;
+        OCTAVE_LOCAL_BUFFER (T, blk, m*m);
+        for (octave_idx_type kr = 0; kr < nr; kr += m)
+          for (octave_idx_type kc = 0; kc < nc; kc += m)
+            {
+              octave_idx_type lr = std::min (m, nr - kr);
+              octave_idx_type lc = std::min (m, nc - kc);
+              if (lr == m && lc == m)
+                {
+                  const T *ss = src + kc * lds + kr;
+                  for (octave_idx_type j = 0; j < m; j++)
+                    for (octave_idx_type i = 0; i < m; i++)
+                      blk[j*m+i] = ss[j*lds + i];
+                  T *dd = dest + kr * ldd + kc;
+                  for (octave_idx_type j = 0; j < m; j++)
+                    for (octave_idx_type i = 0; i < m; i++)
+                      dd[j*ldd+i] = blk[i*m+j];
+                }
+              else
+                {
+                  const T *ss = src + kc * lds + kr;
+                  for (octave_idx_type j = 0; j < lc; j++)
+                    for (octave_idx_type i = 0; i < lr; i++)
+                      blk[j*m+i] = ss[j*lds + i];
+                  T *dd = dest + kr * ldd + kc;
+                  for (octave_idx_type j = 0; j < lr; j++)
+                    for (octave_idx_type i = 0; i < lc; i++)
+                      dd[j*ldd+i] = blk[i*m+j];
+                }
+            }
+      }
+  }
+
   // Recursive N-D generalized transpose
   template <typename T>
   T * do_permute (const T *src, T *dest, int lev) const
@@ -429,7 +498,7 @@ private:
           }
       }
     else if (m_use_blk && lev == 1)
-      dest = blk_trans (src, dest, m_dim[1], m_dim[0]);
+      dest = blk_trans (src, dest, m_dim[1], m_dim[0], m_stride[0]);
     else
       {
         octave_idx_type step = m_stride[lev];
@@ -441,6 +510,52 @@ private:
     return dest;
   }
 
+  // Likewise, splitting the work between threads.  The outermost level
+  // with at least as many slices as threads is divided among them, and
+  // each slice is then permuted serially.
+  template <typename T>
+  T * do_permute_parallel (const T *src, T *dest, int lev) const
+  {
+    octave_idx_type step = m_stride[lev];
+    octave_idx_type len = m_dim[lev];
+
+    if (lev == 0)
+      {
+        octave::thread_pool::parallel_for
+          (len, [=] (std::size_t beg, std::size_t end)
+           {
+             if (step == 1)
+               std::copy (src + beg, src + end, dest + beg);
+             else
+               for (std::size_t i = beg; i < end; i++)
+                 dest[i] = src[i * step];
+           });
+
+        return dest + len;
+      }
+    else if (m_use_blk && lev == 1)
+      return blk_trans (src, dest, m_dim[1], m_dim[0], m_stride[0]);
+
+    octave_idx_type inner = 1;
+    for (int k = 0; k < lev; k++)
+      inner *= m_dim[k];
+
+    if (len >= octave::thread_pool::num_threads ())
+      octave::thread_pool::parallel_for
+        (len, inner, [=] (std::size_t beg, std::size_t end)
+         {
+           for (std::size_t i = beg; i < end; i++)
+             do_permute (src + i * step, dest + i * inner, lev-1);
+         });
+    else
+      {
+        for (octave_idx_type i = 0; i < len; i++)
+          do_permute_parallel (src + i * step, dest + i * inner, lev-1);
+      }
+
+    return dest + len * inner;
+  }
+
   //--------
 
   // STRIDE occupies the last half of the space allocated for dim to
@@ -830,6 +945,22 @@ Array<T, Alloc>::index (const octave::idx_vector& i, const octave::idx_vector& j
           const T *src = data ();
           T *dest = retval.rwdata ();
 
+          if constexpr (std::is_trivially_copyable<T>::value)
+            {
+              if (jl > 1 && octave::thread_pool::use_threads (jl, il))
+                {
+                  // Each thread copies a range of the result columns.
+                  octave::thread_pool::parallel_for
+                    (jl, il, [=, &i, &j] (std::size_t beg, std::size_t end)
+                     {
+                       for (std::size_t k = beg; k < end; k++)
+                         i.index (src + r * j.xelem (k), r, dest + k * il);
+                     });
+
+                  return retval;
+                }
+            }
+
           for (octave_idx_type k = 0; k < jl; k++)
             dest += i.index (src + r * j.xelem (k), r, dest);
         }
@@ -1650,7 +1781,10 @@ Array<T, Alloc>::transpose () const
   octave_idx_type nr = dim1 ();
   octave_idx_type nc = dim2 ();
 
-  if (nr >= 8 && nc >= 8)
+  // Plain data is transposed by vectorized kernels that also handle
+  // narrow matrices efficiently.
+  if ((nr >= 8 && nc >= 8)
+      || (std::is_trivially_copyable<T>::value && nr > 1 && nc > 1))
     {
       Array<T, Alloc> result (dim_vector (nc, nr));
 
@@ -1799,6 +1933,26 @@ sort_isnan (typename ref_param<T>::type)
   return false;
 }
 
+// Call FCN (BEG, END) to sort the slices [BEG, END) of an array with
+// ITER slices of NS elements each.  Many slices of plain data are split
+// between threads, each of which uses its own octave_sort object.
+
+template <typename T, typename F>
+static void
+sort_slices (octave_idx_type iter, octave_idx_type ns, F fcn)
+{
+  if constexpr (std::is_trivially_copyable<T>::value)
+    {
+      if (iter > 1 && octave::thread_pool::use_threads (iter, ns))
+        {
+          octave::thread_pool::parallel_for (iter, ns, fcn);
+          return;
+        }
+    }
+
+  fcn (0, iter);
+}
+
 template <typename T, typename Alloc>
 Array<T, Alloc>
 Array<T, Alloc>::sort (int dim, sortmode mode) const
@@ -1829,89 +1983,100 @@ Array<T, Alloc>::sort (int dim, sortmode mode) const
   for (int i = 0; i < dim; i++)
     stride *= dv(i);
 
-  T *v = m.rwdata ();
-  const T *ov = data ();
-
-  octave_sort<T> lsort;
+  T *v0 = m.rwdata ();
+  const T *ov0 = data ();
 
-  if (mode != UNSORTED)
-    lsort.set_compare (mode);
-  else
+  if (mode == UNSORTED)
     return m;
 
   if (stride == 1)
     {
       // Special case along first dimension avoids gather/scatter AND directly
       // sorts into destination buffer for an 11% performance boost.
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // Copy and partition out NaNs.
-          // No need to special case integer types <T> from floating point
-          // types <T> to avoid sort_isnan() test as it makes no discernible
-          // performance impact.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                v[--ku] = tmp;
-              else
-                v[kl++] = tmp;
-            }
+      sort_slices<T> (iter, ns, [=] (octave_idx_type jbeg, octave_idx_type jend)
+      {
+        octave_sort<T> lsort;
+        lsort.set_compare (mode);
 
-          // sort.
-          lsort.sort (v, kl);
+        T *v = v0 + jbeg * ns;
+        const T *ov = ov0 + jbeg * ns;
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              if (mode == DESCENDING)
-                std::rotate (v, v + ku, v + ns);
-            }
+        for (octave_idx_type j = jbeg; j < jend; j++)
+          {
+            // Copy and partition out NaNs.
+            // No need to special case integer types <T> from floating point
+            // types <T> to avoid sort_isnan() test as it makes no discernible
+            // performance impact.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov[i];
+                if (sort_isnan<T> (tmp))
+                  v[--ku] = tmp;
+                else
+                  v[kl++] = tmp;
+              }
 
-          v += ns;
-          ov += ns;
-        }
+            // sort.
+            lsort.sort (v, kl);
+
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (v + ku, v + ns);
+                if (mode == DESCENDING)
+                  std::rotate (v, v + ku, v + ns);
+              }
+
+            v += ns;
+            ov += ns;
+          }
+      });
     }
   else
     {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
+      sort_slices<T> (iter, ns, [=] (octave_idx_type jbeg, octave_idx_type jend)
+      {
+        octave_sort<T> lsort;
+        lsort.set_compare (mode);
 
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+        OCTAVE_LOCAL_BUFFER (T, buf, ns);
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                buf[--ku] = tmp;
-              else
-                buf[kl++] = tmp;
-            }
+        for (octave_idx_type j = jbeg; j < jend; j++)
+          {
+            octave_idx_type offset = j;
+            octave_idx_type n_strides = j / stride;
+            offset += n_strides * stride * (ns - 1);
+
+            // gather and partition out NaNs.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov0[i*stride + offset];
+                if (sort_isnan<T> (tmp))
+                  buf[--ku] = tmp;
+                else
+                  buf[kl++] = tmp;
+              }
 
-          // sort.
-          lsort.sort (buf, kl);
+            // sort.
+            lsort.sort (buf, kl);
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              if (mode == DESCENDING)
-                std::rotate (buf, buf + ku, buf + ns);
-            }
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (buf + ku, buf + ns);
+                if (mode == DESCENDING)
+                  std::rotate (buf, buf + ku, buf + ns);
+              }
 
-          // scatter.
-          for (octave_idx_type i = 0; i < ns; i++)
-            v[i*stride + offset] = buf[i];
-        }
+            // scatter.
+            for (octave_idx_type i = 0; i < ns; i++)
+              v0[i*stride + offset] = buf[i];
+          }
+      });
     }
 
   return m;
@@ -1941,116 +2106,128 @@ Array<T, Alloc>::sort (Array<octave_idx_type>& sidx, int dim,
   for (int i = 0; i < dim; i++)
     stride *= dv(i);
 
-  T *v = m.rwdata ();
-  const T *ov = data ();
-
-  octave_sort<T> lsort;
+  T *v0 = m.rwdata ();
+  const T *ov0 = data ();
 
-  octave_idx_type *vi = sidx.rwdata ();
+  octave_idx_type *vi0 = sidx.rwdata ();
 
-  if (mode != UNSORTED)
-    lsort.set_compare (mode);
-  else
+  if (mode == UNSORTED)
     return m;
 
   if (stride == 1)
     {
       // Special case for dim 1 avoids gather/scatter for performance boost.
       // See comments in Array::sort (dim, mode).
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // copy and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  v[ku] = tmp;
-                  vi[ku] = i;
-                }
-              else
-                {
-                  v[kl] = tmp;
-                  vi[kl] = i;
-                  kl++;
-                }
-            }
+      sort_slices<T> (iter, ns, [=] (octave_idx_type jbeg, octave_idx_type jend)
+      {
+        octave_sort<T> lsort;
+        lsort.set_compare (mode);
 
-          // sort.
-          lsort.sort (v, vi, kl);
+        T *v = v0 + jbeg * ns;
+        octave_idx_type *vi = vi0 + jbeg * ns;
+        const T *ov = ov0 + jbeg * ns;
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              std::reverse (vi + ku, vi + ns);
-              if (mode == DESCENDING)
-                {
-                  std::rotate (v, v + ku, v + ns);
-                  std::rotate (vi, vi + ku, vi + ns);
-                }
-            }
+        for (octave_idx_type j = jbeg; j < jend; j++)
+          {
+            // copy and partition out NaNs.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov[i];
+                if (sort_isnan<T> (tmp))
+                  {
+                    --ku;
+                    v[ku] = tmp;
+                    vi[ku] = i;
+                  }
+                else
+                  {
+                    v[kl] = tmp;
+                    vi[kl] = i;
+                    kl++;
+                  }
+              }
 
-          v += ns;
-          vi += ns;
-          ov += ns;
-        }
+            // sort.
+            lsort.sort (v, vi, kl);
+
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (v + ku, v + ns);
+                std::reverse (vi + ku, vi + ns);
+                if (mode == DESCENDING)
+                  {
+                    std::rotate (v, v + ku, v + ns);
+                    std::rotate (vi, vi + ku, vi + ns);
+                  }
+              }
+
+            v += ns;
+            vi += ns;
+            ov += ns;
+          }
+      });
     }
   else
     {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, ns);
+      sort_slices<T> (iter, ns, [=] (octave_idx_type jbeg, octave_idx_type jend)
+      {
+        octave_sort<T> lsort;
+        lsort.set_compare (mode);
 
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+        OCTAVE_LOCAL_BUFFER (T, buf, ns);
+        OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, ns);
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  buf[ku] = tmp;
-                  bufi[ku] = i;
-                }
-              else
-                {
-                  buf[kl] = tmp;
-                  bufi[kl] = i;
-                  kl++;
-                }
-            }
+        for (octave_idx_type j = jbeg; j < jend; j++)
+          {
+            octave_idx_type offset = j;
+            octave_idx_type n_strides = j / stride;
+            offset += n_strides * stride * (ns - 1);
+
+            // gather and partition out NaNs.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov0[i*stride + offset];
+                if (sort_isnan<T> (tmp))
+                  {
+                    --ku;
+                    buf[ku] = tmp;
+                    bufi[ku] = i;
+                  }
+                else
+                  {
+                    buf[kl] = tmp;
+                    bufi[kl] = i;
+                    kl++;
+                  }
+              }
 
-          // sort.
-          lsort.sort (buf, bufi, kl);
+            // sort.
+            lsort.sort (buf, bufi, kl);
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              std::reverse (bufi + ku, bufi + ns);
-              if (mode == DESCENDING)
-                {
-                  std::rotate (buf, buf + ku, buf + ns);
-                  std::rotate (bufi, bufi + ku, bufi + ns);
-                }
-            }
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (buf + ku, buf + ns);
+                std::reverse (bufi + ku, bufi + ns);
+                if (mode == DESCENDING)
+                  {
+                    std::rotate (buf, buf + ku, buf + ns);
+                    std::rotate (bufi, bufi + ku, bufi + ns);
+                  }
+              }
 
-          // scatter.
-          for (octave_idx_type i = 0; i < ns; i++)
-            v[i*stride + offset] = buf[i];
-          for (octave_idx_type i = 0; i < ns; i++)
-            vi[i*stride + offset] = bufi[i];
-        }
+            // scatter.
+            for (octave_idx_type i = 0; i < ns; i++)
+              v0[i*stride + offset] = buf[i];
+            for (octave_idx_type i = 0; i < ns; i++)
+              vi0[i*stride + offset] = bufi[i];
+          }
+      });
     }
 
   return m;
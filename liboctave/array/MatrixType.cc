@@ -73,7 +73,7 @@ MatrixType::MatrixType (const MatrixType& a)
   : m_type (a.m_type), m_sp_bandden (a.m_sp_bandden), m_bandden (a.m_bandden),
     m_upper_band (a.m_upper_band), m_lower_band (a.m_lower_band),
     m_dense (a.m_dense), m_full (a.m_full),
-    m_nperm (a.m_nperm), m_perm (nullptr)
+    m_nperm (a.m_nperm), m_perm (nullptr), m_levels (a.m_levels)
 {
   if (m_nperm != 0)
     {
@@ -633,6 +633,7 @@ MatrixType::operator = (const MatrixType& a)
       m_lower_band = a.m_lower_band;
       m_dense = a.m_dense;
       m_full = a.m_full;
+      m_levels = a.m_levels;
 
       if (m_nperm)
         {
@@ -670,6 +671,7 @@ MatrixType::type (bool quiet)
       ("Octave:matrix-type-info", "invalidating matrix type");
 
   m_type = MatrixType::Unknown;
+  m_levels.reset ();
 
   return m_type;
 }
@@ -695,6 +697,7 @@ MatrixType::type (const SparseMatrix& a)
   m_dense = tmp_typ.m_dense;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
+  m_levels.reset ();
 
   if (m_nperm != 0)
     {
@@ -727,6 +730,7 @@ MatrixType::type (const SparseComplexMatrix& a)
   m_dense = tmp_typ.m_dense;
   m_full = tmp_typ.m_full;
   m_nperm = tmp_typ.m_nperm;
+  m_levels.reset ();
 
   if (m_nperm != 0)
     {
@@ -973,6 +977,7 @@ MatrixType
 MatrixType::transpose () const
 {
   MatrixType retval (*this);
+  retval.m_levels.reset ();
   if (m_type == MatrixType::Upper)
     retval.m_type = MatrixType::Lower;
   else if (m_type == MatrixType::Permuted_Upper)
@@ -28,10 +28,18 @@
 
 #include "octave-config.h"
 
+#include <memory>
+
 #include "mx-fwd.h"
 
 #include "MSparse.h"
 
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class triangular_levels;
+
+OCTAVE_END_NAMESPACE(octave)
+
 class MatrixType
 {
 public:
@@ -134,15 +142,24 @@ public:
 
   octave_idx_type * triangular_perm () const { return m_perm; }
 
-  void invalidate_type () { m_type = Unknown; }
+  // Dependency levels of a sparse triangular matrix, saved by the first
+  // solve with it for later solves.  See sparse-trisolve.h.
+  const octave::triangular_levels * solve_levels () const
+  { return m_levels.get (); }
+
+  void set_solve_levels
+  (const std::shared_ptr<const octave::triangular_levels>& levels)
+  { m_levels = levels; }
+
+  void invalidate_type () { m_type = Unknown; m_levels.reset (); }
 
   void mark_as_diagonal () { m_type = Diagonal; }
 
   void mark_as_permuted_diagonal () { m_type = Permuted_Diagonal; }
 
-  void mark_as_upper_triangular () { m_type = Upper; }
+  void mark_as_upper_triangular () { m_type = Upper; m_levels.reset (); }
 
-  void mark_as_lower_triangular () { m_type = Lower; }
+  void mark_as_lower_triangular () { m_type = Lower; m_levels.reset (); }
 
   void mark_as_tridiagonal () {m_type = Tridiagonal; }
 
@@ -179,6 +196,7 @@ private:
   bool m_full;
   octave_idx_type m_nperm;
   octave_idx_type *m_perm;
+  std::shared_ptr<const octave::triangular_levels> m_levels;
 };
 
 #endif
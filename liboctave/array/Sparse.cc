@@ -45,6 +45,7 @@
 #include "oct-locbuf.h"
 
 #include "Sparse.h"
+#include "sparse-assembly.h"
 #include "sparse-util.h"
 #include "oct-spparms.h"
 #include "mx-inlines.cc"
@@ -64,6 +65,8 @@ OCTAVE_API
 T&
 Sparse<T, Alloc>::SparseRep::elem (octave_idx_type r, octave_idx_type c)
 {
+  clear_csr ();
+
   octave_idx_type i;
 
   if (m_nzmax <= 0)
@@ -118,6 +121,8 @@ OCTAVE_API
 void
 Sparse<T, Alloc>::SparseRep::maybe_compress (bool remove_zeros)
 {
+  clear_csr ();
+
   if (remove_zeros)
     {
       octave_idx_type i = 0;
@@ -143,6 +148,8 @@ OCTAVE_API
 void
 Sparse<T, Alloc>::SparseRep::change_length (octave_idx_type nz)
 {
+  clear_csr ();
+
   for (octave_idx_type j = m_ncols; j > 0 && m_cidx[j] > nz; j--)
     m_cidx[j] = nz;
 
@@ -194,6 +201,52 @@ Sparse<T, Alloc>::SparseRep::any_element_is_nan () const
   return false;
 }
 
+template <typename T, typename Alloc>
+OCTAVE_API
+const typename Sparse<T, Alloc>::SparseRep::csr_form *
+Sparse<T, Alloc>::SparseRep::csr (bool force) const
+{
+  if (! m_csr && (force || m_csr_wanted))
+    {
+      // Same counting sort as for the transpose.
+      octave_idx_type nz = nnz ();
+
+      std::unique_ptr<csr_form> f (new csr_form);
+      f->m_rptr.reset (new octave_idx_type [m_nrows + 1] ());
+      f->m_cidx.reset (new octave_idx_type [nz]);
+      f->m_data.reset (new T [nz]);
+
+      octave_idx_type *rptr = f->m_rptr.get ();
+      octave_idx_type *cidx = f->m_cidx.get ();
+      T *data = f->m_data.get ();
+
+      for (octave_idx_type i = 0; i < nz; i++)
+        rptr[m_ridx[i] + 1]++;
+
+      nz = 0;
+      for (octave_idx_type i = 1; i <= m_nrows; i++)
+        {
+          const octave_idx_type tmp = rptr[i];
+          rptr[i] = nz;
+          nz += tmp;
+        }
+
+      for (octave_idx_type j = 0; j < m_ncols; j++)
+        for (octave_idx_type k = m_cidx[j]; k < m_cidx[j+1]; k++)
+          {
+            octave_idx_type q = rptr[m_ridx[k] + 1]++;
+            cidx[q] = j;
+            data[q] = m_data[k];
+          }
+
+      m_csr = std::move (f);
+    }
+
+  m_csr_wanted = true;
+
+  return m_csr.get ();
+}
+
 template <typename T, typename Alloc>
 OCTAVE_API
 Sparse<T, Alloc>::Sparse (octave_idx_type nr, octave_idx_type nc, T val)
@@ -415,94 +468,14 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
         }
       else
         {
-          octave::idx_vector rr = r;
-          octave::idx_vector cc = c;
-          const octave_idx_type *rd = rr.raw ();
-          const octave_idx_type *cd = cc.raw ();
-          OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, ci, nc+1, 0);
-          ci[0] = 0;
-          // Bin counts of column indices.
-          for (octave_idx_type i = 0; i < n; i++)
-            ci[cd[i]+1]++;
-          // Make them cumulative, shifted one to right.
-          for (octave_idx_type i = 1, s = 0; i <= nc; i++)
-            {
-              octave_idx_type s1 = s + ci[i];
-              ci[i] = s;
-              s = s1;
-            }
+          octave::sparse_assembly p (r, c, nr, nc, n);
 
           octave_quit ();
 
-          // Bucket sort.
-          OCTAVE_LOCAL_BUFFER (octave_idx_type, sidx, n);
-          for (octave_idx_type i = 0; i < n; i++)
-            if (rl == 1)
-              sidx[ci[cd[i]+1]++] = rd[0];
-            else
-              sidx[ci[cd[i]+1]++] = rd[i];
-
-          // Subsorts.  We don't need a stable sort, all values are equal.
-          xcidx (0) = 0;
-          for (octave_idx_type j = 0; j < nc; j++)
-            {
-              std::sort (sidx + ci[j], sidx + ci[j+1]);
-              octave_idx_type l = -1;
-              octave_idx_type nzj = 0;
-              // Count.
-              for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-                {
-                  octave_idx_type k = sidx[i];
-                  if (k != l)
-                    {
-                      l = k;
-                      nzj++;
-                    }
-                }
-              // Set column pointer.
-              xcidx (j+1) = xcidx (j) + nzj;
-            }
-
-          change_capacity (nzm > xcidx (nc) ? nzm : xcidx (nc));
-          octave_idx_type *rri = ridx ();
-          T *rrd = data ();
-
-          // Fill-in data.
-          for (octave_idx_type j = 0, jj = -1; j < nc; j++)
-            {
-              octave_quit ();
-              octave_idx_type l = -1;
-              if (sum_terms)
-                {
-                  // Sum adjacent terms.
-                  for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-                    {
-                      octave_idx_type k = sidx[i];
-                      if (k != l)
-                        {
-                          l = k;
-                          rrd[++jj] = a0;
-                          rri[jj] = k;
-                        }
-                      else
-                        rrd[jj] += a0;
-                    }
-                }
-              else
-                {
-                  // Use the last one.
-                  for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-                    {
-                      octave_idx_type k = sidx[i];
-                      if (k != l)
-                        {
-                          l = k;
-                          rrd[++jj] = a0;
-                          rri[jj] = k;
-                        }
-                    }
-                }
-            }
+          change_capacity (nzm > p.nnz () ? nzm : p.nnz ());
+          std::copy_n (p.cidx (), nc + 1, xcidx ());
+          std::copy_n (p.ridx (), p.nnz (), xridx ());
+          p.assemble (a.data (), true, xdata (), sum_terms);
         }
     }
   else if (cl == 1)
@@ -562,102 +535,39 @@ Sparse<T, Alloc>::Sparse (const Array<T>& a,
     }
   else
     {
-      octave::idx_vector rr = r;
-      octave::idx_vector cc = c;
-      const octave_idx_type *rd = rr.raw ();
-      const octave_idx_type *cd = cc.raw ();
-      OCTAVE_LOCAL_BUFFER_INIT (octave_idx_type, ci, nc+1, 0);
-      ci[0] = 0;
-      // Bin counts of column indices.
-      for (octave_idx_type i = 0; i < n; i++)
-        ci[cd[i]+1]++;
-      // Make them cumulative, shifted one to right.
-      for (octave_idx_type i = 1, s = 0; i <= nc; i++)
-        {
-          octave_idx_type s1 = s + ci[i];
-          ci[i] = s;
-          s = s1;
-        }
+      octave::sparse_assembly p (r, c, nr, nc, n);
 
       octave_quit ();
 
-      typedef std::pair<octave_idx_type, octave_idx_type> idx_pair;
-      // Bucket sort.
-      OCTAVE_LOCAL_BUFFER (idx_pair, spairs, n);
-      for (octave_idx_type i = 0; i < n; i++)
-        {
-          idx_pair& p = spairs[ci[cd[i]+1]++];
-          if (rl == 1)
-            p.first = rd[0];
-          else
-            p.first = rd[i];
-          p.second = i;
-        }
+      change_capacity (nzm > p.nnz () ? nzm : p.nnz ());
+      std::copy_n (p.cidx (), nc + 1, xcidx ());
+      std::copy_n (p.ridx (), p.nnz (), xridx ());
+      p.assemble (a.data (), false, xdata (), sum_terms);
 
-      // Subsorts.  We don't need a stable sort, the second index stabilizes it.
-      xcidx (0) = 0;
-      for (octave_idx_type j = 0; j < nc; j++)
-        {
-          std::sort (spairs + ci[j], spairs + ci[j+1]);
-          octave_idx_type l = -1;
-          octave_idx_type nzj = 0;
-          // Count.
-          for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-            {
-              octave_idx_type k = spairs[i].first;
-              if (k != l)
-                {
-                  l = k;
-                  nzj++;
-                }
-            }
-          // Set column pointer.
-          xcidx (j+1) = xcidx (j) + nzj;
-        }
+      maybe_compress (true);
+    }
+}
 
-      change_capacity (nzm > xcidx (nc) ? nzm : xcidx (nc));
-      octave_idx_type *rri = ridx ();
-      T *rrd = data ();
+template <typename T, typename Alloc>
+OCTAVE_API
+Sparse<T, Alloc>::Sparse (const Array<T>& a, const octave::sparse_assembly& p,
+                          bool sum_terms, bool keep_zeros)
+  : m_rep (nullptr), m_dimensions (p.rows (), p.cols ())
+{
+  octave_idx_type n = a.numel ();
 
-      // Fill-in data.
-      for (octave_idx_type j = 0, jj = -1; j < nc; j++)
-        {
-          octave_quit ();
-          octave_idx_type l = -1;
-          if (sum_terms)
-            {
-              // Sum adjacent terms.
-              for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-                {
-                  octave_idx_type k = spairs[i].first;
-                  if (k != l)
-                    {
-                      l = k;
-                      rrd[++jj] = a(spairs[i].second);
-                      rri[jj] = k;
-                    }
-                  else
-                    rrd[jj] += a(spairs[i].second);
-                }
-            }
-          else
-            {
-              // Use the last one.
-              for (octave_idx_type i = ci[j]; i < ci[j+1]; i++)
-                {
-                  octave_idx_type k = spairs[i].first;
-                  if (k != l)
-                    {
-                      l = k;
-                      rri[++jj] = k;
-                    }
-                  rrd[jj] = a(spairs[i].second);
-                }
-            }
-        }
+  if (n != 1 && n != p.numel ())
+    (*current_liboctave_error_handler) ("sparse: dimension mismatch");
 
-      maybe_compress (true);
-    }
+  m_rep = new typename Sparse<T, Alloc>::SparseRep (p.rows (), p.cols (),
+                                                    p.nnz ());
+
+  std::copy_n (p.cidx (), p.cols () + 1, xcidx ());
+  std::copy_n (p.ridx (), p.nnz (), xridx ());
+  p.assemble (a.data (), n == 1, xdata (), sum_terms);
+
+  if (! keep_zeros)
+    maybe_compress (true);
 }
 
 /*
@@ -1145,6 +1055,16 @@ Sparse<T, Alloc>::transpose () const
   octave_idx_type nz = nnz ();
   Sparse<T, Alloc> retval (nc, nr, nz);
 
+  if (m_rep->m_csr)
+    {
+      // The row form of the matrix is its transpose.
+      const typename SparseRep::csr_form *f = m_rep->m_csr.get ();
+      std::copy_n (f->m_rptr.get (), nr + 1, retval.xcidx ());
+      std::copy_n (f->m_cidx.get (), nz, retval.xridx ());
+      std::copy_n (f->m_data.get (), nz, retval.xdata ());
+      return retval;
+    }
+
   for (octave_idx_type i = 0; i < nz; i++)
     retval.xcidx (ridx (i) + 1)++;
   // retval.xcidx[1:nr] holds the row degrees for rows 0:(nr-1)
@@ -1724,36 +1644,56 @@ Sparse<T, Alloc>::index (const octave::idx_vector& idx_i,
   else if (idx_i.is_scalar ())
     {
       octave_idx_type ii = idx_i(0);
-      retval = Sparse<T, Alloc> (1, m);
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, ij, m);
-      for (octave_idx_type j = 0; j < m; j++)
-        {
-          octave_quit ();
-          octave_idx_type jj = idx_j(j);
-          octave_idx_type lj = cidx (jj);
-          octave_idx_type nzj = cidx (jj+1) - cidx (jj);
-
-          // Scalar index - just a binary lookup.
-          octave_idx_type i = lblookup (ridx () + lj, nzj, ii);
-          if (i < nzj && ridx (i+lj) == ii)
+      const octave_idx_type *rptr, *rcidx;
+      const T *rdata;
+      if (idx_j.is_colon () && csr (rptr, rcidx, rdata))
+        {
+          // A whole row, straight from the row form of the matrix.
+          octave_idx_type lo = rptr[ii];
+          octave_idx_type nzr = rptr[ii+1] - lo;
+          retval = Sparse<T, Alloc> (1, nc, nzr);
+          for (octave_idx_type k = 0; k < nzr; k++)
             {
-              ij[j] = i + lj;
-              retval.xcidx (j+1) = retval.xcidx (j) + 1;
+              retval.xcidx (rcidx[lo+k] + 1) = 1;
+              retval.xridx (k) = 0;
+              retval.xdata (k) = rdata[lo+k];
             }
-          else
-            retval.xcidx (j+1) = retval.xcidx (j);
+          for (octave_idx_type j = 0; j < nc; j++)
+            retval.xcidx (j+1) += retval.xcidx (j);
         }
+      else
+        {
+          retval = Sparse<T, Alloc> (1, m);
+          OCTAVE_LOCAL_BUFFER (octave_idx_type, ij, m);
+          for (octave_idx_type j = 0; j < m; j++)
+            {
+              octave_quit ();
+              octave_idx_type jj = idx_j(j);
+              octave_idx_type lj = cidx (jj);
+              octave_idx_type nzj = cidx (jj+1) - cidx (jj);
 
-      retval.change_capacity (retval.xcidx (m));
+              // Scalar index - just a binary lookup.
+              octave_idx_type i = lblookup (ridx () + lj, nzj, ii);
+              if (i < nzj && ridx (i+lj) == ii)
+                {
+                  ij[j] = i + lj;
+                  retval.xcidx (j+1) = retval.xcidx (j) + 1;
+                }
+              else
+                retval.xcidx (j+1) = retval.xcidx (j);
+            }
 
-      // Copy data, adjust row indices.
-      for (octave_idx_type j = 0; j < m; j++)
-        {
-          octave_idx_type i = retval.xcidx (j);
-          if (retval.xcidx (j+1) > i)
+          retval.change_capacity (retval.xcidx (m));
+
+          // Copy data, adjust row indices.
+          for (octave_idx_type j = 0; j < m; j++)
             {
-              retval.xridx (i) = 0;
-              retval.xdata (i) = data (ij[j]);
+              octave_idx_type i = retval.xcidx (j);
+              if (retval.xcidx (j+1) > i)
+                {
+                  retval.xridx (i) = 0;
+                  retval.xdata (i) = data (ij[j]);
+                }
             }
         }
     }
@@ -32,12 +32,19 @@
 
 #include <algorithm>
 #include <iosfwd>
+#include <memory>
 #include <string>
 
 #include "Array-fwd.h"
 #include "Sparse-fwd.h"
 #include "mx-fwd.h"
 
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class sparse_assembly;
+
+OCTAVE_END_NAMESPACE(octave)
+
 // Two dimensional sparse class.  Handles the reference counting for
 // all the derived classes.
 
@@ -73,6 +80,19 @@ protected:
     octave_idx_type m_ncols;
     octave::refcount<octave_idx_type> m_count;
 
+    // Compressed sparse row form of the matrix, built on demand for
+    // operations that access it by rows.  See Sparse<T>::csr.
+
+    struct csr_form
+    {
+      std::unique_ptr<octave_idx_type[]> m_rptr;
+      std::unique_ptr<octave_idx_type[]> m_cidx;
+      std::unique_ptr<T[]> m_data;
+    };
+
+    mutable std::unique_ptr<csr_form> m_csr;
+    mutable bool m_csr_wanted = false;
+
     SparseRep ()
       : Alloc (), m_data (T_allocate (1)), m_ridx (idx_type_allocate (1)),
         m_cidx (idx_type_allocate (1)),
@@ -179,6 +199,17 @@ protected:
     // Prefer nzmax.
     octave_idx_type length () const { return m_nzmax; }
 
+    OCTAVE_API const csr_form * csr (bool force) const;
+
+    void clear_csr ()
+    {
+      if (m_csr_wanted)
+        {
+          m_csr.reset ();
+          m_csr_wanted = false;
+        }
+    }
+
     template <typename U, typename A> friend class Sparse;
 
     // No assignment!
@@ -321,6 +352,17 @@ public:
           octave_idx_type nr = -1, octave_idx_type nc = -1,
           bool sum_terms = true, octave_idx_type nzm = -1);
 
+  // Matrix with the pattern of P and the values A of its triplets (see
+  // octave::sparse_assembly).  Elements whose value is zero are removed
+  // unless KEEP_ZEROS is true.  Keeping them gives every matrix built
+  // from P the same pattern, so that their data arrays can be used in
+  // place of each other.  All other operations on Sparse objects assume
+  // that no stored element is zero, so call maybe_compress (true) on
+  // such a matrix before using it in any other way.
+  OCTAVE_API
+  Sparse (const Array<T>& a, const octave::sparse_assembly& p,
+          bool sum_terms = true, bool keep_zeros = false);
+
   // Sparsify a normal matrix
   OCTAVE_API Sparse (const Array<T>& a);
 
@@ -568,41 +610,84 @@ public:
 
   OCTAVE_API Sparse<T, Alloc> transpose () const;
 
-  T * data () { make_unique (); return m_rep->m_data; }
-  T& data (octave_idx_type i) { make_unique (); return m_rep->data (i); }
-  T * xdata () { return m_rep->m_data; }
-  T& xdata (octave_idx_type i) { return m_rep->data (i); }
+  // The non-const accessors below drop the cached row form of the
+  // matrix (see csr), because the caller may modify the elements.
+
+  T * data () { make_unique (); m_rep->clear_csr (); return m_rep->m_data; }
+  T& data (octave_idx_type i)
+  {
+    make_unique (); m_rep->clear_csr (); return m_rep->data (i);
+  }
+  T * xdata () { m_rep->clear_csr (); return m_rep->m_data; }
+  T& xdata (octave_idx_type i) { m_rep->clear_csr (); return m_rep->data (i); }
 
   T data (octave_idx_type i) const { return m_rep->data (i); }
   // FIXME: shouldn't this be returning const T*?
   T * data () const { return m_rep->m_data; }
 
-  octave_idx_type * ridx () { make_unique (); return m_rep->m_ridx; }
+  octave_idx_type * ridx ()
+  {
+    make_unique (); m_rep->clear_csr (); return m_rep->m_ridx;
+  }
   octave_idx_type& ridx (octave_idx_type i)
   {
-    make_unique (); return m_rep->ridx (i);
+    make_unique (); m_rep->clear_csr (); return m_rep->ridx (i);
   }
 
-  octave_idx_type * xridx () { return m_rep->m_ridx; }
-  octave_idx_type& xridx (octave_idx_type i) { return m_rep->ridx (i); }
+  octave_idx_type * xridx () { m_rep->clear_csr (); return m_rep->m_ridx; }
+  octave_idx_type& xridx (octave_idx_type i)
+  {
+    m_rep->clear_csr (); return m_rep->ridx (i);
+  }
 
   octave_idx_type ridx (octave_idx_type i) const { return m_rep->cridx (i); }
   // FIXME: shouldn't this be returning const octave_idx_type*?
   octave_idx_type * ridx () const { return m_rep->m_ridx; }
 
-  octave_idx_type * cidx () { make_unique (); return m_rep->m_cidx; }
+  octave_idx_type * cidx ()
+  {
+    make_unique (); m_rep->clear_csr (); return m_rep->m_cidx;
+  }
   octave_idx_type& cidx (octave_idx_type i)
   {
-    make_unique (); return m_rep->cidx (i);
+    make_unique (); m_rep->clear_csr (); return m_rep->cidx (i);
   }
 
-  octave_idx_type * xcidx () { return m_rep->m_cidx; }
-  octave_idx_type& xcidx (octave_idx_type i) { return m_rep->cidx (i); }
+  octave_idx_type * xcidx () { m_rep->clear_csr (); return m_rep->m_cidx; }
+  octave_idx_type& xcidx (octave_idx_type i)
+  {
+    m_rep->clear_csr (); return m_rep->cidx (i);
+  }
 
   octave_idx_type cidx (octave_idx_type i) const { return m_rep->ccidx (i); }
   // FIXME: shouldn't this be returning const octave_idx_type*?
   octave_idx_type * cidx () const { return m_rep->m_cidx; }
 
+  // Row-oriented access.  Operations that traverse the matrix by rows
+  // may use a compressed sparse row copy of it, which is cached with the
+  // shared representation until the matrix is modified.  Return true
+  // and set RPTR, CIDX, and DATA to the row pointers, column indices,
+  // and values of that copy if it exists, or if it is built now.  It is
+  // built if FORCE is true or if it has been asked for before, so that a
+  // single row-oriented operation does not pay for the conversion.
+  // Pointers obtained from the non-const accessors must not be used to
+  // modify the matrix after calling this function.
+
+  bool csr (const octave_idx_type *& rptr, const octave_idx_type *& cidx,
+            const T *& data, bool force = false) const
+  {
+    const typename SparseRep::csr_form *f = m_rep->csr (force);
+
+    if (! f)
+      return false;
+
+    rptr = f->m_rptr.get ();
+    cidx = f->m_cidx.get ();
+    data = f->m_data.get ();
+
+    return true;
+  }
+
   octave_idx_type ndims () const { return m_dimensions.ndims (); }
 
   OCTAVE_API void delete_elements (const octave::idx_vector& i);
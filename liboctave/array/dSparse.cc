@@ -47,6 +47,7 @@
 #include "sparse-lu.h"
 #include "MatrixType.h"
 #include "oct-sparse.h"
+#include "sparse-trisolve.h"
 #include "sparse-util.h"
 #include "sparse-chol.h"
 #include "sparse-qr.h"
@@ -502,15 +503,24 @@ SparseMatrix::row (octave_idx_type i) const
   octave_idx_type nc = columns ();
   RowVector retval (nc, 0);
 
-  for (octave_idx_type j = 0; j < nc; j++)
-    for (octave_idx_type k = cidx (j); k < cidx (j+1); k++)
-      {
-        if (ridx (k) == i)
-          {
-            retval(j) = data (k);
-            break;
-          }
-      }
+  const octave_idx_type *rptr, *rcidx;
+  const double *rdata;
+  if (csr (rptr, rcidx, rdata))
+    {
+      for (octave_idx_type k = rptr[i]; k < rptr[i+1]; k++)
+        retval.xelem (rcidx[k]) = rdata[k];
+    }
+  else
+    {
+      for (octave_idx_type j = 0; j < nc; j++)
+        {
+          const octave_idx_type *lo = ridx () + cidx (j);
+          const octave_idx_type *hi = ridx () + cidx (j+1);
+          const octave_idx_type *k = std::lower_bound (lo, hi, i);
+          if (k != hi && *k == i)
+            retval.xelem (j) = data (k - ridx ());
+        }
+    }
 
   return retval;
 }
@@ -1507,45 +1517,16 @@ SparseMatrix::utsolve (MatrixType& mattype, const Matrix& b,
         {
           retval.resize (nc, b_nc);
           octave_idx_type *perm = mattype.triangular_perm ();
-          OCTAVE_LOCAL_BUFFER (double, work, nm);
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                work[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                work[i] = 0.;
-
-              for (octave_idx_type k = nc-1; k >= 0; k--)
-                {
-                  octave_idx_type kidx = perm[k];
-
-                  if (work[k] != 0.)
-                    {
-                      if (ridx (cidx (kidx+1)-1) != k
-                          || data (cidx (kidx+1)-1) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      double tmp = work[k] / data (cidx (kidx+1)-1);
-                      work[k] = tmp;
-                      for (octave_idx_type i = cidx (kidx);
-                           i < cidx (kidx+1)-1; i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          work[iidx] = work[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (perm[i], j) = work[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
+              OCTAVE_LOCAL_BUFFER (double, work, nm);
+
               // Calculation of 1-norm of inv(*this)
               for (octave_idx_type i = 0; i < nm; i++)
                 work[i] = 0.;
@@ -1584,43 +1565,17 @@ SparseMatrix::utsolve (MatrixType& mattype, const Matrix& b,
         }
       else
         {
-          OCTAVE_LOCAL_BUFFER (double, work, nm);
           retval.resize (nc, b_nc);
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                work[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                work[i] = 0.;
-
-              for (octave_idx_type k = nc-1; k >= 0; k--)
-                {
-                  if (work[k] != 0.)
-                    {
-                      if (ridx (cidx (k+1)-1) != k
-                          || data (cidx (k+1)-1) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      double tmp = work[k] / data (cidx (k+1)-1);
-                      work[k] = tmp;
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1)-1; i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          work[iidx] = work[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (i, j) = work[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
+              OCTAVE_LOCAL_BUFFER (double, work, nm);
+
               // Calculation of 1-norm of inv(*this)
               for (octave_idx_type i = 0; i < nm; i++)
                 work[i] = 0.;
@@ -2013,42 +1968,11 @@ SparseMatrix::utsolve (MatrixType& mattype, const ComplexMatrix& b,
         {
           retval.resize (nc, b_nc);
           octave_idx_type *perm = mattype.triangular_perm ();
-          OCTAVE_LOCAL_BUFFER (Complex, cwork, nm);
-
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                cwork[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                cwork[i] = 0.;
 
-              for (octave_idx_type k = nc-1; k >= 0; k--)
-                {
-                  octave_idx_type kidx = perm[k];
-
-                  if (cwork[k] != 0.)
-                    {
-                      if (ridx (cidx (kidx+1)-1) != k
-                          || data (cidx (kidx+1)-1) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      Complex tmp = cwork[k] / data (cidx (kidx+1)-1);
-                      cwork[k] = tmp;
-                      for (octave_idx_type i = cidx (kidx);
-                           i < cidx (kidx+1)-1; i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          cwork[iidx] = cwork[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (perm[i], j) = cwork[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
@@ -2091,40 +2015,12 @@ SparseMatrix::utsolve (MatrixType& mattype, const ComplexMatrix& b,
         }
       else
         {
-          OCTAVE_LOCAL_BUFFER (Complex, cwork, nm);
           retval.resize (nc, b_nc);
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                cwork[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                cwork[i] = 0.;
-
-              for (octave_idx_type k = nc-1; k >= 0; k--)
-                {
-                  if (cwork[k] != 0.)
-                    {
-                      if (ridx (cidx (k+1)-1) != k
-                          || data (cidx (k+1)-1) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      Complex tmp = cwork[k] / data (cidx (k+1)-1);
-                      cwork[k] = tmp;
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1)-1; i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          cwork[iidx] = cwork[iidx] - tmp  * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (i, j) = cwork[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
@@ -2524,56 +2420,17 @@ SparseMatrix::ltsolve (MatrixType& mattype, const Matrix& b,
       if (typ == MatrixType::Permuted_Lower)
         {
           retval.resize (nc, b_nc);
-          OCTAVE_LOCAL_BUFFER (double, work, nm);
           octave_idx_type *perm = mattype.triangular_perm ();
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              if (nc > nr)
-                for (octave_idx_type i = 0; i < nm; i++)
-                  work[i] = 0.;
-              for (octave_idx_type i = 0; i < nr; i++)
-                work[perm[i]] = b(i, j);
-
-              for (octave_idx_type k = 0; k < nc; k++)
-                {
-                  if (work[k] != 0.)
-                    {
-                      octave_idx_type minr = nr;
-                      octave_idx_type mini = 0;
-
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1); i++)
-                        if (perm[ridx (i)] < minr)
-                          {
-                            minr = perm[ridx (i)];
-                            mini = i;
-                          }
-
-                      if (minr != k || data (mini) == 0)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      double tmp = work[k] / data (mini);
-                      work[k] = tmp;
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1); i++)
-                        {
-                          if (i == mini)
-                            continue;
-
-                          octave_idx_type iidx = perm[ridx (i)];
-                          work[iidx] = work[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval(i, j) = work[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
+              OCTAVE_LOCAL_BUFFER (double, work, nm);
+
               // Calculation of 1-norm of inv(*this)
               for (octave_idx_type i = 0; i < nm; i++)
                 work[i] = 0.;
@@ -2625,42 +2482,17 @@ SparseMatrix::ltsolve (MatrixType& mattype, const Matrix& b,
         }
       else
         {
-          OCTAVE_LOCAL_BUFFER (double, work, nm);
           retval.resize (nc, b_nc, 0.);
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                work[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                work[i] = 0.;
-              for (octave_idx_type k = 0; k < nc; k++)
-                {
-                  if (work[k] != 0.)
-                    {
-                      if (ridx (cidx (k)) != k || data (cidx (k)) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      double tmp = work[k] / data (cidx (k));
-                      work[k] = tmp;
-                      for (octave_idx_type i = cidx (k)+1;
-                           i < cidx (k+1); i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          work[iidx] = work[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (i, j) = work[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
+              OCTAVE_LOCAL_BUFFER (double, work, nm);
+
               // Calculation of 1-norm of inv(*this)
               for (octave_idx_type i = 0; i < nm; i++)
                 work[i] = 0.;
@@ -3073,52 +2905,12 @@ SparseMatrix::ltsolve (MatrixType& mattype, const ComplexMatrix& b,
       if (typ == MatrixType::Permuted_Lower)
         {
           retval.resize (nc, b_nc);
-          OCTAVE_LOCAL_BUFFER (Complex, cwork, nm);
           octave_idx_type *perm = mattype.triangular_perm ();
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nm; i++)
-                cwork[i] = 0.;
-              for (octave_idx_type i = 0; i < nr; i++)
-                cwork[perm[i]] = b(i, j);
-
-              for (octave_idx_type k = 0; k < nc; k++)
-                {
-                  if (cwork[k] != 0.)
-                    {
-                      octave_idx_type minr = nr;
-                      octave_idx_type mini = 0;
-
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1); i++)
-                        if (perm[ridx (i)] < minr)
-                          {
-                            minr = perm[ridx (i)];
-                            mini = i;
-                          }
-
-                      if (minr != k || data (mini) == 0)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      Complex tmp = cwork[k] / data (mini);
-                      cwork[k] = tmp;
-                      for (octave_idx_type i = cidx (k); i < cidx (k+1); i++)
-                        {
-                          if (i == mini)
-                            continue;
-
-                          octave_idx_type iidx = perm[ridx (i)];
-                          cwork[iidx] = cwork[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval(i, j) = cwork[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
@@ -3174,39 +2966,12 @@ SparseMatrix::ltsolve (MatrixType& mattype, const ComplexMatrix& b,
         }
       else
         {
-          OCTAVE_LOCAL_BUFFER (Complex, cwork, nm);
           retval.resize (nc, b_nc, 0.);
 
-          for (octave_idx_type j = 0; j < b_nc; j++)
-            {
-              for (octave_idx_type i = 0; i < nr; i++)
-                cwork[i] = b(i, j);
-              for (octave_idx_type i = nr; i < nc; i++)
-                cwork[i] = 0.;
-
-              for (octave_idx_type k = 0; k < nc; k++)
-                {
-                  if (cwork[k] != 0.)
-                    {
-                      if (ridx (cidx (k)) != k || data (cidx (k)) == 0.)
-                        {
-                          err = -2;
-                          goto triangular_error;
-                        }
-
-                      Complex tmp = cwork[k] / data (cidx (k));
-                      cwork[k] = tmp;
-                      for (octave_idx_type i = cidx (k)+1; i < cidx (k+1); i++)
-                        {
-                          octave_idx_type iidx = ridx (i);
-                          cwork[iidx] = cwork[iidx] - tmp * data (i);
-                        }
-                    }
-                }
-
-              for (octave_idx_type i = 0; i < nc; i++)
-                retval.xelem (i, j) = cwork[i];
-            }
+          err = octave::sparse_trisolve (*this, mattype, typ, b.data (),
+                                          b_nc, retval.fortran_vec ());
+          if (err != 0)
+            goto triangular_error;
 
           if (calc_cond)
             {
@@ -28,6 +28,7 @@
 #endif
 
 #include <cinttypes>
+#include <cstdint>
 #include <cstdlib>
 
 #include <ostream>
@@ -39,8 +40,10 @@
 #include "Range.h"
 
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 #include "lo-error.h"
 #include "lo-mappers.h"
+#include "mx-simd.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -1304,6 +1307,209 @@ idx_vector::ones_count () const
   return n;
 }
 
+// Index and assign elements of plain types as raw bytes.  Elements of 4
+// and 8 bytes use the vector kernels from mx-simd.h.  The others are
+// copied by loops over unsigned integers of the same size.
+
+struct plain_16
+{
+  uint64_t m_w[2];
+};
+
+template <typename U>
+static void
+gather_loop (const void *src, const octave_idx_type *idx,
+             octave_idx_type len, void *dest)
+{
+  const U *s = static_cast<const U *> (src);
+  U *d = static_cast<U *> (dest);
+
+  for (octave_idx_type i = 0; i < len; i++)
+    d[i] = s[idx[i]];
+}
+
+template <typename U>
+static octave_idx_type
+compress_loop (const void *src, const bool *mask, octave_idx_type ext,
+               void *dest)
+{
+  const U *s = static_cast<const U *> (src);
+  U *d = static_cast<U *> (dest);
+  octave_idx_type k = 0;
+
+  for (octave_idx_type i = 0; i < ext; i++)
+    if (mask[i])
+      d[k++] = s[i];
+
+  return k;
+}
+
+template <typename U>
+static octave_idx_type
+expand_loop (const void *src, const bool *mask, octave_idx_type ext,
+             void *dest)
+{
+  const U *s = static_cast<const U *> (src);
+  U *d = static_cast<U *> (dest);
+  octave_idx_type k = 0;
+
+  for (octave_idx_type i = 0; i < ext; i++)
+    if (mask[i])
+      d[i] = s[k++];
+
+  return k;
+}
+
+static void
+gather_range (std::size_t size, const void *src, const octave_idx_type *idx,
+              octave_idx_type len, void *dest)
+{
+  switch (size)
+    {
+    case 1:
+      gather_loop<uint8_t> (src, idx, len, dest);
+      break;
+    case 2:
+      gather_loop<uint16_t> (src, idx, len, dest);
+      break;
+    case 4:
+      mx_simd_gather_4 (src, idx, len, dest);
+      break;
+    case 8:
+      mx_simd_gather_8 (src, idx, len, dest);
+      break;
+    default:
+      gather_loop<plain_16> (src, idx, len, dest);
+      break;
+    }
+}
+
+static octave_idx_type
+compress_range (std::size_t size, const void *src, const bool *mask,
+                octave_idx_type ext, void *dest)
+{
+  switch (size)
+    {
+    case 1:
+      return compress_loop<uint8_t> (src, mask, ext, dest);
+    case 2:
+      return compress_loop<uint16_t> (src, mask, ext, dest);
+    case 4:
+      return mx_simd_compress_4 (src, mask, ext, dest);
+    case 8:
+      return mx_simd_compress_8 (src, mask, ext, dest);
+    default:
+      return compress_loop<plain_16> (src, mask, ext, dest);
+    }
+}
+
+static octave_idx_type
+expand_range (std::size_t size, const void *src, const bool *mask,
+              octave_idx_type ext, void *dest)
+{
+  switch (size)
+    {
+    case 1:
+      return expand_loop<uint8_t> (src, mask, ext, dest);
+    case 2:
+      return expand_loop<uint16_t> (src, mask, ext, dest);
+    case 4:
+      return mx_simd_expand_4 (src, mask, ext, dest);
+    case 8:
+      return mx_simd_expand_8 (src, mask, ext, dest);
+    default:
+      return expand_loop<plain_16> (src, mask, ext, dest);
+    }
+}
+
+void
+idx_vector::gather_plain (std::size_t size, const void *src,
+                          const octave_idx_type *idx, octave_idx_type len,
+                          void *dest)
+{
+  if (thread_pool::use_threads (len))
+    {
+      char *d = static_cast<char *> (dest);
+
+      thread_pool::parallel_for
+        (len, [=] (std::size_t beg, std::size_t end)
+         {
+           gather_range (size, src, idx + beg, end - beg, d + beg * size);
+         });
+    }
+  else
+    gather_range (size, src, idx, len, dest);
+}
+
+// Copy between the elements selected by a mask and consecutive elements
+// in parallel.  The number of true values in each share of the mask is
+// counted first, which gives the offset of its consecutive elements.
+
+template <typename F>
+static void
+mask_parallel (std::size_t size, const void *src, const bool *mask,
+               octave_idx_type ext, void *dest, bool compress, F range)
+{
+  octave_idx_type nt = thread_pool::num_threads ();
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, offset, nt + 1);
+
+  auto share = [=] (octave_idx_type c)
+  { return (ext / nt) * c + std::min (c, ext % nt); };
+
+  offset[0] = 0;
+  thread_pool::parallel_for
+    (nt, ext / nt, [=] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t c = beg; c < end; c++)
+         offset[c+1] = std::count (mask + share (c), mask + share (c+1),
+                                   true);
+     });
+
+  for (octave_idx_type c = 0; c < nt; c++)
+    offset[c+1] += offset[c];
+
+  const char *s = static_cast<const char *> (src);
+  char *d = static_cast<char *> (dest);
+
+  thread_pool::parallel_for
+    (nt, ext / nt, [=] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t c = beg; c < end; c++)
+         {
+           octave_idx_type i = share (c);
+           octave_idx_type k = offset[c];
+           if (compress)
+             range (size, s + i * size, mask + i, share (c+1) - i,
+                    d + k * size);
+           else
+             range (size, s + k * size, mask + i, share (c+1) - i,
+                    d + i * size);
+         }
+     });
+}
+
+void
+idx_vector::compress_plain (std::size_t size, const void *src,
+                            const bool *mask, octave_idx_type ext,
+                            void *dest)
+{
+  if (thread_pool::num_threads () > 1 && thread_pool::use_threads (ext))
+    mask_parallel (size, src, mask, ext, dest, true, compress_range);
+  else
+    compress_range (size, src, mask, ext, dest);
+}
+
+void
+idx_vector::expand_plain (std::size_t size, const void *src,
+                          const bool *mask, octave_idx_type ext, void *dest)
+{
+  if (thread_pool::num_threads () > 1 && thread_pool::use_threads (ext))
+    mask_parallel (size, src, mask, ext, dest, false, expand_range);
+  else
+    expand_range (size, src, mask, ext, dest);
+}
+
 // Instantiate the octave_int constructors we want.
 #define INSTANTIATE_SCALAR_VECTOR_REP_CONST(T)                          \
   template OCTAVE_API idx_vector::idx_scalar_rep::idx_scalar_rep (T);   \
@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <iosfwd>
 #include <memory>
+#include <type_traits>
 
 #include "Array-fwd.h"
 #include "dim-vector.h"
@@ -626,6 +627,12 @@ public:
         {
           idx_vector_rep *r = dynamic_cast<idx_vector_rep *> (m_rep);
           const octave_idx_type *data = r->get_data ();
+          if constexpr (is_plain<T> ())
+            if (len >= s_plain_min_len)
+              {
+                gather_plain (sizeof (T), src, data, len, dest);
+                break;
+              }
           for (octave_idx_type i = 0; i < len; i++)
             dest[i] = src[data[i]];
         }
@@ -636,6 +643,12 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
+          if constexpr (is_plain<T> ())
+            if (ext >= s_plain_min_len)
+              {
+                compress_plain (sizeof (T), src, data, ext, dest);
+                break;
+              }
           for (octave_idx_type i = 0; i < ext; i++)
             if (data[i]) *dest++ = src[i];
         }
@@ -713,6 +726,12 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
+          if constexpr (is_plain<T> ())
+            if (ext >= s_plain_min_len)
+              {
+                expand_plain (sizeof (T), src, data, ext, dest);
+                break;
+              }
           for (octave_idx_type i = 0; i < ext; i++)
             if (data[i]) dest[i] = *src++;
         }
@@ -1033,6 +1052,34 @@ public:
 
 private:
 
+  // Types that index and assign copy as raw bytes, with vector kernels
+  // and threads for long index vectors and masks.  Assignment through an
+  // index vector stays a plain loop because the order of the writes
+  // matters when the indices repeat.
+
+  template <typename T>
+  static constexpr bool is_plain ()
+  {
+    return (std::is_trivially_copyable<T>::value
+            && (sizeof (T) == 1 || sizeof (T) == 2 || sizeof (T) == 4
+                || sizeof (T) == 8 || sizeof (T) == 16));
+  }
+
+  static const octave_idx_type s_plain_min_len = 64;
+
+  static OCTAVE_API void
+  gather_plain (std::size_t size, const void *src,
+                const octave_idx_type *idx, octave_idx_type len,
+                void *dest);
+
+  static OCTAVE_API void
+  compress_plain (std::size_t size, const void *src, const bool *mask,
+                  octave_idx_type ext, void *dest);
+
+  static OCTAVE_API void
+  expand_plain (std::size_t size, const void *src, const bool *mask,
+                octave_idx_type ext, void *dest);
+
   idx_base_rep *m_rep;
 
 };
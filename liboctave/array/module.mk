@@ -50,6 +50,8 @@ ARRAY_INC = \
   %reldir%/intNDArray.h \
   %reldir%/mx-fwd.h \
   %reldir%/range-fwd.h \
+  %reldir%/sparse-assembly.h \
+  %reldir%/sparse-trisolve.h \
   %reldir%/uint16NDArray.h \
   %reldir%/uint32NDArray.h \
   %reldir%/uint64NDArray.h \
@@ -115,6 +117,8 @@ ARRAY_SRC = \
   %reldir%/int32NDArray.cc \
   %reldir%/int64NDArray.cc \
   %reldir%/int8NDArray.cc \
+  %reldir%/sparse-assembly.cc \
+  %reldir%/sparse-trisolve.cc \
   %reldir%/uint16NDArray.cc \
   %reldir%/uint32NDArray.cc \
   %reldir%/uint64NDArray.cc \
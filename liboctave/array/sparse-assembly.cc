@@ -0,0 +1,379 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "oct-locbuf.h"
+#include "quit.h"
+#include "sparse-assembly.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// First triplet of range CH when N triplets are split into NCH ranges.
+
+static inline octave_idx_type
+chunk_start (octave_idx_type n, octave_idx_type nch, octave_idx_type ch)
+{
+  return (ch == nch ? n : n / nch * ch);
+}
+
+sparse_assembly::sparse_assembly (const idx_vector& r, const idx_vector& c,
+                                  octave_idx_type nr, octave_idx_type nc,
+                                  octave_idx_type n)
+  : m_nr (nr), m_nc (nc), m_n (n), m_nnz (0), m_sorted (true),
+    m_cidx (new octave_idx_type [nc + 1] ()), m_ridx (), m_kstart (),
+    m_perm (), m_pcol (), m_pdest ()
+{
+  if (n == 0)
+    return;
+
+  // Index vectors are converted to plain arrays of indices.  A single
+  // index is used for all triplets.
+  idx_vector rr = r;
+  idx_vector cc = c;
+  const octave_idx_type *rd = rr.raw ();
+  const octave_idx_type *cd = cc.raw ();
+  const octave_idx_type rs = (rr.length (nr) == 1 ? 0 : 1);
+  const octave_idx_type cs = (cc.length (nc) == 1 ? 0 : 1);
+
+  octave_idx_type nch = (thread_pool::use_threads (n)
+                         ? thread_pool::num_threads () : 1);
+
+  // Check whether the triplets are sorted by column and then by row.
+  std::atomic<bool> sorted (true);
+
+  thread_pool::parallel_for
+    (n - 1, [=, &sorted] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t k = beg; k < end; k++)
+         {
+           octave_idx_type c0 = cd[k*cs];
+           octave_idx_type c1 = cd[(k+1)*cs];
+           if (c1 < c0 || (c1 == c0 && rd[(k+1)*rs] < rd[k*rs]))
+             {
+               sorted = false;
+               break;
+             }
+         }
+     });
+
+  octave_quit ();
+
+  m_sorted = sorted;
+
+  if (m_sorted)
+    merge_sorted (rd, rs, cd, cs, nch);
+  else
+    merge_unsorted (rd, rs, cd, cs, nch);
+}
+
+std::vector<octave_idx_type>
+sparse_assembly::column_chunks (octave_idx_type nch) const
+{
+  std::vector<octave_idx_type> retval (nch + 1);
+  octave_idx_type *lim = retval.data ();
+  const octave_idx_type *pcol = m_pcol.get ();
+
+  lim[0] = 0;
+  for (octave_idx_type ch = 1; ch < nch; ch++)
+    lim[ch] = std::max (lim[ch-1],
+                        static_cast<octave_idx_type>
+                        (std::lower_bound (pcol, pcol + m_nc + 1,
+                                           m_n / nch * ch) - pcol));
+  lim[nch] = m_nc;
+
+  return retval;
+}
+
+// Triplets sorted by column and row.  Each range of triplets counts the
+// runs of equal indices that start in it, then writes them.  The
+// column pointers are set where the column changes between two runs.
+
+void
+sparse_assembly::merge_sorted (const octave_idx_type *rd,
+                               octave_idx_type rs,
+                               const octave_idx_type *cd,
+                               octave_idx_type cs, octave_idx_type nch)
+{
+  const octave_idx_type n = m_n;
+
+  auto is_start = [=] (octave_idx_type k)
+  {
+    return (k == 0 || cd[k*cs] != cd[(k-1)*cs] || rd[k*rs] != rd[(k-1)*rs]);
+  };
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, off, nch + 1);
+
+  thread_pool::parallel_for
+    (nch, n / nch, [=] (std::size_t cbeg, std::size_t cend)
+     {
+       for (octave_idx_type ch = cbeg; ch < octave_idx_type (cend); ch++)
+         {
+           octave_idx_type cnt = 0;
+           for (octave_idx_type k = chunk_start (n, nch, ch);
+                k < chunk_start (n, nch, ch + 1); k++)
+             cnt += is_start (k);
+           off[ch+1] = cnt;
+         }
+     });
+
+  off[0] = 0;
+  for (octave_idx_type ch = 0; ch < nch; ch++)
+    off[ch+1] += off[ch];
+
+  m_nnz = off[nch];
+  m_ridx.reset (new octave_idx_type [m_nnz]);
+
+  if (m_nnz < n)
+    m_kstart.reset (new octave_idx_type [m_nnz + 1]);
+
+  octave_quit ();
+
+  octave_idx_type *cidx = m_cidx.get ();
+  octave_idx_type *ridx = m_ridx.get ();
+  octave_idx_type *ks = m_kstart.get ();
+
+  thread_pool::parallel_for
+    (nch, n / nch, [=] (std::size_t cbeg, std::size_t cend)
+     {
+       for (octave_idx_type ch = cbeg; ch < octave_idx_type (cend); ch++)
+         {
+           octave_idx_type i = off[ch];
+           for (octave_idx_type k = chunk_start (n, nch, ch);
+                k < chunk_start (n, nch, ch + 1); k++)
+             {
+               if (! is_start (k))
+                 continue;
+
+               octave_idx_type j = cd[k*cs];
+               octave_idx_type j0 = (k == 0 ? 0 : cd[(k-1)*cs] + 1);
+               for (; j0 <= j; j0++)
+                 cidx[j0] = i;
+
+               ridx[i] = rd[k*rs];
+               if (ks)
+                 ks[i] = k;
+               i++;
+             }
+         }
+     });
+
+  for (octave_idx_type j = cd[(n-1)*cs] + 1; j <= m_nc; j++)
+    cidx[j] = m_nnz;
+
+  if (ks)
+    ks[m_nnz] = n;
+}
+
+// Other triplets.  A counting sort by column lists the triplets of each
+// column in their original order.  With several threads, each range of
+// triplets is counted and placed separately.  Each column is then
+// reduced to its distinct rows, which are sorted.
+
+void
+sparse_assembly::merge_unsorted (const octave_idx_type *rd,
+                                 octave_idx_type rs,
+                                 const octave_idx_type *cd,
+                                 octave_idx_type cs, octave_idx_type nch)
+{
+  const octave_idx_type n = m_n;
+  const octave_idx_type nr = m_nr;
+  const octave_idx_type nc = m_nc;
+
+  // The counts of each range take NC elements, so only split the sort
+  // if the triplets outnumber them.
+  octave_idx_type nsort = (nch * nc <= n ? nch : 1);
+
+  m_perm.reset (new octave_idx_type [n]);
+  m_pcol.reset (new octave_idx_type [nc + 1]);
+
+  octave_idx_type *perm = m_perm.get ();
+  octave_idx_type *pcol = m_pcol.get ();
+
+  // The rows of the triplets in the order of PERM.
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, rows, n);
+
+  {
+    std::vector<octave_idx_type> cnt (nsort * nc, 0);
+    octave_idx_type *pcnt = cnt.data ();
+
+    thread_pool::parallel_for
+      (nsort, n / nsort, [=] (std::size_t cbeg, std::size_t cend)
+       {
+         for (octave_idx_type ch = cbeg; ch < octave_idx_type (cend); ch++)
+           {
+             octave_idx_type *cc = pcnt + ch * nc;
+             for (octave_idx_type k = chunk_start (n, nsort, ch);
+                  k < chunk_start (n, nsort, ch + 1); k++)
+               cc[cd[k*cs]]++;
+           }
+       });
+
+    // Turn the counts into the first position of each column and range.
+    octave_idx_type s = 0;
+    for (octave_idx_type j = 0; j < nc; j++)
+      {
+        pcol[j] = s;
+        for (octave_idx_type ch = 0; ch < nsort; ch++)
+          {
+            octave_idx_type t = pcnt[ch * nc + j];
+            pcnt[ch * nc + j] = s;
+            s += t;
+          }
+      }
+    pcol[nc] = s;
+
+    octave_quit ();
+
+    thread_pool::parallel_for
+      (nsort, n / nsort, [=] (std::size_t cbeg, std::size_t cend)
+       {
+         for (octave_idx_type ch = cbeg; ch < octave_idx_type (cend); ch++)
+           {
+             octave_idx_type *cc = pcnt + ch * nc;
+             for (octave_idx_type k = chunk_start (n, nsort, ch);
+                  k < chunk_start (n, nsort, ch + 1); k++)
+               {
+                 octave_idx_type i = cc[cd[k*cs]]++;
+                 perm[i] = k;
+                 rows[i] = rd[k*rs];
+               }
+           }
+       });
+  }
+
+  octave_quit ();
+
+  // Find the distinct rows of each column.  Column J keeps them sorted in
+  // ROWS(PCOL(J):PCOL(J)+NZC(J)-1), and PDEST gives the position of the
+  // row of each triplet among them.  A marker array of NR elements makes
+  // this linear in the number of triplets, but is only used if it is not
+  // much larger than the number of triplets handled by the thread.
+
+  m_pdest.reset (new octave_idx_type [n]);
+  octave_idx_type *pdest = m_pdest.get ();
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, nzc, nc);
+
+  std::vector<octave_idx_type> lim = column_chunks (nch);
+  const octave_idx_type *jlim = lim.data ();
+
+  thread_pool::parallel_for
+    (nch, n / nch, [=] (std::size_t cbeg, std::size_t cend)
+     {
+       for (octave_idx_type ch = cbeg; ch < octave_idx_type (cend); ch++)
+         {
+           octave_idx_type jb = jlim[ch];
+           octave_idx_type je = jlim[ch+1];
+
+           if (nr <= pcol[je] - pcol[jb])
+             {
+               // The first triplet of column J with row R sets MARK(R) to
+               // PCOL(J), and older marks are smaller.  Once the distinct
+               // rows are sorted, MARK(R) is set to PCOL(J) plus the
+               // position of R among them.
+               std::vector<octave_idx_type> mark (nr, -1);
+               std::vector<octave_idx_type> uq;
+
+               for (octave_idx_type j = jb; j < je; j++)
+                 {
+                   uq.clear ();
+                   for (octave_idx_type i = pcol[j]; i < pcol[j+1]; i++)
+                     {
+                       octave_idx_type r = rows[i];
+                       if (mark[r] < pcol[j])
+                         {
+                           mark[r] = pcol[j];
+                           uq.push_back (r);
+                         }
+                     }
+
+                   std::sort (uq.begin (), uq.end ());
+
+                   octave_idx_type nu = uq.size ();
+                   for (octave_idx_type t = 0; t < nu; t++)
+                     mark[uq[t]] = pcol[j] + t;
+                   for (octave_idx_type i = pcol[j]; i < pcol[j+1]; i++)
+                     pdest[i] = mark[rows[i]] - pcol[j];
+
+                   std::copy_n (uq.begin (), nu, rows + pcol[j]);
+                   nzc[j] = nu;
+                 }
+             }
+           else
+             {
+               // Sort the rows of each column with their positions.
+               std::vector<std::pair<octave_idx_type, octave_idx_type>> rp;
+
+               for (octave_idx_type j = jb; j < je; j++)
+                 {
+                   octave_idx_type *u = rows + pcol[j];
+                   octave_idx_type len = pcol[j+1] - pcol[j];
+                   rp.resize (len);
+                   for (octave_idx_type t = 0; t < len; t++)
+                     rp[t] = std::make_pair (u[t], t);
+
+                   std::sort (rp.begin (), rp.end ());
+
+                   octave_idx_type nu = 0;
+                   for (octave_idx_type t = 0; t < len; t++)
+                     {
+                       if (t == 0 || rp[t].first != rp[t-1].first)
+                         u[nu++] = rp[t].first;
+                       pdest[pcol[j] + rp[t].second] = nu - 1;
+                     }
+
+                   nzc[j] = nu;
+                 }
+             }
+         }
+     });
+
+  octave_quit ();
+
+  octave_idx_type *cidx = m_cidx.get ();
+  cidx[0] = 0;
+  for (octave_idx_type j = 0; j < nc; j++)
+    cidx[j+1] = cidx[j] + nzc[j];
+
+  m_nnz = cidx[nc];
+  m_ridx.reset (new octave_idx_type [m_nnz]);
+  octave_idx_type *ridx = m_ridx.get ();
+
+  thread_pool::parallel_for
+    (nch, n / nch, [=] (std::size_t cbeg, std::size_t cend)
+     {
+       for (octave_idx_type j = jlim[cbeg]; j < jlim[cend]; j++)
+         std::copy_n (rows + pcol[j], nzc[j], ridx + cidx[j]);
+     });
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_sparse_assembly_h)
+#define octave_sparse_assembly_h 1
+
+#include "octave-config.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "idx-vector.h"
+#include "oct-thread-pool.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Compressed column pattern of the triplets (R(k), C(k), A(k)) of a
+// sparse matrix, where triplets with the same row and column are merged.
+// The pattern only depends on the indices, so once it is computed it can
+// be used to assemble any number of value arrays with the same indices,
+// as in finite element codes that update the values on a fixed mesh.
+//
+// Triplets that are already sorted by column and row are merged in one
+// pass.  Other triplets are sorted by column with a counting sort, and
+// the repeated rows of each column are found with a marker array, or by
+// sorting the column if the matrix has many more rows than triplets.
+// Both steps are split between threads.
+
+class OCTAVE_API sparse_assembly
+{
+public:
+
+  sparse_assembly ()
+    : m_nr (0), m_nc (0), m_n (0), m_nnz (0), m_sorted (true),
+      m_cidx (new octave_idx_type [1] ()), m_ridx (), m_kstart (),
+      m_perm (), m_pcol (), m_pdest ()
+  { }
+
+  // R and C have N elements, or one element that is used for all of
+  // them.  The indices must be less than NR and NC.
+  sparse_assembly (const idx_vector& r, const idx_vector& c,
+                   octave_idx_type nr, octave_idx_type nc,
+                   octave_idx_type n);
+
+  OCTAVE_DISABLE_COPY (sparse_assembly)
+
+  OCTAVE_DEFAULT_MOVE (sparse_assembly)
+
+  ~sparse_assembly () = default;
+
+  octave_idx_type rows () const { return m_nr; }
+
+  octave_idx_type cols () const { return m_nc; }
+
+  // Number of triplets.
+  octave_idx_type numel () const { return m_n; }
+
+  // Number of merged elements.
+  octave_idx_type nnz () const { return m_nnz; }
+
+  const octave_idx_type * cidx () const { return m_cidx.get (); }
+
+  const octave_idx_type * ridx () const { return m_ridx.get (); }
+
+  // Store in DATA, which has nnz () elements, the sum of the values A of
+  // the triplets at each position, or the last of them in the order of
+  // the triplets if SUM_TERMS is false.  Values are summed in the order
+  // of the triplets.  If A_SCALAR is true, A(0) is used for all triplets.
+  template <typename T>
+  void assemble (const T *a, bool a_scalar, T *data, bool sum_terms) const;
+
+private:
+
+  // Boundaries of NCH ranges of columns with about the same number of
+  // triplets.
+  std::vector<octave_idx_type> column_chunks (octave_idx_type nch) const;
+
+  void merge_sorted (const octave_idx_type *rd, octave_idx_type rs,
+                     const octave_idx_type *cd, octave_idx_type cs,
+                     octave_idx_type nch);
+
+  void merge_unsorted (const octave_idx_type *rd, octave_idx_type rs,
+                       const octave_idx_type *cd, octave_idx_type cs,
+                       octave_idx_type nch);
+
+  octave_idx_type m_nr;
+  octave_idx_type m_nc;
+  octave_idx_type m_n;
+  octave_idx_type m_nnz;
+
+  // TRUE if the triplets were sorted.
+  bool m_sorted;
+
+  // The pattern.
+  std::unique_ptr<octave_idx_type []> m_cidx;
+  std::unique_ptr<octave_idx_type []> m_ridx;
+
+  // Sorted triplets: element I of the result merges triplets
+  // M_KSTART(I) to M_KSTART(I+1)-1.  Null if no triplets are repeated.
+  std::unique_ptr<octave_idx_type []> m_kstart;
+
+  // Other triplets: M_PERM lists the triplets by column, in their
+  // original order within each column, and the triplets of column J are
+  // M_PERM(M_PCOL(J):M_PCOL(J+1)-1).  Triplet M_PERM(I) goes to element
+  // M_CIDX(J) + M_PDEST(I) of the result.
+  std::unique_ptr<octave_idx_type []> m_perm;
+  std::unique_ptr<octave_idx_type []> m_pcol;
+  std::unique_ptr<octave_idx_type []> m_pdest;
+};
+
+template <typename T>
+void
+sparse_assembly::assemble (const T *a, bool a_scalar, T *data,
+                           bool sum_terms) const
+{
+  const octave_idx_type as = (a_scalar ? 0 : 1);
+
+  if (m_sorted)
+    {
+      if (! m_kstart)
+        {
+          if (a_scalar)
+            std::fill_n (data, m_nnz, a[0]);
+          else
+            std::copy_n (a, m_nnz, data);
+          return;
+        }
+
+      const octave_idx_type *ks = m_kstart.get ();
+
+      thread_pool::parallel_for
+        (m_nnz, [=] (std::size_t beg, std::size_t end)
+         {
+           for (std::size_t i = beg; i < end; i++)
+             {
+               octave_idx_type k = ks[i];
+               octave_idx_type k_end = ks[i+1];
+               if (sum_terms)
+                 {
+                   T v = a[k*as];
+                   for (k++; k < k_end; k++)
+                     v += a[k*as];
+                   data[i] = v;
+                 }
+               else
+                 data[i] = a[(k_end-1)*as];
+             }
+         });
+    }
+  else
+    {
+      octave_idx_type nch = (thread_pool::use_threads (m_n)
+                             ? thread_pool::num_threads () : 1);
+      std::vector<octave_idx_type> lim = column_chunks (nch);
+      const octave_idx_type *jlim = lim.data ();
+
+      const octave_idx_type *cidx = m_cidx.get ();
+      const octave_idx_type *perm = m_perm.get ();
+      const octave_idx_type *pcol = m_pcol.get ();
+      const octave_idx_type *pdest = m_pdest.get ();
+
+      thread_pool::parallel_for
+        (nch, m_n / nch, [=] (std::size_t cbeg, std::size_t cend)
+         {
+           for (octave_idx_type j = jlim[cbeg]; j < jlim[cend]; j++)
+             {
+               T *dj = data + cidx[j];
+               std::fill (dj, data + cidx[j+1], T ());
+               if (sum_terms)
+                 for (octave_idx_type i = pcol[j]; i < pcol[j+1]; i++)
+                   dj[pdest[i]] += a[perm[i]*as];
+               else
+                 for (octave_idx_type i = pcol[j]; i < pcol[j+1]; i++)
+                   dj[pdest[i]] = a[perm[i]*as];
+             }
+         });
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <vector>
+
+#include "sparse-trisolve.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+triangular_levels::triangular_levels (octave_idx_type n,
+                                      const octave_idx_type *cidx,
+                                      const octave_idx_type *ridx,
+                                      bool upper)
+  : m_n (n), m_nnz (cidx[n]), m_upper (upper), m_level_ptr (), m_rows (n)
+{
+  // The columns are visited in the order of the solve.  When column K is
+  // reached, the rows it depends on have been visited, so its level is
+  // final and is passed on to the rows of its other elements.
+  std::vector<octave_idx_type> lev (n, 0);
+  octave_idx_type nlev = (n > 0 ? 1 : 0);
+
+  for (octave_idx_type jj = 0; jj < n; jj++)
+    {
+      octave_idx_type k = (upper ? n - 1 - jj : jj);
+      octave_idx_type lk = lev[k] + 1;
+
+      if (lk > nlev)
+        nlev = lk;
+
+      for (octave_idx_type i = cidx[k]; i < cidx[k+1]; i++)
+        {
+          octave_idx_type r = ridx[i];
+          if ((upper ? r < k : r > k) && lev[r] < lk)
+            lev[r] = lk;
+        }
+    }
+
+  // Sort the rows by level.
+  m_level_ptr.assign (nlev + 1, 0);
+  for (octave_idx_type i = 0; i < n; i++)
+    m_level_ptr[lev[i]+1]++;
+  for (octave_idx_type l = 0; l < nlev; l++)
+    m_level_ptr[l+1] += m_level_ptr[l];
+
+  std::vector<octave_idx_type> pos (m_level_ptr.begin (),
+                                    m_level_ptr.end () - 1);
+  for (octave_idx_type i = 0; i < n; i++)
+    m_rows[pos[lev[i]]++] = i;
+}
+
+OCTAVE_END_NAMESPACE(octave)
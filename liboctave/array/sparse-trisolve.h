@@ -0,0 +1,353 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_sparse_trisolve_h)
+#define octave_sparse_trisolve_h 1
+
+#include "octave-config.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "MatrixType.h"
+#include "Sparse.h"
+#include "oct-thread-pool.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Dependency levels of the rows of a sparse triangular matrix.  Solving
+// for row I of an upper (lower) triangular system needs the solution in
+// the rows of the elements right (left) of the diagonal in row I.  Rows
+// of level 0 need none, and rows of level L only need rows of lower
+// levels, so all rows of one level can be solved at the same time.
+// The levels only depend on the sparsity pattern, so they are computed
+// once and saved in the MatrixType of the matrix for later solves.
+
+class OCTAVE_API triangular_levels
+{
+public:
+
+  triangular_levels (octave_idx_type n, const octave_idx_type *cidx,
+                     const octave_idx_type *ridx, bool upper);
+
+  OCTAVE_DISABLE_COPY_MOVE (triangular_levels)
+
+  ~triangular_levels () = default;
+
+  octave_idx_type rows () const { return m_n; }
+
+  octave_idx_type nnz () const { return m_nnz; }
+
+  bool is_upper () const { return m_upper; }
+
+  octave_idx_type nlevels () const { return m_level_ptr.size () - 1; }
+
+  // The rows of level L are ROWS(LEVEL_PTR(L):LEVEL_PTR(L+1)-1).
+  const octave_idx_type * level_ptr () const { return m_level_ptr.data (); }
+
+  const octave_idx_type * level_rows () const { return m_rows.data (); }
+
+  // TRUE if the levels were computed for the triangular matrix with N
+  // rows and NNZ elements.
+  bool matches (octave_idx_type n, octave_idx_type nnz, bool upper) const
+  {
+    return m_n == n && m_nnz == nnz && m_upper == upper;
+  }
+
+private:
+
+  octave_idx_type m_n;
+  octave_idx_type m_nnz;
+  bool m_upper;
+
+  std::vector<octave_idx_type> m_level_ptr;
+  std::vector<octave_idx_type> m_rows;
+};
+
+// Solve for column J of B with the triangular matrix A of type TYP,
+// using WORK with max (NR, NC) elements, and store the solution in X.
+// Return false if the matrix is singular.
+
+template <typename T, typename B, typename R>
+bool
+sparse_trisolve_column (int typ, octave_idx_type nr, octave_idx_type nc,
+                        const octave_idx_type *cidx,
+                        const octave_idx_type *ridx, const T *data,
+                        const octave_idx_type *perm, const B *b, R *work,
+                        R *x)
+{
+  const R zero = R ();
+
+  if (typ == MatrixType::Permuted_Lower)
+    {
+      if (nc > nr)
+        std::fill_n (work, nc, zero);
+      for (octave_idx_type i = 0; i < nr; i++)
+        work[perm[i]] = b[i];
+    }
+  else
+    {
+      for (octave_idx_type i = 0; i < nr; i++)
+        work[i] = b[i];
+      for (octave_idx_type i = nr; i < nc; i++)
+        work[i] = zero;
+    }
+
+  switch (typ)
+    {
+    case MatrixType::Upper:
+      for (octave_idx_type k = nc-1; k >= 0; k--)
+        {
+          if (work[k] != zero)
+            {
+              octave_idx_type kd = cidx[k+1] - 1;
+              if (kd < cidx[k] || ridx[kd] != k || data[kd] == T ())
+                return false;
+
+              R tmp = work[k] / data[kd];
+              work[k] = tmp;
+              for (octave_idx_type i = cidx[k]; i < kd; i++)
+                work[ridx[i]] -= tmp * data[i];
+            }
+        }
+
+      std::copy_n (work, nc, x);
+      break;
+
+    case MatrixType::Permuted_Upper:
+      for (octave_idx_type k = nc-1; k >= 0; k--)
+        {
+          octave_idx_type kidx = perm[k];
+
+          if (work[k] != zero)
+            {
+              octave_idx_type kd = cidx[kidx+1] - 1;
+              if (kd < cidx[kidx] || ridx[kd] != k || data[kd] == T ())
+                return false;
+
+              R tmp = work[k] / data[kd];
+              work[k] = tmp;
+              for (octave_idx_type i = cidx[kidx]; i < kd; i++)
+                work[ridx[i]] -= tmp * data[i];
+            }
+        }
+
+      for (octave_idx_type i = 0; i < nc; i++)
+        x[perm[i]] = work[i];
+      break;
+
+    case MatrixType::Lower:
+      for (octave_idx_type k = 0; k < nc; k++)
+        {
+          if (work[k] != zero)
+            {
+              octave_idx_type kd = cidx[k];
+              if (kd == cidx[k+1] || ridx[kd] != k || data[kd] == T ())
+                return false;
+
+              R tmp = work[k] / data[kd];
+              work[k] = tmp;
+              for (octave_idx_type i = kd+1; i < cidx[k+1]; i++)
+                work[ridx[i]] -= tmp * data[i];
+            }
+        }
+
+      std::copy_n (work, nc, x);
+      break;
+
+    case MatrixType::Permuted_Lower:
+      for (octave_idx_type k = 0; k < nc; k++)
+        {
+          if (work[k] != zero)
+            {
+              octave_idx_type minr = nr;
+              octave_idx_type mini = 0;
+
+              for (octave_idx_type i = cidx[k]; i < cidx[k+1]; i++)
+                if (perm[ridx[i]] < minr)
+                  {
+                    minr = perm[ridx[i]];
+                    mini = i;
+                  }
+
+              if (minr != k || data[mini] == T ())
+                return false;
+
+              R tmp = work[k] / data[mini];
+              work[k] = tmp;
+              for (octave_idx_type i = cidx[k]; i < cidx[k+1]; i++)
+                {
+                  if (i == mini)
+                    continue;
+
+                  work[perm[ridx[i]]] -= tmp * data[i];
+                }
+            }
+        }
+
+      std::copy_n (work, nc, x);
+      break;
+    }
+
+  return true;
+}
+
+// Solve A*X = B, where A is a sparse triangular matrix of type TYP
+// (Upper, Lower, Permuted_Upper, or Permuted_Lower) described by
+// MATTYPE, and B and X are full column-major matrices with B_NC columns.
+// Return 0, or -2 if A is singular.
+//
+// Several right-hand sides are solved in parallel, one column per
+// thread.  With fewer right-hand sides than threads, an unpermuted
+// square matrix is solved row by row over its row-oriented form (see
+// Sparse<T>::csr), one dependency level at a time, with the rows of each
+// level split between threads.  The levels are computed by the first
+// solve and saved in MATTYPE.  This adds up the products in each row in
+// a different order than the column-oriented solve, so the result may
+// differ from it by rounding.
+
+template <typename T, typename B, typename R>
+octave_idx_type
+sparse_trisolve (const Sparse<T>& a, MatrixType& mattype, int typ,
+                 const B *b, octave_idx_type b_nc, R *x)
+{
+  const octave_idx_type nr = a.rows ();
+  const octave_idx_type nc = a.cols ();
+  const octave_idx_type nm = (nc > nr ? nc : nr);
+  const octave_idx_type nz = a.nnz ();
+
+  const octave_idx_type *cidx = a.cidx ();
+  const octave_idx_type *ridx = a.ridx ();
+  const T *data = a.data ();
+  const octave_idx_type *perm = mattype.triangular_perm ();
+
+  std::atomic<bool> singular (false);
+
+  if (b_nc < thread_pool::num_threads () && nr == nc
+      && (typ == MatrixType::Upper || typ == MatrixType::Lower)
+      && thread_pool::use_threads (nz))
+    {
+      const bool upper = (typ == MatrixType::Upper);
+
+      const triangular_levels *lv = mattype.solve_levels ();
+      if (! lv || ! lv->matches (nr, nz, upper))
+        {
+          auto new_lv
+            = std::make_shared<const triangular_levels> (nr, cidx, ridx,
+                                                         upper);
+          mattype.set_solve_levels (new_lv);
+          lv = new_lv.get ();
+        }
+
+      // Solving level by level visits the rows out of order, which is
+      // slower than the column-oriented solve unless the levels are
+      // large enough on average to be split between threads.  Factors
+      // of discretized PDEs, such as those from ichol or ilu, have
+      // thousands of levels of a few hundred rows and fail this test.
+      const std::size_t cost = (nz / nr + 1) * b_nc;
+
+      const octave_idx_type *rp;
+      const octave_idx_type *ci;
+      const T *d;
+
+      if (thread_pool::use_threads (nr / lv->nlevels (), cost)
+          && a.csr (rp, ci, d))
+        {
+          const octave_idx_type *lptr = lv->level_ptr ();
+          const octave_idx_type *lrows = lv->level_rows ();
+
+          for (octave_idx_type l = 0; l < lv->nlevels (); l++)
+            {
+              const octave_idx_type *rows = lrows + lptr[l];
+
+              thread_pool::parallel_for
+                (lptr[l+1] - lptr[l], cost,
+                 [=, &singular] (std::size_t beg, std::size_t end)
+                 {
+                   for (std::size_t t = beg; t < end; t++)
+                     {
+                       octave_idx_type i = rows[t];
+                       octave_idx_type pb = rp[i];
+                       octave_idx_type pe = rp[i+1];
+
+                       // The diagonal element comes first in a row of
+                       // an upper triangular matrix, and last in a row
+                       // of a lower triangular matrix.
+                       T diag = T ();
+                       if (upper && pb < pe && ci[pb] == i)
+                         diag = d[pb++];
+                       else if (! upper && pb < pe && ci[pe-1] == i)
+                         diag = d[--pe];
+
+                       for (octave_idx_type j = 0; j < b_nc; j++)
+                         {
+                           R *xj = x + j * nc;
+                           R s = b[i + j * nr];
+                           for (octave_idx_type p = pb; p < pe; p++)
+                             s -= d[p] * xj[ci[p]];
+
+                           if (s != R ())
+                             {
+                               if (diag == T ())
+                                 {
+                                   singular = true;
+                                   return;
+                                 }
+
+                               s /= diag;
+                             }
+
+                           xj[i] = s;
+                         }
+                     }
+                 });
+
+              if (singular)
+                return -2;
+            }
+
+          return 0;
+        }
+    }
+
+  thread_pool::parallel_for
+    (b_nc, nz + nm, [=, &singular] (std::size_t beg, std::size_t end)
+     {
+       std::vector<R> work (nm);
+
+       for (std::size_t j = beg; j < end && ! singular; j++)
+         if (! sparse_trisolve_column (typ, nr, nc, cidx, ridx, data, perm,
+                                       b + j * nr, work.data (),
+                                       x + j * nc))
+           singular = true;
+     });
+
+  return singular ? -2 : 0;
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
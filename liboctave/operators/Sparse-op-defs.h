@@ -28,10 +28,14 @@
 
 #include "octave-config.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
 #include "mx-inlines.cc"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // sparse matrix by scalar operations.
 
@@ -1760,6 +1764,477 @@
 
 #define SPARSE_ANY_OP(DIM) SPARSE_ANY_ALL_OP (DIM, false, false, !=, true)
 
+// Products of sparse matrices with sparse and full matrices.  The
+// kernels work on raw data and compute ranges of the columns or rows of
+// the result, so that large products can be split between threads.
+// Loops that run serially check for interrupts between blocks of
+// columns.
+
+// Call FCN (BEG, END) for ranges that cover [0, N), where each of the N
+// items costs about COST operations.
+
+template <typename F>
+void
+sparse_mul_for (octave_idx_type n, octave_idx_type cost, const F& fcn)
+{
+  if (octave::thread_pool::use_threads (n, cost))
+    octave::thread_pool::parallel_for (n, cost, fcn);
+  else
+    {
+      octave_idx_type blk
+        = std::max<octave_idx_type> (1, 65536 / std::max<octave_idx_type>
+                                                  (1, cost));
+
+      for (octave_idx_type beg = 0; beg < n; beg += blk)
+        {
+          octave_quit ();
+
+          fcn (beg, std::min (n, beg + blk));
+        }
+    }
+}
+
+// Split [0, N) into NCH ranges of about the same work, where WORK[i] is
+// the work of the items before i, and call FCN (C, BEG, END) for range
+// C.  The ranges run in parallel if NCH > 1, so FCN may use storage
+// private to C.  Otherwise FCN (0, BEG, END) is called for consecutive
+// blocks of [0, N) of about the same work, with a check for interrupts
+// before each block.
+
+template <typename F>
+void
+sparse_mul_chunks (octave_idx_type n, const octave_idx_type *work,
+                   octave_idx_type nch, const F& fcn)
+{
+  if (nch <= 1)
+    {
+      const octave_idx_type blk = 65536;
+
+      for (octave_idx_type beg = 0; beg < n; )
+        {
+          octave_quit ();
+
+          octave_idx_type end
+            = std::upper_bound (work + beg + 1, work + n + 1,
+                                work[beg] + blk) - work - 1;
+          end = std::max (end, beg + 1);
+
+          fcn (0, beg, end);
+
+          beg = end;
+        }
+
+      return;
+    }
+
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, lim, nch + 1);
+
+  lim[0] = 0;
+  for (octave_idx_type c = 1; c < nch; c++)
+    lim[c] = std::max (lim[c-1],
+                       static_cast<octave_idx_type>
+                       (std::lower_bound (work, work + n + 1,
+                                          work[n] / nch * c) - work));
+  lim[nch] = n;
+
+  octave::thread_pool::parallel_for
+    (nch, work[n] / nch, [=, &fcn] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t c = beg; c < end; c++)
+         fcn (c, lim[c], lim[c+1]);
+     });
+}
+
+// R += M * A, with M sparse and A full.  Columns of the result are
+// independent.  If there are fewer of them than threads, as for a
+// matrix-vector product, the rows are split between threads using the
+// row form of M (see Sparse<T>::csr), which is built if needed.  Each
+// element is then summed in the same order as by the serial loop, so
+// the result does not depend on the number of threads.
+
+template <typename RT, typename SM, typename FM>
+void
+sparse_full_mul (const SM& m, const FM& a, RT& r)
+{
+  typedef typename RT::element_type R;
+
+  octave_idx_type nr = m.rows ();
+  octave_idx_type nc = m.cols ();
+  octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *cidx = m.cidx ();
+  const octave_idx_type *ridx = m.ridx ();
+  const auto *mdata = m.data ();
+  const auto *adata = a.data ();
+  R *rdata = r.rwdata ();
+
+  octave_idx_type nz = cidx[nc];
+
+  auto kernel = [=] (R *rcol, octave_idx_type i, octave_idx_type jb,
+                     octave_idx_type je)
+  {
+    const auto *acol = adata + i * nc;
+    for (octave_idx_type j = jb; j < je; j++)
+      {
+        auto tmpval = acol[j];
+        for (octave_idx_type k = cidx[j]; k < cidx[j+1]; k++)
+          rcol[ridx[k]] += tmpval * mdata[k];
+      }
+  };
+
+  if (a_nc < octave::thread_pool::num_threads () && nr > 0
+      && octave::thread_pool::use_threads (nz * a_nc))
+    {
+      const octave_idx_type *rptr, *rcidx;
+      const typename SM::element_type *rvals;
+
+      m.csr (rptr, rcidx, rvals, true);
+
+      octave::thread_pool::parallel_for
+        (nr, (nz / nr + 1) * a_nc, [=] (std::size_t beg, std::size_t end)
+         {
+           for (octave_idx_type i = 0; i < a_nc; i++)
+             {
+               const auto *acol = adata + i * nc;
+               R *rcol = rdata + i * nr;
+               for (std::size_t k = beg; k < end; k++)
+                 {
+                   R acc = R ();
+                   for (octave_idx_type p = rptr[k]; p < rptr[k+1]; p++)
+                     acc += acol[rcidx[p]] * rvals[p];
+                   rcol[k] = acc;
+                 }
+             }
+         });
+    }
+  else
+    sparse_mul_for (a_nc, nz + nc, [=] (std::size_t beg, std::size_t end)
+                    {
+                      for (std::size_t i = beg; i < end; i++)
+                        kernel (rdata + i * nr, i, 0, nc);
+                    });
+}
+
+// R = OP (M).' * A, with M sparse and A full.  Each element of the
+// result is a dot product, so the columns of M are split between
+// threads.
+
+template <typename RT, typename SM, typename FM, typename F>
+void
+sparse_full_trans_mul (const SM& m, const FM& a, RT& r, F op)
+{
+  typedef typename RT::element_type R;
+
+  octave_idx_type nr = m.rows ();
+  octave_idx_type nc = m.cols ();
+  octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *cidx = m.cidx ();
+  const octave_idx_type *ridx = m.ridx ();
+  const auto *mdata = m.data ();
+  const auto *adata = a.data ();
+  R *rdata = r.rwdata ();
+
+  octave_idx_type cost = (cidx[nc] / std::max<octave_idx_type> (1, nc) + 1)
+                         * a_nc;
+
+  sparse_mul_for (nc, cost, [=] (std::size_t beg, std::size_t end)
+                  {
+                    for (octave_idx_type i = 0; i < a_nc; i++)
+                      {
+                        const auto *acol = adata + i * nr;
+                        R *rcol = rdata + i * nc;
+                        for (std::size_t j = beg; j < end; j++)
+                          {
+                            R acc = R ();
+                            for (octave_idx_type k = cidx[j];
+                                 k < cidx[j+1]; k++)
+                              acc += acol[ridx[k]] * op (mdata[k]);
+                            rcol[j] = acc;
+                          }
+                      }
+                  });
+}
+
+// R += M * A, with M full and A sparse.  Columns of the result are
+// independent.  If there are fewer of them than threads, the rows are
+// split between threads instead.
+
+template <typename RT, typename FM, typename SM>
+void
+full_sparse_mul (const FM& m, const SM& a, RT& r)
+{
+  typedef typename RT::element_type R;
+
+  octave_idx_type nr = m.rows ();
+  octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *cidx = a.cidx ();
+  const octave_idx_type *ridx = a.ridx ();
+  const auto *adata = a.data ();
+  const auto *mdata = m.data ();
+  R *rdata = r.rwdata ();
+
+  octave_idx_type nz = cidx[a_nc];
+
+  auto kernel = [=] (octave_idx_type i, octave_idx_type kb,
+                     octave_idx_type ke)
+  {
+    R *rcol = rdata + i * nr;
+    for (octave_idx_type j = cidx[i]; j < cidx[i+1]; j++)
+      {
+        const auto *mcol = mdata + ridx[j] * nr;
+        auto tmpval = adata[j];
+        for (octave_idx_type k = kb; k < ke; k++)
+          rcol[k] += tmpval * mcol[k];
+      }
+  };
+
+  if (a_nc < octave::thread_pool::num_threads ()
+      && octave::thread_pool::use_threads (nr, nz + a_nc))
+    octave::thread_pool::parallel_for
+      (nr, nz + a_nc, [=] (std::size_t beg, std::size_t end)
+       {
+         for (octave_idx_type i = 0; i < a_nc; i++)
+           kernel (i, beg, end);
+       });
+  else
+    sparse_mul_for (a_nc, (nz / std::max<octave_idx_type> (1, a_nc) + 1) * nr,
+                    [=] (std::size_t beg, std::size_t end)
+                    {
+                      for (std::size_t i = beg; i < end; i++)
+                        kernel (i, 0, nr);
+                    });
+}
+
+// R += M * OP (A).', with M full and A sparse.  Each column of A
+// updates several columns of the result, so the rows are split between
+// threads.  If there are fewer rows than threads, as for a vector times
+// a transposed matrix, the columns of the result are split instead,
+// using the row form of A, which is built if needed.
+
+template <typename RT, typename FM, typename SM, typename F>
+void
+full_sparse_mul_trans (const FM& m, const SM& a, RT& r, F op)
+{
+  typedef typename RT::element_type R;
+
+  octave_idx_type nr = m.rows ();
+  octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *cidx = a.cidx ();
+  const octave_idx_type *ridx = a.ridx ();
+  const auto *adata = a.data ();
+  const auto *mdata = m.data ();
+  R *rdata = r.rwdata ();
+
+  octave_idx_type nz = cidx[a_nc];
+
+  auto kernel = [=] (octave_idx_type ib, octave_idx_type ie,
+                     octave_idx_type kb, octave_idx_type ke)
+  {
+    for (octave_idx_type i = ib; i < ie; i++)
+      {
+        const auto *mcol = mdata + i * nr;
+        for (octave_idx_type j = cidx[i]; j < cidx[i+1]; j++)
+          {
+            R *rcol = rdata + ridx[j] * nr;
+            auto tmpval = op (adata[j]);
+            for (octave_idx_type k = kb; k < ke; k++)
+              rcol[k] += tmpval * mcol[k];
+          }
+      }
+  };
+
+  octave_idx_type a_nr = a.rows ();
+  const octave_idx_type *rptr, *rcidx;
+  const typename SM::element_type *rvals;
+
+  if (nr < octave::thread_pool::num_threads () && a_nr > 0
+      && octave::thread_pool::use_threads (nz * nr)
+      && a.csr (rptr, rcidx, rvals, true))
+    octave::thread_pool::parallel_for
+      (a_nr, (nz / a_nr + 1) * nr, [=] (std::size_t beg, std::size_t end)
+       {
+         for (std::size_t c = beg; c < end; c++)
+           {
+             R *rcol = rdata + c * nr;
+             for (octave_idx_type p = rptr[c]; p < rptr[c+1]; p++)
+               {
+                 const auto *mcol = mdata + rcidx[p] * nr;
+                 auto tmpval = op (rvals[p]);
+                 for (octave_idx_type k = 0; k < nr; k++)
+                   rcol[k] += tmpval * mcol[k];
+               }
+           }
+       });
+  else if (octave::thread_pool::use_threads (nr, nz + a_nc))
+    octave::thread_pool::parallel_for
+      (nr, nz + a_nc, [=] (std::size_t beg, std::size_t end)
+       {
+         kernel (0, a_nc, beg, end);
+       });
+  else
+    sparse_mul_for (a_nc, (nz / std::max<octave_idx_type> (1, a_nc) + 1) * nr,
+                    [=] (std::size_t beg, std::size_t end)
+                    {
+                      kernel (beg, end, 0, nr);
+                    });
+}
+
+// M * A, with M and A sparse, by Gustavson's algorithm.  A symbolic pass
+// counts the elements of each column of the result and a numeric pass
+// fills them in.  Both split the columns between threads in ranges of
+// about the same number of operations, each with its own dense markers
+// and accumulator.  The number of threads is limited so that these take
+// no more space than the operations.
+
+template <typename RT, typename SM1, typename SM2>
+RT
+sparse_sparse_mul (const SM1& m, const SM2& a)
+{
+  typedef typename RT::element_type R;
+
+  octave_idx_type nr = m.rows ();
+  octave_idx_type a_nc = a.cols ();
+
+  const octave_idx_type *mcidx = m.cidx ();
+  const octave_idx_type *mridx = m.ridx ();
+  const auto *mdata = m.data ();
+  const octave_idx_type *acidx = a.cidx ();
+  const octave_idx_type *aridx = a.ridx ();
+  const auto *adata = a.data ();
+
+  // Operations before each column of the result, counting one for
+  // every column so that empty ones are not free.
+  OCTAVE_LOCAL_BUFFER (octave_idx_type, work, a_nc + 1);
+  work[0] = 0;
+  for (octave_idx_type i = 0; i < a_nc; i++)
+    {
+      octave_idx_type w = 1;
+      for (octave_idx_type j = acidx[i]; j < acidx[i+1]; j++)
+        w += mcidx[aridx[j]+1] - mcidx[aridx[j]];
+      work[i+1] = work[i] + w;
+    }
+
+  octave_idx_type nch = 1;
+  if (nr > 0 && octave::thread_pool::use_threads (work[a_nc]))
+    nch = std::min<octave_idx_type> (octave::thread_pool::num_threads (),
+                                     std::max<octave_idx_type>
+                                       (1, work[a_nc] / nr));
+
+  std::vector<octave_idx_type> mark (nch * nr, 0);
+  octave_idx_type *mark_data = mark.data ();
+
+  std::vector<octave_idx_type> cnt (a_nc + 1, 0);
+  octave_idx_type *cnt_data = cnt.data ();
+
+  sparse_mul_chunks
+    (a_nc, work, nch, [=] (octave_idx_type c, octave_idx_type ib,
+                           octave_idx_type ie)
+     {
+       octave_idx_type *w = mark_data + c * nr;
+       for (octave_idx_type i = ib; i < ie; i++)
+         {
+           octave_idx_type nel = 0;
+           for (octave_idx_type j = acidx[i]; j < acidx[i+1]; j++)
+             {
+               octave_idx_type col = aridx[j];
+               for (octave_idx_type k = mcidx[col]; k < mcidx[col+1]; k++)
+                 if (w[mridx[k]] < i + 1)
+                   {
+                     w[mridx[k]] = i + 1;
+                     nel++;
+                   }
+             }
+           cnt_data[i+1] = nel;
+         }
+     });
+
+  for (octave_idx_type i = 0; i < a_nc; i++)
+    cnt[i+1] += cnt[i];
+
+  octave_idx_type nel = cnt[a_nc];
+
+  if (nel == 0)
+    return RT (nr, a_nc);
+
+  RT retval (nr, a_nc, nel);
+  std::copy (cnt.begin (), cnt.end (), retval.xcidx ());
+
+  const octave_idx_type *rcidx = retval.xcidx ();
+  octave_idx_type *rridx = retval.xridx ();
+  R *rdata = retval.xdata ();
+
+  std::vector<R> acc (nch * nr);
+  R *acc_data = acc.data ();
+
+  // The optimal break-point as estimated from simulations
+  // Note that Mergesort is O(nz log(nz)) while searching all
+  // values is O(nr), where nz here is nonzero per row of
+  // length nr.  The test itself was then derived from the
+  // simulation with random square matrices and the observation
+  // of the number of nonzero elements in the output matrix
+  // it was found that the breakpoints were
+  //   nr: 500  1000  2000  5000 10000
+  //   nz:   6    25    97   585  2202
+  // The below is a simplication of the 'polyfit'-ed parameters
+  // to these breakpoints
+  octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :
+                               (a_nc * a_nc) / 43000);
+
+  sparse_mul_chunks
+    (a_nc, work, nch, [=] (octave_idx_type c, octave_idx_type ib,
+                           octave_idx_type ie)
+     {
+       // The markers left by the symbolic pass are at most A_NC.
+       octave_idx_type *w = mark_data + c * nr;
+       R *xcol = acc_data + c * nr;
+       for (octave_idx_type i = ib; i < ie; i++)
+         {
+           octave_idx_type mk = a_nc + i + 1;
+           octave_idx_type ii = rcidx[i];
+           bool dense = rcidx[i+1] - rcidx[i] > n_per_col;
+           for (octave_idx_type j = acidx[i]; j < acidx[i+1]; j++)
+             {
+               octave_idx_type col = aridx[j];
+               auto tmpval = adata[j];
+               for (octave_idx_type k = mcidx[col]; k < mcidx[col+1]; k++)
+                 {
+                   octave_idx_type row = mridx[k];
+                   if (w[row] < mk)
+                     {
+                       w[row] = mk;
+                       if (! dense)
+                         rridx[ii++] = row;
+                       xcol[row] = tmpval * mdata[k];
+                     }
+                   else
+                     xcol[row] += tmpval * mdata[k];
+                 }
+             }
+           if (dense)
+             {
+               for (octave_idx_type k = 0; k < nr; k++)
+                 if (w[k] == mk)
+                   {
+                     rdata[ii] = xcol[k];
+                     rridx[ii++] = k;
+                   }
+             }
+           else
+             {
+               std::sort (rridx + rcidx[i], rridx + ii);
+               for (octave_idx_type k = rcidx[i]; k < ii; k++)
+                 rdata[k] = xcol[rridx[k]];
+             }
+         }
+     });
+
+  retval.maybe_compress (true);
+  return retval;
+}
+
 #define SPARSE_SPARSE_MUL(RET_TYPE, RET_EL_TYPE, EL_TYPE)               \
   octave_idx_type nr = m.rows ();                                       \
   octave_idx_type nc = m.cols ();                                       \
@@ -1812,119 +2287,7 @@
   else if (nc != a_nr)                                                  \
     octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
   else                                                                  \
-    {                                                                   \
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, w, nr);                     \
-      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
-      for (octave_idx_type i = 0; i < nr; i++)                          \
-        w[i] = 0;                                                       \
-      retval.xcidx (0) = 0;                                             \
-                                                                        \
-      octave_idx_type nel = 0;                                          \
-                                                                        \
-      for (octave_idx_type i = 0; i < a_nc; i++)                        \
-        {                                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
-                {                                                       \
-                  if (w[m.ridx (k)] < i + 1)                            \
-                    {                                                   \
-                      w[m.ridx (k)] = i + 1;                            \
-                      nel++;                                            \
-                    }                                                   \
-                  octave_quit ();                                       \
-                }                                                       \
-            }                                                           \
-          retval.xcidx (i+1) = nel;                                     \
-        }                                                               \
-                                                                        \
-      if (nel == 0)                                                     \
-        return RET_TYPE (nr, a_nc);                                     \
-      else                                                              \
-        {                                                               \
-          for (octave_idx_type i = 0; i < nr; i++)                      \
-            w[i] = 0;                                                   \
-                                                                        \
-          OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                  \
-                                                                        \
-          retval.change_capacity (nel);                                 \
-          /* The optimal break-point as estimated from simulations */   \
-          /* Note that Mergesort is O(nz log(nz)) while searching all */ \
-          /* values is O(nr), where nz here is nonzero per row of */    \
-          /* length nr.  The test itself was then derived from the */   \
-          /* simulation with random square matrices and the observation */ \
-          /* of the number of nonzero elements in the output matrix */  \
-          /* it was found that the breakpoints were */                  \
-          /*   nr: 500  1000  2000  5000 10000 */                       \
-          /*   nz:   6    25    97   585  2202 */                       \
-          /* The below is a simplication of the 'polyfit'-ed parameters */ \
-          /* to these breakpoints */                                    \
-          octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :           \
-                                       (a_nc * a_nc) / 43000);          \
-          octave_idx_type ii = 0;                                       \
-          octave_idx_type *ri = retval.xridx ();                        \
-          octave_sort<octave_idx_type> sort;                            \
-                                                                        \
-          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
-            {                                                           \
-              if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)    \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  for (octave_idx_type k = 0; k < nr; k++)              \
-                    if (w[k] == i + 1)                                  \
-                      {                                                 \
-                        retval.xdata (ii) = Xcol[k];                    \
-                        retval.xridx (ii++) = k;                        \
-                      }                                                 \
-                }                                                       \
-              else                                                      \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              retval.xridx (ii++) = row;                \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
-                  for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
-                    retval.xdata (k) = Xcol[retval.xridx (k)];          \
-                }                                                       \
-            }                                                           \
-          retval.maybe_compress (true);                                 \
-          return retval;                                                \
-        }                                                               \
-    }
+    return sparse_sparse_mul<RET_TYPE> (m, a);
 
 #define SPARSE_FULL_MUL(RET_TYPE, EL_TYPE)                              \
   octave_idx_type nr = m.rows ();                                       \
@@ -1946,17 +2309,8 @@
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < a_nr; j++)                    \
-            {                                                           \
-              octave_quit ();                                           \
+      sparse_full_mul (m, a, retval);                                   \
                                                                         \
-              EL_TYPE tmpval = a.elem (j,i);                            \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                retval.elem (m.ridx (k),i) += tmpval * m.data (k);      \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -1978,18 +2332,9 @@
     {                                                                   \
       RET_TYPE retval (nc, a_nc);                                       \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < nc; j++)                      \
-            {                                                           \
-              octave_quit ();                                           \
+      sparse_full_trans_mul (m, a, retval, [] (const EL_TYPE& x)       \
+                             { return CONJ_OP (x); });                  \
                                                                         \
-              EL_TYPE acc = EL_TYPE ();                                 \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));    \
-              retval.xelem (j,i) = acc;                                 \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2013,18 +2358,8 @@
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = a.data (j);                              \
+      full_sparse_mul (m, a, retval);                                   \
                                                                         \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,i) += tmpval * m.elem (k,col);          \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2048,17 +2383,9 @@
                                                                         \
       RET_TYPE retval (nr, a_nr, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = CONJ_OP (a.data (j));                    \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,col) += tmpval * m.elem (k,i);          \
-            }                                                           \
-        }                                                               \
+      full_sparse_mul_trans (m, a, retval, [] (const EL_TYPE& x)       \
+                             { return CONJ_OP (x); });                  \
+                                                                        \
       return retval;                                                    \
     }
 
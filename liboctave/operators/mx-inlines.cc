@@ -33,13 +33,17 @@
 #include <cmath>
 
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 
 #include "Array-util.h"
 #include "Array.h"
 #include "bsxfun.h"
 #include "oct-cmplx.h"
 #include "oct-inttypes-fwd.h"
+#include "mx-simd.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // Provides some commonly repeated, basic loop templates.
 
@@ -462,6 +466,86 @@ mx_inline_map (std::size_t n, R *r, const X *x)
     r[i] = fcn (x[i]);
 }
 
+// Run an element-wise operation on N elements.  Large arrays are split
+// into ranges that are handled by the threads of the thread pool.
+
+template <typename R>
+inline void
+mx_inline_apply (std::size_t n, R *r, void (*op) (std::size_t, R *))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg); });
+  else
+    op (n, r);
+}
+
+template <typename R, typename X>
+inline void
+mx_inline_apply (std::size_t n, R *r, const X *x,
+                 void (*op) (std::size_t, R *, const X *))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg, x + beg); });
+  else
+    op (n, r, x);
+}
+
+template <typename R, typename X>
+inline void
+mx_inline_apply (std::size_t n, R *r, X x,
+                 void (*op) (std::size_t, R *, X))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg, x); });
+  else
+    op (n, r, x);
+}
+
+template <typename R, typename X, typename Y>
+inline void
+mx_inline_apply (std::size_t n, R *r, const X *x, const Y *y,
+                 void (*op) (std::size_t, R *, const X *, const Y *))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg, x + beg, y + beg); });
+  else
+    op (n, r, x, y);
+}
+
+template <typename R, typename X, typename Y>
+inline void
+mx_inline_apply (std::size_t n, R *r, const X *x, Y y,
+                 void (*op) (std::size_t, R *, const X *, Y))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg, x + beg, y); });
+  else
+    op (n, r, x, y);
+}
+
+template <typename R, typename X, typename Y>
+inline void
+mx_inline_apply (std::size_t n, R *r, X x, const Y *y,
+                 void (*op) (std::size_t, R *, X, const Y *))
+{
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for
+      (n, [=] (std::size_t beg, std::size_t end)
+       { op (end - beg, r + beg, x, y + beg); });
+  else
+    op (n, r, x, y);
+}
+
 // Appliers.  Since these call the operation just once, we pass it as
 // a pointer, to allow the compiler reduce number of instances.
 
@@ -471,7 +555,7 @@ do_mx_unary_op (const Array<X>& x,
                 void (*op) (std::size_t, R *, const X *))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data ());
+  mx_inline_apply (r.numel (), r.rwdata (), x.data (), op);
   return r;
 }
 
@@ -491,12 +575,54 @@ do_mx_unary_map (const Array<X>& x)
   return do_mx_unary_op<R, X> (x, mx_inline_map<R, X, fcn>);
 }
 
+// Like Array<T>::map, but large arrays are split between the threads
+// of the thread pool.  FCN must not depend on or modify shared state.
+
+template <typename R, typename X, typename F>
+inline Array<R>
+do_mx_parallel_map (const Array<X>& x, F fcn)
+{
+  Array<R> r (x.dims ());
+
+  const X *px = x.data ();
+  R *pr = r.rwdata ();
+
+  auto op = [=] (std::size_t beg, std::size_t end)
+  {
+    for (std::size_t i = beg; i < end; i++)
+      pr[i] = fcn (px[i]);
+  };
+
+  std::size_t n = r.numel ();
+
+  if (octave::thread_pool::use_threads (n))
+    octave::thread_pool::parallel_for (n, op);
+  else
+    op (0, n);
+
+  return r;
+}
+
+template <typename R, typename X>
+inline Array<R>
+do_mx_parallel_map (const Array<X>& x, R (&fcn) (X))
+{
+  return do_mx_parallel_map<R, X, R (*) (X)> (x, fcn);
+}
+
+template <typename R, typename X>
+inline Array<R>
+do_mx_parallel_map (const Array<X>& x, R (&fcn) (const X&))
+{
+  return do_mx_parallel_map<R, X, R (*) (const X&)> (x, fcn);
+}
+
 template <typename R>
 inline Array<R>&
 do_mx_inplace_op (Array<R>& r,
                   void (*op) (std::size_t, R *))
 {
-  op (r.numel (), r.rwdata ());
+  mx_inline_apply (r.numel (), r.rwdata (), op);
   return r;
 }
 
@@ -513,7 +639,7 @@ do_mm_binary_op (const Array<X>& x, const Array<Y>& y,
   if (dx == dy)
     {
       Array<R> r (dx);
-      op (r.numel (), r.rwdata (), x.data (), y.data ());
+      mx_inline_apply (r.numel (), r.rwdata (), x.data (), y.data (), op);
       return r;
     }
   else if (is_valid_bsxfun (opname, dx, dy))
@@ -530,7 +656,7 @@ do_ms_binary_op (const Array<X>& x, const Y& y,
                  void (*op) (std::size_t, R *, const X *, Y))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data (), y);
+  mx_inline_apply (r.numel (), r.rwdata (), x.data (), y, op);
   return r;
 }
 
@@ -540,7 +666,7 @@ do_sm_binary_op (const X& x, const Array<Y>& y,
                  void (*op) (std::size_t, R *, X, const Y *))
 {
   Array<R> r (y.dims ());
-  op (r.numel (), r.rwdata (), x, y.data ());
+  mx_inline_apply (r.numel (), r.rwdata (), x, y.data (), op);
   return r;
 }
 
@@ -554,7 +680,7 @@ do_mm_inplace_op (Array<R>& r, const Array<X>& x,
   const dim_vector &dr = r.dims ();
   const dim_vector &dx = x.dims ();
   if (dr == dx)
-    op (r.numel (), r.rwdata (), x.data ());
+    mx_inline_apply (r.numel (), r.rwdata (), x.data (), op);
   else if (is_valid_inplace_bsxfun (opname, dr, dx))
     do_inplace_bsxfun_op (r, x, op, op1);
   else
@@ -568,7 +694,7 @@ inline Array<R>&
 do_ms_inplace_op (Array<R>& r, const X& x,
                   void (*op) (std::size_t, R *, X))
 {
-  op (r.numel (), r.rwdata (), x);
+  mx_inline_apply (r.numel (), r.rwdata (), x, op);
   return r;
 }
 
@@ -754,19 +880,208 @@ op_dble_sum (double& ac, const octave_int<T>& el)
     return ac;                                  \
   }
 
+// TRUE if reductions of elements of type T may be evaluated in any
+// order.  Integer arithmetic saturates, so the order matters there.
+
+template <typename T>
+struct mx_inline_reorderable : std::false_type
+{ };
+
+template <>
+struct mx_inline_reorderable<double> : std::true_type
+{ };
+
+template <>
+struct mx_inline_reorderable<float> : std::true_type
+{ };
+
+template <typename T>
+struct mx_inline_reorderable<std::complex<T>> : mx_inline_reorderable<T>
+{ };
+
+// Floating point sums are evaluated as a binary tree whose leaves are
+// blocks of at most mx_inline_red_block elements, each accumulated with
+// four independent accumulators.  The rounding error then grows with
+// log (n) rather than n.  Products keep their serial order, because
+// reordering them changes where they overflow or underflow.  The tree depends only on the
+// number of elements, so the result is the same however many threads
+// compute its subtrees.
+
+static const octave_idx_type mx_inline_red_block = 128;
+
+// Depth of the tree at which long reductions are split between threads.
+static const int mx_inline_red_split_depth = 6;
+
+// Number of elements in the left subtree of a tree with N elements.
+
+inline octave_idx_type
+mx_inline_red_split (octave_idx_type n)
+{
+  octave_idx_type nblocks = (n + mx_inline_red_block - 1) / mx_inline_red_block;
+
+  return ((nblocks + 1) / 2) * mx_inline_red_block;
+}
+
+template <typename R, typename T, typename OP, typename COMB>
+inline R
+mx_inline_red_tree (const T *v, octave_idx_type n, R zero, OP op, COMB comb)
+{
+  if (n > mx_inline_red_block)
+    {
+      octave_idx_type h = mx_inline_red_split (n);
+      R a = mx_inline_red_tree (v, h, zero, op, comb);
+      R b = mx_inline_red_tree (v + h, n - h, zero, op, comb);
+      return comb (a, b);
+    }
+
+  R ac0 = zero;
+  R ac1 = zero;
+  R ac2 = zero;
+  R ac3 = zero;
+  octave_idx_type i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      op (ac0, v[i]);
+      op (ac1, v[i+1]);
+      op (ac2, v[i+2]);
+      op (ac3, v[i+3]);
+    }
+  for (; i < n; i++)
+    op (ac0, v[i]);
+
+  return comb (comb (ac0, ac1), comb (ac2, ac3));
+}
+
+// Append the offset and length of each node at depth DEPTH of the tree
+// for N elements starting at OFFSET to NODES.
+
+inline void
+mx_inline_red_nodes (octave_idx_type offset, octave_idx_type n, int depth,
+                     std::vector<octave_idx_type>& nodes)
+{
+  if (depth == 0 || n <= mx_inline_red_block)
+    {
+      nodes.push_back (offset);
+      nodes.push_back (n);
+    }
+  else
+    {
+      octave_idx_type h = mx_inline_red_split (n);
+      mx_inline_red_nodes (offset, h, depth - 1, nodes);
+      mx_inline_red_nodes (offset + h, n - h, depth - 1, nodes);
+    }
+}
+
+// Combine the results P of the nodes at depth DEPTH of the tree for N
+// elements, in the same order as mx_inline_red_tree.
+
+template <typename R, typename COMB>
+inline R
+mx_inline_red_join (octave_idx_type n, int depth, const R *& p, COMB comb)
+{
+  if (depth == 0 || n <= mx_inline_red_block)
+    return *p++;
+
+  octave_idx_type h = mx_inline_red_split (n);
+  R a = mx_inline_red_join (h, depth - 1, p, comb);
+  R b = mx_inline_red_join (n - h, depth - 1, p, comb);
+  return comb (a, b);
+}
+
+template <typename R, typename T, typename OP, typename COMB>
+inline R
+mx_inline_red_pairwise (const T *v, octave_idx_type n, R zero,
+                        OP op, COMB comb)
+{
+  if (! octave::thread_pool::use_threads (n))
+    return mx_inline_red_tree (v, n, zero, op, comb);
+
+  std::vector<octave_idx_type> nodes;
+  mx_inline_red_nodes (0, n, mx_inline_red_split_depth, nodes);
+
+  std::size_t nnodes = nodes.size () / 2;
+  std::vector<R> partial (nnodes, zero);
+
+  const octave_idx_type *pn = nodes.data ();
+  R *pp = partial.data ();
+
+  octave::thread_pool::parallel_for
+    (nnodes, n / nnodes, [=] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t k = beg; k < end; k++)
+         pp[k] = mx_inline_red_tree (v + pn[2*k], pn[2*k+1], zero, op, comb);
+     });
+
+  const R *p = partial.data ();
+  return mx_inline_red_join (n, mx_inline_red_split_depth, p, comb);
+}
+
+// Like OP_RED_FCN, but use mx_inline_red_pairwise if the elements are
+// floating point values.  COMB is the operator that combines partial
+// results.
+
+#define OP_RED_PAIRWISE_FCN(F, TSRC, TRES, OP, COMB, ZERO)              \
+  template <typename T>                                                 \
+  inline TRES                                                           \
+  F (const TSRC *v, octave_idx_type n)                                  \
+  {                                                                     \
+    if constexpr (mx_inline_reorderable<TSRC>::value)                   \
+      return mx_inline_red_pairwise                                     \
+        (v, n, TRES (ZERO),                                             \
+         [] (TRES& ac, const TSRC& el) { OP(ac, el); },                 \
+         [] (const TRES& a, const TRES& b) { return a COMB b; });       \
+    else                                                                \
+      {                                                                 \
+        TRES ac = ZERO;                                                 \
+        for (octave_idx_type i = 0; i < n; i++)                         \
+          OP(ac, v[i]);                                                 \
+        return ac;                                                      \
+      }                                                                 \
+  }
+
 #define PROMOTE_DOUBLE(T)                                       \
   typename subst_template_param<std::complex, T, double>::type
 
-OP_RED_FCN (mx_inline_sum, T, T, OP_RED_SUM, 0)
-OP_RED_FCN (mx_inline_dsum, T, PROMOTE_DOUBLE(T), op_dble_sum, 0.0)
+OP_RED_PAIRWISE_FCN (mx_inline_sum, T, T, OP_RED_SUM, +, 0)
+OP_RED_PAIRWISE_FCN (mx_inline_dsum, T, PROMOTE_DOUBLE(T), op_dble_sum, +, 0.0)
 OP_RED_FCN (mx_inline_count, bool, T, OP_RED_SUM, 0)
 OP_RED_FCN (mx_inline_prod, T, T, OP_RED_PROD, 1)
 OP_RED_FCN (mx_inline_dprod, T, PROMOTE_DOUBLE(T), op_dble_prod, 1)
-OP_RED_FCN (mx_inline_sumsq, T, T, OP_RED_SUMSQ, 0)
-OP_RED_FCN (mx_inline_sumsq, std::complex<T>, T, OP_RED_SUMSQC, 0)
+OP_RED_PAIRWISE_FCN (mx_inline_sumsq, T, T, OP_RED_SUMSQ, +, 0)
+OP_RED_PAIRWISE_FCN (mx_inline_sumsq, std::complex<T>, T, OP_RED_SUMSQC, +, 0)
 OP_RED_FCN (mx_inline_any, T, bool, OP_RED_ANYC, false)
 OP_RED_FCN (mx_inline_all, T, bool, OP_RED_ALLC, true)
 
+// Vectorized versions for real arrays, from mx-simd.cc.
+
+template <>
+inline bool
+mx_inline_any<double> (const double *v, octave_idx_type n)
+{
+  return mx_simd_any (v, n);
+}
+
+template <>
+inline bool
+mx_inline_any<float> (const float *v, octave_idx_type n)
+{
+  return mx_simd_any (v, n);
+}
+
+template <>
+inline bool
+mx_inline_all<double> (const double *v, octave_idx_type n)
+{
+  return mx_simd_all (v, n);
+}
+
+template <>
+inline bool
+mx_inline_all<float> (const float *v, octave_idx_type n)
+{
+  return mx_simd_all (v, n);
+}
+
 #define OP_RED_FCN2(F, TSRC, TRES, OP, ZERO)                            \
   template <typename T>                                                 \
   inline void                                                           \
@@ -867,6 +1182,54 @@ OP_RED_FCNN (mx_inline_sumsq, std::complex<T>, T)
 OP_RED_FCNN (mx_inline_any, T, bool)
 OP_RED_FCNN (mx_inline_all, T, bool)
 
+// Cumulative sums of more than one block of floating point values are
+// computed for each block separately, and the result of all
+// previous blocks is then applied to each block.  Both steps may be split
+// between threads.  The blocks have a fixed size, so the result does not
+// depend on the number of threads.
+
+static const octave_idx_type mx_inline_cum_block = 32768;
+
+template <typename R, typename T, typename OP>
+inline void
+mx_inline_cum_blocked (const T *v, R *r, octave_idx_type n, OP op)
+{
+  const octave_idx_type bs = mx_inline_cum_block;
+  octave_idx_type nblocks = (n + bs - 1) / bs;
+
+  octave::thread_pool::parallel_for
+    (nblocks, bs, [=] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t k = beg; k < end; k++)
+         {
+           octave_idx_type i0 = k * bs;
+           octave_idx_type i1 = std::min (i0 + bs, n);
+           R t = r[i0] = v[i0];
+           for (octave_idx_type i = i0 + 1; i < i1; i++)
+             r[i] = t = op (t, v[i]);
+         }
+     });
+
+  // The result of all blocks before block K.
+  std::vector<R> prev (nblocks);
+  for (octave_idx_type k = 1; k < nblocks; k++)
+    prev[k] = (k == 1 ? r[bs-1] : op (prev[k-1], r[k*bs-1]));
+
+  const R *pp = prev.data ();
+
+  octave::thread_pool::parallel_for
+    (nblocks - 1, bs, [=] (std::size_t beg, std::size_t end)
+     {
+       for (std::size_t k = beg + 1; k < end + 1; k++)
+         {
+           octave_idx_type i0 = k * bs;
+           octave_idx_type i1 = std::min (i0 + bs, n);
+           for (octave_idx_type i = i0; i < i1; i++)
+             r[i] = op (pp[k], r[i]);
+         }
+     });
+}
+
 #define OP_CUM_FCN(F, TSRC, TRES, OP)           \
   template <typename T>                         \
   inline void                                   \
@@ -880,7 +1243,33 @@ OP_RED_FCNN (mx_inline_all, T, bool)
       }                                         \
   }
 
-OP_CUM_FCN (mx_inline_cumsum, T, T, +)
+// Like OP_CUM_FCN, but use mx_inline_cum_blocked for long vectors of
+// floating point values.
+
+#define OP_CUM_BLOCKED_FCN(F, TSRC, TRES, OP)                           \
+  template <typename T>                                                 \
+  inline void                                                           \
+  F (const TSRC *v, TRES *r, octave_idx_type n)                         \
+  {                                                                     \
+    if constexpr (mx_inline_reorderable<TSRC>::value)                   \
+      {                                                                 \
+        if (n > mx_inline_cum_block)                                    \
+          {                                                             \
+            mx_inline_cum_blocked                                       \
+              (v, r, n, [] (const TRES& a, const TRES& b)               \
+                        { return a OP b; });                            \
+            return;                                                     \
+          }                                                             \
+      }                                                                 \
+    if (n)                                                              \
+      {                                                                 \
+        TRES t = r[0] = v[0];                                           \
+        for (octave_idx_type i = 1; i < n; i++)                         \
+          r[i] = t = t OP v[i];                                         \
+      }                                                                 \
+  }
+
+OP_CUM_BLOCKED_FCN (mx_inline_cumsum, T, T, +)
 OP_CUM_FCN (mx_inline_cumprod, T, T, *)
 OP_CUM_FCN (mx_inline_cumcount, bool, T, +)
 
@@ -1561,7 +1950,17 @@ do_mx_red_op (const Array<T>& src, int dim,
   dims.chop_trailing_singletons ();
 
   Array<R> ret (dims);
-  mx_red_op (src.data (), ret.rwdata (), l, n, u);
+
+  const T *v = src.data ();
+  R *r = ret.rwdata ();
+
+  // The U slices are independent, so they may be reduced in parallel.
+  if (u > 1 && octave::thread_pool::use_threads (u, l*n))
+    octave::thread_pool::parallel_for
+      (u, l*n, [=] (std::size_t beg, std::size_t end)
+       { mx_red_op (v + beg*l*n, r + beg*l, l, n, end - beg); });
+  else
+    mx_red_op (v, r, l, n, u);
 
   return ret;
 }
@@ -1578,7 +1977,16 @@ do_mx_cum_op (const Array<T>& src, int dim,
 
   // Cumulative operation doesn't reduce the array size.
   Array<R> ret (dims);
-  mx_cum_op (src.data (), ret.rwdata (), l, n, u);
+
+  const T *v = src.data ();
+  R *r = ret.rwdata ();
+
+  if (u > 1 && octave::thread_pool::use_threads (u, l*n))
+    octave::thread_pool::parallel_for
+      (u, l*n, [=] (std::size_t beg, std::size_t end)
+       { mx_cum_op (v + beg*l*n, r + beg*l*n, l, n, end - beg); });
+  else
+    mx_cum_op (v, r, l, n, u);
 
   return ret;
 }
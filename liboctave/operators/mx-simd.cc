@@ -0,0 +1,1151 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "lo-mappers.h"
+#include "mx-simd.h"
+#include "oct-inttypes.h"
+
+#if (defined (__GNUC__) || defined (__clang__))                 \
+  && (defined (__x86_64__) || defined (__i386__))
+#  define MX_SIMD_X86 1
+#  include <immintrin.h>
+#endif
+
+// Instruction sets, in increasing order of preference.
+
+enum simd_level
+{
+  simd_none,
+  simd_sse2,
+  simd_avx2,
+  simd_avx512
+};
+
+static simd_level
+detect_simd_level ()
+{
+#if defined (MX_SIMD_X86)
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512bw"))
+    return simd_avx512;
+  else if (__builtin_cpu_supports ("avx2"))
+    return simd_avx2;
+  else if (__builtin_cpu_supports ("sse2"))
+    return simd_sse2;
+#endif
+
+  return simd_none;
+}
+
+static simd_level
+cpu_simd_level ()
+{
+  static const simd_level level = detect_simd_level ();
+
+  return level;
+}
+
+// Pick the best version of the kernel NAME for this processor.
+
+#if defined (MX_SIMD_X86)
+#  define MX_SIMD_SELECT(NAME)                                  \
+  (cpu_simd_level () >= simd_avx512 ? NAME ## _avx512           \
+   : cpu_simd_level () >= simd_avx2 ? NAME ## _avx2             \
+   : cpu_simd_level () >= simd_sse2 ? NAME ## _sse2             \
+   : NAME ## _generic)
+#else
+#  define MX_SIMD_SELECT(NAME) NAME ## _generic
+#endif
+
+// Saturating arithmetic on the underlying integers, with the same
+// results as the operators of octave_int<T>.
+
+template <typename T>
+static inline T
+sat_add (T x, T y)
+{
+  int z = static_cast<int> (x) + static_cast<int> (y);
+
+  if (z < std::numeric_limits<T>::min ())
+    return std::numeric_limits<T>::min ();
+  else if (z > std::numeric_limits<T>::max ())
+    return std::numeric_limits<T>::max ();
+  else
+    return static_cast<T> (z);
+}
+
+template <typename T>
+static inline T
+sat_sub (T x, T y)
+{
+  int z = static_cast<int> (x) - static_cast<int> (y);
+
+  if (z < std::numeric_limits<T>::min ())
+    return std::numeric_limits<T>::min ();
+  else if (z > std::numeric_limits<T>::max ())
+    return std::numeric_limits<T>::max ();
+  else
+    return static_cast<T> (z);
+}
+
+#define MX_SIMD_SAT_GENERIC(NAME, T, SOP)                               \
+  static void                                                           \
+  NAME ## _vv_generic (std::size_t n, T *r, const T *x, const T *y)     \
+  {                                                                     \
+    for (std::size_t i = 0; i < n; i++)                                 \
+      r[i] = SOP (x[i], y[i]);                                          \
+  }                                                                     \
+  static void                                                           \
+  NAME ## _vs_generic (std::size_t n, T *r, const T *x, T y)            \
+  {                                                                     \
+    for (std::size_t i = 0; i < n; i++)                                 \
+      r[i] = SOP (x[i], y);                                             \
+  }                                                                     \
+  static void                                                           \
+  NAME ## _sv_generic (std::size_t n, T *r, T x, const T *y)            \
+  {                                                                     \
+    for (std::size_t i = 0; i < n; i++)                                 \
+      r[i] = SOP (x, y[i]);                                             \
+  }
+
+MX_SIMD_SAT_GENERIC (add_i8, int8_t, sat_add)
+MX_SIMD_SAT_GENERIC (add_u8, uint8_t, sat_add)
+MX_SIMD_SAT_GENERIC (add_i16, int16_t, sat_add)
+MX_SIMD_SAT_GENERIC (add_u16, uint16_t, sat_add)
+MX_SIMD_SAT_GENERIC (sub_i8, int8_t, sat_sub)
+MX_SIMD_SAT_GENERIC (sub_u8, uint8_t, sat_sub)
+MX_SIMD_SAT_GENERIC (sub_i16, int16_t, sat_sub)
+MX_SIMD_SAT_GENERIC (sub_u16, uint16_t, sat_sub)
+
+// Maximum or minimum of the elements that are not NaN, or INIT if there
+// are none.
+
+#define MX_SIMD_MINMAX_GENERIC(NAME, T, OP, INIT)       \
+  static T                                              \
+  NAME ## _generic (const T *v, octave_idx_type n)      \
+  {                                                     \
+    T tmp = INIT;                                       \
+    for (octave_idx_type i = 0; i < n; i++)             \
+      if (v[i] OP tmp)                                  \
+        tmp = v[i];                                     \
+    return tmp;                                         \
+  }
+
+#define MX_INF(T) std::numeric_limits<T>::infinity ()
+
+MX_SIMD_MINMAX_GENERIC (max_d, double, >, -MX_INF (double))
+MX_SIMD_MINMAX_GENERIC (max_f, float, >, -MX_INF (float))
+MX_SIMD_MINMAX_GENERIC (min_d, double, <, MX_INF (double))
+MX_SIMD_MINMAX_GENERIC (min_f, float, <, MX_INF (float))
+
+// Return FOUND as soon as an element satisfies PRED.
+
+#define MX_SIMD_TEST_GENERIC(NAME, T, PRED, FOUND)      \
+  static bool                                           \
+  NAME ## _generic (const T *v, octave_idx_type n)      \
+  {                                                     \
+    for (octave_idx_type i = 0; i < n; i++)             \
+      if (PRED (v[i]))                                  \
+        return FOUND;                                   \
+    return ! FOUND;                                     \
+  }
+
+#define MX_IS_TRUE(x) ((x) != 0 && ! octave::math::isnan (x))
+#define MX_IS_ZERO(x) ((x) == 0)
+
+MX_SIMD_TEST_GENERIC (any_d, double, MX_IS_TRUE, true)
+MX_SIMD_TEST_GENERIC (any_f, float, MX_IS_TRUE, true)
+MX_SIMD_TEST_GENERIC (all_d, double, MX_IS_ZERO, false)
+MX_SIMD_TEST_GENERIC (all_f, float, MX_IS_ZERO, false)
+
+#if defined (MX_SIMD_X86)
+
+#define MX_SIMD_SAT_KERNELS(NAME, ISA, TARGET, VT, LOAD, STORE,         \
+                            SET1, VOP, T, SOP)                          \
+  __attribute__ ((target (TARGET))) static void                         \
+  NAME ## _vv_ ## ISA (std::size_t n, T *r, const T *x, const T *y)     \
+  {                                                                     \
+    const std::size_t w = sizeof (VT) / sizeof (T);                     \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (reinterpret_cast<VT *> (r + i),                            \
+             VOP (LOAD (reinterpret_cast<const VT *> (x + i)),          \
+                  LOAD (reinterpret_cast<const VT *> (y + i))));        \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x[i], y[i]);                                          \
+  }                                                                     \
+  __attribute__ ((target (TARGET))) static void                         \
+  NAME ## _vs_ ## ISA (std::size_t n, T *r, const T *x, T y)            \
+  {                                                                     \
+    const std::size_t w = sizeof (VT) / sizeof (T);                     \
+    const VT yv = SET1 (y);                                             \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (reinterpret_cast<VT *> (r + i),                            \
+             VOP (LOAD (reinterpret_cast<const VT *> (x + i)), yv));    \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x[i], y);                                             \
+  }                                                                     \
+  __attribute__ ((target (TARGET))) static void                         \
+  NAME ## _sv_ ## ISA (std::size_t n, T *r, T x, const T *y)            \
+  {                                                                     \
+    const std::size_t w = sizeof (VT) / sizeof (T);                     \
+    const VT xv = SET1 (x);                                             \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (reinterpret_cast<VT *> (r + i),                            \
+             VOP (xv, LOAD (reinterpret_cast<const VT *> (y + i))));    \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x, y[i]);                                             \
+  }
+
+#define MX_SIMD_SAT_ISA(ISA, TARGET, VT, LOAD, STORE, PFX)              \
+  MX_SIMD_SAT_KERNELS (add_i8, ISA, TARGET, VT, LOAD, STORE,            \
+                       PFX ## _set1_epi8, PFX ## _adds_epi8,            \
+                       int8_t, sat_add)                                 \
+  MX_SIMD_SAT_KERNELS (add_u8, ISA, TARGET, VT, LOAD, STORE,            \
+                       PFX ## _set1_epi8, PFX ## _adds_epu8,            \
+                       uint8_t, sat_add)                                \
+  MX_SIMD_SAT_KERNELS (add_i16, ISA, TARGET, VT, LOAD, STORE,           \
+                       PFX ## _set1_epi16, PFX ## _adds_epi16,          \
+                       int16_t, sat_add)                                \
+  MX_SIMD_SAT_KERNELS (add_u16, ISA, TARGET, VT, LOAD, STORE,           \
+                       PFX ## _set1_epi16, PFX ## _adds_epu16,          \
+                       uint16_t, sat_add)                               \
+  MX_SIMD_SAT_KERNELS (sub_i8, ISA, TARGET, VT, LOAD, STORE,            \
+                       PFX ## _set1_epi8, PFX ## _subs_epi8,            \
+                       int8_t, sat_sub)                                 \
+  MX_SIMD_SAT_KERNELS (sub_u8, ISA, TARGET, VT, LOAD, STORE,            \
+                       PFX ## _set1_epi8, PFX ## _subs_epu8,            \
+                       uint8_t, sat_sub)                                \
+  MX_SIMD_SAT_KERNELS (sub_i16, ISA, TARGET, VT, LOAD, STORE,           \
+                       PFX ## _set1_epi16, PFX ## _subs_epi16,          \
+                       int16_t, sat_sub)                                \
+  MX_SIMD_SAT_KERNELS (sub_u16, ISA, TARGET, VT, LOAD, STORE,           \
+                       PFX ## _set1_epi16, PFX ## _subs_epu16,          \
+                       uint16_t, sat_sub)
+
+MX_SIMD_SAT_ISA (sse2, "sse2", __m128i,
+                 _mm_loadu_si128, _mm_storeu_si128, _mm)
+MX_SIMD_SAT_ISA (avx2, "avx2", __m256i,
+                 _mm256_loadu_si256, _mm256_storeu_si256, _mm256)
+MX_SIMD_SAT_ISA (avx512, "avx512f,avx512bw", __m512i,
+                 _mm512_loadu_si512, _mm512_storeu_si512, _mm512)
+
+// The max and min instructions return their second operand if either
+// operand is NaN, so NaN elements never replace the running result.
+// Four independent accumulators hide the latency of the instruction.
+
+#define MX_SIMD_MINMAX_KERNEL(NAME, ISA, TARGET, T, VT, LOAD, STORE,    \
+                              SET1, VOP, OP, INIT)                      \
+  __attribute__ ((target (TARGET))) static T                            \
+  NAME ## _ ## ISA (const T *v, octave_idx_type n)                      \
+  {                                                                     \
+    const octave_idx_type w = sizeof (VT) / sizeof (T);                 \
+    VT a0 = SET1 (INIT);                                                \
+    VT a1 = a0;                                                         \
+    VT a2 = a0;                                                         \
+    VT a3 = a0;                                                         \
+    octave_idx_type i = 0;                                              \
+    for (; i + 4*w <= n; i += 4*w)                                      \
+      {                                                                 \
+        a0 = VOP (LOAD (v + i), a0);                                    \
+        a1 = VOP (LOAD (v + i + w), a1);                                \
+        a2 = VOP (LOAD (v + i + 2*w), a2);                              \
+        a3 = VOP (LOAD (v + i + 3*w), a3);                              \
+      }                                                                 \
+    for (; i + w <= n; i += w)                                          \
+      a0 = VOP (LOAD (v + i), a0);                                      \
+    a0 = VOP (VOP (a0, a1), VOP (a2, a3));                              \
+    T buf[sizeof (VT) / sizeof (T)];                                    \
+    STORE (buf, a0);                                                    \
+    T tmp = INIT;                                                       \
+    for (octave_idx_type j = 0; j < w; j++)                             \
+      if (buf[j] OP tmp)                                                \
+        tmp = buf[j];                                                   \
+    for (; i < n; i++)                                                  \
+      if (v[i] OP tmp)                                                  \
+        tmp = v[i];                                                     \
+    return tmp;                                                         \
+  }
+
+#define MX_SIMD_MINMAX_ISA(ISA, TARGET, PFX, VTD, VTF)                  \
+  MX_SIMD_MINMAX_KERNEL (max_d, ISA, TARGET, double, VTD,               \
+                         PFX ## _loadu_pd, PFX ## _storeu_pd,           \
+                         PFX ## _set1_pd, PFX ## _max_pd,               \
+                         >, -MX_INF (double))                           \
+  MX_SIMD_MINMAX_KERNEL (max_f, ISA, TARGET, float, VTF,                \
+                         PFX ## _loadu_ps, PFX ## _storeu_ps,           \
+                         PFX ## _set1_ps, PFX ## _max_ps,               \
+                         >, -MX_INF (float))                            \
+  MX_SIMD_MINMAX_KERNEL (min_d, ISA, TARGET, double, VTD,               \
+                         PFX ## _loadu_pd, PFX ## _storeu_pd,           \
+                         PFX ## _set1_pd, PFX ## _min_pd,               \
+                         <, MX_INF (double))                            \
+  MX_SIMD_MINMAX_KERNEL (min_f, ISA, TARGET, float, VTF,                \
+                         PFX ## _loadu_ps, PFX ## _storeu_ps,           \
+                         PFX ## _set1_ps, PFX ## _min_ps,               \
+                         <, MX_INF (float))
+
+#define MX_SIMD_TEST_KERNEL(NAME, ISA, TARGET, T, VT, LOAD,             \
+                            VPRED, PRED, FOUND)                         \
+  __attribute__ ((target (TARGET))) static bool                         \
+  NAME ## _ ## ISA (const T *v, octave_idx_type n)                      \
+  {                                                                     \
+    const octave_idx_type w = sizeof (VT) / sizeof (T);                 \
+    octave_idx_type i = 0;                                              \
+    for (; i + w <= n; i += w)                                          \
+      {                                                                 \
+        VT x = LOAD (v + i);                                            \
+        if (VPRED (x))                                                  \
+          return FOUND;                                                 \
+      }                                                                 \
+    for (; i < n; i++)                                                  \
+      if (PRED (v[i]))                                                  \
+        return FOUND;                                                   \
+    return ! FOUND;                                                     \
+  }
+
+// Nonzero and ordered, or equal to zero, for each element of X.
+
+#define SSE2_IS_TRUE_PD(x)                                              \
+  _mm_movemask_pd (_mm_and_pd (_mm_cmpneq_pd (x, _mm_setzero_pd ()),    \
+                               _mm_cmpord_pd (x, x)))
+#define SSE2_IS_TRUE_PS(x)                                              \
+  _mm_movemask_ps (_mm_and_ps (_mm_cmpneq_ps (x, _mm_setzero_ps ()),    \
+                               _mm_cmpord_ps (x, x)))
+#define SSE2_IS_ZERO_PD(x)                                      \
+  _mm_movemask_pd (_mm_cmpeq_pd (x, _mm_setzero_pd ()))
+#define SSE2_IS_ZERO_PS(x)                                      \
+  _mm_movemask_ps (_mm_cmpeq_ps (x, _mm_setzero_ps ()))
+
+#define AVX2_IS_TRUE_PD(x)                                              \
+  _mm256_movemask_pd (_mm256_cmp_pd (x, _mm256_setzero_pd (), _CMP_NEQ_OQ))
+#define AVX2_IS_TRUE_PS(x)                                              \
+  _mm256_movemask_ps (_mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_NEQ_OQ))
+#define AVX2_IS_ZERO_PD(x)                                              \
+  _mm256_movemask_pd (_mm256_cmp_pd (x, _mm256_setzero_pd (), _CMP_EQ_OQ))
+#define AVX2_IS_ZERO_PS(x)                                              \
+  _mm256_movemask_ps (_mm256_cmp_ps (x, _mm256_setzero_ps (), _CMP_EQ_OQ))
+
+#define AVX512_IS_TRUE_PD(x)                                    \
+  _mm512_cmp_pd_mask (x, _mm512_setzero_pd (), _CMP_NEQ_OQ)
+#define AVX512_IS_TRUE_PS(x)                                    \
+  _mm512_cmp_ps_mask (x, _mm512_setzero_ps (), _CMP_NEQ_OQ)
+#define AVX512_IS_ZERO_PD(x)                                    \
+  _mm512_cmp_pd_mask (x, _mm512_setzero_pd (), _CMP_EQ_OQ)
+#define AVX512_IS_ZERO_PS(x)                                    \
+  _mm512_cmp_ps_mask (x, _mm512_setzero_ps (), _CMP_EQ_OQ)
+
+#define MX_SIMD_TEST_ISA(ISA, TARGET, PFX, VPFX, VTD, VTF)              \
+  MX_SIMD_TEST_KERNEL (any_d, ISA, TARGET, double, VTD,                 \
+                       PFX ## _loadu_pd, VPFX ## _IS_TRUE_PD,           \
+                       MX_IS_TRUE, true)                                \
+  MX_SIMD_TEST_KERNEL (any_f, ISA, TARGET, float, VTF,                  \
+                       PFX ## _loadu_ps, VPFX ## _IS_TRUE_PS,           \
+                       MX_IS_TRUE, true)                                \
+  MX_SIMD_TEST_KERNEL (all_d, ISA, TARGET, double, VTD,                 \
+                       PFX ## _loadu_pd, VPFX ## _IS_ZERO_PD,           \
+                       MX_IS_ZERO, false)                               \
+  MX_SIMD_TEST_KERNEL (all_f, ISA, TARGET, float, VTF,                  \
+                       PFX ## _loadu_ps, VPFX ## _IS_ZERO_PS,           \
+                       MX_IS_ZERO, false)
+
+MX_SIMD_MINMAX_ISA (sse2, "sse2", _mm, __m128d, __m128)
+MX_SIMD_MINMAX_ISA (avx2, "avx2", _mm256, __m256d, __m256)
+MX_SIMD_MINMAX_ISA (avx512, "avx512f,avx512bw", _mm512, __m512d, __m512)
+
+MX_SIMD_TEST_ISA (sse2, "sse2", _mm, SSE2, __m128d, __m128)
+MX_SIMD_TEST_ISA (avx2, "avx2", _mm256, AVX2, __m256d, __m256)
+MX_SIMD_TEST_ISA (avx512, "avx512f,avx512bw", _mm512, AVX512, __m512d, __m512)
+
+#endif
+
+#define MX_SIMD_SAT_OP_DEFS(F, NAME, OT, T)                             \
+  void                                                                  \
+  F (std::size_t n, OT *r, const OT *x, const OT *y)                    \
+  {                                                                     \
+    static const auto fcn = MX_SIMD_SELECT (NAME ## _vv);               \
+    fcn (n, reinterpret_cast<T *> (r), reinterpret_cast<const T *> (x), \
+         reinterpret_cast<const T *> (y));                              \
+  }                                                                     \
+  void                                                                  \
+  F (std::size_t n, OT *r, const OT *x, OT y)                           \
+  {                                                                     \
+    static const auto fcn = MX_SIMD_SELECT (NAME ## _vs);               \
+    fcn (n, reinterpret_cast<T *> (r), reinterpret_cast<const T *> (x), \
+         y.value ());                                                   \
+  }                                                                     \
+  void                                                                  \
+  F (std::size_t n, OT *r, OT x, const OT *y)                           \
+  {                                                                     \
+    static const auto fcn = MX_SIMD_SELECT (NAME ## _sv);               \
+    fcn (n, reinterpret_cast<T *> (r), x.value (),                      \
+         reinterpret_cast<const T *> (y));                              \
+  }                                                                     \
+  void                                                                  \
+  F ## 2 (std::size_t n, OT *r, const OT *x)                            \
+  {                                                                     \
+    F (n, r, r, x);                                                     \
+  }                                                                     \
+  void                                                                  \
+  F ## 2 (std::size_t n, OT *r, OT x)                                   \
+  {                                                                     \
+    F (n, r, r, x);                                                     \
+  }
+
+MX_SIMD_SAT_OP_DEFS (mx_inline_add, add_i8, octave_int8, int8_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_add, add_u8, octave_uint8, uint8_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_add, add_i16, octave_int16, int16_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_add, add_u16, octave_uint16, uint16_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_sub, sub_i8, octave_int8, int8_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_sub, sub_u8, octave_uint8, uint8_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_sub, sub_i16, octave_int16, int16_t)
+MX_SIMD_SAT_OP_DEFS (mx_inline_sub, sub_u16, octave_uint16, uint16_t)
+
+// An infinite result from the kernel is either the true result or means
+// that all elements are NaN.  Like the generic code in mx-inlines.cc,
+// return the first element in the latter case.
+
+#define MX_SIMD_MINMAX_DEFS(F, NAME, T, INIT)                   \
+  void                                                          \
+  F (const T *v, T *r, octave_idx_type n)                       \
+  {                                                             \
+    if (! n)                                                    \
+      return;                                                   \
+    static const auto fcn = MX_SIMD_SELECT (NAME);              \
+    T tmp = fcn (v, n);                                         \
+    if (tmp == INIT)                                            \
+      {                                                         \
+        octave_idx_type i = 0;                                  \
+        while (i < n && octave::math::isnan (v[i]))             \
+          i++;                                                  \
+        if (i == n)                                             \
+          tmp = v[0];                                           \
+      }                                                         \
+    *r = tmp;                                                   \
+  }
+
+MX_SIMD_MINMAX_DEFS (mx_inline_max, max_d, double, -MX_INF (double))
+MX_SIMD_MINMAX_DEFS (mx_inline_max, max_f, float, -MX_INF (float))
+MX_SIMD_MINMAX_DEFS (mx_inline_min, min_d, double, MX_INF (double))
+MX_SIMD_MINMAX_DEFS (mx_inline_min, min_f, float, MX_INF (float))
+
+#define MX_SIMD_TEST_DEFS(F, NAME, T)                   \
+  bool                                                  \
+  F (const T *v, octave_idx_type n)                     \
+  {                                                     \
+    static const auto fcn = MX_SIMD_SELECT (NAME);      \
+    return fcn (v, n);                                  \
+  }
+
+MX_SIMD_TEST_DEFS (mx_simd_any, any_d, double)
+MX_SIMD_TEST_DEFS (mx_simd_any, any_f, float)
+MX_SIMD_TEST_DEFS (mx_simd_all, all_d, double)
+MX_SIMD_TEST_DEFS (mx_simd_all, all_f, float)
+
+// Transpose of 4- and 8-byte elements, DEST(j,i) = SRC(i,j).  The
+// matrices are processed in square tiles that fit in the L1 cache, and
+// the vector kernels transpose each tile in blocks of W by W elements
+// held in W registers.
+
+static const octave_idx_type transpose_tile = 32;
+
+template <typename U>
+static void
+transpose_generic (const U *src, U *dest,
+                   octave_idx_type nr, octave_idx_type nc,
+                   octave_idx_type lds, octave_idx_type ldd)
+{
+  const octave_idx_type ts = transpose_tile;
+  for (octave_idx_type jb = 0; jb < nc; jb += ts)
+    for (octave_idx_type ib = 0; ib < nr; ib += ts)
+      {
+        octave_idx_type je = std::min (jb + ts, nc);
+        octave_idx_type ie = std::min (ib + ts, nr);
+        for (octave_idx_type j = jb; j < je; j++)
+          for (octave_idx_type i = ib; i < ie; i++)
+            dest[j + i*ldd] = src[i + j*lds];
+      }
+}
+
+static void
+transpose_4_generic (const uint32_t *src, uint32_t *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd)
+{
+  transpose_generic (src, dest, nr, nc, lds, ldd);
+}
+
+static void
+transpose_8_generic (const uint64_t *src, uint64_t *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd)
+{
+  transpose_generic (src, dest, nr, nc, lds, ldd);
+}
+
+#if defined (MX_SIMD_X86)
+
+#define MX_SIMD_TRANSPOSE_KERNEL(NAME, ISA, TARGET, U, W, BLOCK)        \
+  __attribute__ ((target (TARGET))) static void                         \
+  NAME ## _ ## ISA (const U *src, U *dest,                              \
+                    octave_idx_type nr, octave_idx_type nc,             \
+                    octave_idx_type lds, octave_idx_type ldd)           \
+  {                                                                     \
+    const octave_idx_type ts = transpose_tile;                          \
+    for (octave_idx_type jb = 0; jb < nc; jb += ts)                     \
+      for (octave_idx_type ib = 0; ib < nr; ib += ts)                   \
+        {                                                               \
+          octave_idx_type je = std::min (jb + ts, nc);                  \
+          octave_idx_type ie = std::min (ib + ts, nr);                  \
+          octave_idx_type j = jb;                                       \
+          for (; j + W <= je; j += W)                                   \
+            {                                                           \
+              octave_idx_type i = ib;                                   \
+              for (; i + W <= ie; i += W)                               \
+                BLOCK (src + i + j*lds, lds, dest + j + i*ldd, ldd);    \
+              for (; i < ie; i++)                                       \
+                for (octave_idx_type k = j; k < j + W; k++)             \
+                  dest[k + i*ldd] = src[i + k*lds];                     \
+            }                                                           \
+          for (; j < je; j++)                                           \
+            for (octave_idx_type i = ib; i < ie; i++)                   \
+              dest[j + i*ldd] = src[i + j*lds];                         \
+        }                                                               \
+  }
+
+__attribute__ ((target ("sse2"))) static inline void
+transpose_block_4_sse2 (const uint32_t *s, octave_idx_type lds,
+                        uint32_t *d, octave_idx_type ldd)
+{
+  __m128 r0 = _mm_loadu_ps (reinterpret_cast<const float *> (s));
+  __m128 r1 = _mm_loadu_ps (reinterpret_cast<const float *> (s + lds));
+  __m128 r2 = _mm_loadu_ps (reinterpret_cast<const float *> (s + 2*lds));
+  __m128 r3 = _mm_loadu_ps (reinterpret_cast<const float *> (s + 3*lds));
+
+  _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+
+  _mm_storeu_ps (reinterpret_cast<float *> (d), r0);
+  _mm_storeu_ps (reinterpret_cast<float *> (d + ldd), r1);
+  _mm_storeu_ps (reinterpret_cast<float *> (d + 2*ldd), r2);
+  _mm_storeu_ps (reinterpret_cast<float *> (d + 3*ldd), r3);
+}
+
+__attribute__ ((target ("sse2"))) static inline void
+transpose_block_8_sse2 (const uint64_t *s, octave_idx_type lds,
+                        uint64_t *d, octave_idx_type ldd)
+{
+  __m128d r0 = _mm_loadu_pd (reinterpret_cast<const double *> (s));
+  __m128d r1 = _mm_loadu_pd (reinterpret_cast<const double *> (s + lds));
+
+  _mm_storeu_pd (reinterpret_cast<double *> (d), _mm_unpacklo_pd (r0, r1));
+  _mm_storeu_pd (reinterpret_cast<double *> (d + ldd),
+                 _mm_unpackhi_pd (r0, r1));
+}
+
+__attribute__ ((target ("avx2"))) static inline void
+transpose_block_4_avx2 (const uint32_t *s, octave_idx_type lds,
+                        uint32_t *d, octave_idx_type ldd)
+{
+  __m256 r[8];
+  for (int k = 0; k < 8; k++)
+    r[k] = _mm256_loadu_ps (reinterpret_cast<const float *> (s + k*lds));
+
+  __m256 t[8];
+  for (int k = 0; k < 8; k += 4)
+    {
+      __m256 u0 = _mm256_unpacklo_ps (r[k], r[k+1]);
+      __m256 u1 = _mm256_unpackhi_ps (r[k], r[k+1]);
+      __m256 u2 = _mm256_unpacklo_ps (r[k+2], r[k+3]);
+      __m256 u3 = _mm256_unpackhi_ps (r[k+2], r[k+3]);
+      t[k] = _mm256_shuffle_ps (u0, u2, _MM_SHUFFLE (1, 0, 1, 0));
+      t[k+1] = _mm256_shuffle_ps (u0, u2, _MM_SHUFFLE (3, 2, 3, 2));
+      t[k+2] = _mm256_shuffle_ps (u1, u3, _MM_SHUFFLE (1, 0, 1, 0));
+      t[k+3] = _mm256_shuffle_ps (u1, u3, _MM_SHUFFLE (3, 2, 3, 2));
+    }
+
+  for (int k = 0; k < 4; k++)
+    {
+      _mm256_storeu_ps (reinterpret_cast<float *> (d + k*ldd),
+                        _mm256_permute2f128_ps (t[k], t[k+4], 0x20));
+      _mm256_storeu_ps (reinterpret_cast<float *> (d + (k+4)*ldd),
+                        _mm256_permute2f128_ps (t[k], t[k+4], 0x31));
+    }
+}
+
+__attribute__ ((target ("avx2"))) static inline void
+transpose_block_8_avx2 (const uint64_t *s, octave_idx_type lds,
+                        uint64_t *d, octave_idx_type ldd)
+{
+  __m256d r0 = _mm256_loadu_pd (reinterpret_cast<const double *> (s));
+  __m256d r1 = _mm256_loadu_pd (reinterpret_cast<const double *> (s + lds));
+  __m256d r2 = _mm256_loadu_pd (reinterpret_cast<const double *> (s + 2*lds));
+  __m256d r3 = _mm256_loadu_pd (reinterpret_cast<const double *> (s + 3*lds));
+
+  __m256d t0 = _mm256_unpacklo_pd (r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd (r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd (r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd (r2, r3);
+
+  double *dd = reinterpret_cast<double *> (d);
+  _mm256_storeu_pd (dd, _mm256_permute2f128_pd (t0, t2, 0x20));
+  _mm256_storeu_pd (dd + ldd, _mm256_permute2f128_pd (t1, t3, 0x20));
+  _mm256_storeu_pd (dd + 2*ldd, _mm256_permute2f128_pd (t0, t2, 0x31));
+  _mm256_storeu_pd (dd + 3*ldd, _mm256_permute2f128_pd (t1, t3, 0x31));
+}
+
+MX_SIMD_TRANSPOSE_KERNEL (transpose_4, sse2, "sse2", uint32_t,
+                          4, transpose_block_4_sse2)
+MX_SIMD_TRANSPOSE_KERNEL (transpose_8, sse2, "sse2", uint64_t,
+                          2, transpose_block_8_sse2)
+MX_SIMD_TRANSPOSE_KERNEL (transpose_4, avx2, "avx2", uint32_t,
+                          8, transpose_block_4_avx2)
+MX_SIMD_TRANSPOSE_KERNEL (transpose_8, avx2, "avx2", uint64_t,
+                          4, transpose_block_8_avx2)
+
+// The AVX2 kernels are limited by memory bandwidth already.
+
+#define transpose_4_avx512 transpose_4_avx2
+#define transpose_8_avx512 transpose_8_avx2
+
+#endif
+
+void
+mx_simd_transpose_4 (const void *src, void *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd)
+{
+  static const auto fcn = MX_SIMD_SELECT (transpose_4);
+  fcn (static_cast<const uint32_t *> (src), static_cast<uint32_t *> (dest),
+       nr, nc, lds, ldd);
+}
+
+void
+mx_simd_transpose_8 (const void *src, void *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd)
+{
+  static const auto fcn = MX_SIMD_SELECT (transpose_8);
+  fcn (static_cast<const uint64_t *> (src), static_cast<uint64_t *> (dest),
+       nr, nc, lds, ldd);
+}
+
+// Gather of 4- and 8-byte elements through an index vector.  The vector
+// kernels use the gather instructions of AVX2 and AVX-512 with 64-bit
+// indices; other processors and 32-bit indices use the generic loop.
+// The loads are independent, so the processor overlaps their cache
+// misses without help from software prefetching.
+
+template <typename U>
+static void
+gather_generic (const U *src, const octave_idx_type *idx, octave_idx_type n,
+                U *dest)
+{
+  for (octave_idx_type i = 0; i < n; i++)
+    dest[i] = src[idx[i]];
+}
+
+static void
+gather_4_generic (const uint32_t *src, const octave_idx_type *idx,
+                  octave_idx_type n, uint32_t *dest)
+{
+  gather_generic (src, idx, n, dest);
+}
+
+static void
+gather_8_generic (const uint64_t *src, const octave_idx_type *idx,
+                  octave_idx_type n, uint64_t *dest)
+{
+  gather_generic (src, idx, n, dest);
+}
+
+#if defined (MX_SIMD_X86) && defined (OCTAVE_ENABLE_64)
+
+// Gather W elements at a time with BLOCK (SRC, IDX + I, DEST + I).
+
+#define MX_SIMD_GATHER_KERNEL(NAME, ISA, TARGET, U, W, BLOCK)           \
+  __attribute__ ((target (TARGET))) static void                         \
+  NAME ## _ ## ISA (const U *src, const octave_idx_type *idx,           \
+                    octave_idx_type n, U *dest)                         \
+  {                                                                     \
+    octave_idx_type i = 0;                                              \
+    for (; i + W <= n; i += W)                                          \
+      BLOCK (src, idx + i, dest + i);                                   \
+    for (; i < n; i++)                                                  \
+      dest[i] = src[idx[i]];                                            \
+  }
+
+__attribute__ ((target ("avx2"))) static inline void
+gather_block_4_avx2 (const uint32_t *s, const octave_idx_type *idx,
+                     uint32_t *d)
+{
+  const int *base = reinterpret_cast<const int *> (s);
+  __m256i i0 = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (idx));
+  __m256i i1
+    = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (idx + 4));
+  __m128i v0 = _mm256_i64gather_epi32 (base, i0, 4);
+  __m128i v1 = _mm256_i64gather_epi32 (base, i1, 4);
+  _mm256_storeu_si256 (reinterpret_cast<__m256i *> (d),
+                       _mm256_set_m128i (v1, v0));
+}
+
+__attribute__ ((target ("avx2"))) static inline void
+gather_block_8_avx2 (const uint64_t *s, const octave_idx_type *idx,
+                     uint64_t *d)
+{
+  const long long *base = reinterpret_cast<const long long *> (s);
+  __m256i i0 = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (idx));
+  _mm256_storeu_si256 (reinterpret_cast<__m256i *> (d),
+                       _mm256_i64gather_epi64 (base, i0, 8));
+}
+
+__attribute__ ((target ("avx512f"))) static inline void
+gather_block_4_avx512 (const uint32_t *s, const octave_idx_type *idx,
+                       uint32_t *d)
+{
+  __m512i i0 = _mm512_loadu_si512 (idx);
+  __m512i i1 = _mm512_loadu_si512 (idx + 8);
+  __m256i v0 = _mm512_i64gather_epi32 (i0, s, 4);
+  __m256i v1 = _mm512_i64gather_epi32 (i1, s, 4);
+  _mm512_storeu_si512 (d, _mm512_inserti64x4 (_mm512_castsi256_si512 (v0),
+                                              v1, 1));
+}
+
+__attribute__ ((target ("avx512f"))) static inline void
+gather_block_8_avx512 (const uint64_t *s, const octave_idx_type *idx,
+                       uint64_t *d)
+{
+  __m512i i0 = _mm512_loadu_si512 (idx);
+  _mm512_storeu_si512 (d, _mm512_i64gather_epi64 (i0, s, 8));
+}
+
+MX_SIMD_GATHER_KERNEL (gather_4, avx2, "avx2", uint32_t,
+                       8, gather_block_4_avx2)
+MX_SIMD_GATHER_KERNEL (gather_8, avx2, "avx2", uint64_t,
+                       4, gather_block_8_avx2)
+MX_SIMD_GATHER_KERNEL (gather_4, avx512, "avx512f", uint32_t,
+                       16, gather_block_4_avx512)
+MX_SIMD_GATHER_KERNEL (gather_8, avx512, "avx512f", uint64_t,
+                       8, gather_block_8_avx512)
+
+#define gather_4_sse2 gather_4_generic
+#define gather_8_sse2 gather_8_generic
+
+#  define MX_SIMD_SELECT_GATHER(NAME) MX_SIMD_SELECT (NAME)
+#else
+#  define MX_SIMD_SELECT_GATHER(NAME) NAME ## _generic
+#endif
+
+void
+mx_simd_gather_4 (const void *src, const octave_idx_type *idx,
+                  octave_idx_type n, void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT_GATHER (gather_4);
+  fcn (static_cast<const uint32_t *> (src), idx, n,
+       static_cast<uint32_t *> (dest));
+}
+
+void
+mx_simd_gather_8 (const void *src, const octave_idx_type *idx,
+                  octave_idx_type n, void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT_GATHER (gather_8);
+  fcn (static_cast<const uint64_t *> (src), idx, n,
+       static_cast<uint64_t *> (dest));
+}
+
+// Compression of 4- and 8-byte elements by a logical mask, and the
+// reverse expansion.  The vector kernels turn W mask bytes into a bit
+// mask and move the selected elements to the front of a register, or
+// from the front to their positions, loading and storing only those.
+// AVX-512 has instructions for this; AVX2 permutes the elements with a
+// table indexed by the bit mask.
+
+template <typename U>
+static octave_idx_type
+compress_generic (const U *src, const bool *mask, octave_idx_type n, U *dest)
+{
+  octave_idx_type k = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    if (mask[i])
+      dest[k++] = src[i];
+
+  return k;
+}
+
+static octave_idx_type
+compress_4_generic (const uint32_t *src, const bool *mask, octave_idx_type n,
+                    uint32_t *dest)
+{
+  return compress_generic (src, mask, n, dest);
+}
+
+static octave_idx_type
+compress_8_generic (const uint64_t *src, const bool *mask, octave_idx_type n,
+                    uint64_t *dest)
+{
+  return compress_generic (src, mask, n, dest);
+}
+
+template <typename U>
+static octave_idx_type
+expand_generic (const U *src, const bool *mask, octave_idx_type n, U *dest)
+{
+  octave_idx_type k = 0;
+
+  for (octave_idx_type i = 0; i < n; i++)
+    if (mask[i])
+      dest[i] = src[k++];
+
+  return k;
+}
+
+static octave_idx_type
+expand_4_generic (const uint32_t *src, const bool *mask, octave_idx_type n,
+                  uint32_t *dest)
+{
+  return expand_generic (src, mask, n, dest);
+}
+
+static octave_idx_type
+expand_8_generic (const uint64_t *src, const bool *mask, octave_idx_type n,
+                  uint64_t *dest)
+{
+  return expand_generic (src, mask, n, dest);
+}
+
+#if defined (MX_SIMD_X86)
+
+// For each mask of 8 bits, the positions of the set bits packed in
+// bytes, the number of set bits below each position, and the mask with
+// each bit doubled, which selects the pairs of 32-bit lanes that hold
+// the 64-bit elements of a 4-bit mask.
+
+struct compress_tables
+{
+  uint64_t perm[256];
+  uint64_t rank[256];
+  uint8_t pairs[16];
+
+  constexpr compress_tables ()
+    : perm (), rank (), pairs ()
+  {
+    for (int m = 0; m < 256; m++)
+      {
+        int k = 0;
+        for (int b = 0; b < 8; b++)
+          {
+            rank[m] |= static_cast<uint64_t> (k) << (8 * b);
+            if (m & (1 << b))
+              perm[m] |= static_cast<uint64_t> (b) << (8 * k++);
+          }
+      }
+
+    for (int m = 0; m < 16; m++)
+      for (int b = 0; b < 4; b++)
+        if (m & (1 << b))
+          pairs[m] |= 3 << (2 * b);
+  }
+};
+
+static constexpr compress_tables compress_tab;
+
+// Bit masks of the 4, 8, or 16 bytes at MASK that are nonzero.  Only
+// those bytes are read, since the mask may end right after them.
+
+__attribute__ ((target ("sse2"))) static inline unsigned int
+compress_bits_4 (const bool *mask)
+{
+  int w;
+  std::memcpy (&w, mask, 4);
+  __m128i m = _mm_cvtsi32_si128 (w);
+  return ~_mm_movemask_epi8 (_mm_cmpeq_epi8 (m, _mm_setzero_si128 ())) & 0xf;
+}
+
+__attribute__ ((target ("sse2"))) static inline unsigned int
+compress_bits_8 (const bool *mask)
+{
+  __m128i m = _mm_loadl_epi64 (reinterpret_cast<const __m128i *> (mask));
+  return ~_mm_movemask_epi8 (_mm_cmpeq_epi8 (m, _mm_setzero_si128 ())) & 0xff;
+}
+
+__attribute__ ((target ("sse2"))) static inline unsigned int
+compress_bits_16 (const bool *mask)
+{
+  __m128i m = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (mask));
+  return ~_mm_movemask_epi8 (_mm_cmpeq_epi8 (m, _mm_setzero_si128 ()))
+         & 0xffff;
+}
+
+// Compress W elements at a time with K = BLOCK (SRC + I, MASK + I, DEST, K).
+
+#define MX_SIMD_COMPRESS_KERNEL(NAME, ISA, TARGET, U, W, BLOCK)         \
+  __attribute__ ((target (TARGET))) static octave_idx_type              \
+  NAME ## _ ## ISA (const U *src, const bool *mask, octave_idx_type n,  \
+                    U *dest)                                            \
+  {                                                                     \
+    octave_idx_type k = 0;                                              \
+    octave_idx_type i = 0;                                              \
+    for (; i + W <= n; i += W)                                          \
+      k = BLOCK (src + i, mask + i, dest, k);                           \
+    for (; i < n; i++)                                                  \
+      if (mask[i])                                                      \
+        dest[k++] = src[i];                                             \
+    return k;                                                           \
+  }
+
+__attribute__ ((target ("avx2"))) static inline octave_idx_type
+compress_block_4_avx2 (const uint32_t *s, const bool *mask, uint32_t *d,
+                       octave_idx_type k)
+{
+  unsigned int m = compress_bits_8 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (s));
+  __m256i p = _mm256_cvtepu8_epi32 (_mm_cvtsi64_si128 (compress_tab.perm[m]));
+  __m256i keep = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (c),
+                                     _mm256_setr_epi32 (0, 1, 2, 3,
+                                                        4, 5, 6, 7));
+  _mm256_maskstore_epi32 (reinterpret_cast<int *> (d + k), keep,
+                          _mm256_permutevar8x32_epi32 (v, p));
+  return k + c;
+}
+
+__attribute__ ((target ("avx2"))) static inline octave_idx_type
+compress_block_8_avx2 (const uint64_t *s, const bool *mask, uint64_t *d,
+                       octave_idx_type k)
+{
+  unsigned int m = compress_bits_4 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m256i v = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (s));
+  uint64_t pm = compress_tab.perm[compress_tab.pairs[m]];
+  __m256i p = _mm256_cvtepu8_epi32 (_mm_cvtsi64_si128 (pm));
+  __m256i keep = _mm256_cmpgt_epi64 (_mm256_set1_epi64x (c),
+                                     _mm256_setr_epi64x (0, 1, 2, 3));
+  _mm256_maskstore_epi64 (reinterpret_cast<long long *> (d + k), keep,
+                          _mm256_permutevar8x32_epi32 (v, p));
+  return k + c;
+}
+
+__attribute__ ((target ("avx512f"))) static inline octave_idx_type
+compress_block_4_avx512 (const uint32_t *s, const bool *mask, uint32_t *d,
+                         octave_idx_type k)
+{
+  __mmask16 m = compress_bits_16 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m512i v = _mm512_maskz_compress_epi32 (m, _mm512_loadu_si512 (s));
+  _mm512_mask_storeu_epi32 (d + k, (1u << c) - 1, v);
+  return k + c;
+}
+
+__attribute__ ((target ("avx512f"))) static inline octave_idx_type
+compress_block_8_avx512 (const uint64_t *s, const bool *mask, uint64_t *d,
+                         octave_idx_type k)
+{
+  __mmask8 m = compress_bits_8 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m512i v = _mm512_maskz_compress_epi64 (m, _mm512_loadu_si512 (s));
+  _mm512_mask_storeu_epi64 (d + k, (1u << c) - 1, v);
+  return k + c;
+}
+
+MX_SIMD_COMPRESS_KERNEL (compress_4, avx2, "avx2", uint32_t,
+                         8, compress_block_4_avx2)
+MX_SIMD_COMPRESS_KERNEL (compress_8, avx2, "avx2", uint64_t,
+                         4, compress_block_8_avx2)
+MX_SIMD_COMPRESS_KERNEL (compress_4, avx512, "avx512f", uint32_t,
+                         16, compress_block_4_avx512)
+MX_SIMD_COMPRESS_KERNEL (compress_8, avx512, "avx512f", uint64_t,
+                         8, compress_block_8_avx512)
+
+// Expand W elements at a time with K = BLOCK (SRC, MASK + I, DEST + I, K).
+
+#define MX_SIMD_EXPAND_KERNEL(NAME, ISA, TARGET, U, W, BLOCK)           \
+  __attribute__ ((target (TARGET))) static octave_idx_type              \
+  NAME ## _ ## ISA (const U *src, const bool *mask, octave_idx_type n,  \
+                    U *dest)                                            \
+  {                                                                     \
+    octave_idx_type k = 0;                                              \
+    octave_idx_type i = 0;                                              \
+    for (; i + W <= n; i += W)                                          \
+      k = BLOCK (src, mask + i, dest + i, k);                           \
+    for (; i < n; i++)                                                  \
+      if (mask[i])                                                      \
+        dest[i] = src[k++];                                             \
+    return k;                                                           \
+  }
+
+__attribute__ ((target ("avx2"))) static inline octave_idx_type
+expand_block_4_avx2 (const uint32_t *s, const bool *mask, uint32_t *d,
+                     octave_idx_type k)
+{
+  unsigned int m = compress_bits_8 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m256i first = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (c),
+                                      _mm256_setr_epi32 (0, 1, 2, 3,
+                                                         4, 5, 6, 7));
+  __m256i v = _mm256_maskload_epi32 (reinterpret_cast<const int *> (s + k),
+                                     first);
+  __m256i p
+    = _mm256_cvtepu8_epi32 (_mm_cvtsi64_si128 (compress_tab.rank[m]));
+  __m128i mb = _mm_loadl_epi64 (reinterpret_cast<const __m128i *> (mask));
+  __m256i sel = _mm256_cmpgt_epi32 (_mm256_cvtepu8_epi32 (mb),
+                                    _mm256_setzero_si256 ());
+  _mm256_maskstore_epi32 (reinterpret_cast<int *> (d), sel,
+                          _mm256_permutevar8x32_epi32 (v, p));
+  return k + c;
+}
+
+__attribute__ ((target ("avx2"))) static inline octave_idx_type
+expand_block_8_avx2 (const uint64_t *s, const bool *mask, uint64_t *d,
+                     octave_idx_type k)
+{
+  unsigned int m = compress_bits_4 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m256i first = _mm256_cmpgt_epi64 (_mm256_set1_epi64x (c),
+                                      _mm256_setr_epi64x (0, 1, 2, 3));
+  __m256i v
+    = _mm256_maskload_epi64 (reinterpret_cast<const long long *> (s + k),
+                             first);
+  uint64_t pm = compress_tab.rank[compress_tab.pairs[m]];
+  __m256i p = _mm256_cvtepu8_epi32 (_mm_cvtsi64_si128 (pm));
+  int w;
+  std::memcpy (&w, mask, 4);
+  __m128i mb = _mm_cvtsi32_si128 (w);
+  __m256i sel = _mm256_cmpgt_epi64 (_mm256_cvtepu8_epi64 (mb),
+                                    _mm256_setzero_si256 ());
+  _mm256_maskstore_epi64 (reinterpret_cast<long long *> (d), sel,
+                          _mm256_permutevar8x32_epi32 (v, p));
+  return k + c;
+}
+
+__attribute__ ((target ("avx512f"))) static inline octave_idx_type
+expand_block_4_avx512 (const uint32_t *s, const bool *mask, uint32_t *d,
+                       octave_idx_type k)
+{
+  __mmask16 m = compress_bits_16 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m512i v = _mm512_maskz_loadu_epi32 ((1u << c) - 1, s + k);
+  _mm512_mask_storeu_epi32 (d, m, _mm512_maskz_expand_epi32 (m, v));
+  return k + c;
+}
+
+__attribute__ ((target ("avx512f"))) static inline octave_idx_type
+expand_block_8_avx512 (const uint64_t *s, const bool *mask, uint64_t *d,
+                       octave_idx_type k)
+{
+  __mmask8 m = compress_bits_8 (mask);
+  if (m == 0)
+    return k;
+
+  int c = __builtin_popcount (m);
+  __m512i v = _mm512_maskz_loadu_epi64 ((1u << c) - 1, s + k);
+  _mm512_mask_storeu_epi64 (d, m, _mm512_maskz_expand_epi64 (m, v));
+  return k + c;
+}
+
+MX_SIMD_EXPAND_KERNEL (expand_4, avx2, "avx2", uint32_t,
+                       8, expand_block_4_avx2)
+MX_SIMD_EXPAND_KERNEL (expand_8, avx2, "avx2", uint64_t,
+                       4, expand_block_8_avx2)
+MX_SIMD_EXPAND_KERNEL (expand_4, avx512, "avx512f", uint32_t,
+                       16, expand_block_4_avx512)
+MX_SIMD_EXPAND_KERNEL (expand_8, avx512, "avx512f", uint64_t,
+                       8, expand_block_8_avx512)
+
+#define compress_4_sse2 compress_4_generic
+#define compress_8_sse2 compress_8_generic
+#define expand_4_sse2 expand_4_generic
+#define expand_8_sse2 expand_8_generic
+
+#endif
+
+octave_idx_type
+mx_simd_compress_4 (const void *src, const bool *mask, octave_idx_type n,
+                    void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT (compress_4);
+  return fcn (static_cast<const uint32_t *> (src), mask, n,
+              static_cast<uint32_t *> (dest));
+}
+
+octave_idx_type
+mx_simd_compress_8 (const void *src, const bool *mask, octave_idx_type n,
+                    void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT (compress_8);
+  return fcn (static_cast<const uint64_t *> (src), mask, n,
+              static_cast<uint64_t *> (dest));
+}
+
+octave_idx_type
+mx_simd_expand_4 (const void *src, const bool *mask, octave_idx_type n,
+                  void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT (expand_4);
+  return fcn (static_cast<const uint32_t *> (src), mask, n,
+              static_cast<uint32_t *> (dest));
+}
+
+octave_idx_type
+mx_simd_expand_8 (const void *src, const bool *mask, octave_idx_type n,
+                  void *dest)
+{
+  static const auto fcn = MX_SIMD_SELECT (expand_8);
+  return fcn (static_cast<const uint64_t *> (src), mask, n,
+              static_cast<uint64_t *> (dest));
+}
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mx_simd_h)
+#define octave_mx_simd_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+#include "oct-inttypes-fwd.h"
+
+// Hand-vectorized versions of some of the loops in mx-inlines.cc.  The
+// instruction set is chosen when each function is first called: on x86
+// processors these use AVX-512, AVX2, or SSE2 if available, elsewhere
+// they fall back to plain loops.
+//
+// The overloads of mx_inline_add, mx_inline_sub, mx_inline_max, and
+// mx_inline_min below are non-templates, so they are preferred to the
+// generic templates of mx-inlines.cc for the same argument types.
+
+// Saturating addition and subtraction of 8- and 16-bit integers.
+
+#define MX_SIMD_SAT_OP_DECLS(F, T)                                      \
+  extern OCTAVE_API void                                                \
+  F (std::size_t n, T *r, const T *x, const T *y);                      \
+  extern OCTAVE_API void                                                \
+  F (std::size_t n, T *r, const T *x, T y);                             \
+  extern OCTAVE_API void                                                \
+  F (std::size_t n, T *r, T x, const T *y);                             \
+  extern OCTAVE_API void                                                \
+  F ## 2 (std::size_t n, T *r, const T *x);                             \
+  extern OCTAVE_API void                                                \
+  F ## 2 (std::size_t n, T *r, T x);
+
+#define MX_SIMD_SAT_DECLS(T)                    \
+  MX_SIMD_SAT_OP_DECLS (mx_inline_add, T)       \
+  MX_SIMD_SAT_OP_DECLS (mx_inline_sub, T)
+
+MX_SIMD_SAT_DECLS (octave_int8)
+MX_SIMD_SAT_DECLS (octave_int16)
+MX_SIMD_SAT_DECLS (octave_uint8)
+MX_SIMD_SAT_DECLS (octave_uint16)
+
+#undef MX_SIMD_SAT_DECLS
+#undef MX_SIMD_SAT_OP_DECLS
+
+// Maximum and minimum ignoring NaNs.  The result is NaN only if all
+// elements are NaN.
+
+extern OCTAVE_API void
+mx_inline_max (const double *v, double *r, octave_idx_type n);
+
+extern OCTAVE_API void
+mx_inline_max (const float *v, float *r, octave_idx_type n);
+
+extern OCTAVE_API void
+mx_inline_min (const double *v, double *r, octave_idx_type n);
+
+extern OCTAVE_API void
+mx_inline_min (const float *v, float *r, octave_idx_type n);
+
+// TRUE if any element is nonzero and not NaN, or if all elements are
+// nonzero.  Both return as soon as the result is known.
+
+extern OCTAVE_API bool
+mx_simd_any (const double *v, octave_idx_type n);
+
+extern OCTAVE_API bool
+mx_simd_any (const float *v, octave_idx_type n);
+
+extern OCTAVE_API bool
+mx_simd_all (const double *v, octave_idx_type n);
+
+extern OCTAVE_API bool
+mx_simd_all (const float *v, octave_idx_type n);
+
+// Transpose the NR by NC matrix SRC with leading dimension LDS into
+// DEST with leading dimension LDD.  Only the size of the elements
+// matters, so these are used for any trivially copyable type of 4 or 8
+// bytes.
+
+extern OCTAVE_API void
+mx_simd_transpose_4 (const void *src, void *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd);
+
+extern OCTAVE_API void
+mx_simd_transpose_8 (const void *src, void *dest,
+                     octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type lds, octave_idx_type ldd);
+
+// Gather DEST[i] = SRC[IDX[i]] for 0 <= i < N.  Like the transposes,
+// these are used for any trivially copyable type of 4 or 8 bytes.
+
+extern OCTAVE_API void
+mx_simd_gather_4 (const void *src, const octave_idx_type *idx,
+                  octave_idx_type n, void *dest);
+
+extern OCTAVE_API void
+mx_simd_gather_8 (const void *src, const octave_idx_type *idx,
+                  octave_idx_type n, void *dest);
+
+// Copy the elements SRC[i] for which MASK[i] is true, 0 <= i < N, to
+// consecutive elements of DEST.  Return the number of elements copied.
+
+extern OCTAVE_API octave_idx_type
+mx_simd_compress_4 (const void *src, const bool *mask, octave_idx_type n,
+                    void *dest);
+
+extern OCTAVE_API octave_idx_type
+mx_simd_compress_8 (const void *src, const bool *mask, octave_idx_type n,
+                    void *dest);
+
+// The reverse: copy consecutive elements of SRC to the elements DEST[i]
+// for which MASK[i] is true, 0 <= i < N.  Return the number of elements
+// copied.
+
+extern OCTAVE_API octave_idx_type
+mx_simd_expand_4 (const void *src, const bool *mask, octave_idx_type n,
+                  void *dest);
+
+extern OCTAVE_API octave_idx_type
+mx_simd_expand_8 (const void *src, const bool *mask, octave_idx_type n,
+                  void *dest);
+
+#endif
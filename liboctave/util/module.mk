@@ -18,6 +18,7 @@ UTIL_INC = \
   %reldir%/lo-error.h \
   %reldir%/octave-preserve-stream-state.h \
   %reldir%/quit.h \
+  %reldir%/oct-alloc.h \
   %reldir%/oct-atomic.h \
   %reldir%/oct-base64.h \
   %reldir%/oct-binmap.h \
@@ -33,6 +34,7 @@ UTIL_INC = \
   %reldir%/oct-shlib.h \
   %reldir%/oct-sort.h \
   %reldir%/oct-string.h \
+  %reldir%/oct-thread-pool.h \
   %reldir%/pathsearch.h \
   %reldir%/singleton-cleanup.h \
   %reldir%/sparse-util.h \
@@ -71,6 +73,7 @@ UTIL_SRC = \
   %reldir%/lo-regexp.cc \
   %reldir%/lo-utils.cc \
   %reldir%/quit.cc \
+  %reldir%/oct-alloc.cc \
   %reldir%/oct-atomic.c \
   %reldir%/oct-base64.cc \
   %reldir%/oct-cmplx.cc \
@@ -80,6 +83,7 @@ UTIL_SRC = \
   %reldir%/oct-shlib.cc \
   %reldir%/oct-sparse.cc \
   %reldir%/oct-string.cc \
+  %reldir%/oct-thread-pool.cc \
   %reldir%/pathsearch.cc \
   %reldir%/singleton-cleanup.cc \
   %reldir%/sparse-util.cc \
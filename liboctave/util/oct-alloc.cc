@@ -0,0 +1,308 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <new>
+
+#include "oct-alloc.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static mutex&
+registry_mutex ()
+{
+  static mutex *m = new mutex ();
+
+  return *m;
+}
+
+static std::vector<slab_allocator *>&
+registry ()
+{
+  static std::vector<slab_allocator *> *r
+    = new std::vector<slab_allocator *> ();
+
+  return *r;
+}
+
+// Per-thread caches of all allocators, indexed by allocator id.  The
+// table is reached through a trivially destructible pointer so that it
+// remains usable while the thread's other objects are destroyed.
+
+struct cache_table
+{
+  std::vector<slab_allocator::thread_cache> m_caches;
+};
+
+static thread_local cache_table *t_table = nullptr;
+
+static thread_local bool t_exiting = false;
+
+class cache_table_guard
+{
+public:
+
+  cache_table_guard () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (cache_table_guard)
+
+  // Give the free blocks of the exiting thread back to the shared lists.
+  // Blocks freed after this point go to a new table that is never
+  // released, which only happens while the thread is exiting.
+
+  ~cache_table_guard ()
+  {
+    if (t_table)
+      {
+        std::vector<slab_allocator *> allocators;
+
+        {
+          autolock guard (registry_mutex ());
+
+          allocators = registry ();
+        }
+
+        std::vector<slab_allocator::thread_cache>& caches = t_table->m_caches;
+
+        for (std::size_t i = 0; i < caches.size (); i++)
+          allocators[i]->release (caches[i]);
+
+        delete t_table;
+        t_table = nullptr;
+      }
+
+    t_exiting = true;
+  }
+};
+
+static thread_local cache_table_guard t_guard;
+
+slab_allocator::slab_allocator (const std::string& name, std::size_t size)
+  : m_name (name), m_requested_size (size), m_block_size (),
+    m_batch_size (), m_slab_blocks (), m_id (), m_mutex (),
+    m_free (nullptr), m_nfree (0), m_allocated (0), m_freed (0), m_slabs ()
+{
+  std::size_t align = alignof (std::max_align_t);
+
+  m_block_size = std::max (size, sizeof (void *));
+  m_block_size = (m_block_size + align - 1) / align * align;
+
+  m_batch_size = std::max<std::size_t> (8, 4096 / m_block_size);
+  m_slab_blocks = std::max<std::size_t> (4 * m_batch_size,
+                                         65536 / m_block_size);
+
+  autolock guard (registry_mutex ());
+
+  m_id = registry ().size ();
+  registry ().push_back (this);
+}
+
+void *
+slab_allocator::allocate (std::size_t size)
+{
+  if (size != m_requested_size)
+    return ::operator new (size);
+
+  thread_cache& tc = local_cache ();
+
+  if (! tc.free_list)
+    refill (tc);
+
+  void *p = tc.free_list;
+  tc.free_list = *static_cast<void **> (p);
+  tc.nfree--;
+  tc.allocated++;
+
+  return p;
+}
+
+void
+slab_allocator::deallocate (void *p, std::size_t size)
+{
+  if (size != m_requested_size)
+    {
+      ::operator delete (p);
+      return;
+    }
+
+  thread_cache& tc = local_cache ();
+
+  *static_cast<void **> (p) = tc.free_list;
+  tc.free_list = p;
+  tc.nfree++;
+  tc.freed++;
+
+  if (tc.nfree > 2 * m_batch_size)
+    drain (tc, m_batch_size);
+}
+
+slab_allocator::statistics
+slab_allocator::stats () const
+{
+  statistics s;
+
+  s.name = m_name;
+  s.block_size = m_block_size;
+
+  {
+    autolock guard (m_mutex);
+
+    s.allocated = m_allocated;
+    s.freed = m_freed;
+    s.reserved = m_slabs.size () * m_slab_blocks;
+  }
+
+  if (t_table && m_id < t_table->m_caches.size ())
+    {
+      const thread_cache& tc = t_table->m_caches[m_id];
+
+      s.allocated += tc.allocated;
+      s.freed += tc.freed;
+    }
+
+  return s;
+}
+
+std::list<slab_allocator::statistics>
+slab_allocator::all_stats ()
+{
+  std::vector<slab_allocator *> allocators;
+
+  {
+    autolock guard (registry_mutex ());
+
+    allocators = registry ();
+  }
+
+  std::list<statistics> retval;
+
+  for (const auto *a : allocators)
+    retval.push_back (a->stats ());
+
+  return retval;
+}
+
+slab_allocator::thread_cache&
+slab_allocator::local_cache ()
+{
+  if (! t_table)
+    {
+      t_table = new cache_table ();
+
+      // Make sure the blocks are returned when the thread exits.
+      if (! t_exiting)
+        static_cast<void> (&t_guard);
+    }
+
+  std::vector<thread_cache>& caches = t_table->m_caches;
+
+  if (m_id >= caches.size ())
+    caches.resize (m_id + 1);
+
+  return caches[m_id];
+}
+
+// Move a batch of blocks from the shared list to TC.
+
+void
+slab_allocator::refill (thread_cache& tc)
+{
+  autolock guard (m_mutex);
+
+  if (m_nfree == 0)
+    new_slab ();
+
+  std::size_t n = std::min (m_batch_size, m_nfree);
+
+  for (std::size_t i = 0; i < n; i++)
+    {
+      void *p = m_free;
+      m_free = *static_cast<void **> (p);
+
+      *static_cast<void **> (p) = tc.free_list;
+      tc.free_list = p;
+    }
+
+  m_nfree -= n;
+  tc.nfree += n;
+
+  m_allocated += tc.allocated;
+  m_freed += tc.freed;
+  tc.allocated = 0;
+  tc.freed = 0;
+}
+
+// Move N blocks from TC to the shared list.
+
+void
+slab_allocator::drain (thread_cache& tc, std::size_t n)
+{
+  autolock guard (m_mutex);
+
+  for (std::size_t i = 0; i < n; i++)
+    {
+      void *p = tc.free_list;
+      tc.free_list = *static_cast<void **> (p);
+
+      *static_cast<void **> (p) = m_free;
+      m_free = p;
+    }
+
+  tc.nfree -= n;
+  m_nfree += n;
+
+  m_allocated += tc.allocated;
+  m_freed += tc.freed;
+  tc.allocated = 0;
+  tc.freed = 0;
+}
+
+// Allocate a new slab and add its blocks to the shared list.  Must be
+// called with M_MUTEX locked.
+
+void
+slab_allocator::new_slab ()
+{
+  char *slab = static_cast<char *> (::operator new (m_block_size
+                                                    * m_slab_blocks));
+
+  m_slabs.push_back (slab);
+
+  for (std::size_t i = m_slab_blocks; i-- > 0; )
+    {
+      void *p = slab + i * m_block_size;
+
+      *static_cast<void **> (p) = m_free;
+      m_free = p;
+    }
+
+  m_nfree += m_slab_blocks;
+}
+
+OCTAVE_END_NAMESPACE(octave)
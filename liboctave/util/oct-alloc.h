@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_alloc_h)
+#define octave_oct_alloc_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "oct-mutex.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Pool of fixed-size memory blocks for small objects that are created
+// and destroyed very often.
+//
+// Memory is obtained from the system in slabs that hold many blocks.
+// Freed blocks are kept for later objects of the same type and slabs
+// are never returned, so a steady stream of short-lived objects does
+// not fragment the general heap.
+//
+// Each thread keeps a short list of free blocks for every allocator, so
+// allocating and freeing a block normally takes no locks and no atomic
+// operations.  Blocks move between a thread's list and the list shared
+// by all threads in batches, and a thread's blocks are returned to the
+// shared list when it exits.
+//
+// Requests for any size other than the one the allocator was created
+// with, such as objects of a larger derived class that inherits the
+// class-specific operator new, are passed on to the global operator new.
+
+class OCTAVE_API slab_allocator
+{
+public:
+
+  struct statistics
+  {
+    std::string name;
+
+    // Size of each block in bytes.
+    std::size_t block_size;
+
+    // Total number of blocks handed out and freed.
+    std::size_t allocated;
+    std::size_t freed;
+
+    // Number of blocks in all slabs.
+    std::size_t reserved;
+  };
+
+  // Per-thread state for one allocator.
+  struct thread_cache
+  {
+    void *free_list = nullptr;
+    std::size_t nfree = 0;
+
+    // Counts not yet added to the totals of the allocator.
+    std::size_t allocated = 0;
+    std::size_t freed = 0;
+  };
+
+  slab_allocator (const std::string& name, std::size_t size);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (slab_allocator)
+
+  // Allocators are created on first use and never destroyed, so that
+  // objects may still be freed while the program exits.
+  ~slab_allocator () = default;
+
+  void * allocate (std::size_t size);
+
+  void deallocate (void *p, std::size_t size);
+
+  // Statistics include the counts of the calling thread but may lag
+  // behind by up to one batch for other running threads.
+  statistics stats () const;
+
+  static std::list<statistics> all_stats ();
+
+  // Return the blocks held by TC to the shared list.  Called for all
+  // allocators when a thread exits.
+  void release (thread_cache& tc) { drain (tc, tc.nfree); }
+
+private:
+
+  thread_cache& local_cache ();
+
+  void refill (thread_cache& tc);
+
+  void drain (thread_cache& tc, std::size_t n);
+
+  void new_slab ();
+
+  std::string m_name;
+
+  // Size that objects of this type ask for and the size of the blocks
+  // that hold them, rounded up for alignment.
+  std::size_t m_requested_size;
+  std::size_t m_block_size;
+
+  // Number of blocks moved between a thread and the shared list at
+  // once, and number of blocks in each new slab.
+  std::size_t m_batch_size;
+  std::size_t m_slab_blocks;
+
+  // Index of this allocator in the per-thread cache tables.
+  std::size_t m_id;
+
+  mutable mutex m_mutex;
+
+  // Shared list of free blocks and totals, protected by M_MUTEX.
+  void *m_free;
+  std::size_t m_nfree;
+  std::size_t m_allocated;
+  std::size_t m_freed;
+  std::vector<char *> m_slabs;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -28,11 +28,17 @@
 
 #include "octave-config.h"
 
-#include <atomic>
+#if defined (OCTAVE_ENABLE_ATOMIC_REFCOUNT)
+#  include <atomic>
+#endif
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 // Encapsulates a reference counter.
+//
+// The count is updated with atomic operations unless Octave was
+// configured with --disable-atomic-refcount.  In that case objects that
+// use a refcount must never be shared between threads.
 
 template <typename T>
 class refcount
@@ -72,7 +78,11 @@ public:
 
   count_type value () const
   {
+#if defined (OCTAVE_ENABLE_ATOMIC_REFCOUNT)
     return m_count.load ();
+#else
+    return m_count;
+#endif
   }
 
   operator count_type () const
@@ -82,7 +92,11 @@ public:
 
 private:
 
+#if defined (OCTAVE_ENABLE_ATOMIC_REFCOUNT)
   std::atomic<T> m_count;
+#else
+  T m_count;
+#endif
 };
 
 OCTAVE_END_NAMESPACE(octave)
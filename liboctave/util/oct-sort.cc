@@ -108,14 +108,21 @@
 // this file.
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <stack>
+#include <type_traits>
+#include <vector>
 
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "quit.h"
+#include "oct-inttypes-fwd.h"
 #include "oct-sort.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 template <typename T>
 octave_sort<T>::octave_sort () :
@@ -1512,6 +1519,320 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
     }
 }
 
+// Keys for sorting by radix.  octave_sort_radix_key<T>::key maps each
+// value to an unsigned integer so that the keys of two values compare in
+// the same way as the values themselves with operator <.  Types without
+// such a map are only sorted by comparison.
+
+template <typename T, typename = void>
+struct octave_sort_radix_key
+{
+  static const bool available = false;
+};
+
+template <typename T>
+struct octave_sort_radix_key
+  <T, typename std::enable_if<std::is_integral<T>::value
+                              && ! std::is_same<T, bool>::value>::type>
+{
+  static const bool available = true;
+
+  typedef typename std::make_unsigned<T>::type key_type;
+
+  // Flip the sign bit so that negative values come first.
+  static key_type key (T x)
+  {
+    key_type k = static_cast<key_type> (x);
+    if (std::is_signed<T>::value)
+      k ^= static_cast<key_type> (1) << (8 * sizeof (T) - 1);
+    return k;
+  }
+};
+
+template <typename T, typename U>
+struct octave_sort_radix_float_key
+{
+  static const bool available = true;
+
+  typedef U key_type;
+
+  // Flip all bits of negative values and the sign bit of positive ones.
+  // Negative zero is equal to zero, and NaNs, which are not ordered, are
+  // placed last.
+  static key_type key (T x)
+  {
+    if (octave::math::isnan (x))
+      return std::numeric_limits<U>::max ();
+
+    if (x == 0)
+      x = 0;
+
+    U k;
+    std::memcpy (&k, &x, sizeof (U));
+
+    const U sign = static_cast<U> (1) << (8 * sizeof (U) - 1);
+
+    return (k & sign) ? ~k : (k | sign);
+  }
+};
+
+template <>
+struct octave_sort_radix_key<double>
+  : public octave_sort_radix_float_key<double, uint64_t>
+{ };
+
+template <>
+struct octave_sort_radix_key<float>
+  : public octave_sort_radix_float_key<float, uint32_t>
+{ };
+
+template <typename U>
+struct octave_sort_radix_key<octave_int<U>> : public octave_sort_radix_key<U>
+{
+  static typename octave_sort_radix_key<U>::key_type
+  key (const octave_int<U>& x)
+  {
+    return octave_sort_radix_key<U>::key (x.value ());
+  }
+};
+
+// Stable least significant digit radix sort by bytes of the key, also
+// permuting IDX if it is not null.  Bytes that are the same for all
+// elements are skipped, so small integers need only one or two passes.
+
+template <typename T, bool DESCENDING>
+static void
+radix_sort (T *data, octave_idx_type *idx, octave_idx_type nel)
+{
+  typedef octave_sort_radix_key<T> radix_key;
+  typedef typename radix_key::key_type key_type;
+
+  static const int nbytes = sizeof (key_type);
+
+  auto key = [] (const T& x) -> key_type
+  {
+    key_type k = radix_key::key (x);
+    return DESCENDING ? static_cast<key_type> (~k) : k;
+  };
+
+  std::vector<octave_idx_type> count (nbytes * 256, 0);
+
+  for (octave_idx_type i = 0; i < nel; i++)
+    {
+      key_type k = key (data[i]);
+      for (int b = 0; b < nbytes; b++)
+        count[b*256 + ((k >> (8*b)) & 0xff)]++;
+    }
+
+  std::unique_ptr<T[]> buf (new T [nel]);
+  std::unique_ptr<octave_idx_type[]> ibuf (idx ? new octave_idx_type [nel]
+                                           : nullptr);
+
+  T *src = data;
+  T *dest = buf.get ();
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idest = ibuf.get ();
+
+  for (int b = 0; b < nbytes; b++)
+    {
+      octave_idx_type *pos = &count[b*256];
+
+      if (pos[(key (src[0]) >> (8*b)) & 0xff] == nel)
+        continue;
+
+      octave_idx_type sum = 0;
+      for (int d = 0; d < 256; d++)
+        {
+          octave_idx_type tmp = pos[d];
+          pos[d] = sum;
+          sum += tmp;
+        }
+
+      if (idx)
+        {
+          for (octave_idx_type i = 0; i < nel; i++)
+            {
+              octave_idx_type j = pos[(key (src[i]) >> (8*b)) & 0xff]++;
+              dest[j] = src[i];
+              idest[j] = isrc[i];
+            }
+        }
+      else
+        {
+          for (octave_idx_type i = 0; i < nel; i++)
+            dest[pos[(key (src[i]) >> (8*b)) & 0xff]++] = src[i];
+        }
+
+      std::swap (src, dest);
+      std::swap (isrc, idest);
+    }
+
+  if (src != data)
+    {
+      std::copy_n (src, nel, data);
+      if (idx)
+        std::copy_n (isrc, nel, idx);
+    }
+}
+
+// Return the number of elements of the stable merge of A and B that
+// come from A among the first K elements of the merge.
+
+template <typename T, typename Comp>
+static octave_idx_type
+merge_split (const T *a, octave_idx_type na, const T *b, octave_idx_type nb,
+             octave_idx_type k, Comp comp)
+{
+  octave_idx_type lo = std::max (k - nb, static_cast<octave_idx_type> (0));
+  octave_idx_type hi = std::min (k, na);
+
+  while (lo < hi)
+    {
+      octave_idx_type mid = lo + (hi - lo) / 2;
+
+      // Elements of A come first unless the element of B is smaller.
+      if (! comp (b[k-mid-1], a[mid]))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return lo;
+}
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort_serial (T *data, octave_idx_type *idx,
+                             octave_idx_type nel, Comp comp)
+{
+  if constexpr (octave_sort_radix_key<T>::available
+                && (std::is_same<Comp, std::less<T>>::value
+                    || std::is_same<Comp, std::greater<T>>::value))
+    {
+      // Sorted input is left to the merge sort, which only needs one
+      // pass to detect it.
+      if (nel >= RADIX_SORT_MIN && ! issorted (data, nel, comp))
+        {
+          radix_sort<T, std::is_same<Comp, std::greater<T>>::value>
+            (data, idx, nel);
+          return;
+        }
+    }
+
+  if (idx)
+    sort (data, idx, nel, comp);
+  else
+    sort (data, nel, comp);
+}
+
+// Sort NP pieces of DATA in parallel, then merge pairs of sorted runs in
+// rounds.  In each round, every thread writes the same part of the
+// output, so the work stays balanced until the last merge.
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::parallel_sort (T *data, octave_idx_type *idx,
+                               octave_idx_type nel, Comp comp)
+{
+  octave_idx_type np = octave::thread_pool::num_threads ();
+
+  std::vector<octave_idx_type> bnd (np + 1);
+  for (octave_idx_type k = 0; k <= np; k++)
+    bnd[k] = (nel / np) * k + std::min (k, nel % np);
+
+  const octave_idx_type *b = bnd.data ();
+
+  octave::thread_pool::parallel_for
+    (np, nel / np * SORT_ELEMENT_COST, [=] (std::size_t beg, std::size_t end)
+     {
+       octave_sort<T> lsort;
+       for (std::size_t k = beg; k < end; k++)
+         lsort.sort_serial (data + b[k], idx ? idx + b[k] : nullptr,
+                            b[k+1] - b[k], comp);
+     });
+
+  std::unique_ptr<T[]> buf (new T [nel]);
+  std::unique_ptr<octave_idx_type[]> ibuf (idx ? new octave_idx_type [nel]
+                                           : nullptr);
+
+  T *src = data;
+  T *dest = buf.get ();
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idest = ibuf.get ();
+
+  for (octave_idx_type w = 1; w < np; w *= 2)
+    {
+      octave::thread_pool::parallel_for
+        (np, nel / np, [=] (std::size_t beg, std::size_t end)
+         {
+           octave_idx_type s_end = end;
+           for (octave_idx_type s = beg; s < s_end; s++)
+             {
+               // Merge runs [B(K), B(M)) and [B(M), B(E)), writing the
+               // part of the result that goes to [B(S), B(S+1)).
+               octave_idx_type k = s - s % (2*w);
+               octave_idx_type m = std::min (k + w, np);
+               octave_idx_type e = std::min (k + 2*w, np);
+
+               const T *pa = src + b[k];
+               const T *pb = src + b[m];
+               octave_idx_type na = b[m] - b[k];
+               octave_idx_type nb = b[e] - b[m];
+
+               octave_idx_type k0 = b[s] - b[k];
+               octave_idx_type k1 = b[s+1] - b[k];
+               octave_idx_type i = merge_split (pa, na, pb, nb, k0, comp);
+               octave_idx_type i1 = merge_split (pa, na, pb, nb, k1, comp);
+               octave_idx_type j = k0 - i;
+               octave_idx_type j1 = k1 - i1;
+
+               for (octave_idx_type l = b[s]; l < b[s+1]; l++)
+                 {
+                   bool from_b = (j < j1 && (i == i1 || comp (pb[j], pa[i])));
+                   octave_idx_type r = (from_b ? b[m] + j++ : b[k] + i++);
+                   dest[l] = src[r];
+                   if (idx)
+                     idest[l] = isrc[r];
+                 }
+             }
+         });
+
+      std::swap (src, dest);
+      std::swap (isrc, idest);
+    }
+
+  if (src != data)
+    {
+      std::copy_n (src, nel, data);
+      if (idx)
+        std::copy_n (isrc, nel, idx);
+    }
+}
+
+// Sort with one of the built-in comparisons.  Large arrays of plain data
+// are sorted by several threads.  Other types may share
+// reference-counted data, so copying them is not thread safe.
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort_inline (T *data, octave_idx_type *idx,
+                             octave_idx_type nel, Comp comp)
+{
+  if constexpr (std::is_trivially_copyable<T>::value)
+    {
+      if (octave::thread_pool::use_threads (nel, SORT_ELEMENT_COST))
+        {
+          parallel_sort (data, idx, nel, comp);
+          return;
+        }
+    }
+
+  sort_serial (data, idx, nel, comp);
+}
+
 template <typename T>
 using compare_fcn_ptr = bool (*) (typename ref_param<T>::type,
                                   typename ref_param<T>::type);
@@ -1522,12 +1843,12 @@ octave_sort<T>::sort (T *data, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, nel, std::less<T> ());
+    sort_inline (data, nullptr, nel, std::less<T> ());
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, nel, std::greater<T> ());
+      sort_inline (data, nullptr, nel, std::greater<T> ());
     else
 #endif
       if (m_compare)
@@ -1540,12 +1861,12 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, idx, nel, std::less<T> ());
+    sort_inline (data, idx, nel, std::less<T> ());
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, idx, nel, std::greater<T> ());
+      sort_inline (data, idx, nel, std::greater<T> ());
     else
 #endif
       if (m_compare)
@@ -1963,6 +2284,60 @@ octave_sort<T>::nth_element (T *data, octave_idx_type nel,
         nth_element (data, nel, lo, up, m_compare);
 }
 
+// Place the elements with the indices RANKS[0..NR-1], all of which lie
+// in [LO, HI), within DATA[LO..HI-1].
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::nth_elements (T *data, octave_idx_type lo, octave_idx_type hi,
+                              const octave_idx_type *ranks,
+                              octave_idx_type nr, Comp comp)
+{
+  while (nr > 0)
+    {
+      // A run of subsequent indices is handled as a range.
+      if (ranks[nr-1] - ranks[0] == nr - 1)
+        {
+          nth_element (data + lo, hi - lo, ranks[0] - lo,
+                       ranks[nr-1] - lo + 1, comp);
+          break;
+        }
+
+      // Place the middle index.  The elements before and after it are
+      // then independent problems for the indices on either side.
+      octave_idx_type mid = nr / 2;
+      octave_idx_type k = ranks[mid];
+
+      std::nth_element (data + lo, data + k, data + hi, comp);
+
+      nth_elements (data, lo, k, ranks, mid, comp);
+
+      lo = k + 1;
+      ranks += mid + 1;
+      nr -= mid + 1;
+    }
+}
+
+template <typename T>
+void
+octave_sort<T>::nth_element (T *data, octave_idx_type nel,
+                             const octave_idx_type *ranks, octave_idx_type nr)
+{
+#if defined (INLINE_ASCENDING_SORT)
+  if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
+    nth_elements (data, 0, nel, ranks, nr, std::less<T> ());
+  else
+#endif
+#if defined (INLINE_DESCENDING_SORT)
+    if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
+      nth_elements (data, 0, nel, ranks, nr, std::greater<T> ());
+    else
+#endif
+      if (m_compare)
+        nth_elements (data, 0, nel, ranks, nr, m_compare);
+}
+
 template <typename T>
 bool
 octave_sort<T>::ascending_compare (typename ref_param<T>::type x,
@@ -154,6 +154,11 @@ public:
   void nth_element (T *data, octave_idx_type nel,
                     octave_idx_type lo, octave_idx_type up = -1);
 
+  // Ditto, for the nr indices in ranks, which must be in ascending order
+  // and distinct.  All of them are placed by a single partitioning pass.
+  void nth_element (T *data, octave_idx_type nel,
+                    const octave_idx_type *ranks, octave_idx_type nr);
+
   static bool ascending_compare (typename ref_param<T>::type,
                                  typename ref_param<T>::type);
 
@@ -176,6 +181,13 @@ private:
   // Avoid malloc for small temp arrays.
   static const int MERGESTATE_TEMP_SIZE = 1024;
 
+  // Shorter arrays are not sorted by radix, even if the keys allow it.
+  static const int RADIX_SORT_MIN = 2048;
+
+  // Approximate cost of sorting one element, in units of one element of
+  // an element-wise operation, used to decide when to use threads.
+  static const int SORT_ELEMENT_COST = 16;
+
   // One MergeState exists on the stack per invocation of mergesort.
   // It's just a convenient way to pass state around among the helper
   // functions.
@@ -304,6 +316,18 @@ private:
   template <typename Comp>
   void sort (T *data, octave_idx_type *idx, octave_idx_type nel, Comp comp);
 
+  template <typename Comp>
+  void sort_inline (T *data, octave_idx_type *idx, octave_idx_type nel,
+                    Comp comp);
+
+  template <typename Comp>
+  void sort_serial (T *data, octave_idx_type *idx, octave_idx_type nel,
+                    Comp comp);
+
+  template <typename Comp>
+  void parallel_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                      Comp comp);
+
   template <typename Comp>
   bool issorted (const T *data, octave_idx_type nel, Comp comp);
 
@@ -334,6 +358,11 @@ private:
   void nth_element (T *data, octave_idx_type nel,
                     octave_idx_type lo, octave_idx_type up,
                     Comp comp);
+
+  template <typename Comp>
+  void nth_elements (T *data, octave_idx_type lo, octave_idx_type hi,
+                     const octave_idx_type *ranks, octave_idx_type nr,
+                     Comp comp);
 };
 
 template <typename T>
@@ -0,0 +1,385 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "nproc-wrapper.h"
+#include "oct-thread-pool.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Below this many elements per thread, the cost of waking the workers
+// outweighs the gain for simple element-wise operations.
+static const std::size_t default_min_chunk_size = 32768;
+
+// Range boundaries are multiples of this many elements so that threads
+// writing adjacent ranges of small elements do not share cache lines.
+static const std::size_t chunk_alignment = 64;
+
+// Zero means the number of processors available.
+static std::atomic<int> s_num_threads (0);
+
+static std::atomic<std::size_t> s_min_chunk_size (default_min_chunk_size);
+
+// TRUE in worker threads and in a thread that is running a parallel
+// loop, so that nested loops run serially.
+static thread_local bool t_in_parallel_loop = false;
+
+class worker_pool
+{
+public:
+
+  worker_pool ()
+    : m_mutex (), m_wake (), m_done (), m_loop_mutex (), m_workers (),
+      m_generation (0), m_job (nullptr)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (worker_pool)
+
+  // The pool is created on first use and never destroyed, since the
+  // worker threads are never joined.
+  ~worker_pool () = default;
+
+  // Run a loop split into NCHUNKS ranges whose lengths are multiples of
+  // ALIGN.  Return false without doing anything if another thread is
+  // running a loop or the worker threads can not be started.
+  bool run (std::size_t n, std::size_t nchunks, std::size_t align,
+            const thread_pool::range_function& fcn);
+
+private:
+
+  // A parallel loop.  Lives on the stack of the thread that runs it.
+  struct job
+  {
+    job (std::size_t n, std::size_t nchunks, std::size_t align,
+         const thread_pool::range_function& fcn)
+      : m_fcn (fcn), m_n (n), m_nchunks (nchunks),
+        m_chunk_size (chunk_size (n, nchunks, align)), m_next (0),
+        m_active (0), m_error ()
+    { }
+
+    OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (job)
+
+    ~job () = default;
+
+    static std::size_t chunk_size (std::size_t n, std::size_t nchunks,
+                                   std::size_t align)
+    {
+      std::size_t sz = (n + nchunks - 1) / nchunks;
+
+      return ((sz + align - 1) / align) * align;
+    }
+
+    const thread_pool::range_function& m_fcn;
+    std::size_t m_n;
+    std::size_t m_nchunks;
+    std::size_t m_chunk_size;
+
+    // Index of the next range to run.
+    std::atomic<std::size_t> m_next;
+
+    // Number of worker threads working on this loop and the first
+    // exception thrown, protected by the mutex of the pool.
+    std::size_t m_active;
+    std::exception_ptr m_error;
+  };
+
+  bool start_workers (std::size_t count);
+
+  void worker_loop ();
+
+  void run_chunks (job& j);
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+
+  // Held by the thread that is running a loop.
+  std::mutex m_loop_mutex;
+
+  std::vector<std::thread> m_workers;
+
+  // Incremented for each loop so that waiting workers notice new work.
+  std::size_t m_generation;
+
+  // The loop that is running, if any.
+  job *m_job;
+};
+
+bool
+worker_pool::run (std::size_t n, std::size_t nchunks, std::size_t align,
+                  const thread_pool::range_function& fcn)
+{
+  std::unique_lock<std::mutex> loop_lock (m_loop_mutex, std::try_to_lock);
+
+  if (! loop_lock.owns_lock () || ! start_workers (nchunks - 1))
+    return false;
+
+  job j (n, nchunks, align, fcn);
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    m_job = &j;
+    m_generation++;
+  }
+
+  m_wake.notify_all ();
+
+  t_in_parallel_loop = true;
+
+  run_chunks (j);
+
+  t_in_parallel_loop = false;
+
+  // Wait for the workers that joined this loop, then detach it so that
+  // workers waking up late do not see it.
+
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    m_done.wait (lock, [&j] () { return j.m_active == 0; });
+
+    m_job = nullptr;
+  }
+
+  if (j.m_error)
+    std::rethrow_exception (j.m_error);
+
+  return true;
+}
+
+bool
+worker_pool::start_workers (std::size_t count)
+{
+  try
+    {
+      while (m_workers.size () < count)
+        m_workers.emplace_back ([this] () { worker_loop (); });
+    }
+  catch (const std::system_error&)
+    {
+      // Run with the threads that could be started, if any.
+    }
+
+  return ! m_workers.empty ();
+}
+
+void
+worker_pool::worker_loop ()
+{
+  t_in_parallel_loop = true;
+
+  std::size_t seen = 0;
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  for (;;)
+    {
+      m_wake.wait (lock, [this, &seen] () { return m_generation != seen; });
+
+      seen = m_generation;
+
+      job *j = m_job;
+
+      if (! j)
+        continue;
+
+      j->m_active++;
+
+      lock.unlock ();
+
+      run_chunks (*j);
+
+      lock.lock ();
+
+      if (--j->m_active == 0)
+        m_done.notify_all ();
+    }
+}
+
+void
+worker_pool::run_chunks (job& j)
+{
+  for (;;)
+    {
+      std::size_t i = j.m_next.fetch_add (1);
+
+      if (i >= j.m_nchunks)
+        break;
+
+      std::size_t beg = std::min (i * j.m_chunk_size, j.m_n);
+      std::size_t end = std::min (beg + j.m_chunk_size, j.m_n);
+
+      if (beg == end)
+        continue;
+
+      try
+        {
+          j.m_fcn (beg, end);
+        }
+      catch (...)
+        {
+          std::lock_guard<std::mutex> lock (m_mutex);
+
+          if (! j.m_error)
+            j.m_error = std::current_exception ();
+        }
+    }
+}
+
+static worker_pool *&
+pool_ptr ()
+{
+  static worker_pool *pool = new worker_pool ();
+
+  return pool;
+}
+
+static worker_pool&
+the_pool ()
+{
+  return *pool_ptr ();
+}
+
+static std::size_t
+num_chunks (std::size_t n, std::size_t cost = 1)
+{
+  std::size_t max_chunks = n / thread_pool::min_chunk_size ();
+
+  if (cost > 1)
+    {
+      // Minimum number of items per range, computed this way to avoid
+      // overflow in N * COST.
+      std::size_t min_items = std::max (thread_pool::min_chunk_size () / cost,
+                                        static_cast<std::size_t> (1));
+
+      max_chunks = n / min_items;
+    }
+
+  if (max_chunks < 2)
+    return 1;
+
+  std::size_t nthreads = thread_pool::num_threads ();
+
+  return std::min (nthreads, max_chunks);
+}
+
+int
+thread_pool::num_threads ()
+{
+  int n = s_num_threads;
+
+  if (n < 1)
+    {
+      static const int nproc = static_cast<int>
+        (octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE));
+
+      n = nproc;
+    }
+
+  return std::max (n, 1);
+}
+
+void
+thread_pool::set_num_threads (int n)
+{
+  s_num_threads = std::max (n, 0);
+}
+
+std::size_t
+thread_pool::min_chunk_size ()
+{
+  return s_min_chunk_size;
+}
+
+void
+thread_pool::set_min_chunk_size (std::size_t n)
+{
+  s_min_chunk_size = std::max (n, static_cast<std::size_t> (1));
+}
+
+bool
+thread_pool::use_threads (std::size_t n)
+{
+  return ! t_in_parallel_loop && num_chunks (n) > 1;
+}
+
+bool
+thread_pool::use_threads (std::size_t n, std::size_t cost)
+{
+  return ! t_in_parallel_loop && num_chunks (n, cost) > 1;
+}
+
+void
+thread_pool::parallel_for (std::size_t n, const range_function& fcn)
+{
+  if (n == 0)
+    return;
+
+  std::size_t nchunks = t_in_parallel_loop ? 1 : num_chunks (n);
+
+  if (nchunks > 1 && the_pool ().run (n, nchunks, chunk_alignment, fcn))
+    return;
+
+  fcn (0, n);
+}
+
+void
+thread_pool::parallel_for (std::size_t n, std::size_t cost,
+                           const range_function& fcn)
+{
+  if (n == 0)
+    return;
+
+  std::size_t nchunks = t_in_parallel_loop ? 1 : num_chunks (n, cost);
+
+  if (nchunks > 1 && the_pool ().run (n, nchunks, 1, fcn))
+    return;
+
+  fcn (0, n);
+}
+
+void
+thread_pool::reset_in_child ()
+{
+  // The old pool can not be destroyed: its threads were not copied and
+  // its mutexes may have been locked by one of them at the time of the
+  // fork.
+  pool_ptr () = new worker_pool ();
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_thread_pool_h)
+#define octave_oct_thread_pool_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <functional>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Worker threads shared by the numerical kernels of liboctave.
+//
+// A parallel loop over N elements is split into at most num_threads ()
+// contiguous ranges of at least min_chunk_size () elements each.  The
+// calling thread handles one range and the worker threads the others,
+// and the loop returns when all ranges are done.  Loops that are too
+// small to split, loops started from inside another parallel loop, and
+// loops started while another thread is using the pool are run by the
+// calling thread alone.
+//
+// The loop body runs concurrently in several threads, so it must only
+// read and write raw element data of arrays owned by the caller.  It
+// must not copy or destroy reference-counted objects such as Array or
+// octave_value, allocate memory through the interpreter, or call
+// octave_quit.  An exception thrown by the body is rethrown in the
+// calling thread after all ranges have finished.
+//
+// The pool threads are started on first use and live until the program
+// exits.
+
+class OCTAVE_API thread_pool
+{
+public:
+
+  typedef std::function<void (std::size_t, std::size_t)> range_function;
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (thread_pool)
+
+  // Number of threads used for parallel loops, including the calling
+  // thread.
+  static int num_threads ();
+
+  // Set the number of threads used for parallel loops.  If N is less
+  // than one, use the number of processors available to the process.
+  static void set_num_threads (int n);
+
+  // Minimum number of elements in each range of a parallel loop.
+  static std::size_t min_chunk_size ();
+
+  static void set_min_chunk_size (std::size_t n);
+
+  // TRUE if a loop over N elements would be split between threads.
+  static bool use_threads (std::size_t n);
+
+  // Likewise, for a loop over N items that each take about as long as
+  // COST elements of an element-wise operation.
+  static bool use_threads (std::size_t n, std::size_t cost);
+
+  // Call FCN (BEG, END) for ranges [BEG, END) that cover [0, N).
+  static void parallel_for (std::size_t n, const range_function& fcn);
+
+  // Likewise, for N items that each cost about COST elements.  The
+  // ranges may have any length.
+  static void parallel_for (std::size_t n, std::size_t cost,
+                            const range_function& fcn);
+
+  // Call in a child process created with fork.  The worker threads of
+  // the parent do not exist in the child, so the next parallel loop
+  // starts new ones.
+  static void reset_in_child ();
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -324,6 +324,12 @@ octave_pipe_wrapper (int *fd)
   return pipe (fd);
 }
 
+ssize_t
+octave_read_wrapper (int fd, void *buf, size_t n)
+{
+  return read (fd, buf, n);
+}
+
 int
 octave_rmdir_wrapper (const char *nm)
 {
@@ -402,6 +408,12 @@ octave_vfork_wrapper (void)
 #endif
 }
 
+ssize_t
+octave_write_wrapper (int fd, const void *buf, size_t n)
+{
+  return write (fd, buf, n);
+}
+
 bool
 octave_have_fork (void)
 {
@@ -86,6 +86,8 @@ extern OCTAVE_API int octave_link_wrapper (const char *nm1, const char *nm2);
 
 extern OCTAVE_API int octave_pipe_wrapper (int *fd);
 
+extern OCTAVE_API ssize_t octave_read_wrapper (int fd, void *buf, size_t n);
+
 extern OCTAVE_API int octave_rmdir_wrapper (const char *nm);
 
 extern OCTAVE_API pid_t octave_setsid_wrapper (void);
@@ -102,6 +104,8 @@ extern OCTAVE_API int octave_unlink_wrapper (const char *nm);
 
 extern OCTAVE_API pid_t octave_vfork_wrapper (void);
 
+extern OCTAVE_API ssize_t octave_write_wrapper (int fd, const void *buf, size_t n);
+
 extern OCTAVE_API bool octave_have_fork (void);
 
 extern OCTAVE_API bool octave_have_vfork (void);
@@ -126,8 +126,10 @@
 ## The complexity of accumarray in general for the non-sparse case is
 ## generally O(M+N), where N is the number of subscripts and M is the
 ## maximum subscript (linearized in multi-dimensional case).  If
-## @var{fcn} is one of @code{@@sum} (default), @code{@@max},
-## @code{@@min} or @code{@@(x) @{x@}}, an optimized code path is used.
+## @var{fcn} is one of @code{@@sum} (default), @code{@@prod},
+## @code{@@max}, @code{@@min}, @code{@@mean}, @code{@@numel},
+## @code{@@length}, @code{@@any}, @code{@@all}, or @code{@@(x) @{x@}}, an
+## optimized code path is used.
 ## Note that for general reduction function the interpreter overhead can
 ## play a major part and it may be more efficient to do multiple
 ## accumarray calls and compute the results in a vectorized manner.
@@ -177,6 +179,19 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
     issparse = false;
   endif
 
+  ## Reductions with a built-in kernel.
+  op = "";
+  if ((isnumeric (vals) || islogical (vals))
+      && isscalar (fillval) && isreal (fillval)
+      && (isnumeric (fillval) || islogical (fillval)))
+    switch (func2str (fcn))
+      case {"sum", "prod", "max", "min", "mean", "any", "all"}
+        op = func2str (fcn);
+      case {"numel", "length"}
+        op = "count";
+    endswitch
+  endif
+
   if (issparse)
 
     ## Sparse case.
@@ -204,41 +219,41 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
       error ("accumarray: in the sparse case, values must be numeric or logical");
     endif
 
-    if (fcn != @sum)
-
-      ## Reduce values.  This is not needed if we're about to sum them,
-      ## because "sparse" can do that.
-
-      ## Sort indices.
-      [subs, idx] = sortrows (subs);
-      n = rows (subs);
-      ## Identify runs.
-      jdx = find (any (diff (subs, 1, 1), 2));
-      jdx = [jdx; n];
-
-      vals = cellfun (fcn, mat2cell (vals(:)(idx), diff ([0; jdx])));
-      subs = subs(jdx, :);
-      mode = "unique";
-    else
-      mode = "sum";
-    endif
-
-    ## Form the sparse matrix.
     if (isempty (sz))
-      A = sparse (subs(:,1), subs(:,2), vals, mode);
+      ## Size is given by the largest subscripts.
     elseif (length (sz) == 2)
-
       ## Row vector case
       if (sz(1) == 1)
-        [i, j] = deal (subs(:,2), subs(:,1));
-      else
-        [i, j] = deal (subs(:,1), subs(:,2));
+        subs = subs(:, [2, 1]);
       endif
-      A = sparse (i, j, vals, sz(1), sz(2), mode);
     else
       error ("accumarray: dimensions mismatch");
     endif
 
+    if (strcmp (op, "sum"))
+      ## Let "sparse" add the values.
+      if (isempty (sz))
+        A = sparse (subs(:,1), subs(:,2), vals, "sum");
+      else
+        A = sparse (subs(:,1), subs(:,2), vals, sz(1), sz(2), "sum");
+      endif
+    elseif (! isempty (op))
+      A = __accumarray__ (op, subs, vals, sz, 0, true);
+    else
+      ## Group the values by subscript and reduce each group.
+      if (isscalar (vals))
+        vals = vals(ones (rows (subs), 1), 1);
+      endif
+      [subs, idx, cnt] = __accumarray_groups__ (subs, sz, true);
+      vals = cellfun (fcn, mat2cell (vals(:)(idx), cnt));
+
+      if (isempty (sz))
+        A = sparse (subs(:,1), subs(:,2), vals, "unique");
+      else
+        A = sparse (subs(:,1), subs(:,2), vals, sz(1), sz(2), "unique");
+      endif
+    endif
+
   else
 
     ## Linearize subscripts.
@@ -264,97 +279,27 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
       error ("accumarray: indices must be positive integers");
     endif
 
-
-    ## Some built-in reductions handled efficiently.
-
-    if (fcn == @sum)
-      ## Fast summation.
+    if (! isempty (op))
+      ## Scatter the values straight into their bins.
       if (isempty (sz))
-        A = __accumarray_sum__ (subs, vals);
+        A = __accumarray__ (op, subs, vals, [], fillval, false);
       else
-        A = __accumarray_sum__ (subs, vals, prod (sz));
+        A = __accumarray__ (op, subs, vals, prod (sz), fillval, false);
         ## set proper shape.
         A = reshape (A, sz);
       endif
-
-      ## we fill in nonzero fill value.
-      if (fillval != 0)
-        mask = true (size (A));
-        mask(subs) = false;
-        A(mask) = fillval;
-      endif
-    elseif (fcn == @max)
-      ## Fast maximization.
-
-      if (isinteger (vals))
-        zero = intmin (vals);
-      elseif (islogical (vals))
-        zero = false;
-      elseif (fillval == 0 && all (vals(:) >= 0))
-        ## This is a common case - fillval is zero, all numbers
-        ## nonegative.
-        zero = 0;
-      else
-        zero = NaN; # Neutral value.
-      endif
-
-      if (isempty (sz))
-        A = __accumarray_max__ (subs, vals, zero);
-      else
-        A = __accumarray_max__ (subs, vals, zero, prod (sz));
-        A = reshape (A, sz);
-      endif
-
-      if (fillval != zero && ! (isnan (fillval) || isnan (zero)))
-        mask = true (size (A));
-        mask(subs) = false;
-        A(mask) = fillval;
-      endif
-    elseif (fcn == @min)
-      ## Fast minimization.
-
-      if (isinteger (vals))
-        zero = intmax (vals);
-      elseif (islogical (vals))
-        zero = true;
-      elseif (fillval == 0 && all (vals(:) <= 0))
-        ## This is a common case - fillval is zero, all numbers
-        ## non-positive.
-        zero = 0;
-      else
-        zero = NaN; # Neutral value.
-      endif
-
-      if (isempty (sz))
-        A = __accumarray_min__ (subs, vals, zero);
-      else
-        A = __accumarray_min__ (subs, vals, zero, prod (sz));
-        A = reshape (A, sz);
-      endif
-
-      if (fillval != zero && ! (isnan (fillval) || isnan (zero)))
-        mask = true (size (A));
-        mask(subs) = false;
-        A(mask) = fillval;
-      endif
     else
 
       ## The general case.  Reduce values.
-      n = rows (subs);
-      if (numel (vals) == 1)
-        vals = vals(ones (1, n), 1);
+      if (isscalar (vals))
+        vals = vals(ones (1, numel (subs)), 1);
       else
         vals = vals(:);
       endif
 
-      ## Sort indices.
-      [subs, idx] = sort (subs);
-      ## Identify runs.
-      jdx = find (subs(1:n-1) != subs(2:n));
-      if (n != 0) # bug #47287
-        jdx = [jdx; n];
-      endif
-      vals = mat2cell (vals(idx), diff ([0; jdx]));
+      ## Group the values by subscript.
+      [subs, idx, cnt] = __accumarray_groups__ (subs, [], false);
+      vals = mat2cell (vals(idx), cnt);
       ## Optimize the case when function is @(x) {x}, i.e., we just want
       ## to collect the values to cells.
       persistent simple_cell_str = func2str (@(x) {x});
@@ -362,8 +307,6 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
         vals = cellfun (fcn, vals);
       endif
 
-      subs = subs(jdx);
-
       if (isempty (sz))
         sz = max (subs);
         ## If subs is empty, sz will be too, and length will be 0, hence "<= 1"
@@ -445,6 +388,24 @@ endfunction
 %! assert (accumarray (subsc, vals, [], @max),
 %!         accumarray (subs, vals, [], @max));
 
+%!test
+%! subs = ceil (rand (500, 2) * 8);
+%! vals = round (rand (500, 1) * 10) - 3;
+%! vals(1:50:end) = NaN;
+%! for fcn = {@sum, @prod, @max, @min, @mean, @numel, @any, @all}
+%!   fcn = fcn{1};
+%!   afcn = @(x) fcn (x);
+%!   assert (accumarray (subs, vals, [9, 9], fcn, -1),
+%!           accumarray (subs, vals, [9, 9], afcn, -1));
+%!   if (! strcmp (func2str (fcn), "sum"))
+%!     ## Integer sums are double.
+%!     assert (accumarray (subs, int8 (vals), [], fcn),
+%!             accumarray (subs, int8 (vals), [], afcn));
+%!   endif
+%!   assert (accumarray (subs, vals, [9, 9], fcn, 0, true),
+%!           accumarray (subs, vals, [9, 9], afcn, 0, true));
+%! endfor
+
 %!error accumarray (1:5)
 %!error accumarray ([1,2,3],1:2)
 
@@ -0,0 +1,560 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef decomposition
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{dA} =} decomposition (@var{A})
+  ## @deftypefnx {} {@var{dA} =} decomposition (@var{A}, @var{type})
+  ## Compute a factorization of the matrix @var{A} that can be reused to solve
+  ## several linear systems with the same coefficient matrix.
+  ##
+  ## The object @var{dA} supports left and right division just like @var{A}
+  ## itself, i.e., @code{@var{dA} \ @var{b}} and @code{@var{b} / @var{dA}},
+  ## but the factorization is computed only once, when the object is created.
+  ## This is useful when the right-hand sides are not all known in advance,
+  ## for example inside an iterative method or a time-stepping loop.
+  ##
+  ## The optional argument @var{type} selects the factorization.  Valid values
+  ## are
+  ##
+  ## @table @asis
+  ## @item @qcode{"auto"} (default)
+  ## Use @qcode{"chol"} if @var{A} is square, Hermitian, and has a positive
+  ## real diagonal, and fall back to @qcode{"lu"} if the Cholesky
+  ## factorization fails.  Other square matrices use @qcode{"lu"} and
+  ## rectangular matrices use @qcode{"qr"}.
+  ##
+  ## @item @qcode{"chol"}
+  ## Cholesky factorization of a Hermitian positive definite matrix.  Only the
+  ## upper triangular part of @var{A} is used.
+  ##
+  ## @item @qcode{"lu"}
+  ## LU factorization with partial pivoting of a square matrix.
+  ##
+  ## @item @qcode{"qr"}
+  ## QR factorization of a matrix of full rank.  Overdetermined systems are
+  ## solved in the least squares sense and underdetermined systems return the
+  ## minimum norm solution.
+  ## @end table
+  ##
+  ## For sparse matrices, the factorizations use a fill-reducing ordering.
+  ## When the values of the matrix change but its sparsity pattern stays the
+  ## same, @code{refactor} computes the new factorization using the ordering
+  ## found for the original matrix, which avoids repeating the symbolic
+  ## analysis:
+  ##
+  ## @example
+  ## @group
+  ## dA = decomposition (A);
+  ## for k = 1:nsteps
+  ##   x = dA \ b;
+  ##   @dots{}
+  ##   dA = refactor (dA, A + dt*K);
+  ## endfor
+  ## @end group
+  ## @end example
+  ##
+  ## @seealso{mldivide, mrdivide, linsolve, chol, lu, qr}
+  ## @end deftypefn
+
+  properties (GetAccess = public, SetAccess = private)
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{type} =} decomposition.Type ()
+    ## Return the type of the factorization, one of @qcode{"chol"},
+    ## @qcode{"lu"}, or @qcode{"qr"}.
+    ## @end deftypefn
+
+    Type = "";
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{sz} =} decomposition.MatrixSize ()
+    ## Return the size of the factorized matrix.
+    ## @end deftypefn
+
+    MatrixSize = [0, 0];
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{tf} =} decomposition.IsSparse ()
+    ## Return true if the factorized matrix is sparse.
+    ## @end deftypefn
+
+    IsSparse = false;
+
+  endproperties
+
+  properties (Access = private)
+
+    ## Triangular factors.  For "chol" and sparse "qr", L holds R' so that
+    ## repeated solves do not transpose a sparse factor every time.
+    L = [];
+    U = [];
+    R = [];
+    Q = [];
+
+    ## Row and column permutation vectors, and the UMFPACK row scaling.
+    p = [];
+    q = [];
+    S = [];
+
+    ## Sparse "qr" keeps the column-permuted matrix for the seminormal
+    ## equations.
+    W = [];
+
+    ## For "qr", true if A itself was factorized, false if A' was.
+    tall = true;
+
+  endproperties
+
+  methods (Access = public)
+
+    function this = decomposition (A, type)
+
+      if (nargin == 0)
+        return;
+      endif
+
+      if (nargin < 2)
+        type = "auto";
+      endif
+
+      if (! (isnumeric (A) || islogical (A)) || ndims (A) != 2)
+        error ("decomposition: A must be a 2-D numeric matrix");
+      endif
+      if (! ischar (type))
+        error ("decomposition: TYPE must be a string");
+      endif
+
+      type = tolower (type);
+      if (! any (strcmp (type, {"auto", "chol", "lu", "qr"})))
+        error ("decomposition: unknown TYPE '%s'", type);
+      endif
+
+      if (! isfloat (A))
+        A = double (A);
+      endif
+
+      [m, n] = size (A);
+      fallback = strcmp (type, "auto");
+      if (fallback)
+        if (m != n)
+          type = "qr";
+        elseif (ishermitian (A) && all (real (diag (A)) > 0))
+          type = "chol";
+        else
+          type = "lu";
+        endif
+      elseif (m != n && ! strcmp (type, "qr"))
+        error ("decomposition: TYPE '%s' requires a square matrix", type);
+      endif
+
+      this.Type = type;
+      this.MatrixSize = [m, n];
+      this.IsSparse = issparse (A);
+      this = factorize (this, A, fallback);
+
+    endfunction
+
+    function this = refactor (this, A)
+
+      ## -*- texinfo -*-
+      ## @deftypefn {} {@var{dA} =} refactor (@var{dA}, @var{A})
+      ## Factorize the matrix @var{A} using the same type as @var{dA}.
+      ##
+      ## @var{A} must have the same size as the matrix originally used to
+      ## create @var{dA}.  For sparse matrices, the fill-reducing ordering of
+      ## @var{dA} is reused, so that only the numerical factorization is
+      ## recomputed.  The ordering remains valid for any sparsity pattern, but
+      ## it is only effective if the pattern of @var{A} is unchanged.
+      ## @end deftypefn
+
+      if (nargin != 2)
+        print_usage ();
+      endif
+
+      if (! (isnumeric (A) || islogical (A)) || ! isequal (size (A), this.MatrixSize))
+        error ("decomposition: A must be a numeric matrix of size %dx%d",
+               this.MatrixSize(1), this.MatrixSize(2));
+      endif
+      if (issparse (A) != this.IsSparse)
+        error ("decomposition: A must be sparse if and only if the original matrix was");
+      endif
+
+      if (! isfloat (A))
+        A = double (A);
+      endif
+
+      if (! this.IsSparse)
+        this = factorize (this, A, false);
+        return;
+      endif
+
+      switch (this.Type)
+        case "chol"
+          [R, err] = chol (A(this.q, this.q));
+          if (err != 0)
+            error ("decomposition: A must be Hermitian positive definite for TYPE 'chol'");
+          endif
+          this.R = R;
+          this.L = matrix_type (R', "lower");
+
+        case "lu"
+          ## With a fixed column ordering, UMFPACK only performs the numerical
+          ## factorization with partial row pivoting.
+          warning ("off", "Octave:lu:sparse_input", "local");
+          [L, U, p] = lu (A(:, this.q), "vector");
+          this.L = matrix_type (L, "lower");
+          this.U = matrix_type (U, "upper");
+          this.p = p;
+          this.S = [];
+
+        case "qr"
+          if (! this.tall)
+            A = A';
+          endif
+          this.W = A(:, this.q);
+          this.R = matrix_type (qr (this.W, 0), "upper");
+          this.L = matrix_type (this.R', "lower");
+      endswitch
+
+    endfunction
+
+    function x = mldivide (this, b)
+
+      ## -*- texinfo -*-
+      ## @deftypefn {} {@var{x} =} mldivide (@var{dA}, @var{b})
+      ## Solve @code{@var{A} * @var{x} = @var{b}} using the factorization
+      ## stored in @var{dA}.
+      ## @end deftypefn
+
+      if (! isa (this, "decomposition"))
+        error ("decomposition: a decomposition object can only appear as the left operand of '\\'");
+      endif
+      if (! (isnumeric (b) || islogical (b)))
+        error ("decomposition: B must be numeric");
+      endif
+      if (rows (b) != this.MatrixSize(1))
+        error ("decomposition: nonconformant arguments (op1 is %dx%d, op2 is %dx%d)",
+               this.MatrixSize(1), this.MatrixSize(2), rows (b), columns (b));
+      endif
+
+      x = solve (this, b, false);
+
+    endfunction
+
+    function x = mrdivide (b, this)
+
+      ## -*- texinfo -*-
+      ## @deftypefn {} {@var{x} =} mrdivide (@var{b}, @var{dA})
+      ## Solve @code{@var{x} * @var{A} = @var{b}} using the factorization
+      ## stored in @var{dA}.
+      ## @end deftypefn
+
+      if (! isa (this, "decomposition"))
+        error ("decomposition: a decomposition object can only appear as the right operand of '/'");
+      endif
+      if (! (isnumeric (b) || islogical (b)))
+        error ("decomposition: B must be numeric");
+      endif
+      if (columns (b) != this.MatrixSize(2))
+        error ("decomposition: nonconformant arguments (op1 is %dx%d, op2 is %dx%d)",
+               rows (b), columns (b), this.MatrixSize(1), this.MatrixSize(2));
+      endif
+
+      x = solve (this, b', true)';
+
+    endfunction
+
+    function varargout = size (this, varargin)
+
+      ## -*- texinfo -*-
+      ## @deftypefn {} {@var{sz} =} size (@var{dA}, @dots{})
+      ## Return the size of the factorized matrix.  Additional arguments are
+      ## interpreted as for the built-in @code{size} function.
+      ## @end deftypefn
+
+      [varargout{1:max (nargout, 1)}] ...
+        = size (sparse (this.MatrixSize(1), this.MatrixSize(2)), varargin{:});
+
+    endfunction
+
+    function disp (this)
+      printf ("  decomposition object with properties:\n\n");
+      printf (["    Type       : %s\n" ...
+               "    MatrixSize : [%d %d]\n" ...
+               "    IsSparse   : %d\n\n"],
+               this.Type, this.MatrixSize, this.IsSparse);
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    function this = factorize (this, A, fallback)
+
+      [m, n] = size (A);
+
+      switch (this.Type)
+        case "chol"
+          if (this.IsSparse)
+            [R, err, q] = chol (A, "vector");
+          else
+            [R, err] = chol (A);
+            q = [];
+          endif
+          if (err != 0)
+            if (fallback)
+              this.Type = "lu";
+              this = factorize (this, A, false);
+              return;
+            endif
+            error ("decomposition: A must be Hermitian positive definite for TYPE 'chol'");
+          endif
+          this.R = R;
+          this.q = q;
+          if (this.IsSparse)
+            this.L = matrix_type (R', "lower");
+          endif
+
+        case "lu"
+          if (this.IsSparse)
+            [L, U, p, q, S] = lu (A, "vector");
+            this.q = q;
+            this.S = S;
+          else
+            [L, U, p] = lu (A, "vector");
+          endif
+          this.L = matrix_type (L, "lower");
+          this.U = matrix_type (U, "upper");
+          this.p = p;
+
+        case "qr"
+          ## Always factorize the tall one of A and A'.
+          this.tall = (m >= n);
+          if (! this.tall)
+            A = A';
+          endif
+          if (this.IsSparse)
+            this.q = colamd (A);
+            this.W = A(:, this.q);
+            this.R = matrix_type (qr (this.W, 0), "upper");
+            this.L = matrix_type (this.R', "lower");
+          else
+            [Q, R, P] = qr (A, "econ");
+            [p, ~] = find (P);
+            this.p = p;
+            this.Q = Q;
+            this.R = matrix_type (R, "upper");
+          endif
+      endswitch
+
+    endfunction
+
+    ## Solve A*x = b, or A'*x = b if HERM is true.
+    function x = solve (this, b, herm)
+
+      if (! isfloat (b))
+        b = double (b);
+      endif
+
+      switch (this.Type)
+        case "chol"
+          ## A is Hermitian, so HERM makes no difference.
+          if (this.IsSparse)
+            x = this.R \ (this.L \ b(this.q, :));
+            x(this.q, :) = x;
+          else
+            x = this.R \ (this.R' \ b);
+          endif
+
+        case "lu"
+          ## Dense: A(p,:) = L*U.  Sparse: (S\A)(p,q) = L*U.
+          if (! herm)
+            if (! isempty (this.S))
+              b = this.S \ b;
+            endif
+            x = this.U \ (this.L \ b(this.p, :));
+            if (this.IsSparse)
+              x(this.q, :) = x;
+            endif
+          else
+            if (this.IsSparse)
+              b = b(this.q, :);
+            endif
+            x = this.L' \ (this.U' \ b);
+            x(this.p, :) = x;
+            if (! isempty (this.S))
+              x = this.S \ x;
+            endif
+          endif
+
+        case "qr"
+          ## The factorized matrix W is A if "tall", A' otherwise.  Solving
+          ## with W is a least squares problem and solving with W' is a
+          ## minimum norm problem.
+          if (herm == ! this.tall)
+            x = lsq_solve (this, b);
+          else
+            x = min_norm_solve (this, b);
+          endif
+      endswitch
+
+    endfunction
+
+    ## Least squares solution of W*x = b with W(:,p) = Q*R, or for sparse
+    ## matrices the corrected seminormal equations with W(:,q)'*W(:,q) = R'*R.
+    function x = lsq_solve (this, b)
+
+      if (this.IsSparse)
+        x = this.R \ (this.L \ (this.W' * b));
+        r = b - this.W * x;
+        x += this.R \ (this.L \ (this.W' * r));
+        x(this.q, :) = x;
+      else
+        x = this.R \ (this.Q' * b);
+        x(this.p, :) = x;
+      endif
+
+    endfunction
+
+    ## Minimum norm solution of W'*x = b.
+    function x = min_norm_solve (this, b)
+
+      if (this.IsSparse)
+        b = b(this.q, :);
+        x = this.W * (this.R \ (this.L \ b));
+        r = b - this.W' * x;
+        x += this.W * (this.R \ (this.L \ r));
+      else
+        x = this.Q * (this.R' \ b(this.p, :));
+      endif
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared A, B, b
+%! A = [4, 1, 0; 1, 3, 1; 0, 1, 2];
+%! B = [1, 2, 0; 3, 1, 4; 0, 5, 1];
+%! b = [1, 2; 3, 4; 5, 6];
+
+%!test
+%! dA = decomposition (A);
+%! assert (dA.Type, "chol");
+%! assert (dA.MatrixSize, [3, 3]);
+%! assert (dA.IsSparse, false);
+%! assert (dA \ b, A \ b, 10*eps);
+%! assert (b' / dA, b' / A, 10*eps);
+
+%!test
+%! dB = decomposition (B);
+%! assert (dB.Type, "lu");
+%! assert (dB \ b, B \ b, 10*eps);
+%! assert (b' / dB, b' / B, 10*eps);
+%! assert (size (dB), [3, 3]);
+%! assert (size (dB, 2), 3);
+
+%!test
+%! C = B + 1i*A;
+%! dC = decomposition (C, "lu");
+%! assert (dC \ b, C \ b, 10*eps);
+%! assert (b' / dC, b' / C, 10*eps);
+
+%!test
+%! ## Not positive definite: "auto" falls back to LU.
+%! dA = decomposition (-A);
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, -A \ b, 10*eps);
+
+%!test
+%! M = [B; 1, 1, 1; 2, 0, 1];
+%! dM = decomposition (M);
+%! assert (dM.Type, "qr");
+%! c = [b; 7, 8; 9, 10];
+%! assert (dM \ c, M \ c, 100*eps);
+%! assert (b' / dM, b' / M, 100*eps);
+%! assert (c' / decomposition (M'), c' / M', 100*eps);
+%! assert (decomposition (M') \ b, M' \ b, 100*eps);
+
+%!test
+%! dA = decomposition (single (A));
+%! assert (class (dA \ b), "single");
+%! assert (dA \ b, single (A) \ b, 10*eps ("single"));
+
+%!test
+%! dA = refactor (decomposition (A), 2*A);
+%! assert (dA.Type, "chol");
+%! assert (dA \ b, (2*A) \ b, 10*eps);
+
+%!testif HAVE_CHOLMOD
+%! n = 50;
+%! S = spdiags ([-ones(n,1), 4*ones(n,1), -ones(n,1)], -1:1, n, n);
+%! S(1,n) = S(n,1) = -1;
+%! c = (1:n)';
+%! dS = decomposition (S);
+%! assert (dS.Type, "chol");
+%! assert (dS.IsSparse, true);
+%! assert (dS \ c, S \ c, 1e-12);
+%! dS = refactor (dS, S + speye (n));
+%! assert (dS \ c, (S + speye (n)) \ c, 1e-12);
+
+%!testif HAVE_UMFPACK
+%! n = 50;
+%! S = spdiags ([-2*ones(n,1), 4*ones(n,1), -ones(n,1)], -1:1, n, n);
+%! S(1,n) = 1;
+%! c = [(1:n)', ones(n, 1)];
+%! dS = decomposition (S);
+%! assert (dS.Type, "lu");
+%! assert (dS \ c, S \ c, 1e-12);
+%! assert (c' / dS, c' / S, 1e-12);
+%! S2 = S;
+%! S2(1,n) = 3;
+%! dS = refactor (dS, S2);
+%! assert (dS \ c, S2 \ c, 1e-12);
+%! assert (c' / dS, c' / S2, 1e-12);
+
+%!testif HAVE_COLAMD, HAVE_SPQR, HAVE_CHOLMOD
+%! S = sparse ([1, 0, 2; 0, 3, 0; 4, 0, 5; 0, 6, 1; 1, 1, 1]);
+%! c = (1:5)';
+%! dS = decomposition (S);
+%! assert (dS.Type, "qr");
+%! assert (dS \ c, full (S) \ c, 1e-12);
+%! assert (c(1:3)' / dS, c(1:3)' / full (S), 1e-12);
+%! dS = refactor (dS, 2*S);
+%! assert (dS \ c, full (2*S) \ c, 1e-12);
+
+## Test input validation
+%!error <A must be a 2-D numeric matrix> decomposition ({1})
+%!error <TYPE must be a string> decomposition (A, 1)
+%!error <unknown TYPE 'ldl'> decomposition (A, "ldl")
+%!error <requires a square matrix> decomposition ([1, 2], "lu")
+%!error <Hermitian positive definite> decomposition (B - 10*eye (3), "chol")
+%!error <nonconformant arguments> decomposition (A) \ [1; 2]
+%!error <nonconformant arguments> [1, 2] / decomposition (A)
+%!error <must be a numeric matrix of size 3x3> refactor (decomposition (A), eye (2))
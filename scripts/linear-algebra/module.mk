@@ -8,6 +8,7 @@ FCN_FILE_DIRS += %reldir%
   %reldir%/condeig.m \
   %reldir%/condest.m \
   %reldir%/cross.m \
+  %reldir%/decomposition.m \
   %reldir%/duplication_matrix.m \
   %reldir%/expm.m \
   %reldir%/gls.m \
@@ -78,7 +78,6 @@ function [c, ia, ib] = intersect (a, b, varargin)
   endif
 
   by_rows = any (strcmp ("rows", varargin));
-  optsorted = ! any (strcmp ("stable", varargin));
   optlegacy = any (strcmp ("legacy", varargin));
 
   if (optlegacy)
@@ -87,72 +86,39 @@ function [c, ia, ib] = intersect (a, b, varargin)
     isrowvec = isrow (a) && isrow (b);
   endif
 
-  ## Form A and B into sets
-  if (nargout > 1 || ! optsorted)
+  ## Form A into a set, in the requested order, and keep the elements
+  ## that are found in B.  B only needs to be a set for its indices.
+  if (nargout > 1)
     [a, ia] = unique (a, varargin{:});
-    ia = ia(:);
     [b, ib] = unique (b, varargin{:});
-    ib = ib(:);
   else
     a = unique (a, varargin{:});
-    b = unique (b, varargin{:});
   endif
 
   if (by_rows)
-    c = [a; b];
-    if (nargout > 1 || ! optsorted)
-      [c, ic] = sortrows (c);
-    else
-      c = sortrows (c);
-    endif
-    match = find (all (c(1:end-1,:) == c(2:end,:), 2));
-    if (optsorted)
-      c = c(match, :);
-    else
-      c = [a; b];
-      ## FIXME: Is there a way to avoid a call to sort?
-      [c_idx, sort_idx] = sort (ic(match));
-      c = c(c_idx, :);
-    endif
-    len_a = rows (a);
+    [tf, loc] = ismember (a, b, "rows");
+    c = a(tf,:);
   else
-    c = [a(:); b(:)];
-    if (nargout > 1 || ! optsorted)
-      [c, ic] = sort (c);
-    else
-      c = sort (c);
-    endif
-    if (iscellstr (c))
-      match = find (strcmp (c(1:end-1), c(2:end)));
-    else
-      match = find (c(1:end-1) == c(2:end));
-    endif
-    len_a = length (a);
-    if (optsorted)
-      c = c(match);
-    else
-      c = [a(:); b(:)];
-      ## FIXME: Is there a way to avoid a call to sort?
-      [c_idx, sort_idx] = sort (ic(match));
-      c = c(c_idx);
-    endif
+    [tf, loc] = ismember (a(:), b(:));
+    c = a(tf);
+    c = c(:);
+  endif
 
-    ## Adjust output orientation for Matlab compatibility
-    if (isrowvec)
-      c = c.';
-    endif
+  if (! strcmp (class (a), class (b)))
+    ## Use the class that the concatenation of A and B would have.
+    c = [c; b([])];
+  endif
+
+  ## Adjust output orientation for Matlab compatibility
+  if (isrowvec && ! by_rows)
+    c = c.';
   endif
 
   if (nargout > 1)
-    ia = ia(ic(match));            # a(ia) == c
-    ib = ib(ic(match+1) - len_a);  # b(ib) == c
-    if (! optsorted)
-      ## FIXME: Is there a way to avoid a call to sort?
-      ia = sort (ia);
-      ib_ind(sort_idx) = 1:numel(sort_idx);
-      ## Change ordering to conform to unsorted c
-      ib(ib_ind) = ib;
-    endif
+    ia = ia(:);
+    ia = ia(tf);                 # a(ia) == c
+    ib = ib(:);
+    ib = ib(loc(tf));            # b(ib) == c
     if (optlegacy && isrowvec && ! by_rows)
       ia = ia.';
       ib = ib.';
@@ -276,6 +242,30 @@ endfunction
 %! assert (ia, [4; 5]);
 %! assert (ib, [1; 2]);
 
+## Cell arrays of strings, mixed classes, and integers of small range
+%!test
+%! a = {"e", "b", "a", "b", "d"};
+%! b = {"e", "c", "b"};
+%! [c, ia, ib] = intersect (a, b);
+%! assert (c, {"b", "e"});
+%! assert (ia, [2; 1]);
+%! assert (ib, [3; 1]);
+%! [c, ia, ib] = intersect (a, b, "stable");
+%! assert (c, {"e", "b"});
+%! assert (ia, [1; 2]);
+%! assert (ib, [1; 3]);
+
+%!assert (intersect (int8 ([1, 2, 3]), [2, 3, 4]), int8 ([2, 3]))
+%!assert (intersect (single ([1; 2]), [2, 3]), single (2))
+
+%!test
+%! a = int32 (mod ((1:10000) * 7, 1000));
+%! b = int32 (500:1500);
+%! [c, ia, ib] = intersect (a, b);
+%! assert (c, int32 (500:999));
+%! assert (a(ia), c);
+%! assert (b(ib), c);
+
 ## Test orientation of output
 %!shared a,b
 %! a = 1:4;
@@ -124,7 +124,14 @@ function [tf, s_idx] = ismember (a, s, varargin)
   ## FIXME: uncomment if bug #56692 is addressed.
   ## optlegacy = any (strcmp ("legacy", varargin));
 
-  if (! by_rows)
+  if (! issparse (a) && ! issparse (s) && strcmp (class (a), class (s))
+      && iscellstr (a) == iscellstr (s)
+      && (! by_rows || columns (a) == columns (s)))
+    ## Look up the elements or rows with a direct-address table or a hash
+    ## table built from S, without sorting.
+    [tf, s_idx] = __ismember__ (a, s, by_rows);
+
+  elseif (! by_rows)
     s = s(:);
     ## Check sort status, because we expect the array will often be sorted.
     if (issorted (s))
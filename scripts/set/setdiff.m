@@ -77,14 +77,11 @@ function [c, ia] = setdiff (a, b, varargin)
       c = unique (a, varargin{:});
     endif
     if (! isempty (c) && ! isempty (b))
-      ## Form A and B into combined set.
-      b = unique (b, varargin{:});
-      [csort, idx] = sortrows ([c; b]);
-      ## Eliminate those elements of A that are the same as in B.
-      dups = find (all (csort(1:end-1,:) == csort(2:end,:), 2));
-      c(idx(dups),:) = [];
+      ## Eliminate those rows of A that are also in B.
+      dups = ismember (c, b, "rows");
+      c(dups,:) = [];
       if (nargout > 1)
-        ia(idx(dups),:) = [];
+        ia(dups,:) = [];
       endif
     endif
   else
@@ -94,16 +91,9 @@ function [c, ia] = setdiff (a, b, varargin)
       c = unique (a, varargin{:});
     endif
     if (! isempty (c) && ! isempty (b))
-      ## Form a and b into combined set.
-      b = unique (b);
-      [csort, idx] = sort ([c(:); b(:)]);
-      ## Eliminate those elements of a that are the same as in b.
-      if (iscellstr (csort))
-        dups = find (strcmp (csort(1:end-1), csort(2:end)));
-      else
-        dups = find (csort(1:end-1) == csort(2:end));
-      endif
-      c(idx(dups)) = [];
+      ## Eliminate those elements of A that are also in B.
+      dups = ismember (c, b);
+      c(dups) = [];
 
       ## Reshape if necessary for Matlab compatibility.
       if (isrowvec)
@@ -113,7 +103,7 @@ function [c, ia] = setdiff (a, b, varargin)
       endif
 
       if (nargout > 1)
-        ia(idx(dups)) = [];
+        ia(dups) = [];
         if (optlegacy && isrowvec)
           ia = ia(:).';
         endif
@@ -65,6 +65,7 @@ function [y, ia, ib] = union (a, b, varargin)
   [a, b] = validsetargs ("union", a, b, varargin{:});
 
   by_rows = any (strcmp ("rows", varargin));
+  optstable = any (strcmp ("stable", varargin));
   optlegacy = any (strcmp ("legacy", varargin));
 
   if (optlegacy)
@@ -73,27 +74,71 @@ function [y, ia, ib] = union (a, b, varargin)
     isrowvec = isrow (a) && isrow (b);
   endif
 
-  if (by_rows)
-    y = [a; b];
+  ## Form both inputs into sets and add the elements of the second set
+  ## that are not in the first.  Common elements are taken from A, or
+  ## from B for "legacy".
+  if (optlegacy)
+    [p, q] = deal (b, a);
   else
-    y = [a(:); b(:)];
-    ## Adjust output orientation for Matlab compatibility
-    if (isrowvec)
-      y = y.';
-    endif
+    [p, q] = deal (a, b);
   endif
 
-  if (nargout <= 1)
-    y = unique (y, varargin{:});
+  if (nargout > 1)
+    [p, ip] = unique (p, varargin{:});
+    [q, iq] = unique (q, varargin{:});
   else
-    [y, idx] = unique (y, varargin{:});
+    p = unique (p, varargin{:});
+    q = unique (q, varargin{:});
+  endif
+
+  if (by_rows)
+    if (isempty (p) || isempty (q))
+      keep = true (rows (q), 1);
+    else
+      keep = ! ismember (q, p, "rows");
+    endif
+    y = [p; q(keep,:)];
+  else
+    q = q(:);
+    keep = ! ismember (q, p(:));
+    y = [p(:); q(keep)];
+  endif
+
+  if (! optstable)
+    ## The elements are distinct, so this only sorts them.
     if (by_rows)
-      na = rows (a);
+      [y, idx] = unique (y, "rows");
     else
-      na = numel (a);
+      [y, idx] = unique (y);
+    endif
+  endif
+
+  ## Adjust output orientation for Matlab compatibility
+  if (isrowvec && ! by_rows)
+    y = y.';
+  endif
+
+  if (nargout > 1)
+    ip = ip(:);
+    iq = iq(:);
+    iq = iq(keep);
+    if (! optstable)
+      ## Indices in the order of the elements of Y.
+      idx = idx(:);
+      np = numel (ip);
+      from_p = (idx <= np);
+      ip = ip(idx(from_p));
+      iq = iq(idx(! from_p) - np);
+    endif
+    if (optlegacy)
+      [ia, ib] = deal (iq, ip);
+    else
+      [ia, ib] = deal (ip, iq);
+    endif
+    if (optlegacy && isrowvec && ! by_rows)
+      ia = ia.';
+      ib = ib.';
     endif
-    ia = idx(idx <= na);
-    ib = idx(idx > na) - na;
   endif
 
 endfunction
@@ -179,6 +224,22 @@ endfunction
 %! assert (ia, [1; 3]);
 %! assert (ib, [1; 2; 3]);
 
+## Cell arrays of strings and mixed classes
+%!test
+%! a = {"e", "b", "a", "b"};
+%! b = {"c", "b", "f"};
+%! [y, ia, ib] = union (a, b);
+%! assert (y, {"a", "b", "c", "e", "f"});
+%! assert (ia, [3; 2; 1]);
+%! assert (ib, [1; 3]);
+%! [y, ia, ib] = union (a, b, "stable");
+%! assert (y, {"e", "b", "a", "c", "f"});
+%! assert (ia, [1; 2; 3]);
+%! assert (ib, [1; 3]);
+
+%!assert (union (int8 ([1, 2]), [2, 3]), int8 ([1, 2, 3]))
+%!assert (union ([1, NaN], [NaN, 2]), [1, 2, NaN, NaN])
+
 ## Test orientation of output
 %!shared x,y
 %! x = 1:3;
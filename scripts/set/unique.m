@@ -183,6 +183,25 @@ function [y, i, j] = unique (x, varargin)
     return;
   endif
 
+  if (! issparse (x))
+    ## Group the elements or rows with a direct-address table, a hash
+    ## table, or a sort, whichever suits the data best.
+    if (nargout > 1)
+      [y, i, j] = __unique__ (x, optrows, ! optsorted,
+                              optlegacy || ! optfirst);
+      if (optlegacy && isrowvec)
+        i = i.';
+        j = j.';
+      endif
+    else
+      y = __unique__ (x, optrows, ! optsorted, false);
+    endif
+    if (isrowvec)
+      y = y.';
+    endif
+    return;
+  endif
+
   ## Calculate y output
   if (optrows)
     if (nargout > 1 || ! optsorted)
@@ -423,6 +423,32 @@ function y = movfun (fcn, x, wlen, varargin)
     endswitch
   endif
 
+  ## Common statistics have built-in kernels instead of applying FCN to a
+  ## copy of every window.  They take sums, variances, maxima, and minima
+  ## from prefix and suffix scans of blocks of the window length, and keep
+  ## medians in two sets that are updated as the window moves.
+  if (sp.standard && (isempty (outdim) || isequal (outdim, 1))
+      && isfloat (x) && isreal (x) && ! issparse (x)
+      && (ischar (bc) || (isreal (bc) && ! issparse (bc))))
+    op = func2str (fcn);
+    if (any (strcmp (op, {"sum", "mean", "var", "std", "max", "min", "median"})))
+      if (ischar (bc))
+        bc = lower (bc);
+        if (strcmp (bc, "fill"))
+          bc = NaN;
+        endif
+      else
+        bc = double (bc);
+      endif
+      y = __movfun__ (op, x, wlen(1), wlen(2), bc, omitnan, nanval);
+      y = ipermute (reshape (y, szx(dperm)), dperm);
+      if (! isempty (y))
+        y = squeeze (y);
+      endif
+      return;
+    endif
+  endif
+
   ## Validate that outdim makes sense.
   ## Check fcn ouptut for data sampled from x.  See bug #55984.
   if (! sp.apply)
@@ -1707,6 +1733,28 @@ endfunction
 %!assert <66156> (movfun (@sum, 1:10, 5, "samplepoints", [1:3, 9, 14, 17, 20, 28:30]), [6, 6, 6, 4, 5, 6, 7, 27, 27, 27])
 
 
+## Built-in kernels agree with applying FCN to each window
+%!test
+%! x = [1, NaN, 3; 4, 5, -6; NaN, 8, 9; 10, 11, 2; -1, 0, NaN; 7, 7, 7];
+%! x = [x; 2*x(end:-1:1,:)];
+%! fcns = {@sum, @mean, @var, @std, @max, @min, @median};
+%! bcs = {"shrink", "discard", "fill", "same", "periodic", -2};
+%! for i = 1:numel (fcns)
+%!   fcn = fcns{i};
+%!   for j = 1:numel (bcs)
+%!     for nancond = {"includenan", "omitnan"}
+%!       for wlen = {3, 4, [2, 0], [0, 3]}
+%!         y = movfun (fcn, x, wlen{1}, "endpoints", bcs{j},
+%!                     "nancond", nancond{1});
+%!         yref = movfun (@(w) fcn (w), x, wlen{1}, "endpoints", bcs{j},
+%!                        "nancond", nancond{1});
+%!         assert (y, yref, 1e-10);
+%!       endfor
+%!     endfor
+%!   endfor
+%! endfor
+
+
 ## Test input validation
 %!error <Invalid call> movfun ()
 %!error <Invalid call> movfun (@min)
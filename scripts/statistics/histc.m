@@ -152,19 +152,14 @@ function [n, idx] = histc (x, edges, dim)
 
     iidx = idx;
 
-    ## In case of matrix input, we adjust the indices.
-    if (! isvector (x))
-      nl = prod (sz(1:dim-1));
-      nn = sz(dim);
-      nu = prod (sz(dim+1:end));
-      if (nl != 1)
-        iidx = (iidx-1) * nl;
-        iidx += reshape (kron (ones (1, nn*nu), 1:nl), sz);
-      endif
-      if (nu != 1)
-        ne =length (edges);
-        iidx += reshape (kron (nl*ne*(0:nu-1), ones (1, nl*nn)), sz);
-      endif
+    ## Unless X is a vector along DIM, convert the bin numbers to linear
+    ## indices into N.
+    nl = prod (sz(1:dim-1));
+    nn = sz(dim);
+    nu = prod (sz(dim+1:end));
+    if (nl != 1 || nu != 1)
+      iidx = ((reshape (iidx, nl, nn, nu) - 1) * nl + (1:nl).'
+              + reshape (nl*num_edges*(0:nu-1), 1, 1, nu));
     endif
 
     ## Select valid elements.
@@ -188,6 +183,13 @@ endfunction
 %! n = histc (x, 0:10, 2);
 %! assert (n, repmat ([repmat(100, 1, 10), 1], [2, 1, 3]));
 
+%!test
+%! x = [0.5, 2, 7; 3, NaN, 9; -1, 4, 4; 10, 2.5, 1];
+%! [n, idx] = histc (x, [0, 2, 4, 6, 8, 10], 2);
+%! assert (n, [1, 1, 0, 1, 0, 0; 0, 1, 0, 0, 1, 0; 0, 0, 2, 0, 0, 0;
+%!             1, 1, 0, 0, 0, 1]);
+%! assert (idx, [1, 2, 4; 2, 0, 5; 0, 3, 3; 6, 2, 1]);
+
 ## Test input validation
 %!error <Invalid call> histc ()
 %!error <Invalid call> histc (1)
@@ -320,52 +320,39 @@ function m = median (x, varargin)
     omitnan = false;
   endif
 
-  x = sort (x, dim); # Note: pushes any NaN's to end for omitnan compatibility
+  ## Select the one or two middle elements of each column instead of sorting
+  ## the whole column.  Like sort, __nth_element__ places any NaNs last.
+  isvec = isvector (x);
+  if (isvec)
+    x = x(:);
+  else
+    x = reshape (x, szx(1), []);
+  endif
 
   if (omitnan)
     ## Ignore any NaN's in data.  Each operating vector might have a
     ## different number of non-NaN data points.
+    n = sum (! isnan (x), 1);
+    k = floor ((n + 1) / 2);
+    xk = __nth_element__ (x, min (max ([k; k + 1], 1), rows (x)));
 
-    if (isvector (x))
-      ## Checks above ensure either dim1 or dim2 vector
-      x = x(! isnan (x));
-      n = numel (x);
-      k = floor ((n + 1) / 2);
+    if (isvec)
       if (mod (n, 2))
         ## odd
-        m = x(k);
+        m = xk(1);
       else
         ## even
-        m = (x(k) + x(k + 1)) / 2;
+        m = (xk(1) + xk(2)) / 2;
       endif
 
     else
-      ## Each column may have a different n and k.  Force index column vector
-      ## for consistent orientation for 2D and nD inputs, then use sub2ind to
-      ## get correct element(s) for each column.
-
-      n = sum (! isnan (x), 1)(:);
-      k = floor ((n + 1) / 2);
       m_idx_odd = mod (n, 2) & n;
       m_idx_even = (! m_idx_odd) & n;
 
       m = NaN ([1, szx(2 : end)]);
 
-      if (ndims (x) > 2)
-        szx = [szx(1), prod(szx(2 : end))];
-      endif
-
-      ## Grab kth value, k possibly different for each column
-      if (any (m_idx_odd))
-        x_idx_odd = sub2ind (szx, k(m_idx_odd), find (m_idx_odd));
-        m(m_idx_odd) = x(x_idx_odd);
-      endif
-      if (any (m_idx_even))
-        k_even = k(m_idx_even);
-        x_idx_even = sub2ind (szx, [k_even, k_even + 1], ...
-                                (find (m_idx_even))(:, [1, 1]));
-        m(m_idx_even) = sum (x(x_idx_even), 2) / 2;
-      endif
+      m(m_idx_odd) = xk(1, m_idx_odd);
+      m(m_idx_even) = (xk(1, m_idx_even) + xk(2, m_idx_even)) / 2;
     endif
 
   else
@@ -375,19 +362,20 @@ function m = median (x, varargin)
       m = NaN (sz_out);
 
     else
-      if (isvector (x))
-        n = numel (x);
-        k = floor ((n + 1) / 2);
+      n = rows (x);
+      k = floor ((n + 1) / 2);
+      xk = __nth_element__ (x, [k; k + 1]);
 
-        m = x(k);
+      if (isvec)
+        m = xk(1);
         if (! mod (n, 2))
           ## Even
-          if (any (isinf ([x(k), x(k+1)])))
+          m2 = xk(2);
+          if (isinf (m) || isinf (m2))
             ## If either center value is Inf, replace m by +/-Inf or NaN.
-            m = x(k) + x(k+1);
-          elseif (any (isa (x, "integer")))
+            m += m2;
+          elseif (isa (x, "integer"))
             ## avoid int overflow issues
-            m2 = x(k + 1);
             if (sign (m) != sign (m2))
               m += m2;
               m /= 2;
@@ -395,15 +383,12 @@ function m = median (x, varargin)
               m += (m2 - m) / 2;
             endif
           else
-            m += (x(k + 1) - m) / 2;
+            m += (m2 - m) / 2;
           endif
         endif
 
       else
         ## Nonvector, all operations were permuted to be along dim 1
-        n = szx(1);
-        k = floor ((n + 1) / 2);
-
         if (isfloat (x))
           m = NaN ([1, szx(2 : end)]);
         else
@@ -412,28 +397,27 @@ function m = median (x, varargin)
 
         if (! mod (n, 2))
           ## Even
-          if (any (isa (x, "integer")))
+          if (isa (x, "integer"))
             ## avoid int overflow issues
 
             ## Use flattened index to simplify N-D operations
-            m(1, :) = x(k, :);
-            m2 = x(k + 1, :);
+            m(1, :) = xk(1, :);
+            m2 = xk(2, :);
 
             samesign = prod (sign ([m(1, :); m2]), 1) == 1;
             m(1, :) = samesign .* m(1, :) + ...
                        (m2 + !samesign .* m(1, :) - samesign .* m(1, :)) / 2;
 
           else
-            m(nanfree) = (x(k, nanfree) + x(k + 1, nanfree)) / 2;
+            m(nanfree) = (xk(1, nanfree(:)) + xk(2, nanfree(:))) / 2;
           endif
         else
           ## Odd.  Use flattened index to simplify N-D operations
-          m(nanfree) = x(k, nanfree);
+          m(nanfree) = xk(1, nanfree(:));
         endif
       endif
     endif
   endif
-
   if (perm_flag)
     ## Inverse permute back to correct dimensions
     m = ipermute (m, perm);
@@ -737,6 +721,21 @@ endfunction
 %!assert <*54567> (median ([intmax("uint64"), intmax("uint64")-2], "native"), ...
 %!                 intmax ("uint64")-1)
 
+## Test selection against sorting for wide arrays with scattered NaNs
+%!test
+%! x = rand (99, 40, 3);
+%! x(rand (size (x)) < 0.1) = NaN;
+%! s = sort (x);
+%! n = sum (! isnan (x));
+%! k = floor ((n + 1) / 2);
+%! m = NaN (size (n));
+%! for j = 1:numel (n)
+%!   m(j) = (s(k(j),j) + s(n(j)+1-k(j),j)) / 2;
+%! endfor
+%! assert (median (x, "omitnan"), m, eps);
+%! m(any (isnan (x))) = NaN;
+%! assert (median (x), m, eps);
+
 ## Test input case insensitivity
 %!assert (median ([1 2 3], "aLL"), 2)
 %!assert (median ([1 2 3], "OmitNan"), 2)
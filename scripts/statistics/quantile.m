@@ -386,6 +386,24 @@ endfunction
 %!assert <*54421> (quantile ([1:10], [0.25, 0.75]'), [3; 8])
 %!assert (quantile ([1:10], 1, 3), [1:10])
 
+%!test
+%! x = randn (50, 20);
+%! x(rand (size (x)) < 0.2) = NaN;
+%! x(:,3) = NaN;
+%! x(2:end,4) = NaN;
+%! p = [0, 0.1, 0.25, 0.5, 0.9, 1];
+%! for method = 1:9
+%!   q = quantile (x, p, 1, method);
+%!   for j = 1:columns (x)
+%!     xj = x(! isnan (x(:,j)), j);
+%!     if (isempty (xj))
+%!       assert (all (isnan (q(:,j))));
+%!     else
+%!       assert (q(:,j), quantile (xj, p(:), 1, method), eps);
+%!     endif
+%!   endfor
+%! endfor
+
 ## Test input validation
 %!error <Invalid call> quantile ()
 %!error quantile (['A'; 'B'], 10)
@@ -417,8 +435,9 @@ function inv = __quantile__ (x, p, method = 5)
   ## set shape of quantiles to column vector.
   p = p(:);
 
-  ## Save length and set shape of samples.
-  x = sort (x, 1);
+  ## Save length and set shape of samples.  Rather than sorting X, the
+  ## order statistics needed for all of P are selected from each column at
+  ## once by __nth_element__, which like sort places any NaNs last.
   m = sum (! isnan (x));
   [xr, xc] = size (x);
 
@@ -436,28 +455,27 @@ function inv = __quantile__ (x, p, method = 5)
       return;
     endif
 
-    ## The column-distribution indices.
-    pcd = kron (ones (n, 1), xr*(0:xc-1));
     mm = kron (ones (n, 1), m);
     switch (method)
       case {1, 2, 3}
         switch (method)
           case 1
             p = max (ceil (kron (p, m)), 1);
-            inv(k,:) = x(p + pcd);
+            inv(k,:) = __nth_element__ (x, p);
 
           case 2
             p = kron (p, m);
             p_lr = max (ceil (p), 1);
-            p_rl = min (floor (p + 1), mm);
-            inv(k,:) = (x(p_lr + pcd) + x(p_rl + pcd))/2;
+            p_rl = max (min (floor (p + 1), mm), 1);
+            xs = __nth_element__ (x, [p_lr; p_rl]);
+            inv(k,:) = (xs(1:n,:) + xs(n+1:end,:))/2;
 
           case 3
            ## Used by SAS, method PCTLDEF=2.
            ## http://support.sas.com/onlinedoc/913/getDoc/en/statug.hlp/stdize_sect14.htm
             t = max (kron (p, m), 1);
             t = roundb (t);
-            inv(k,:) = x(t + pcd);
+            inv(k,:) = __nth_element__ (x, t);
         endswitch
 
       otherwise
@@ -489,15 +507,12 @@ function inv = __quantile__ (x, p, method = 5)
             error ("quantile: Unknown METHOD, '%d'", method);
         endswitch
 
-        ## Duplicate single values.
-        imm1 = (mm(1,:) == 1);
-        x(2,imm1) = x(1,imm1);
-
-        ## Interval indices.
+        ## Interval indices.  Single values are duplicated.
         pi = max (min (floor (p), mm-1), 1);
         pr = max (min (p - pi, 1), 0);
-        pi += pcd;
-        inv(k,:) = (1-pr) .* x(pi) + pr .* x(pi+1);
+        pj = min (pi + 1, max (mm, 1));
+        xs = __nth_element__ (x, [pi; pj]);
+        inv(k,:) = (1-pr) .* xs(1:n,:) + pr .* xs(n+1:end,:);
     endswitch
   endif
 
@@ -612,3 +612,39 @@
 %! c = cell (1,1,1);
 %! c{1,1,1} = zeros(5, 2);
 %! c{1,1,1}(:, 1) = 1;
+
+## Long index vectors and masks of every element size
+%!test
+%! n = 100003;
+%! idx = mod ((1:n) * 7919, n) + 1;
+%! mask = mod (1:n, 3) == 0;
+%! for cls = {"int8", "int16", "single", "double", "logical", "char"}
+%!   x = cast (mod (1:n, 100), cls{1});
+%!   y = x(idx);
+%!   assert (y(1:3), x(idx(1:3)));
+%!   assert (y(end), x(idx(end)));
+%!   assert (x(mask), x(3:3:n));
+%!   z = x;
+%!   z(mask) = x(1:nnz (mask));
+%!   assert (z(3:3:n), x(1:nnz (mask)));
+%!   assert (z(~mask), x(~mask));
+%! endfor
+%! x = complex (1:n, -(1:n));
+%! assert (x(idx), complex (idx, -idx));
+%! assert (x(mask), x(3:3:n));
+%! A = reshape (1:n*10, n, 10);
+%! assert (A(idx,[3 1 3]), [A(idx,3), A(idx,1), A(idx,3)]);
+
+## Masks whose last element is true at a length not a multiple of 8
+%!test
+%! for n = [68, 100, 101]
+%!   m = false (1, n);
+%!   m([1:3:n-1, n]) = true;
+%!   for cls = {"single", "double", "int32", "int64"}
+%!     x = cast (1:n, cls{1});
+%!     assert (x(m), x(find (m)));
+%!     z = zeros (1, n, cls{1});
+%!     z(m) = x(1:nnz (m));
+%!     assert (z(find (m)), x(1:nnz (m)));
+%!   endfor
+%! endfor
@@ -158,3 +158,23 @@
 %! bval = int64 (9223372036854775807);
 %! b = [b0val; bval; bval; bval; bval];
 %! assert (a, b);
+
+## Saturating addition and subtraction of arrays of any length
+%!test
+%! for cls = {"int8", "uint8", "int16", "uint16"}
+%!   lo = double (intmin (cls{1}));
+%!   hi = double (intmax (cls{1}));
+%!   for n = [1, 15, 16, 33, 130]
+%!     x = linspace (lo, hi, n);
+%!     y = fliplr (x);
+%!     a = cast (x, cls{1});
+%!     b = cast (y, cls{1});
+%!     assert (a + b, cast (min (max (round (x) + round (y), lo), hi), cls{1}));
+%!     assert (a - b, cast (min (max (round (x) - round (y), lo), hi), cls{1}));
+%!     assert (a + b(1), cast (min (max (round (x) + round (y(1)), lo), hi), cls{1}));
+%!     assert (b(1) - a, cast (min (max (round (y(1)) - round (x), lo), hi), cls{1}));
+%!     c = a;
+%!     c += b;
+%!     assert (c, a + b);
+%!   endfor
+%! endfor
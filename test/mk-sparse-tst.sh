@@ -205,6 +205,107 @@ cat <<EOF
 %! n = 510;
 %! sparse (kron ((1:n)', ones (n,1)), kron (ones (n,1), (1:n)'), ones (n));
 
+%!test # assembly of unsorted, column-sorted, and repeated triplets
+%! m = 300;  n = 200;  nt = 200000;
+%! i = randi (m, nt, 1);  j = randi (n, nt, 1);  v = rand (nt, 1);
+%! A = accumarray ([i, j], v, [m, n]);
+%! assert (sparse (i, j, v, m, n), sparse (A), 1e-12);
+%! [~, p] = sort (j);
+%! assert (sparse (i(p), j(p), v(p), m, n), sparse (A), 1e-12);
+%! [~, p] = sortrows ([j, i]);
+%! assert (sparse (i(p), j(p), v(p), m, n), sparse (A), 1e-12);
+%! assert (sparse (i, j, 1, m, n), sparse (accumarray ([i, j], 1, [m, n])));
+%! B = zeros (m, n);
+%! B(sub2ind ([m, n], i, j)) = v;
+%! assert (sparse (i, j, v, m, n, "unique"), sparse (B));
+%! assert (sparse (i, j, v > 0.5, m, n),
+%!         sparse (accumarray ([i, j], double (v > 0.5), [m, n]) > 0));
+%! assert (nnz (sparse ([1 2 1], [1 1 1], [1 5 -1], 2, 1)), 1);
+
+%!test # triangular solves, repeated and with several right-hand sides
+%! n = 40;
+%! e = ones (n^2, 1);
+%! A = spdiags ([-e, -e, 4*e, -e, -e], [-n, -1, 0, 1, n], n^2, n^2);
+%! L = ichol (A);
+%! U = L';
+%! b = (1:n^2)';
+%! B = [b, -2*b, 1i*b];
+%! for k = 1:3
+%!   assert (L \ b, full (L) \ b, -1e-12);
+%!   assert (U \ b, full (U) \ b, -1e-12);
+%!   assert (L \ B, full (L) \ B, -1e-12);
+%!   assert (U \ B, full (U) \ B, -1e-12);
+%! endfor
+
+%!test # triangular solves with few, wide levels, split between threads
+%! n_old = maxNumCompThreads (4);
+%! unwind_protect
+%!   n = 1500;
+%!   [i, j] = ndgrid (1:n);
+%!   m = mod (i + 3*j, 10) == 0;
+%!   B = sparse (i(m), j(m), 1 ./ (i(m) + j(m)), n, n);
+%!   L = [speye(n), sparse(n, n); B, 2*speye(n)];
+%!   U = L.';
+%!   b = (1:2*n)';
+%!   for k = 1:2
+%!     assert (L \ b, full (L) \ b, -1e-12);
+%!     assert (U \ b, full (U) \ b, -1e-12);
+%!     assert (L \ [b, -b, 2*b], full (L) \ [b, -b, 2*b], -1e-12);
+%!     assert (U \ [b, 1i*b], full (U) \ [b, 1i*b], -1e-12);
+%!     assert (L \ (b * (1:6)), full (L) \ (b * (1:6)), -1e-12);
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
+%!test # rows of a matrix used repeatedly, before and after modifying it
+%! A = sparse ([1 0 2; 0 3 0; 4 0 5]);
+%! for k = 1:3
+%!   assert (A(2,:), sparse ([0 3 0]));
+%!   assert (A(3,:), sparse ([4 0 5]));
+%!   assert (A.', sparse ([1 0 4; 0 3 0; 2 0 5]));
+%! endfor
+%! A(3,1) = 7;
+%! assert (A(3,:), sparse ([7 0 5]));
+%! assert (A.', sparse ([1 0 7; 0 3 0; 2 0 5]));
+
+%!test # products large enough to be split between threads
+%! n = 20000;
+%! i = mod ((1:20*n)' * 7919, n) + 1;
+%! j = repmat ((1:n)', 20, 1);
+%! v = sin (1:20*n)';
+%! A = sparse (i, j, v, n, n);
+%! x = cos (1:n)';
+%! X = [x, 2*x, x.^2];
+%! assert (A*x, accumarray (i, v .* x(j), [n, 1]), 1e-10);
+%! assert (A'*x, accumarray (j, v .* x(i), [n, 1]), 1e-10);
+%! assert (A*X, [A*x, 2*(A*x), A*x.^2], 1e-10);
+%! assert (X'*A, (A'*X)', 1e-10);
+%! assert (X'*A', (A*X)', 1e-10);
+%! assert ((A*A)*x, A*(A*x), 1e-8);
+%! Z = A + 1i*A';
+%! assert (Z'*X, conj (Z).'*X, 1e-10);
+%! assert ((Z*A)*x, Z*(A*x), 1e-8);
+
+%!test # threaded products that do not depend on earlier products
+%! n_old = maxNumCompThreads (1);
+%! unwind_protect
+%!   n = 20000;
+%!   i = mod ((1:20*n)' * 7919, n) + 1;
+%!   j = repmat ((1:n)', 20, 1);
+%!   A = sparse (i, j, sin (1:20*n)', n, n);
+%!   x = cos (1:n)';
+%!   y = A*x;
+%!   z = x'*A.';
+%!   maxNumCompThreads (4);
+%!   for k = 1:2
+%!     assert (A*x, y);
+%!     assert (x'*A.', z);
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (n_old);
+%! end_unwind_protect
+
 %% segfault tests from Fabian@isas-berlin.de
 %% Note that the last four do not fail, but rather give a warning
 %% of a singular matrix, which is consistent with the full matrix